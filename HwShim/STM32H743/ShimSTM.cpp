@@ -41,7 +41,7 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 //Hal callback override uart error shim::errorCallback
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
-	// TODO - figure out if it is transmit and let transport layer know it failed/can try again
+	// The UART errors (parity, noise, framing, overrun) are receive errors; a stalled transmit is caught by the transport layer's timeout
 	extern UART_HandleTypeDef huart3;
 	if(&huart3 == huart)
 	{
@@ -59,11 +59,11 @@ void ShimSTM::rxCallback()
 
 void ShimSTM::txCallback()
 {
-	/** 
-	 * Decided if you need to do anything here in the future
-	 * As of now HAL_UART_GetState is polled by Transport 
-	 * and action is decided from there
-	 ** */
+	// The driver starts its next queued send from here, so back to back sends have no gap between them
+	if(mp_txCallbackClass != nullptr && mp_txCallback != nullptr)
+	{
+		(mp_txCallbackClass->*mp_txCallback)();
+	}
 }
 
 void ShimSTM::errorCallback()
@@ -71,29 +71,38 @@ void ShimSTM::errorCallback()
 	if(mp_errorCallbackClass != nullptr && mp_errorCallback != nullptr)
 	{
 		extern UART_HandleTypeDef huart3;
-		errorCode_t cefError = errorCode_debugPortErrorCodeUnknown;
 		uint32_t halErrorCode = HAL_UART_GetError(&huart3);
-		switch (halErrorCode)
+
+		// More than one error can be flagged for a byte, each one is reported so it is counted
+		static const struct
+		{
+			uint32_t halError;
+			errorCode_t cefError;
+		} errorMap[] =
+		{
+			{ HAL_UART_ERROR_PE,  errorCode_debugPortErrorCodeParity },
+			{ HAL_UART_ERROR_NE,  errorCode_debugPortErrorCodeNoise },
+			{ HAL_UART_ERROR_FE,  errorCode_debugPortErrorCodeFrame },
+			{ HAL_UART_ERROR_ORE, errorCode_debugPortErrorCodeOverrun },
+		};
+		uint32_t unreportedErrors = halErrorCode;
+		for (uint32_t i = 0; i < NUM_ELEMENTS(errorMap); ++i)
+		{
+			if ((halErrorCode & errorMap[i].halError) != 0)
+			{
+				(mp_errorCallbackClass->*mp_errorCallback)(errorMap[i].cefError);
+				unreportedErrors &= ~errorMap[i].halError;
+			}
+		}
+
+		if (halErrorCode == HAL_UART_ERROR_NONE)
+		{
+			(mp_errorCallbackClass->*mp_errorCallback)(errorCode_debugPortErrorCodeNone);
+		}
+		else if (unreportedErrors != 0)
 		{
-		case HAL_UART_ERROR_NONE :
-			cefError = errorCode_debugPortErrorCodeNone;
-			break;
-		case HAL_UART_ERROR_PE :
-			cefError = errorCode_debugPortErrorCodeParity;
-			break;
-		case HAL_UART_ERROR_NE :
-			cefError = errorCode_debugPortErrorCodeNoise;
-			break;
-		case HAL_UART_ERROR_FE :
-			cefError = errorCode_debugPortErrorCodeFrame;
-			break;
-		case HAL_UART_ERROR_ORE :
-			cefError = errorCode_debugPortErrorCodeOverrun;
-			break;
-		default:
-			break;
+			(mp_errorCallbackClass->*mp_errorCallback)(errorCode_debugPortErrorCodeUnknown);
 		}
-		(mp_errorCallbackClass->*mp_errorCallback)(cefError);
 	}
 }
 
@@ -108,8 +117,10 @@ bool ShimSTM::getSendInProgress(void)
 	return false;
 }
 
-bool ShimSTM::startInterruptSend(void*sendBuffer, int bufferSize)
+bool ShimSTM::startInterruptSend(void*sendBuffer, int bufferSize, DebugPortDriver* callbackClass, void (DebugPortDriver::* callback)(void))
 {
+		mp_txCallbackClass = callbackClass;
+		mp_txCallback = callback;
 		extern UART_HandleTypeDef huart3;
 		HAL_StatusTypeDef startSend = HAL_UART_Transmit_IT(&huart3, (uint8_t *)sendBuffer, bufferSize);
 		if(startSend != HAL_OK)
@@ -120,7 +131,7 @@ bool ShimSTM::startInterruptSend(void*sendBuffer, int bufferSize)
 		return true;
 }
 
-void ShimSTM::startInterruptReceive(void* receiveByte, SerialPortDriverHwImpl* callbackClass, bool (SerialPortDriverHwImpl::* callback)(void))
+void ShimSTM::startInterruptReceive(void* receiveByte, DebugPortDriver* callbackClass, bool (DebugPortDriver::* callback)(void))
 {
 	mp_rxCallbackClass = callbackClass;
 	mp_rxCallback = callback;
@@ -128,7 +139,7 @@ void ShimSTM::startInterruptReceive(void* receiveByte, SerialPortDriverHwImpl* c
 	HAL_UART_Receive_IT(&huart3, ((uint8_t *)receiveByte), sizeof(uint8_t));
 }
 
-void ShimSTM::startErrorCallback(SerialPortDriverHwImpl* errorCallbackClass, void (SerialPortDriverHwImpl::* errorCallback)(errorCode_t error))
+void ShimSTM::startErrorCallback(DebugPortDriver* errorCallbackClass, void (DebugPortDriver::* errorCallback)(errorCode_t error))
 {
 	mp_errorCallbackClass = errorCallbackClass;
 	mp_errorCallback = errorCallback;
@@ -140,4 +151,106 @@ void ShimSTM::forceStopReceive(void)
 	HAL_UART_AbortReceive_IT (&huart3);
 }
 
+void ShimSTM::forceStopSend(void)
+{
+	// Blocking abort, so the transmit complete callback can't be called afterwards for the aborted send
+	extern UART_HandleTypeDef huart3;
+	HAL_UART_AbortTransmit(&huart3);
+}
+
+uint32_t ShimSTM::getTickMs(void)
+{
+	// HAL tick is incremented every millisecond by the SysTick interrupt
+	return HAL_GetTick();
+}
+
+bool ShimSTM::hasClock(void)
+{
+	return true;
+}
+
+uint64_t ShimSTM::getTimeNs(void)
+{
+	// May be called from any context (e.g. logging from an interrupt), so update the 64 bit count with interrupts masked
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (m_timeInitialized == false)
+	{
+		// Enable the DWT cycle counter, which counts core clock cycles
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+		m_lastCycleCount = 0;
+		m_lastTickMs = HAL_GetTick();
+		m_timeInitialized = true;
+	}
 
+	uint32_t cycleCount = DWT->CYCCNT;
+	uint32_t tickMs = HAL_GetTick();
+
+	/**
+	 * The 32 bit cycle counter wraps every few seconds (~8.9 s at 480 MHz).  The millisecond tick is coarse but does
+	 * not wrap for 49 days, so it is used to add back any whole cycle counter wraps between calls.
+	 */
+	uint64_t elapsedCycles = (uint32_t) (cycleCount - m_lastCycleCount);
+	uint64_t elapsedCyclesFromTick = (uint64_t) (tickMs - m_lastTickMs) * (SystemCoreClock / 1000);
+	if (elapsedCyclesFromTick > (elapsedCycles + m_cycleCounterHalfRange))
+	{
+		uint64_t numWraps = (elapsedCyclesFromTick - elapsedCycles + m_cycleCounterHalfRange) >> 32;
+		elapsedCycles += numWraps << 32;
+	}
+
+	m_numCycles += elapsedCycles;
+	m_lastCycleCount = cycleCount;
+	m_lastTickMs = tickMs;
+	uint64_t numCycles = m_numCycles;
+
+	__set_PRIMASK(primask);
+
+	// Split the conversion so the multiply can't overflow
+	uint64_t cyclesPerSecond = SystemCoreClock;
+	return ((numCycles / cyclesPerSecond) * LOGGING_UINT64_NSEC_TO_SECONDS) +
+			(((numCycles % cyclesPerSecond) * LOGGING_UINT64_NSEC_TO_SECONDS) / cyclesPerSecond);
+}
+
+uint32_t ShimSTM::disableInterrupts(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+void ShimSTM::restoreInterrupts(uint32_t interruptState)
+{
+	__set_PRIMASK(interruptState);
+}
+
+bool ShimSTM::isAddressRangeReadable(uint64_t address, uint32_t numBytes)
+{
+	// STM32H743 memory map (RM0433)
+	static const struct
+	{
+		uint32_t startAddress;
+		uint32_t numBytes;
+	} memoryRegions[] =
+	{
+		{ 0x00000000, 0x00010000 },   // ITCM RAM
+		{ 0x08000000, 0x00200000 },   // Flash (both banks)
+		{ 0x20000000, 0x00020000 },   // DTCM RAM
+		{ 0x24000000, 0x00080000 },   // AXI SRAM
+		{ 0x30000000, 0x00048000 },   // SRAM1, SRAM2 and SRAM3
+		{ 0x38000000, 0x00010000 },   // SRAM4
+	};
+	for (uint32_t i = 0; i < NUM_ELEMENTS(memoryRegions); ++i)
+	{
+		// The whole range has to be in one region
+		if ((address >= memoryRegions[i].startAddress) &&
+		    ((address - memoryRegions[i].startAddress) < memoryRegions[i].numBytes) &&
+		    (numBytes <= (memoryRegions[i].numBytes - (address - memoryRegions[i].startAddress))))
+		{
+			return true;
+		}
+	}
+	return false;
+}
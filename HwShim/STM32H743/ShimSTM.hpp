@@ -27,7 +27,12 @@ written permission of Syncroness.
 class ShimSTM : public ShimBase {
 public:
 	//! Constructor.
-	ShimSTM():ShimBase() {}
+	ShimSTM():ShimBase(),
+	m_timeInitialized(false),
+	m_lastCycleCount(0),
+	m_lastTickMs(0),
+	m_numCycles(0)
+	{}
 
    /**
     * See base class for method documentation 
@@ -52,23 +57,73 @@ public:
 	/**
 	 * See base class for method documentation
 	 */
-   bool startInterruptSend( void*sendBuffer, int bufferSize );
+   bool startInterruptSend(void*sendBuffer, int bufferSize, DebugPortDriver* callbackClass, void (DebugPortDriver::* callback)(void));
 
    /**
     * See base class for method documentation
     */
-   void startInterruptReceive(void* receiveByte, SerialPortDriverHwImpl* callbackClass, bool (SerialPortDriverHwImpl::* callback)(void));
+   void startInterruptReceive(void* receiveByte, DebugPortDriver* callbackClass, bool (DebugPortDriver::* callback)(void));
 
    /**
     * See base class for method documentation
     */
-   void startErrorCallback(SerialPortDriverHwImpl* errorCallbackClass, void (SerialPortDriverHwImpl::* errorCallback)(errorCode_t error));
+   void startErrorCallback(DebugPortDriver* errorCallbackClass, void (DebugPortDriver::* errorCallback)(errorCode_t error));
 
    /**
     * Forces the stop of receive interrupt
     */
    void forceStopReceive(void);
 
+   /**
+    * Forces the stop of a send
+    */
+   void forceStopSend(void);
+
+   /**
+    * See base class for method documentation
+    */
+   uint32_t getTickMs(void);
+
+   /**
+    * See base class for method documentation
+    */
+   bool hasClock(void);
+
+   /**
+    * See base class for method documentation
+    * Uses the DWT core cycle counter, extended to 64 bits.
+    */
+   uint64_t getTimeNs(void);
+
+   /**
+    * See base class for method documentation
+    * Masks all interrupts (PRIMASK).
+    */
+   uint32_t disableInterrupts(void);
+
+   /**
+    * See base class for method documentation
+    */
+   void restoreInterrupts(uint32_t interruptState);
+
+   /**
+    * See base class for method documentation
+    * Only the STM32H743 RAMs and flash are readable (peripheral registers are not, as reading some has side effects).
+    */
+   bool isAddressRangeReadable(uint64_t address, uint32_t numBytes);
+
+private:
+   //! Half of the range of the 32 bit DWT cycle counter
+   static const uint64_t m_cycleCounterHalfRange = 0x80000000ULL;
+
+   //! True once the DWT cycle counter has been enabled
+   bool m_timeInitialized;
+   //! DWT cycle count at the previous getTimeNs() call
+   uint32_t m_lastCycleCount;
+   //! HAL millisecond tick at the previous getTimeNs() call
+   uint32_t m_lastTickMs;
+   //! Core clock cycles since the DWT cycle counter was enabled
+   uint64_t m_numCycles;
 };
 
 
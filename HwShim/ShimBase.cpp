@@ -24,10 +24,22 @@ written permission of Syncroness.
 
 #include "ShimBase.hpp"
 #include "Logging.hpp"
+#ifdef __SIMULATOR__
+#include <time.h>
+#endif
 
+#ifdef __SIMULATOR__
+#include "ShimSimulator.hpp"
+//Instance of simulator shim
+static ShimSimulator shimInstance;
+#else
 #include "ShimSTM.hpp"
 //Instance of STM shim
 static ShimSTM shimInstance;
+#endif
+
+//! Nanoseconds per millisecond
+static const uint64_t nsecPerMsec = 1000000;
 
 ShimBase& ShimBase::getInstance()
 {
@@ -57,14 +69,14 @@ void ShimBase::errorCallback(void)
 	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class ShimBase::errorCallback() called, supposed to be implemented in derived class", 0, 0, 0);
 }
 
-bool ShimBase::startInterruptSend(void*sendBuffer, int bufferSize)
+bool ShimBase::startInterruptSend(void*sendBuffer, int bufferSize, DebugPortDriver* callbackClass, void (DebugPortDriver::* callback)(void))
 {
 	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class ShimBase::startInterruptSend() called, supposed to be implemented in derived class",
 	        0, 0, 0);
 	return false;
 }
 
-void ShimBase::startInterruptReceive(void* receiveByte, SerialPortDriverHwImpl* callbackClass, bool (SerialPortDriverHwImpl::* callback)(void))
+void ShimBase::startInterruptReceive(void* receiveByte, DebugPortDriver* callbackClass, bool (DebugPortDriver::* callback)(void))
 {
 	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class ShimBase::startInterruptReceive() called, supposed to be implemented in derived class", 0, 0, 0);
 }
@@ -74,7 +86,55 @@ void ShimBase::forceStopReceive(void)
 	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class ShimBase::forceStopReveive() called, supposed to be implemented in derived class", 0, 0, 0);
 }
 
-void ShimBase::startErrorCallback(SerialPortDriverHwImpl* errorCallbackClass, void (SerialPortDriverHwImpl::* errorCallback)(errorCode_t error))
+void ShimBase::forceStopSend(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class ShimBase::forceStopSend() called, supposed to be implemented in derived class", 0, 0, 0);
+}
+
+uint32_t ShimBase::getTickMs(void)
+{
+	// No LOG_FATAL here as Logging calls this method (it would recurse into logging)
+	return (uint32_t) (getTimeNs() / nsecPerMsec);
+}
+
+bool ShimBase::hasClock(void)
+{
+#ifdef __SIMULATOR__
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t ShimBase::getTimeNs(void)
+{
+	// No LOG_FATAL here as Logging calls this method (it would recurse into logging)
+#ifdef __SIMULATOR__
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t) now.tv_sec * LOGGING_UINT64_NSEC_TO_SECONDS) + (uint64_t) now.tv_nsec;
+#else
+	return 0;
+#endif
+}
+
+uint32_t ShimBase::disableInterrupts(void)
+{
+	// Nothing to do on single threaded platforms (e.g. the simulator), where callbacks can't interrupt the caller
+	return 0;
+}
+
+void ShimBase::restoreInterrupts(uint32_t interruptState)
+{
+}
+
+bool ShimBase::isAddressRangeReadable(uint64_t address, uint32_t numBytes)
+{
+	// No memory map to check against
+	return true;
+}
+
+void ShimBase::startErrorCallback(DebugPortDriver* errorCallbackClass, void (DebugPortDriver::* errorCallback)(errorCode_t error))
 {
 	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class ShimBase::startErrorCallback() called, supposed to be implemented in derived class", 0, 0, 0);
 }
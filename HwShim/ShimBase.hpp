@@ -18,7 +18,7 @@ written permission of Syncroness.
 #define __SHIM_BASE_H
 #include <stdio.h>
 #include <functional>
-#include "SerialPortDriverHwImpl.hpp"
+#include "DebugPortDriver.hpp"
 /**
  * Base Class for UART Shim
  */
@@ -35,13 +35,14 @@ public:
 
    /**
     * Receive finished callback.  
-    * This will send callback to SerialPortDriverHwImpl to decided if receive should continue
+    * This will send callback to DebugPortDriver to decided if receive should continue
     */
    virtual void rxCallback();
 
    /**
-    * Transmit finished callback.  
-    * This will send callback to SerialPortDriverHwImpl to indicate send is finished.
+    * Transmit finished callback (interrupt context).
+    * This will send callback to DebugPortDriver to indicate send is finished, so it can immediately
+    * start sending the next queued data.
     */
    virtual void txCallback();
 
@@ -54,19 +55,22 @@ public:
    virtual bool getSendInProgress(void);
 
    /**
-    * Error callback.  This will send callback to SerialPortDriverHwImpl inform Debug port
+    * Error callback.  This will send callback to DebugPortDriver inform Debug port
     */
    virtual void errorCallback();
 
    /**
 	 * Start send - will send number of bytes of buffer size starting at sendBuffer location 
+	 * Once all the bytes have been sent the callback function will be called (from the transmit interrupt)
     * 
 	 * @param sendBuffer send buffer
     * @param bufferSize number of bytes to be sent in the buffer
+    * @param callbackClass - class of callback function (the class that started the send)
+    * @param callback - callback function once the data has been sent
     * 
     * @return returns true if it was able to start a send routine (dependint on m_startInProgress)
 	 */
-   virtual bool startInterruptSend(void* sendBuffer, int bufferSize);
+   virtual bool startInterruptSend(void* sendBuffer, int bufferSize, DebugPortDriver* callbackClass, void (DebugPortDriver::* callback)(void));
 
    /**
     * Start receive interrupt driven data
@@ -77,7 +81,7 @@ public:
     * @param callbackClass - class of callback function (the class that started the receive)
     * @param callback - callback function once the data byte has been received 
     */
-   virtual void startInterruptReceive(void* receiveByte, SerialPortDriverHwImpl* callbackClass, bool (SerialPortDriverHwImpl::* callback)(void));
+   virtual void startInterruptReceive(void* receiveByte, DebugPortDriver* callbackClass, bool (DebugPortDriver::* callback)(void));
 
    /**
     * Callback for error during send/receive
@@ -85,35 +89,98 @@ public:
     * @param errorCallbackClass - class of callback function for error info
     * @param errorCallback - callback function for error info
     */
-   virtual void startErrorCallback(SerialPortDriverHwImpl* errorCallbackClass, void (SerialPortDriverHwImpl::* errorCallback)(errorCode_t error));
+   virtual void startErrorCallback(DebugPortDriver* errorCallbackClass, void (DebugPortDriver::* errorCallback)(errorCode_t error));
 
    /**
     * Forces the stop of receive interrupt
     */
    virtual void forceStopReceive(void);
 
+   /**
+    * Forces the stop of a send started with startInterruptSend() (its callback is not called)
+    */
+   virtual void forceStopSend(void);
+
+   /**
+    * Free running millisecond tick (wraps at 32 bits, so only use it for differences)
+    * The default derives it from getTimeNs().
+    * Note: Logging uses this tick, so implementations must not log.
+    *
+    * @return milliseconds since power up
+    */
+   virtual uint32_t getTickMs(void);
+
+   /**
+    * Whether getTimeNs() and getTickMs() run on this platform.  Logging rate limiting is turned off without them,
+    * as its token buckets would never refill.
+    *
+    * @return true if the platform has a running clock
+    */
+   virtual bool hasClock(void);
+
+   /**
+    * Free running monotonic time, used to time stamp logs and for host/target time correlation.
+    * Note: Logging uses this time, so implementations must not log.
+    *
+    * @return nanoseconds since power up (never wraps in practice)
+    */
+   virtual uint64_t getTimeNs(void);
+
+   /**
+    * Disables the interrupts that call the callbacks above, so data shared with them can be updated safely.
+    * Must be followed by restoreInterrupts() with the returned value (so the calls can nest).
+    *
+    * @return interrupt state to pass to restoreInterrupts()
+    */
+   virtual uint32_t disableInterrupts(void);
+
+   /**
+    * Restores the interrupt state from before the matching disableInterrupts()
+    *
+    * @param interruptState - value returned by disableInterrupts()
+    */
+   virtual void restoreInterrupts(uint32_t interruptState);
+
+   /**
+    * Whether a range of memory can be read without faulting, for addresses that come from the host (e.g. the
+    * software scope's, which are read every telemetry tick, possibly from an interrupt).
+    * The default accepts any range, as a platform without a memory map (e.g. the simulator) can't tell.
+    *
+    * @param address - start of the range
+    * @param numBytes - number of bytes in the range
+    *
+    * @return true if the whole range is readable memory
+    */
+   virtual bool isAddressRangeReadable(uint64_t address, uint32_t numBytes);
+
 protected:
 	//! Constructor.
 	ShimBase():
    mp_rxCallbackClass(nullptr),
    mp_rxCallback(nullptr),
+   mp_txCallbackClass(nullptr),
+   mp_txCallback(nullptr),
    mp_errorCallbackClass(nullptr),
    mp_errorCallback(nullptr)
  	{}
 
 
    //! Callback class instance for receive callback
-   SerialPortDriverHwImpl* mp_rxCallbackClass; 
+   DebugPortDriver* mp_rxCallbackClass; 
    //! Callback function for receive callback
-	bool (SerialPortDriverHwImpl::* mp_rxCallback)(void);
+	bool (DebugPortDriver::* mp_rxCallback)(void);
+   //! Callback class instance for transmit callback
+   DebugPortDriver* mp_txCallbackClass;
+   //! Callback function for transmit callback
+	void (DebugPortDriver::* mp_txCallback)(void);
    //! Callback class instance for receive error callback
-   SerialPortDriverHwImpl* mp_errorCallbackClass; 
+   DebugPortDriver* mp_errorCallbackClass; 
    /**
     * Callback function for receive error callback
     * 
     * @param - debug buffer error code for send or receive error
     */
-	void (SerialPortDriverHwImpl::* mp_errorCallback)(errorCode_t);
+	void (DebugPortDriver::* mp_errorCallback)(errorCode_t);
 
 };
 
@@ -0,0 +1,47 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include "ShimSimulator.hpp"
+
+uint64_t ShimSimulator::getTimeNs(void)
+{
+	if(m_useSimulatedTime == true)
+	{
+		return m_simulatedTimeNs;
+	}
+	return ShimBase::getTimeNs();
+}
+
+void ShimSimulator::setSimulatedTimeNs(uint64_t timeNs)
+{
+	m_useSimulatedTime = true;
+	m_simulatedTimeNs = timeNs;
+}
+
+void ShimSimulator::startErrorCallback(DebugPortDriver* errorCallbackClass, void (DebugPortDriver::* errorCallback)(errorCode_t error))
+{
+	mp_errorCallbackClass = errorCallbackClass;
+	mp_errorCallback = errorCallback;
+}
+
+void ShimSimulator::injectReceiveError(errorCode_t error)
+{
+	if(mp_errorCallbackClass != nullptr && mp_errorCallback != nullptr)
+	{
+		(mp_errorCallbackClass->*mp_errorCallback)(error);
+	}
+}
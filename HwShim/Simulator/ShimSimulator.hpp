@@ -0,0 +1,69 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __SHIM_SIMULATOR_H
+#define __SHIM_SIMULATOR_H
+
+#include "ShimBase.hpp"
+
+/**
+ * Simulator Shim class
+ * The simulator has no UART (its debug port drivers are sockets, shared memory or an in-process loopback),
+ * so only time is provided.  Time is the host's monotonic clock, unless the simulation sets it, in which
+ * case it only moves when set (so a test can run the target deterministically).  A simulation can also inject
+ * the receive errors a UART reports, to exercise recovering from them.
+ */
+class ShimSimulator : public ShimBase {
+public:
+	//! Constructor.
+	ShimSimulator():ShimBase(),
+	m_useSimulatedTime(false),
+	m_simulatedTimeNs(0)
+	{}
+
+   /**
+    * See base class for method documentation
+    */
+   uint64_t getTimeNs(void);
+
+   /**
+    * Sets the time.  From then on, time only changes when it is set.
+    *
+    * @param timeNs - nanoseconds since power up
+    */
+   void setSimulatedTimeNs(uint64_t timeNs);
+
+   /**
+    * See base class for method documentation
+    */
+   void startErrorCallback(DebugPortDriver* errorCallbackClass, void (DebugPortDriver::* errorCallback)(errorCode_t error));
+
+   /**
+    * Reports a receive error to the debug port driver, as the UART's error interrupt would
+    *
+    * @param error - errorCode_debugPortErrorCodeParity, errorCode_debugPortErrorCodeNoise, ...
+    */
+   void injectReceiveError(errorCode_t error);
+
+private:
+   //! True once the simulation has set the time
+   bool m_useSimulatedTime;
+
+   //! Time set by the simulation
+   uint64_t m_simulatedTimeNs;
+};
+
+#endif  // end header guard
@@ -19,6 +19,7 @@ written permission of Syncroness.
 #include "CommandExecutor.hpp"
 #include "CommandDebugPortRouter.hpp"
 #include "CommandCefCommandProxy.hpp"
+#include "TelemetryStream.hpp"
 
 
 //! Singleton instantiation of AppMain
@@ -278,6 +279,7 @@ void AppMain::initialize()
 
 	CommandExecutor::instance().addCommandToQueue(&CommandDebugPortRouter::instance());
 	CommandExecutor::instance().addCommandToQueue(&CommandCefCommandProxy::instance()); 
+	m_initialized = true;
 }
 
 void AppMain::runAppMain_noReturn()
@@ -296,7 +298,33 @@ void AppMain::runAppMain_noReturn()
 }
 
 
+void AppMain::runAppMainPasses(uint32_t numPasses)
+{
+	if (m_initialized == false)
+	{
+		initialize();
+	}
+
+	for (uint32_t pass = 0; pass < numPasses; ++pass)
+	{
+		runOnePass();
+	}
+}
+
+
 void AppMain::run()
+{
+	while (1)
+	{
+		runOnePass();
+	}
+
+	// We never should reach this point of the code!
+    LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Unexpectedly exited AppMain infinite while loop!", 0, 0, 0);
+}
+
+
+void AppMain::runOnePass()
 {
 	/**
 	 * Number of commands CommandExecutor allowed to execute each time through the while loop.
@@ -304,14 +332,14 @@ void AppMain::run()
 	 * as well as other tasks that may need to run from the forever while loop.
 	 */
 	uint32_t const numCommandsAllowedToExecute = 2;
-	while (1)
-	{
-		CommandExecutor::instance().executeCommands(numCommandsAllowedToExecute);
-		tonyTesting();
 
-		// When watch dog timer is implemented, this should be the one place the watch dog is petted
-	}
+	CommandExecutor::instance().executeCommands(numCommandsAllowedToExecute);
+	tonyTesting();
 
-	// We never should reach this point of the code!
-    LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Unexpectedly exited AppMain infinite while loop!", 0, 0, 0);
+#if (TELEMETRY_SAMPLE_FROM_MAIN_LOOP == 1)
+	// Each pass of the while loop is a telemetry tick
+	TelemetryStream::instance().sample();
+#endif
+
+	// When watch dog timer is implemented, this should be the one place the watch dog is petted
 }
@@ -29,7 +29,8 @@ class AppMain
 		 * Constructor
 		 */
 		AppMain() :
-		    m_firstSystemErrorCode(errorCode_OK)
+		    m_firstSystemErrorCode(errorCode_OK),
+		    m_initialized(false)
 			{ }
 
 		/**
@@ -48,6 +49,15 @@ class AppMain
 		 */
 		void runAppMain_noReturn();
 
+		/**
+		 * Runs passes of the infinite while loop, then returns.  This lets a simulation (e.g. libcefsim,
+		 * see CefSimulatorApi.hpp) step the application rather than giving it the thread.  Initialization
+		 * is completed on the first call.
+		 *
+		 * @param numPasses   number of passes of the while loop to run
+		 */
+		void runAppMainPasses(uint32_t numPasses);
+
 		/**
 		 * Sets the first system error code that occurs in the system.  If all is well in the system,
 		 * this value should be set to errorCode_OK.  Otherwise, it is the first error code that
@@ -86,6 +96,11 @@ class AppMain
 		 */
 		void run();
 
+		/**
+		 * One pass of the "infinite while loop"
+		 */
+		void runOnePass();
+
 
 		/**
 		 * If something "terrible" happens with the system that causes the system to "shutdown"
@@ -95,6 +110,9 @@ class AppMain
 		 */
 		errorCode_t m_firstSystemErrorCode;
 
+		//! True once initialize() has been called
+		bool m_initialized;
+
 };
 
 #endif  // end header guard
@@ -0,0 +1,88 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include "CefSimulatorApi.hpp"
+
+#ifdef __SIMULATOR__
+
+#include "AppMain.hpp"
+#include "CommandDebugPortRouter.hpp"
+#include "EventQueue.hpp"
+#include "TelemetryStream.hpp"
+#include "LoopbackPortDriverImpl.hpp"
+#include "ShimSimulator.hpp"
+
+
+//! The debug port of the simulator library
+static LoopbackPortDriverImpl loopbackPortDriver;
+
+//! True once the debug port has been switched to loopbackPortDriver
+static bool loopbackPortDriverInstalled = false;
+
+/**
+ * Switches the debug port to the loopback driver, the first time the host calls in (before the debug port
+ * has started receiving, as required by setDebugPortDriver())
+ */
+static void installLoopbackPortDriver()
+{
+	if (loopbackPortDriverInstalled == false)
+	{
+		loopbackPortDriverInstalled = CommandDebugPortRouter::instance().setDebugPortDriver(&loopbackPortDriver);
+	}
+}
+
+void cef_step(uint32_t numPasses)
+{
+	installLoopbackPortDriver();
+	AppMain::instance().runAppMainPasses(numPasses);
+}
+
+uint32_t cef_push_rx(const uint8_t* p_data, uint32_t numBytes)
+{
+	installLoopbackPortDriver();
+	return loopbackPortDriver.pushReceiveData(p_data, numBytes);
+}
+
+uint32_t cef_pull_tx(uint8_t* p_buffer, uint32_t maxNumBytes)
+{
+	installLoopbackPortDriver();
+	return loopbackPortDriver.pullTransmitData(p_buffer, maxNumBytes);
+}
+
+void cef_set_time_ns(uint64_t timeNs)
+{
+	((ShimSimulator&) ShimBase::getInstance()).setSimulatedTimeNs(timeNs);
+}
+
+void cef_inject_rx_error(uint16_t errorCode)
+{
+	installLoopbackPortDriver();
+	((ShimSimulator&) ShimBase::getInstance()).injectReceiveError(errorCode);
+}
+
+uint32_t cef_raise_event(uint16_t eventId, const uint8_t* p_data, uint16_t numDataBytes)
+{
+	installLoopbackPortDriver();
+	return (EventQueue::instance().raiseEvent(eventId, p_data, numDataBytes) == true) ? 1 : 0;
+}
+
+uint32_t cef_register_telemetry_channel(const char* p_name, uint8_t type, const void* p_variable, uint16_t decimation)
+{
+	return (TelemetryStream::instance().registerChannel(p_name, (telemetryType_t) type, p_variable, decimation) == true) ? 1 : 0;
+}
+
+#endif // __SIMULATOR__
@@ -0,0 +1,110 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_SIMULATOR_API_H
+#define __CEF_SIMULATOR_API_H
+
+#include <stdint.h>
+
+/**
+ * C interface of libcefsim, the simulator (__SIMULATOR__) built as a shared library, so a host (e.g. Python
+ * through ctypes, see DebugLibraryPort.py) can run the target in its own process.  The debug port is an in memory
+ * loopback (LoopbackPortDriverImpl): the host pushes the bytes it sends, steps the target, and pulls the bytes
+ * the target sent.  The target only runs inside cef_step(), so a test controls exactly when it runs.
+ *
+ * The functions are not thread safe, the host must not call them from more than one thread at a time.
+ *
+ * Build (from the repository root), e.g.:
+ *     g++ -std=c++17 -shared -fPIC -O2 -D__SIMULATOR__ -o libcefsim.so <include paths> <EmbeddedSw, HwShim/ShimBase.cpp
+ *         and HwShim/Simulator sources>
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Runs passes of the application's while loop (initializing the target on the first call)
+ *
+ * @param numPasses   number of passes to run
+ */
+void cef_step(uint32_t numPasses);
+
+/**
+ * Hands bytes from the host to the target's debug port
+ *
+ * @param p_data     bytes from the host
+ * @param numBytes   number of bytes
+ *
+ * @return number of bytes taken (the rest have to be pushed again after stepping the target)
+ */
+uint32_t cef_push_rx(const uint8_t* p_data, uint32_t numBytes);
+
+/**
+ * Takes the bytes the target has sent out of its debug port
+ *
+ * @param p_buffer      where to copy the bytes to
+ * @param maxNumBytes   size of the buffer
+ *
+ * @return number of bytes copied
+ */
+uint32_t cef_pull_tx(uint8_t* p_buffer, uint32_t maxNumBytes);
+
+/**
+ * Sets the target's time.  From then on time only changes when set, so timeouts and time stamps are deterministic
+ * (until then the target uses the host's monotonic clock).
+ *
+ * @param timeNs   nanoseconds since power up
+ */
+void cef_set_time_ns(uint64_t timeNs);
+
+/**
+ * Injects a receive error, as the UART's error interrupt would report it (e.g. to check the target recovers from
+ * noise in the middle of a packet)
+ *
+ * @param errorCode   errorCode_debugPortErrorCodeParity, errorCode_debugPortErrorCodeNoise, ...
+ */
+void cef_inject_rx_error(uint16_t errorCode);
+
+/**
+ * Raises an event on the target, as the application or an interrupt handler would (see EventQueue)
+ *
+ * @param eventId        event id
+ * @param p_data         data sent with the event
+ * @param numDataBytes   number of bytes of data (at most CEF_EVENT_MAX_DATA_BYTES)
+ *
+ * @return 1 if the event was queued, 0 if it was dropped
+ */
+uint32_t cef_raise_event(uint16_t eventId, const uint8_t* p_data, uint16_t numDataBytes);
+
+/**
+ * Registers a telemetry channel, as the application would (see TelemetryStream).  The library runs in the host's
+ * process, so the variable can be host memory.
+ *
+ * @param p_name       name of the channel (the host must keep it for as long as the library runs)
+ * @param type         telemetryType_t of the variable
+ * @param p_variable   the variable
+ * @param decimation   the channel is sampled every decimation passes (0 registers it turned off)
+ *
+ * @return 1 if the channel was registered, 0 if there is no room for it
+ */
+uint32_t cef_register_telemetry_channel(const char* p_name, uint8_t type, const void* p_variable, uint16_t decimation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end header guard
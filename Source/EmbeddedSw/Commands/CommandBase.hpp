@@ -111,6 +111,14 @@ class CommandBase
          */
         errorCode_t exportToCefCommandBase(cefCommandHeader_t* p_cefCommandHeader, uint32_t numBytesInCefResponseCommand);
 
+        /**
+         * Whether the command is in the middle of a fragmented transfer (see Fragmented Commands in cefContract.hpp),
+         * so it is kept for the transfer's next fragment instead of being freed once its response is sent.
+         *
+         * @return true if the command expects more fragments
+         */
+        virtual bool isTransferInProgress() { return false; }
+
 
         /**
          * Gets this command's opcode.
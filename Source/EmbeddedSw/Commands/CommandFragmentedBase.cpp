@@ -0,0 +1,160 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandFragmentedBase.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandFragmentedBase Methods
+ * See notes in CommandFragmentedBase.hpp for the use model of the class
+ */
+
+errorCode_t CommandFragmentedBase::startTransfer(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class startTransfer() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return errorCode_LogFatalReturn;
+}
+
+uint32_t CommandFragmentedBase::exportResponseData(uint8_t* p_data, uint32_t maxNumBytes)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class exportResponseData() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return 0;
+}
+
+errorCode_t CommandFragmentedBase::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandFragment_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+	const cefFragmentHeader_t& fragment = p_cef->m_fragment;
+
+	// Every fragment is executed from the start
+	m_commandState = commandStateCommandEntry;
+	m_commandErrorCode = errorCode_OK;
+	mp_requestData = nullptr;
+	m_requestNumBytes = 0;
+
+	if ((fragment.m_numBytes > CEF_FRAGMENT_MAX_DATA_BYTES) ||
+	    (fragment.m_offset > fragment.m_totalNumBytes) ||
+	    (fragment.m_numBytes > (fragment.m_totalNumBytes - fragment.m_offset)))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "Fragment does not fit in the transfer. offset={:d}, numBytes={:d}, totalNumBytes={:d}",
+		        fragment.m_offset, fragment.m_numBytes, fragment.m_totalNumBytes);
+		m_transferInProgress = false;
+		return errorCode_CmdFragmentInvalidSize;
+	}
+
+	// From the CEF Command's header parameters, update Command Base parameters
+	importFromCefCommandBase(&(p_cef->m_header), CEF_FRAGMENT_HEADERS_NUM_BYTES + fragment.m_numBytes, actualNumBytesReceived);
+
+	if ((fragment.m_flags & CEF_FRAGMENT_FLAG_FIRST) != 0)
+	{
+		// A new transfer, which ends any transfer in progress
+		m_requestNumBytesReceived = 0;
+		m_requestTotalNumBytes = fragment.m_totalNumBytes;
+		m_responseNumBytesSent = 0;
+		m_responseTotalNumBytes = 0;
+		m_transferInProgress = true;
+	}
+	else if ((m_transferInProgress == false) ||
+	         (fragment.m_offset != m_requestNumBytesReceived) ||
+	         (fragment.m_totalNumBytes != m_requestTotalNumBytes))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "Fragment out of order. offset={:d}, expected={:d}, transferInProgress={:d}",
+		        fragment.m_offset, m_requestNumBytesReceived, m_transferInProgress);
+		m_transferInProgress = false;
+		return errorCode_CmdFragmentOutOfOrder;
+	}
+
+	mp_requestData = &p_cef->m_data[0];
+	m_requestNumBytes = fragment.m_numBytes;
+	m_requestNumBytesReceived += fragment.m_numBytes;
+
+	if ((fragment.m_flags & CEF_FRAGMENT_FLAG_FIRST) != 0)
+	{
+		errorCode_t status = startTransfer();
+		if (status != errorCode_OK)
+		{
+			m_transferInProgress = false;
+			return status;
+		}
+	}
+
+	return errorCode_OK;
+}
+
+errorCode_t CommandFragmentedBase::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandFragment_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+	cefFragmentHeader_t& fragment = p_cef->m_fragment;
+
+	uint32_t numBytes = 0;
+	if (m_commandErrorCode == errorCode_OK)
+	{
+		uint32_t maxNumBytes = m_responseTotalNumBytes - m_responseNumBytesSent;
+		if (maxNumBytes > CEF_FRAGMENT_MAX_DATA_BYTES)
+		{
+			maxNumBytes = CEF_FRAGMENT_MAX_DATA_BYTES;
+		}
+
+		numBytes = exportResponseData(&p_cef->m_data[0], maxNumBytes);
+		if (numBytes > maxNumBytes)
+		{
+			// The response data overran the command buffer
+			LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Fragment response data too big. numBytes={:d}, maxNumBytes={:d}",
+			        numBytes, maxNumBytes, 0);
+		}
+	}
+
+	fragment.m_totalNumBytes = m_responseTotalNumBytes;
+	fragment.m_offset = m_responseNumBytesSent;
+	fragment.m_numBytes = numBytes;
+	fragment.m_flags = 0;
+	fragment.m_padding1 = 0;
+	fragment.m_padding2 = 0;
+	m_responseNumBytesSent += numBytes;
+
+	// The transfer is over once everything has been sent both ways, or on an error
+	if ((m_commandErrorCode != errorCode_OK) ||
+	    ((m_requestNumBytesReceived == m_requestTotalNumBytes) && (m_responseNumBytesSent == m_responseTotalNumBytes)))
+	{
+		fragment.m_flags = CEF_FRAGMENT_FLAG_LAST;
+		m_transferInProgress = false;
+	}
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), CEF_FRAGMENT_HEADERS_NUM_BYTES + numBytes);
+
+	return errorCode_OK;
+}
@@ -0,0 +1,92 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_FRAGMENTED_BASE_H
+#define __CEF_COMMAND_FRAGMENTED_BASE_H
+
+
+/**
+ * Base class for commands whose request or response data is sent in fragments (see Fragmented Commands in
+ * cefContract.hpp), so data bigger than a packet can be moved with the command buffers there are.
+ *
+ * The same command object handles every fragment of a transfer (CommandCefCommandProxy keeps it while
+ * isTransferInProgress()).  For each fragment:
+ *  - importFromCefCommand() checks the fragment is the next one, and starts the command over at commandStateCommandEntry
+ *  - execute() (derived class) processes the fragment's request data (mp_requestData, m_requestNumBytes)
+ *  - exportToCefCommand() adds the next response data (exportResponseData(), derived class), and ends the transfer
+ *    once all of the request data is received and all of the response data is sent, or on an error
+ */
+
+#include "CommandBase.hpp"
+
+class CommandFragmentedBase : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandFragmentedBase(commandOpCode_t commandOpCode) :
+			CommandBase(commandOpCode),
+			mp_requestData(nullptr),
+			m_requestNumBytes(0),
+			m_requestNumBytesReceived(0),
+			m_requestTotalNumBytes(0),
+			m_responseNumBytesSent(0),
+			m_responseTotalNumBytes(0),
+			m_transferInProgress(false)
+			{ }
+
+		//! See base class for method description
+		errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+		errorCode_t exportToCefCommand(void* p_cefCommand);
+		bool isTransferInProgress() { return m_transferInProgress; }
+
+	protected:
+		/**
+		 * A new transfer is starting (its first fragment has been imported).  The derived class sets up for it,
+		 * including setting m_responseTotalNumBytes.
+		 *
+		 * @return errorCode_OK, or the error to end the transfer with
+		 */
+		virtual errorCode_t startTransfer(void);
+
+		/**
+		 * Copies the next response data (starting at m_responseNumBytesSent) into a response fragment.
+		 * Only called once the fragment's request data has been processed, as the response data is written over it.
+		 *
+		 * @param p_data         where the response data goes
+		 * @param maxNumBytes    the most response data that fits (never more than is left to send)
+		 *
+		 * @return number of bytes copied (0 if the command doesn't have any more response data yet)
+		 */
+		virtual uint32_t exportResponseData(uint8_t* p_data, uint32_t maxNumBytes);
+
+		//! Request data of the fragment being executed
+		uint8_t* mp_requestData;
+		uint32_t m_requestNumBytes;
+
+		//! Request data received so far (including the fragment being executed), and in the whole transfer
+		uint32_t m_requestNumBytesReceived;
+		uint32_t m_requestTotalNumBytes;
+
+		//! Response data sent so far, and in the whole transfer
+		uint32_t m_responseNumBytesSent;
+		uint32_t m_responseTotalNumBytes;
+
+	private:
+		//! The transfer has more fragments to come
+		bool m_transferInProgress;
+};
+
+#endif  // end header guard
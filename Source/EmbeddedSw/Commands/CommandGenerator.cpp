@@ -49,7 +49,15 @@ written permission of Syncroness.
 #include "Logging.hpp"
 
 /* All command classes in the system that are allocated by the CommandGenerator need to be included here */
+#include "CommandDebugPortStats.hpp"
+#include "CommandFragmentLoopback.hpp"
+#include "CommandMemoryRead.hpp"
+#include "CommandMemoryWrite.hpp"
 #include "CommandPing.hpp"
+#include "CommandSetLogThreshold.hpp"
+#include "CommandSoftwareScope.hpp"
+#include "CommandTelemetry.hpp"
+#include "CommandTimeSync.hpp"
 
 
 /*
@@ -82,7 +90,14 @@ static CommandGenerator commandGeneratorSingleton;
  */
 static constexpr size_t debugCommandPoolMaxClassSizeInBytes = max_sizeof<
 		CommandPing,
-		CommandPing
+		CommandSetLogThreshold,
+		CommandTimeSync,
+		CommandFragmentLoopback,
+		CommandMemoryRead,
+		CommandMemoryWrite,
+		CommandDebugPortStats,
+		CommandTelemetry,
+		CommandSoftwareScope
 		>();
 
 //! Number of commands in the debug command pool (be sure to add all pool counts into m_totalNumberOfCommandGeneratorCommands
@@ -145,6 +160,46 @@ CommandBase* CommandGenerator::allocateCommand(commandOpCode_t commandOpCode, bo
 			p_command = generateCommand<CommandPing>(m_debugCommandPool);
 			break;
 		}
+		case commandOpCodeSetLogThreshold:
+		{
+			p_command = generateCommand<CommandSetLogThreshold>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeTimeSync:
+		{
+			p_command = generateCommand<CommandTimeSync>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeFragmentLoopback:
+		{
+			p_command = generateCommand<CommandFragmentLoopback>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeMemoryRead:
+		{
+			p_command = generateCommand<CommandMemoryRead>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeMemoryWrite:
+		{
+			p_command = generateCommand<CommandMemoryWrite>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeDebugPortStats:
+		{
+			p_command = generateCommand<CommandDebugPortStats>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeTelemetry:
+		{
+			p_command = generateCommand<CommandTelemetry>(m_debugCommandPool);
+			break;
+		}
+		case commandOpCodeSoftwareScope:
+		{
+			p_command = generateCommand<CommandSoftwareScope>(m_debugCommandPool);
+			break;
+		}
 		default:
 		{
 			allocatableCommand = false;
@@ -0,0 +1,119 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandDebugPortStats.hpp"
+#include "CommandDebugPortRouter.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandDebugPortStats Methods
+ * See notes in CommandDebugPortStats.hpp for the use model of the command
+ */
+
+bool CommandDebugPortStats::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateGetStats;
+                break;
+            }
+            case commandStateGetStats:
+            {
+                CommandDebugPortRouter::instance().getDebugPortStats(m_response.m_stats);
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandDebugPortStats::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandDebugPortStatsRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the CEF Command's header parameters, update Command Base parameters (the request has nothing else)
+	importFromCefCommandBase(&(p_cef->m_header), (uint32_t)sizeof(cefCommand_t), actualNumBytesReceived);
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandDebugPortStats::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandDebugPortStatsResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the response parameters
+	const uint32_t* p_numReceiveErrors = &m_response.m_stats.numReceiveErrors[0];
+	p_cef->m_numParityErrors = p_numReceiveErrors[errorCode_debugPortErrorCodeParity - errorCode_debugPortErrorCodeNone];
+	p_cef->m_numNoiseErrors = p_numReceiveErrors[errorCode_debugPortErrorCodeNoise - errorCode_debugPortErrorCodeNone];
+	p_cef->m_numFramingErrors = p_numReceiveErrors[errorCode_debugPortErrorCodeFrame - errorCode_debugPortErrorCodeNone];
+	p_cef->m_numOverrunErrors = p_numReceiveErrors[errorCode_debugPortErrorCodeOverrun - errorCode_debugPortErrorCodeNone];
+	p_cef->m_numOtherErrors = p_numReceiveErrors[errorCode_debugPortErrorCodeNone - errorCode_debugPortErrorCodeNone] +
+	        p_numReceiveErrors[errorCode_debugPortErrorCodeUnknown - errorCode_debugPortErrorCodeNone];
+	p_cef->m_numReceiveErrorPacketsDropped = m_response.m_stats.numReceiveErrorPacketsDropped;
+	p_cef->m_numReceiveTimeouts = m_response.m_stats.numReceiveTimeouts;
+	p_cef->m_numTransmitTimeouts = m_response.m_stats.numTransmitTimeouts;
+
+	return errorCode_OK;
+}
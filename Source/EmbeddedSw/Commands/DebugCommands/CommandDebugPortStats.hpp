@@ -0,0 +1,67 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_DEBUG_PORT_STATS_H
+#define __CEF_COMMAND_DEBUG_PORT_STATS_H
+
+
+/**
+ * Interface definition for Debug Port Stats Command
+ *
+ * Reports the debug port error counts: the receive errors the driver reported (parity, noise, framing,
+ * overrun...), the packets dropped because of them, and the receive and transmit timeouts.  The debug port
+ * recovers from these errors on its own, the counts tell how often it had to.
+ */
+
+#include "CommandBase.hpp"
+#include "DebugPortTransportLayer.hpp"
+
+class CommandDebugPortStats : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandDebugPortStats() :
+			CommandBase(commandOpCodeDebugPortStats)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandDebugPortStatsResponse
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandDebugPortStatsResponse() :
+					m_stats()
+					{ }
+
+				debugPortStats_t	m_stats;		//!< debug port error counts when the command executed
+		};
+		CommandDebugPortStatsResponse m_response;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateGetStats = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,86 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandFragmentLoopback.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandFragmentLoopback Methods
+ * See notes in CommandFragmentLoopback.hpp for the use model of the command
+ */
+
+bool CommandFragmentLoopback::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateLoopback;
+                break;
+            }
+            case commandStateLoopback:
+            {
+                // Nothing to process; the fragment's request data is left in place to be sent back in the response
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+errorCode_t CommandFragmentLoopback::startTransfer(void)
+{
+    m_responseTotalNumBytes = m_requestTotalNumBytes;
+    return errorCode_OK;
+}
+
+uint32_t CommandFragmentLoopback::exportResponseData(uint8_t* p_data, uint32_t maxNumBytes)
+{
+    // The response and request totals are the same, so each fragment's request data fits in its response
+    uint32_t numBytes = m_requestNumBytes;
+    if (numBytes > maxNumBytes)
+    {
+        numBytes = maxNumBytes;
+    }
+
+    // The response data goes where the request data is, but move it in case that ever changes
+    memmove(p_data, mp_requestData, numBytes);
+    return numBytes;
+}
@@ -0,0 +1,59 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_FRAGMENT_LOOPBACK_H
+#define __CEF_COMMAND_FRAGMENT_LOOPBACK_H
+
+
+/**
+ * Interface definition for Fragment Loopback Command
+ *
+ * Checks out fragmented commands (see Fragmented Commands in cefContract.hpp) the way Ping checks out commands:
+ * the response data is the request data, sent back a fragment at a time as each fragment is received, so a
+ * transfer of any size only needs the one command buffer.
+ */
+
+#include <string.h>
+
+#include "CommandFragmentedBase.hpp"
+
+class CommandFragmentLoopback : public CommandFragmentedBase
+{
+	public:
+		//! Constructor
+		CommandFragmentLoopback() :
+			CommandFragmentedBase(commandOpCodeFragmentLoopback)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+
+	protected:
+		//! See base class for method description
+		errorCode_t startTransfer(void);
+		uint32_t exportResponseData(uint8_t* p_data, uint32_t maxNumBytes);
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateLoopback = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,126 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandMemoryRead.hpp"
+#include "MemoryReadStream.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandMemoryRead Methods
+ * See notes in CommandMemoryRead.hpp for the use model of the command
+ */
+
+bool CommandMemoryRead::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateStartRead;
+                break;
+            }
+            case commandStateStartRead:
+            {
+                MemoryReadStream::instance().startRead((const uint8_t*)(uintptr_t) m_request.m_address,
+                                                       m_request.m_numBytes, m_request.m_transferId);
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandMemoryRead::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandMemoryReadRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the CEF Command's header parameters, update Command Base parameters
+	importFromCefCommandBase(&(p_cef->m_header), (uint32_t)sizeof(cefCommand_t), actualNumBytesReceived);
+
+	// A read of 0 bytes only ends the read in progress, otherwise the range has to be addressable by the target
+	if ((p_cef->m_numBytes != 0) &&
+	    ((p_cef->m_address > UINTPTR_MAX) || ((UINTPTR_MAX - (uintptr_t) p_cef->m_address) < p_cef->m_numBytes)))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Memory read of {:d} bytes at 0x{:08x}{:08x} is outside the address space",
+		        p_cef->m_numBytes, (uint32_t) (p_cef->m_address >> 32), (uint32_t) p_cef->m_address);
+		return errorCode_CmdMemoryAccessInvalidAddress;
+	}
+
+	// Update the request parameters from the CEF Command request parameters
+	m_request.m_address = p_cef->m_address;
+	m_request.m_numBytes = p_cef->m_numBytes;
+	m_request.m_transferId = p_cef->m_transferId;
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandMemoryRead::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandMemoryReadResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the request parameters the read was started with
+	p_cef->m_numBytes = m_request.m_numBytes;
+	p_cef->m_transferId = m_request.m_transferId;
+
+	return errorCode_OK;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_MEMORY_READ_H
+#define __CEF_COMMAND_MEMORY_READ_H
+
+
+/**
+ * Interface definition for Memory Read Command
+ *
+ * Starts a read of an address range (see Memory Read and Write in cefContract.hpp).  The response only accepts the
+ * read; the data is sent by the MemoryReadStream on the bulk transfer channel after the command is done.
+ */
+
+#include "CommandBase.hpp"
+
+class CommandMemoryRead : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandMemoryRead() :
+			CommandBase(commandOpCodeMemoryRead)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandMemoryReadRequest
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandMemoryReadRequest() :
+					m_address(0),
+					m_numBytes(0),
+					m_transferId(0)
+					{ }
+
+				uint64_t	m_address;			//!< start of the address range to read
+				uint32_t	m_numBytes;			//!< number of bytes to read (0 ends the read in progress)
+				uint32_t	m_transferId;		//!< sent in each bulk data packet of the read
+		};
+		CommandMemoryReadRequest m_request;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateStartRead = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,133 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include <string.h>
+
+#include "CommandMemoryWrite.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandMemoryWrite Methods
+ * See notes in CommandMemoryWrite.hpp for the use model of the command
+ */
+
+bool CommandMemoryWrite::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateWrite;
+                break;
+            }
+            case commandStateWrite:
+            {
+                memcpy((uint8_t*)(uintptr_t) m_request.m_address, m_request.mp_data, m_request.m_numBytes);
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandMemoryWrite::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandMemoryWriteRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	if (p_cef->m_numBytes > CEF_MEMORY_WRITE_MAX_DATA_BYTES)
+	{
+		LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Memory write of {:d} bytes, the most is {:d}",
+		        p_cef->m_numBytes, CEF_MEMORY_WRITE_MAX_DATA_BYTES, 0);
+		return errorCode_CmdMemoryAccessInvalidSize;
+	}
+
+	// The range has to be addressable by the target (and not wrap around the end of its address space)
+	if ((p_cef->m_address > UINTPTR_MAX) || ((UINTPTR_MAX - (uintptr_t) p_cef->m_address) < p_cef->m_numBytes))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Memory write of {:d} bytes at 0x{:08x}{:08x} is outside the address space",
+		        p_cef->m_numBytes, (uint32_t) (p_cef->m_address >> 32), (uint32_t) p_cef->m_address);
+		return errorCode_CmdMemoryAccessInvalidAddress;
+	}
+
+	// From the CEF Command's header parameters, update Command Base parameters (only the data sent is counted)
+	importFromCefCommandBase(&(p_cef->m_header), (uint32_t)CEF_MEMORY_WRITE_HEADERS_NUM_BYTES + p_cef->m_numBytes,
+	                         actualNumBytesReceived);
+
+	// Update the request parameters from the CEF Command request parameters
+	m_request.m_address = p_cef->m_address;
+	m_request.m_numBytes = p_cef->m_numBytes;
+	m_request.mp_data = &p_cef->m_data[0];
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandMemoryWrite::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandMemoryWriteResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the response parameters
+	p_cef->m_numBytes = m_request.m_numBytes;
+	p_cef->m_padding1 = 0;
+
+	return errorCode_OK;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_MEMORY_WRITE_H
+#define __CEF_COMMAND_MEMORY_WRITE_H
+
+
+/**
+ * Interface definition for Memory Write Command
+ *
+ * Writes the request's data to an address (see Memory Read and Write in cefContract.hpp).  The data is copied
+ * straight from the command buffer, so a write of up to CEF_MEMORY_WRITE_MAX_DATA_BYTES needs no memory of its own.
+ */
+
+#include "CommandBase.hpp"
+
+class CommandMemoryWrite : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandMemoryWrite() :
+			CommandBase(commandOpCodeMemoryWrite)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandMemoryWriteRequest
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandMemoryWriteRequest() :
+					m_address(0),
+					m_numBytes(0),
+					mp_data(nullptr)
+					{ }
+
+				uint64_t		m_address;		//!< where to write the data
+				uint32_t		m_numBytes;		//!< number of bytes to write
+				const uint8_t*	mp_data;		//!< the data, in the command buffer
+		};
+		CommandMemoryWriteRequest m_request;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateWrite = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,125 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandSetLogThreshold.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandSetLogThreshold Methods
+ * See notes in CommandSetLogThreshold.hpp for the use model of the command
+ */
+
+bool CommandSetLogThreshold::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateSetThreshold;
+                break;
+            }
+            case commandStateSetThreshold:
+            {
+                m_response.m_moduleId = m_request.m_moduleId;
+                m_response.m_numLogModules = Logging::LogModuleIdNumModules;
+                m_commandErrorCode = Logging::instance().setLogThreshold(m_request.m_moduleId, m_request.m_logThreshold,
+                                                                         m_response.m_previousLogThreshold);
+
+                // Logged after the change so it is visible whenever the new threshold allows info logs
+                LOG_INFO(Logging::LogModuleIdCefDebugCommands, "Log threshold of module 0x{:X} set to {:d}, errorCode={:d}",
+                        m_request.m_moduleId, m_request.m_logThreshold, m_commandErrorCode);
+
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandSetLogThreshold::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandSetLogThresholdRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the CEF Command's header parameters, update Command Base parameters
+	importFromCefCommandBase(&(p_cef->m_header), (uint32_t)sizeof(cefCommand_t), actualNumBytesReceived);
+
+	// Update the request parameters from the CEF Command request parameters
+	m_request.m_moduleId = p_cef->m_moduleId;
+	m_request.m_logThreshold = p_cef->m_logThreshold;
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandSetLogThreshold::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandSetLogThresholdResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the response parameters
+	p_cef->m_moduleId = m_response.m_moduleId;
+	p_cef->m_previousLogThreshold = m_response.m_previousLogThreshold;
+	p_cef->m_numLogModules = m_response.m_numLogModules;
+	p_cef->m_padding1 = 0;
+	p_cef->m_padding2 = 0;
+
+	return errorCode_OK;
+}
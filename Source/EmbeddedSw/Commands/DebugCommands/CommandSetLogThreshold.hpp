@@ -0,0 +1,85 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_SET_LOG_THRESHOLD_H
+#define __CEF_COMMAND_SET_LOG_THRESHOLD_H
+
+
+/**
+ * Interface definition for Set Log Threshold Command
+ *
+ * Changes the run time logging threshold of a logging module (or of all logging modules).  Logs below
+ * the threshold are discarded before a log buffer is allocated, which reduces debug port bandwidth
+ * and log pool churn.  The threshold can be lowered again when more verbose logging is needed.
+ * Log statements below LOG_COMPILE_TIME_LEVEL_FLOOR are compiled out and cannot be enabled with this command.
+ */
+
+#include "CommandBase.hpp"
+
+class CommandSetLogThreshold : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandSetLogThreshold() :
+			CommandBase(commandOpCodeSetLogThreshold)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandSetLogThresholdRequest
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandSetLogThresholdRequest() :
+					m_moduleId(LOGGING_MODULE_ID_ALL_MODULES),
+					m_logThreshold(logTypeDebug)
+					{ }
+
+				uint8_t		m_moduleId;			//!< logging module to change, or LOGGING_MODULE_ID_ALL_MODULES
+				uint8_t		m_logThreshold;		//!< logs of this logType_t and above are sent
+		};
+		CommandSetLogThresholdRequest m_request;
+
+		class CommandSetLogThresholdResponse
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandSetLogThresholdResponse() :
+					m_moduleId(LOGGING_MODULE_ID_ALL_MODULES),
+					m_previousLogThreshold(logTypeDebug),
+					m_numLogModules(0)
+					{ }
+
+				uint8_t		m_moduleId;				//!< logging module that was changed (echo of the request)
+				uint8_t		m_previousLogThreshold;	//!< threshold before the change
+				uint8_t		m_numLogModules;		//!< number of logging modules in the embedded software
+		};
+		CommandSetLogThresholdResponse m_response;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateSetThreshold = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,183 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandSoftwareScope.hpp"
+#include "TelemetryStream.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandSoftwareScope Methods
+ * See notes in CommandSoftwareScope.hpp for the use model of the command
+ */
+
+bool CommandSoftwareScope::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateAddEntries;
+                break;
+            }
+            case commandStateAddEntries:
+            {
+                TelemetryStream& telemetryStream = TelemetryStream::instance();
+
+                m_commandErrorCode = checkEntries();
+                if (m_commandErrorCode == errorCode_OK)
+                {
+                    if (m_request.m_replace == true)
+                    {
+                        telemetryStream.removeAddressChannels();
+                    }
+                    for (uint32_t entryIndex = 0; entryIndex < m_request.m_numEntries; ++entryIndex)
+                    {
+                        const cefSoftwareScopeEntry_t* p_entry = &m_request.mp_entries[entryIndex];
+                        telemetryStream.registerAddressChannel(p_entry->m_name, p_entry->m_address,
+                                                               (telemetryType_t) p_entry->m_type, p_entry->m_decimation);
+                    }
+                }
+
+                m_response.m_numChannels = telemetryStream.getNumChannels();
+                m_response.m_numAddressChannels = telemetryStream.getNumAddressChannels();
+                m_response.m_configurationNumber = telemetryStream.getConfigurationNumber();
+
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandSoftwareScope::checkEntries(void)
+{
+	TelemetryStream& telemetryStream = TelemetryStream::instance();
+
+	uint32_t numAddressChannels = m_request.m_numEntries;
+	uint32_t numChannels = telemetryStream.getNumChannels() + m_request.m_numEntries;
+	if (m_request.m_replace == false)
+	{
+		numAddressChannels += telemetryStream.getNumAddressChannels();
+	}
+	else
+	{
+		numChannels -= telemetryStream.getNumAddressChannels();
+	}
+	if ((numAddressChannels > TELEMETRY_MAX_NUM_ADDRESS_CHANNELS) || (numChannels > TELEMETRY_MAX_NUM_CHANNELS))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Software scope of {:d} entries does not fit, {:d} channels",
+		        m_request.m_numEntries, telemetryStream.getNumChannels(), 0);
+		return errorCode_CmdSoftwareScopeInvalidEntry;
+	}
+
+	for (uint32_t entryIndex = 0; entryIndex < m_request.m_numEntries; ++entryIndex)
+	{
+		const cefSoftwareScopeEntry_t* p_entry = &m_request.mp_entries[entryIndex];
+		if (TelemetryStream::isAddressChannelValid(p_entry->m_address, (telemetryType_t) p_entry->m_type) == false)
+		{
+			LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Software scope entry {:d} at 0x{:X} of type {:d} can't be sampled",
+			        entryIndex, p_entry->m_address, p_entry->m_type);
+			return errorCode_CmdSoftwareScopeInvalidEntry;
+		}
+	}
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandSoftwareScope::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandSoftwareScopeRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	if (p_cef->m_numEntries > TELEMETRY_MAX_NUM_ADDRESS_CHANNELS)
+	{
+		LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Software scope of {:d} entries, the most is {:d}",
+		        p_cef->m_numEntries, TELEMETRY_MAX_NUM_ADDRESS_CHANNELS, 0);
+		return errorCode_CmdSoftwareScopeInvalidEntry;
+	}
+
+	// From the CEF Command's header parameters, update Command Base parameters (only the entries sent are counted)
+	importFromCefCommandBase(&(p_cef->m_header),
+	                         (uint32_t)(CEF_SOFTWARE_SCOPE_HEADERS_NUM_BYTES + (p_cef->m_numEntries * sizeof(cefSoftwareScopeEntry_t))),
+	                         actualNumBytesReceived);
+
+	// Update the request parameters from the CEF Command request parameters
+	m_request.m_numEntries = p_cef->m_numEntries;
+	m_request.m_replace = (p_cef->m_replace != 0);
+	m_request.mp_entries = &p_cef->m_entries[0];
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandSoftwareScope::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandSoftwareScopeResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the response parameters
+	p_cef->m_numChannels = m_response.m_numChannels;
+	p_cef->m_numAddressChannels = m_response.m_numAddressChannels;
+	p_cef->m_configurationNumber = m_response.m_configurationNumber;
+	p_cef->m_padding1 = 0;
+
+	return errorCode_OK;
+}
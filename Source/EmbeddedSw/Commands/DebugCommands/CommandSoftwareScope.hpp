@@ -0,0 +1,93 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_SOFTWARE_SCOPE_H
+#define __CEF_COMMAND_SOFTWARE_SCOPE_H
+
+
+/**
+ * Interface definition for Software Scope Command
+ *
+ * Adds a sampling list from Python (addresses and types of variables, read from the ELF file) to the telemetry
+ * channels as address channels (see Software Scope in cefContract.hpp).  The entries are read straight from the
+ * command buffer.  Either every entry is added, or none is.
+ */
+
+#include "CommandBase.hpp"
+
+class CommandSoftwareScope : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandSoftwareScope() :
+			CommandBase(commandOpCodeSoftwareScope)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandSoftwareScopeRequest
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandSoftwareScopeRequest() :
+					m_numEntries(0),
+					m_replace(false),
+					mp_entries(nullptr)
+					{ }
+
+				uint32_t						m_numEntries;	//!< number of entries in the sampling list
+				bool							m_replace;		//!< true to remove the address channels added before
+				const cefSoftwareScopeEntry_t*	mp_entries;		//!< the sampling list, in the command buffer
+		};
+		CommandSoftwareScopeRequest m_request;
+
+		class CommandSoftwareScopeResponse
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandSoftwareScopeResponse() :
+					m_numChannels(0),
+					m_numAddressChannels(0),
+					m_configurationNumber(0)
+					{ }
+
+				uint16_t	m_numChannels;			//!< number of telemetry channels, including the address channels
+				uint16_t	m_numAddressChannels;	//!< number of address channels
+				uint16_t	m_configurationNumber;	//!< configuration number of the frames sent from now on
+		};
+		CommandSoftwareScopeResponse m_response;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateAddEntries = commandStateFirstDerivedState,
+        };
+
+        /**
+         * Checks the whole sampling list fits and can be sampled, before any of it is added
+         *
+         * @return errorCode_CmdSoftwareScopeInvalidEntry if it can't be added
+         */
+        errorCode_t checkEntries(void);
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,153 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include <string.h>
+
+#include "CommandTelemetry.hpp"
+#include "TelemetryStream.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of CommandTelemetry Methods
+ * See notes in CommandTelemetry.hpp for the use model of the command
+ */
+
+bool CommandTelemetry::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateConfigureTelemetry;
+                break;
+            }
+            case commandStateConfigureTelemetry:
+            {
+                TelemetryStream& telemetryStream = TelemetryStream::instance();
+
+                if (m_request.m_decimation != TELEMETRY_DECIMATION_UNCHANGED)
+                {
+                    m_commandErrorCode = telemetryStream.setChannelDecimation(m_request.m_channelIndex, m_request.m_decimation);
+                }
+                if ((m_commandErrorCode == errorCode_OK) && (m_request.m_control != telemetryControl_none))
+                {
+                    telemetryStream.setStreaming(m_request.m_control == telemetryControl_start);
+                }
+
+                // A channel that doesn't exist is only an error when it was to be changed, so Python can read the
+                // number of channels before it knows it
+                m_response.m_channelIndex = m_request.m_channelIndex;
+                if (telemetryStream.getChannel(m_request.m_channelIndex, m_response.mp_name, m_response.m_type,
+                                               m_response.m_decimation) == false)
+                {
+                    m_response.mp_name = nullptr;
+                }
+                m_response.m_numChannels = telemetryStream.getNumChannels();
+                m_response.m_streaming = telemetryStream.isStreaming();
+                m_response.m_configurationNumber = telemetryStream.getConfigurationNumber();
+
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandTelemetry::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandTelemetryRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the CEF Command's header parameters, update Command Base parameters
+	importFromCefCommandBase(&(p_cef->m_header), (uint32_t)sizeof(cefCommand_t), actualNumBytesReceived);
+
+	// Update the request parameters from the CEF Command request parameters
+	m_request.m_channelIndex = p_cef->m_channelIndex;
+	m_request.m_decimation = p_cef->m_decimation;
+	m_request.m_control = p_cef->m_control;
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandTelemetry::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandTelemetryResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the response parameters
+	p_cef->m_numChannels = m_response.m_numChannels;
+	p_cef->m_channelIndex = m_response.m_channelIndex;
+	p_cef->m_decimation = m_response.m_decimation;
+	p_cef->m_type = m_response.m_type;
+	p_cef->m_streaming = (m_response.m_streaming == true) ? 1 : 0;
+	p_cef->m_configurationNumber = m_response.m_configurationNumber;
+	p_cef->m_padding1 = 0;
+	p_cef->m_padding2 = 0;
+
+	// The name is always terminated, and the rest of it cleared so nothing else leaks into the response
+	memset(p_cef->m_name, 0, sizeof(p_cef->m_name));
+	if (m_response.mp_name != nullptr)
+	{
+		strncpy(p_cef->m_name, m_response.mp_name, sizeof(p_cef->m_name) - 1);
+	}
+
+	return errorCode_OK;
+}
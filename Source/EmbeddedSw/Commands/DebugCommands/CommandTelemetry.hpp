@@ -0,0 +1,94 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_TELEMETRY_H
+#define __CEF_COMMAND_TELEMETRY_H
+
+
+/**
+ * Interface definition for Telemetry Command
+ *
+ * Reads the registration of a telemetry channel (name, type and decimation), and optionally changes the channel's
+ * decimation and starts or stops the telemetry stream (see Telemetry in cefContract.hpp).  Python reads every
+ * channel with this command before starting the stream, so it can decode the telemetry frames.
+ */
+
+#include "CommandBase.hpp"
+
+class CommandTelemetry : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandTelemetry() :
+			CommandBase(commandOpCodeTelemetry)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandTelemetryRequest
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandTelemetryRequest() :
+					m_channelIndex(0),
+					m_decimation(TELEMETRY_DECIMATION_UNCHANGED),
+					m_control(telemetryControl_none)
+					{ }
+
+				uint16_t	m_channelIndex;		//!< channel to read (and change)
+				uint16_t	m_decimation;		//!< new decimation of the channel, or TELEMETRY_DECIMATION_UNCHANGED
+				uint8_t		m_control;			//!< telemetryControl_t
+		};
+		CommandTelemetryRequest m_request;
+
+		class CommandTelemetryResponse
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandTelemetryResponse() :
+					mp_name(nullptr),
+					m_numChannels(0),
+					m_channelIndex(0),
+					m_decimation(0),
+					m_type(telemetryType_numTypes),
+					m_streaming(false),
+					m_configurationNumber(0)
+					{ }
+
+				const char*	mp_name;				//!< name of the channel, nullptr if there is no such channel
+				uint16_t	m_numChannels;			//!< number of registered channels
+				uint16_t	m_channelIndex;			//!< echo of the request
+				uint16_t	m_decimation;			//!< decimation of the channel (after the change), 0 if off
+				telemetryType_t	m_type;				//!< type of the channel
+				bool		m_streaming;			//!< true if the stream is started (after the change)
+				uint16_t	m_configurationNumber;	//!< configuration number of the frames sent from now on
+		};
+		CommandTelemetryResponse m_response;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateConfigureTelemetry = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
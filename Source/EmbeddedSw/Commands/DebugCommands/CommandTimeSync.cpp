@@ -0,0 +1,122 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include "CommandTimeSync.hpp"
+#include "Logging.hpp"
+#include "ShimBase.hpp"
+
+/**
+ * Implementation of CommandTimeSync Methods
+ * See notes in CommandTimeSync.hpp for the use model of the command
+ */
+
+bool CommandTimeSync::execute(CommandBase* p_childCommand)
+{
+    bool commandDone = false;
+    bool shouldYield = false;
+
+    validateNullChildResponse(p_childCommand);
+
+    while (shouldYield == false)
+    {
+        switch (m_commandState)
+        {
+            case commandStateCommandEntry:
+            {
+                m_commandState = commandStateTimeSync;
+                break;
+            }
+            case commandStateTimeSync:
+            {
+                // The time stamps are taken on import/export; a log here would only add to the link traffic being timed
+                m_response.m_hostTransmitTimeNs = m_request.m_hostTransmitTimeNs;
+                m_commandState = commandStateCommandComplete;
+                break;
+            }
+            case commandStateCommandComplete:
+            {
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+            default:
+            {
+                // If we get here, we've lost our mind.
+                LOG_FATAL(Logging::LogModuleIdCefDebugCommands, "Unhandled command state {:d}",
+                        m_commandState, 0, 0);
+                shouldYield = true;
+                commandDone = true;
+                break;
+            }
+        }
+    }
+
+    return commandDone;
+}
+
+
+errorCode_t CommandTimeSync::importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived)
+{
+	// Time stamp first, as close to reception of the request as the command can get
+	uint64_t receiveTimeNs = ShimBase::getInstance().getTimeNs();
+
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandTimeSyncRequest_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "p_cefCommand is a nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the CEF Command's header parameters, update Command Base parameters
+	importFromCefCommandBase(&(p_cef->m_header), (uint32_t)sizeof(cefCommand_t), actualNumBytesReceived);
+
+	// Update the request parameters from the CEF Command request parameters
+	m_request.m_hostTransmitTimeNs = p_cef->m_hostTransmitTimeNs;
+	m_response.m_targetReceiveTimeNs = receiveTimeNs;
+
+	return errorCode_OK;
+}
+
+
+errorCode_t CommandTimeSync::exportToCefCommand(void* p_cefCommand)
+{
+	// Help avoid cut/paste errors by only having one place the actual command type is defined for the import function
+	typedef cefCommandTimeSyncResponse_t cefCommand_t;
+
+	if (p_cefCommand == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "exportToCefCommand called with nullptr", 0, 0, 0);
+		return errorCode_PointerIsNullptr;
+	}
+
+	cefCommand_t* p_cef = (cefCommand_t*)p_cefCommand;
+
+	// From the Command Base, update the CEF Command's header parameters
+	exportToCefCommandBase(&(p_cef->m_header), sizeof(cefCommand_t));
+
+	// Update the CEF Command response parameters from the response parameters
+	p_cef->m_hostTransmitTimeNs = m_response.m_hostTransmitTimeNs;
+	p_cef->m_targetReceiveTimeNs = m_response.m_targetReceiveTimeNs;
+
+	// Time stamp last, as close to transmission of the response as the command can get
+	p_cef->m_targetTransmitTimeNs = ShimBase::getInstance().getTimeNs();
+
+	return errorCode_OK;
+}
@@ -0,0 +1,81 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_COMMAND_TIME_SYNC_H
+#define __CEF_COMMAND_TIME_SYNC_H
+
+
+/**
+ * Interface definition for Time Sync Command
+ *
+ * Lets Python correlate target time stamps (logs, responses) with host time.  The target receive time is taken when
+ * the request is imported and the target transmit time when the response is exported, so the time the command
+ * waits to execute is excluded from the round trip time Python measures.  See cefCommandTimeSyncRequest_t
+ * for the calculations.
+ */
+
+#include "CommandBase.hpp"
+
+class CommandTimeSync : public CommandBase
+{
+	public:
+		//! Constructor
+		CommandTimeSync() :
+			CommandBase(commandOpCodeTimeSync)
+			{ }
+
+		//! See base class for method description
+		bool execute(CommandBase* p_parentCommand);
+        errorCode_t importFromCefCommand(void* p_cefCommand, uint32_t actualNumBytesReceived);
+        errorCode_t exportToCefCommand(void* p_cefCommand);
+
+		class CommandTimeSyncRequest
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandTimeSyncRequest() :
+					m_hostTransmitTimeNs(0)
+					{ }
+
+				uint64_t	m_hostTransmitTimeNs;		//!< host time the request was sent (opaque to the target)
+		};
+		CommandTimeSyncRequest m_request;
+
+		class CommandTimeSyncResponse
+		{
+			public:
+				//! Constructor.  Set all member values to an initial value to avoid errors and aid debug
+				CommandTimeSyncResponse() :
+					m_hostTransmitTimeNs(0),
+					m_targetReceiveTimeNs(0)
+					{ }
+
+				uint64_t	m_hostTransmitTimeNs;		//!< echo of the request's host transmit time
+				uint64_t	m_targetReceiveTimeNs;		//!< target time the request was imported
+		};
+		CommandTimeSyncResponse m_response;
+
+	private:
+
+        // Command states
+        enum
+        {
+            commandStateTimeSync = commandStateFirstDerivedState,
+        };
+
+};
+
+#endif  // end header guard
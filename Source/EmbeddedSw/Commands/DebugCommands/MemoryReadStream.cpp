@@ -0,0 +1,81 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include <string.h>
+
+#include "MemoryReadStream.hpp"
+#include "CommandDebugPortRouter.hpp"
+#include "Logging.hpp"
+#include "EventQueue.hpp"
+
+/**
+ * Implementation of MemoryReadStream Methods
+ * See notes in MemoryReadStream.hpp for the use model of the class
+ */
+
+//! Singleton instantiation of MemoryReadStream
+static MemoryReadStream memoryReadStreamSingleton;
+
+MemoryReadStream& MemoryReadStream::instance()
+{
+	return memoryReadStreamSingleton;
+}
+
+void MemoryReadStream::startRead(const uint8_t* p_address, uint32_t numBytes, uint32_t transferId)
+{
+	// Packets are built by the router from the same thread, so the cursor can't change while a packet is built
+	mp_address = p_address;
+	m_numBytes = numBytes;
+	m_numBytesSent = 0;
+	m_transferId = transferId;
+
+	CommandDebugPortRouter::instance().registerChannelSource(debugPortChannel_bulkTransfer, this);
+}
+
+bool MemoryReadStream::hasDataToSend(void)
+{
+	return (m_numBytesSent < m_numBytes);
+}
+
+uint32_t MemoryReadStream::fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType)
+{
+	if ((hasDataToSend() == false) || (maxNumBytes <= sizeof(cefBulkDataHeader_t)))
+	{
+		return 0;
+	}
+
+	uint32_t numBytes = MIN(m_numBytes - m_numBytesSent, maxNumBytes - (uint32_t) sizeof(cefBulkDataHeader_t));
+
+	cefBulkDataHeader_t header;
+	header.m_transferId = m_transferId;
+	header.m_offset = m_numBytesSent;
+	memcpy(p_payload, &header, sizeof(header));
+	memcpy(p_payload + sizeof(header), mp_address + m_numBytesSent, numBytes);
+
+	m_numBytesSent += numBytes;
+	debugDataType = debugPacketType_bulkData;
+
+	// Python is told the read is done, rather than polling for it
+	if (m_numBytesSent == m_numBytes)
+	{
+		cefEventMemoryReadDone_t readDone;
+		readDone.m_transferId = m_transferId;
+		readDone.m_numBytes = m_numBytes;
+		EventQueue::instance().raiseEvent(eventId_memoryReadDone, &readDone, sizeof(readDone));
+	}
+
+	return (uint32_t) sizeof(cefBulkDataHeader_t) + numBytes;
+}
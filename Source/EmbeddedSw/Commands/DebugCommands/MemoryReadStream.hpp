@@ -0,0 +1,74 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_MEMORY_READ_STREAM_H
+#define __CEF_MEMORY_READ_STREAM_H
+
+
+/**
+ * Interface definition for the Memory Read Stream
+ *
+ * The source of the bulk transfer channel (see Memory Read and Write in cefContract.hpp).  CommandMemoryRead starts
+ * a read, and the stream then sends the address range from a cursor, a debugPacketType_bulkData packet each time
+ * the channel scheduler gives the bulk transfer channel a turn.  So the debug port transmit queue is kept full
+ * without a command round trip per packet.
+ */
+
+#include "cefContract.hpp"
+#include "DebugPortChannelSource.hpp"
+
+class MemoryReadStream : public DebugPortChannelSource
+{
+	public:
+		//! Constructor
+		MemoryReadStream() :
+			mp_address(nullptr),
+			m_numBytes(0),
+			m_numBytesSent(0),
+			m_transferId(0)
+			{ }
+
+		/**
+		 *  Obtain a reference to the Instance of this Singleton
+		 *
+		 *  @return a reference to the Instance of this Singleton
+		 */
+		static MemoryReadStream& instance();
+
+		/**
+		 * Starts sending an address range on the bulk transfer channel, which ends any read in progress
+		 *
+		 * @param p_address    start of the address range
+		 * @param numBytes     number of bytes to send (0 only ends the read in progress)
+		 * @param transferId   sent in each packet, so Python can tell the packets of this read from an earlier one
+		 */
+		void startRead(const uint8_t* p_address, uint32_t numBytes, uint32_t transferId);
+
+		//! See base class for method description
+		bool hasDataToSend(void);
+		uint32_t fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType);
+
+	private:
+		//! Address range being read, and the cursor (number of bytes sent)
+		const uint8_t* mp_address;
+		uint32_t m_numBytes;
+		uint32_t m_numBytesSent;
+
+		//! Transfer id of the read in progress
+		uint32_t m_transferId;
+};
+
+#endif  // end header guard
@@ -88,8 +88,17 @@ bool CommandCefCommandProxy::execute(CommandBase *p_childCommand)
 
         case commandStateProcessCommand:
         {
-            bool allocatableCommand = false;
-            mp_childCommand = CommandGenerator::instance().allocateCommand(mp_cefCommandHeader->m_commandOpCode, allocatableCommand);
+            bool allocatableCommand = true;
+            if ((mp_fragmentedCommand != nullptr) &&
+                (mp_fragmentedCommand->getCommandOpCode() == mp_cefCommandHeader->m_commandOpCode))
+            {
+                // The next fragment of a transfer in progress; the command it belongs to is still allocated
+                mp_childCommand = mp_fragmentedCommand;
+            }
+            else
+            {
+                mp_childCommand = CommandGenerator::instance().allocateCommand(mp_cefCommandHeader->m_commandOpCode, allocatableCommand);
+            }
 
             // Was the command allocatable?  If not, need to return an error as not setup correctly to allocate the command
             if (allocatableCommand == false)
@@ -99,6 +108,16 @@ bool CommandCefCommandProxy::execute(CommandBase *p_childCommand)
                 break;
             }
 
+            if ((mp_childCommand == nullptr) && (mp_fragmentedCommand != nullptr))
+            {
+                // The fragmented command may be holding the memory this command needs; a host that abandoned
+                // the transfer is not coming back for it, so end the transfer rather than waiting forever
+                LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "Fragmented transfer of OpCode={:d} abandoned for OpCode={:d}",
+                        mp_fragmentedCommand->getCommandOpCode(), mp_cefCommandHeader->m_commandOpCode, 0);
+                CommandGenerator::instance().freeCommand(mp_fragmentedCommand);
+                mp_fragmentedCommand = nullptr;
+            }
+
             if (mp_childCommand == nullptr)
             {
                 // Exit and try again later
@@ -174,10 +193,27 @@ bool CommandCefCommandProxy::execute(CommandBase *p_childCommand)
 
         case commandStateSendAndReleaseResources:
         {
-            // We are all done with the child command (if there was one issued) so release it
+            // We are all done with the child command (if there was one issued) so release it, unless it
+            // is a fragmented command that expects more fragments
             if (mp_childCommand != nullptr)
             {
-                CommandGenerator::instance().freeCommand(mp_childCommand);
+                if (mp_childCommand->isTransferInProgress() == true)
+                {
+                    if ((mp_fragmentedCommand != nullptr) && (mp_fragmentedCommand != mp_childCommand))
+                    {
+                        // Only one transfer is kept at a time; the older one was abandoned by the host
+                        CommandGenerator::instance().freeCommand(mp_fragmentedCommand);
+                    }
+                    mp_fragmentedCommand = mp_childCommand;
+                }
+                else
+                {
+                    if (mp_fragmentedCommand == mp_childCommand)
+                    {
+                        mp_fragmentedCommand = nullptr;
+                    }
+                    CommandGenerator::instance().freeCommand(mp_childCommand);
+                }
                 // Must set child command to nullptr or else validateChildResponse() will fail.
                 mp_childCommand = nullptr;
             }
@@ -31,7 +31,8 @@ public:
      * Constructor
      */
     CommandCefCommandProxy() :
-            CommandBase(commandOpCodeCefCommandProxy), mp_cefCommandHeader(nullptr), mp_childCommand(nullptr)
+            CommandBase(commandOpCodeCefCommandProxy), mp_cefCommandHeader(nullptr), mp_childCommand(nullptr),
+            mp_fragmentedCommand(nullptr)
             { }
 
     /**
@@ -70,6 +71,10 @@ private:
     //! This is a child command so once it finished executing it returns to this object
     CommandBase *mp_childCommand;
 
+    //! A fragmented command kept between CEF commands while its transfer is in progress (see isTransferInProgress())
+    //! so the next fragment goes to the same command
+    CommandBase *mp_fragmentedCommand;
+
 };
 
 #endif  // end header guard
@@ -15,10 +15,12 @@
  ****************************************************************** */
 
 #include <new>      // for placement new
+#include <string.h>
 
 #include "CommandDebugPortRouter.hpp"
 #include "Logging.hpp"
 #include "AppMain.hpp"
+#include "ShimBase.hpp"
 
 /**
  * Implementation of CommandDebugPortRouterRouter Methods
@@ -29,6 +31,8 @@
  * 		Then the log is "returned" via checkinLogBufferLogging(), and added to a queue to transmit
  * 		checkoutLogTransmitBuffer() returns a pointer of the next log to transmit
  * 		Once the transmit has been completed, the buffer is returned via checkinLogTransmitBuffer()
+ * 		With DEBUG_PORT_BATCHING, logs are copied into the transmit payload (with any command response) and returned
+ * 			via checkinLogTransmitBuffer() right away
  *
  * CEF Proxy Command
  * 		There is one buffer that is used for CEF Proxy Commands.
@@ -43,21 +47,46 @@
  */
 static const uint32_t maxNumLoggingPackets = 10;
 
+/**
+ * Number of the logging packets that only error and fatal logs can use, so that a burst of lower severity
+ * logs always leaves room for the errors (and fatal) that explain what happened
+ */
+static const uint32_t numReservedErrorLoggingPackets = 3;
+
 //! Singleton instantiation of CommandDebugPortRouter
 static CommandDebugPortRouter commandDebugPortRouterSingleton(BufferPoolBase::BufferPoolId_Logging, sizeof(cefLog_t),
-            maxNumLoggingPackets);
+            maxNumLoggingPackets, numReservedErrorLoggingPackets);
 
-CommandDebugPortRouter::CommandDebugPortRouter(uint32_t logBufferPoolId, uint32_t numBytesPerLogEntry, uint32_t maxNumLogEntries) :
+CommandDebugPortRouter::CommandDebugPortRouter(uint32_t logBufferPoolId, uint32_t numBytesPerLogEntry, uint32_t maxNumLogEntries,
+                                               uint32_t numReservedErrorLogEntries) :
         CommandBase(commandOpCodeDebugPortRouter),
         m_logPool(logBufferPoolId, numBytesPerLogEntry, maxNumLogEntries),
-        m_logsToSend(maxNumLogEntries),
+        // Any queue may have to hold every log, so each queue is sized for all the log entries
+        m_logsToSend{maxNumLogEntries, maxNumLogEntries, maxNumLogEntries, maxNumLogEntries, maxNumLogEntries},
+        m_numReservedErrorLogEntries(numReservedErrorLogEntries),
+        m_numDroppedLogs{0},
+        m_droppedLogsSummaryPending(false),
         m_cefCommandBuffer(&m_cefCommand, sizeof(m_cefCommand)),
-        m_cefLogBufferTransmit(nullptr, 0),
-        mp_cefBufferTransmit(nullptr),
+        m_cefBufferTransmit{{nullptr, 0}, {nullptr, 0}},
+        m_nextTransmitBufferIndex(0),
+        m_logLingerActive(false),
+        m_logLingerStartTickMs(0),
+        mp_channelSources{nullptr},
+        m_numTransmitBuffersCheckedOut(0),
         m_cefCommandBufferState(cefCommandBufferState_bufferAvailable),
+        m_numCommandBuffersFreed(0),
+        m_advertisedFlowControlCredits(0),
         m_fatalErrorHandling(false),
         m_executeActive(false)
 {
+    STATIC_ASSERT(m_numLogQueues == 5, m_logsToSend_initializer_must_match_number_of_log_types);
+    STATIC_ASSERT(m_numTransmitBuffers == 2, m_cefBufferTransmit_initializer_must_match_number_of_transmit_buffers);
+
+    if (m_numReservedErrorLogEntries >= maxNumLogEntries)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Reserved error logs={:d} must be less than the number of logs={:d}",
+                m_numReservedErrorLogEntries, maxNumLogEntries, 0);
+    }
 }
 
 CommandDebugPortRouter& CommandDebugPortRouter::instance()
@@ -85,9 +114,13 @@ bool CommandDebugPortRouter::execute(CommandBase *p_childCommand)
         }
         case commandStateExecuteTransportFunctions:
         {
-            // Only execute the receive if not in fatal handling mode
+            // Only execute the receive (and add log summaries) if not in fatal handling mode
             if (m_fatalErrorHandling == false)
             {
+                if (m_droppedLogsSummaryPending == true)
+                {
+                    logDroppedLogsSummary();
+                }
                 m_debugTransportLayer.receiveStateMachine();
             }
 
@@ -114,8 +147,14 @@ bool CommandDebugPortRouter::execute(CommandBase *p_childCommand)
     return commandDone;
 }
 
-cefLog_t* CommandDebugPortRouter::checkoutLogBufferLogging()
+cefLog_t* CommandDebugPortRouter::checkoutLogBufferLogging(logType_t logType)
 {
+    // Lower severity logs can't use the reserved log entries
+    if ((logType < logTypeError) && (m_logPool.getNumFreeBuffers() <= m_numReservedErrorLogEntries))
+    {
+        return nullptr;
+    }
+
     cefLog_t *p_cefLog = (cefLog_t*) m_logPool.allocate(sizeof(cefLog_t));
 
     if (p_cefLog == nullptr)
@@ -136,8 +175,9 @@ void CommandDebugPortRouter::checkinLogBufferLogging(cefLog_t *p_cefLog)
     }
 
     // The p_cefLog is assumed to have valid logging data, and now is ready to be transmitted, so add
-    // it to the log to send fifo.
-    if (m_logsToSend.put(p_cefLog) == false)
+    // it to the log to send fifo for its log type.
+    uint32_t logQueueIndex = MIN(p_cefLog->m_logType, m_numLogQueues - 1);
+    if (m_logsToSend[logQueueIndex].put(p_cefLog) == false)
     {
         // Something is messed up in the system setup as there should be room to send all logs we have buffer space for
         LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "m_logsToSend not setup correctly in CommandDebugPortRouter",
@@ -145,11 +185,37 @@ void CommandDebugPortRouter::checkinLogBufferLogging(cefLog_t *p_cefLog)
     }
 }
 
+uint32_t CommandDebugPortRouter::findOldestLogQueue()
+{
+    // Each queue is in sequence number order, so the oldest log is at the front of one of the queues
+    uint32_t oldestLogQueueIndex = m_numLogQueues;
+    uint16_t oldestLogSequenceNumber = 0;
+
+    for (uint32_t i = 0; i < m_numLogQueues; ++i)
+    {
+        void *p_log = nullptr;
+        if (m_logsToSend[i].peek(p_log) == true)
+        {
+            uint16_t logSequenceNumber = ((cefLog_t*) p_log)->m_logSequenceNumber;
+
+            // Sequence numbers roll over, so compare the signed difference
+            if ((oldestLogQueueIndex == m_numLogQueues) || ((int16_t) (logSequenceNumber - oldestLogSequenceNumber) < 0))
+            {
+                oldestLogQueueIndex = i;
+                oldestLogSequenceNumber = logSequenceNumber;
+            }
+        }
+    }
+
+    return oldestLogQueueIndex;
+}
+
 cefLog_t* CommandDebugPortRouter::checkoutLogTransmitBuffer()
 {
+    uint32_t oldestLogQueueIndex = findOldestLogQueue();
     void *p_cefLog = nullptr;
 
-    if (m_logsToSend.get(p_cefLog) == false)
+    if ((oldestLogQueueIndex == m_numLogQueues) || (m_logsToSend[oldestLogQueueIndex].get(p_cefLog) == false))
     {
         // No logs to send
         return nullptr;
@@ -158,10 +224,204 @@ cefLog_t* CommandDebugPortRouter::checkoutLogTransmitBuffer()
     return (cefLog_t*) p_cefLog;
 }
 
+uint32_t CommandDebugPortRouter::packLogs(uint8_t* p_destination, uint32_t maxNumBytes)
+{
+    m_logPacker.startPacket(p_destination, maxNumBytes);
+
+    uint32_t oldestLogQueueIndex = findOldestLogQueue();
+    while (oldestLogQueueIndex != m_numLogQueues)
+    {
+        void *p_cefLog = nullptr;
+        m_logsToSend[oldestLogQueueIndex].peek(p_cefLog);
+
+        if (m_logPacker.packLog((cefLog_t*) p_cefLog) == false)
+        {
+            // Packet is full; the log will go in the next packet
+            break;
+        }
+
+        // The log has been copied into the packet, so return it to the pool now
+        m_logsToSend[oldestLogQueueIndex].get(p_cefLog);
+        checkinLogTransmitBuffer((cefLog_t*) p_cefLog);
+
+        oldestLogQueueIndex = findOldestLogQueue();
+    }
+
+    return m_logPacker.getNumBytes();
+}
+
+CefBuffer* CommandDebugPortRouter::checkoutPackedLogTransmitBuffer()
+{
+    uint8_t* p_transmitPayload = m_transmitPayload[m_nextTransmitBufferIndex];
+    uint32_t numBytes = packLogs(p_transmitPayload, sizeof(m_transmitPayload[0]));
+    if (numBytes == 0)
+    {
+        return nullptr;
+    }
+
+    CefBuffer* p_cefBuffer = (CefBuffer*) new ((void*) &m_cefBufferTransmit[m_nextTransmitBufferIndex])
+            CefBuffer((void*) p_transmitPayload, sizeof(m_transmitPayload[0]));
+    p_cefBuffer->setNumberOfValidBytes(numBytes);
+
+    return p_cefBuffer;
+}
+
+CefBuffer* CommandDebugPortRouter::checkoutBatchTransmitBuffer(bool includeCommandResponse, debugPacketDataType_t &debugDataType)
+{
+    /**
+     * The record table comes before the records, but how many records there will be isn't known until the end.
+     * So records are added after room for the largest table, and moved down to the end of the table when done.
+     */
+    const uint32_t maxTableSizeInBytes = sizeof(cefBatchHeader_t) + (DEBUG_PORT_BATCH_MAX_NUM_RECORDS * sizeof(cefBatchRecordTableEntry_t));
+    STATIC_ASSERT(DEBUG_PORT_BATCH_MAX_NUM_RECORDS <= UINT8_MAX, batch_number_of_records_must_fit_in_8_bits);
+    STATIC_ASSERT(DEBUG_PORT_MAX_APPLICATION_PAYLOAD <= UINT16_MAX, batch_record_size_must_fit_in_16_bits);
+
+    uint8_t* p_transmitPayload = m_transmitPayload[m_nextTransmitBufferIndex];
+    cefBatchHeader_t* p_batchHeader = (cefBatchHeader_t*) p_transmitPayload;
+    cefBatchRecordTableEntry_t* p_recordTable = (cefBatchRecordTableEntry_t*) &p_batchHeader[1];
+    uint8_t* p_records = &p_transmitPayload[maxTableSizeInBytes];
+    const uint32_t maxNumRecordBytes = sizeof(m_transmitPayload[0]) - maxTableSizeInBytes;
+    uint32_t numRecordBytes = 0;
+    uint32_t numRecords = 0;
+    uint32_t numBytesInResponse = 0;
+
+    // Start with the Command Response?  (Logs waiting to be sent go with it)
+    if (includeCommandResponse == true)
+    {
+        CefBuffer* p_commandBuffer = checkoutCefCommandTransmitBuffer();
+        numBytesInResponse = p_commandBuffer->getNumberOfValidBytes();
+        if (numBytesInResponse > maxNumRecordBytes)
+        {
+            // Too big to batch, so it is sent in its own packet (the logs go in the next packet)
+            m_channelScheduler.channelSent(debugPortChannel_commands, numBytesInResponse);
+            debugDataType = debugPacketType_commandResponse;
+            return p_commandBuffer;
+        }
+
+        memcpy(p_records, p_commandBuffer->getBufferStartAddress(), numBytesInResponse);
+        p_recordTable[numRecords].m_recordType = debugPacketType_commandResponse;
+        p_recordTable[numRecords].m_recordNumBytes = (uint16_t) numBytesInResponse;
+        ++numRecords;
+        numRecordBytes += numBytesInResponse;
+
+        // The response has been copied, so the command buffer can be used for the next command
+        checkinCefCommandTransmitBuffer(p_commandBuffer);
+    }
+
+#if (DEBUG_PORT_PACKED_LOGGING == 1)
+    // All the logs that fit go in a single packed logs record
+    uint32_t numBytesInPackedLogs = packLogs(&p_records[numRecordBytes], maxNumRecordBytes - numRecordBytes);
+    if (numBytesInPackedLogs > 0)
+    {
+        p_recordTable[numRecords].m_recordType = debugPacketType_loggingDataPacked;
+        p_recordTable[numRecords].m_recordNumBytes = (uint16_t) numBytesInPackedLogs;
+        ++numRecords;
+        numRecordBytes += numBytesInPackedLogs;
+    }
+#else
+    // Each log that fits is a record
+    while ((numRecords < DEBUG_PORT_BATCH_MAX_NUM_RECORDS) && ((maxNumRecordBytes - numRecordBytes) >= sizeof(cefLog_t)))
+    {
+        cefLog_t *p_cefLog = checkoutLogTransmitBuffer();
+        if (p_cefLog == nullptr)
+        {
+            break;
+        }
+
+        memcpy(&p_records[numRecordBytes], p_cefLog, sizeof(cefLog_t));
+        checkinLogTransmitBuffer(p_cefLog);
+        p_recordTable[numRecords].m_recordType = debugPacketType_loggingData;
+        p_recordTable[numRecords].m_recordNumBytes = (uint16_t) sizeof(cefLog_t);
+        ++numRecords;
+        numRecordBytes += sizeof(cefLog_t);
+    }
+#endif
+
+    uint32_t numBytesInPayload = 0;
+    if (numRecords == 0)
+    {
+        return nullptr;
+    }
+    else if (numRecords == 1)
+    {
+        // Nothing to batch with; send the record in its own packet, without the batch overhead
+        debugDataType = (debugPacketDataType_t) p_recordTable[0].m_recordType;
+        memmove(p_transmitPayload, p_records, numRecordBytes);
+        numBytesInPayload = numRecordBytes;
+    }
+    else
+    {
+        debugDataType = debugPacketType_batch;
+        p_batchHeader->m_numRecords = (uint8_t) numRecords;
+        p_batchHeader->m_padding1 = 0;
+        p_batchHeader->m_padding2 = 0;
+        for (uint32_t i = 0; i < numRecords; ++i)
+        {
+            p_recordTable[i].m_padding1 = 0;
+        }
+        memmove(&p_recordTable[numRecords], p_records, numRecordBytes);
+        numBytesInPayload = sizeof(cefBatchHeader_t) + (numRecords * sizeof(cefBatchRecordTableEntry_t)) + numRecordBytes;
+    }
+
+    // The command response is charged to the commands channel, and the logs (and batch overhead) to the logs channel
+    m_channelScheduler.channelSent(debugPortChannel_commands, numBytesInResponse);
+    m_channelScheduler.channelSent(debugPortChannel_logs, numBytesInPayload - numBytesInResponse);
+
+    // Once all the queued logs are sent, the next log starts a new linger period
+    if (findOldestLogQueue() == m_numLogQueues)
+    {
+        m_logLingerActive = false;
+    }
+
+    CefBuffer* p_cefBuffer = (CefBuffer*) new ((void*) &m_cefBufferTransmit[m_nextTransmitBufferIndex])
+            CefBuffer((void*) p_transmitPayload, sizeof(m_transmitPayload[0]));
+    p_cefBuffer->setNumberOfValidBytes(numBytesInPayload);
+
+    return p_cefBuffer;
+}
+
+bool CommandDebugPortRouter::shouldSendLogs()
+{
+    uint32_t numLogsToSend = 0;
+    bool errorLogToSend = false;
+    for (uint32_t i = 0; i < m_numLogQueues; ++i)
+    {
+        uint32_t numLogsInQueue = m_logsToSend[i].getCurrentNumberOfEntries();
+        numLogsToSend += numLogsInQueue;
+        if ((i >= logTypeError) && (numLogsInQueue > 0))
+        {
+            errorLogToSend = true;
+        }
+    }
+
+    if (numLogsToSend == 0)
+    {
+        m_logLingerActive = false;
+        return false;
+    }
+
+    uint32_t tickMs = ShimBase::getInstance().getTickMs();
+    if (m_logLingerActive == false)
+    {
+        m_logLingerActive = true;
+        m_logLingerStartTickMs = tickMs;
+    }
+
+    // The linger period ends when the logs have been sent (the logs channel may have to wait its turn to send them)
+    return (m_fatalErrorHandling == true) || (errorLogToSend == true) ||
+           (numLogsToSend >= DEBUG_PORT_BATCH_MIN_NUM_LOGS) ||
+           (m_logPool.getNumFreeBuffers() <= m_numReservedErrorLogEntries) ||
+           ((tickMs - m_logLingerStartTickMs) >= DEBUG_PORT_BATCH_LINGER_MS);
+}
+
 void CommandDebugPortRouter::checkinLogTransmitBuffer(cefLog_t *p_cefLog)
 {
     // If memory is attempted to be returned to a pool that it was not allocated from, then free() with trace fatal.
     m_logPool.free(p_cefLog);
+
+    // Now that there is room, let the host know about any logs that were dropped.  The summary is itself a log,
+    // so it is added on the router's next pass rather than while the logs to send are being packed.
+    m_droppedLogsSummaryPending = true;
 }
 
 CefBuffer* CommandDebugPortRouter::checkoutCefCommandReceiveBuffer()
@@ -208,6 +468,8 @@ void CommandDebugPortRouter::checkinCefCommandReceiveBuffer(CefBuffer *p_cefBuff
         LOG_ERROR(Logging::LogModuleIdCefInfrastructure, "Failed to fetch CEF command.  Status = {%d}",
                 cefCommandFetchStatus, 0, 0);
         m_cefCommandBufferState = cefCommandBufferState_bufferAvailable;
+        // The host counts the failed packet as sent, so count it as done for flow control
+        ++m_numCommandBuffersFreed;
     }
     else
     {
@@ -293,58 +555,175 @@ void CommandDebugPortRouter::checkinCefCommandTransmitBuffer(CefBuffer *p_cefBuf
 
     // All done with the buffer; mark buffer as being available
     m_cefCommandBufferState = cefCommandBufferState_bufferAvailable;
+    ++m_numCommandBuffersFreed;
 
     // Reset the valid bytes to aid debug as the next step is to receive another command
     m_cefCommandBuffer.setNumberOfValidBytes(0);
 }
 
-CefBuffer* CommandDebugPortRouter::checkoutCefTransmitBuffer(debugPacketDataType_t &debugDataType)
+uint32_t CommandDebugPortRouter::getChannelsReadyMask()
 {
-    // Is there already a command checked out?
-    if (mp_cefBufferTransmit != nullptr)
+    uint32_t channelsReadyMask = 0;
+
+    // Is there a Command Response waiting to be sent?
+    if (m_cefCommandBufferState == cefCommandBufferState_readyToTransmit)
     {
-        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Attempt to checkout CEF Buffer to transmit when one is already checked out!",
-                0, 0, 0);
+        channelsReadyMask |= (1 << debugPortChannel_commands);
     }
 
-    // Initialize the return values
-    debugDataType = debugPacketType_invalid;
-    mp_cefBufferTransmit = nullptr;   //!<  Yes, the above nullptr check confirms this, but for defensive coding setting up anyhow.
+    // Are there logs waiting to be sent?
+#if (DEBUG_PORT_BATCHING == 1)
+    if (shouldSendLogs() == true)
+#else
+    if (findOldestLogQueue() != m_numLogQueues)
+#endif
+    {
+        channelsReadyMask |= (1 << debugPortChannel_logs);
+    }
 
-    // Is there a Command Response waiting to be sent?
-    if (m_cefCommandBufferState == cefCommandBufferState_readyToTransmit)
+    // When handling a fatal error, only what is needed to get the logs out is done
+    if (m_fatalErrorHandling == false)
     {
-        mp_cefBufferTransmit = checkoutCefCommandTransmitBuffer();
-        if (mp_cefBufferTransmit == nullptr)
+        for (uint32_t channel = 0; channel < debugPortChannel_numChannels; ++channel)
         {
-            LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Programming Error:  Unexpected nullptr for CefCommand Response!",
-                    0, 0, 0);
+            if ((mp_channelSources[channel] != nullptr) && (mp_channelSources[channel]->hasDataToSend() == true))
+            {
+                channelsReadyMask |= (1 << channel);
+            }
         }
-        debugDataType = debugPacketType_commandResponse;
     }
-    // Is there a log waiting to be sent?
-    else if (m_logsToSend.isEmpty() == false)
+
+    return channelsReadyMask;
+}
+
+CefBuffer* CommandDebugPortRouter::checkoutCommandChannelTransmitBuffer(debugPacketDataType_t &debugDataType)
+{
+#if (DEBUG_PORT_BATCHING == 1)
+    // The command response and logs are combined into one packet where possible
+    return checkoutBatchTransmitBuffer(true, debugDataType);
+#else
+    CefBuffer *p_cefBufferTransmit = checkoutCefCommandTransmitBuffer();
+    if (p_cefBufferTransmit == nullptr)
     {
-        cefLog_t *p_cefLog = checkoutLogTransmitBuffer();
-        if (p_cefLog == nullptr)
-        {
-            LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Programming Error:  Unexpected nullptr for CefCommand Response!", 0, 0, 0);
-        }
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Programming Error:  Unexpected nullptr for CefCommand Response!",
+                0, 0, 0);
+        return nullptr;
+    }
+    m_channelScheduler.channelSent(debugPortChannel_commands, p_cefBufferTransmit->getNumberOfValidBytes());
+    debugDataType = debugPacketType_commandResponse;
 
-        // Need to convert to CefBuffer
-        mp_cefBufferTransmit = (CefBuffer*) new ((void*) &m_cefLogBufferTransmit) CefBuffer((void*) p_cefLog, sizeof(cefLog_t));
-        if (mp_cefBufferTransmit == nullptr)
-        {
-            LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Programming Error:  Unexpected nullptr for Log Transmit!", 0, 0, 0);
-        }
+    return p_cefBufferTransmit;
+#endif  // DEBUG_PORT_BATCHING
+}
 
-        // Setup the number of valid bytes in the log buffer
-        mp_cefBufferTransmit->setNumberOfValidBytes(sizeof(cefLog_t));
+CefBuffer* CommandDebugPortRouter::checkoutLogChannelTransmitBuffer(debugPacketDataType_t &debugDataType)
+{
+#if (DEBUG_PORT_BATCHING == 1)
+    return checkoutBatchTransmitBuffer(false, debugDataType);
+#elif (DEBUG_PORT_PACKED_LOGGING == 1)
+    CefBuffer *p_cefBufferTransmit = checkoutPackedLogTransmitBuffer();
+    if (p_cefBufferTransmit == nullptr)
+    {
+        return nullptr;
+    }
+    m_channelScheduler.channelSent(debugPortChannel_logs, p_cefBufferTransmit->getNumberOfValidBytes());
+    debugDataType = debugPacketType_loggingDataPacked;
 
-        debugDataType = debugPacketType_loggingData;
+    return p_cefBufferTransmit;
+#else
+    cefLog_t *p_cefLog = checkoutLogTransmitBuffer();
+    if (p_cefLog == nullptr)
+    {
+        // No logs to send
+        return nullptr;
+    }
+
+    // Need to convert to CefBuffer
+    CefBuffer *p_cefBufferTransmit = (CefBuffer*) new ((void*) &m_cefBufferTransmit[m_nextTransmitBufferIndex]) CefBuffer((void*) p_cefLog, sizeof(cefLog_t));
+    if (p_cefBufferTransmit == nullptr)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Programming Error:  Unexpected nullptr for Log Transmit!", 0, 0, 0);
+        return nullptr;
     }
 
-    return mp_cefBufferTransmit;
+    // Setup the number of valid bytes in the log buffer
+    p_cefBufferTransmit->setNumberOfValidBytes(sizeof(cefLog_t));
+    m_channelScheduler.channelSent(debugPortChannel_logs, sizeof(cefLog_t));
+    debugDataType = debugPacketType_loggingData;
+
+    return p_cefBufferTransmit;
+#endif  // DEBUG_PORT_BATCHING
+}
+
+CefBuffer* CommandDebugPortRouter::checkoutChannelSourceTransmitBuffer(uint32_t channel, debugPacketDataType_t &debugDataType)
+{
+    uint8_t* p_transmitPayload = m_transmitPayload[m_nextTransmitBufferIndex];
+    uint32_t numBytes = mp_channelSources[channel]->fillTransmitPayload(p_transmitPayload, sizeof(m_transmitPayload[0]), debugDataType);
+    if (numBytes == 0)
+    {
+        debugDataType = debugPacketType_invalid;
+        return nullptr;
+    }
+    if (numBytes > sizeof(m_transmitPayload[0]))
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Debug port channel={:d} source filled {:d} bytes, more than the payload holds",
+                channel, numBytes, 0);
+        return nullptr;
+    }
+    m_channelScheduler.channelSent(channel, numBytes);
+
+    CefBuffer* p_cefBuffer = (CefBuffer*) new ((void*) &m_cefBufferTransmit[m_nextTransmitBufferIndex])
+            CefBuffer((void*) p_transmitPayload, sizeof(m_transmitPayload[0]));
+    p_cefBuffer->setNumberOfValidBytes(numBytes);
+
+    return p_cefBuffer;
+}
+
+CefBuffer* CommandDebugPortRouter::checkoutCefTransmitBuffer(debugPacketDataType_t &debugDataType)
+{
+    // Are all the transmit buffers already checked out?
+    if (m_numTransmitBuffersCheckedOut >= m_numTransmitBuffers)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Attempt to checkout CEF Buffer to transmit when {:d} are already checked out!",
+                m_numTransmitBuffersCheckedOut, 0, 0);
+    }
+
+    // Initialize the return values
+    debugDataType = debugPacketType_invalid;
+    CefBuffer *p_cefBufferTransmit = nullptr;
+
+    // Each channel with something to send gets its share of the debug port (see DebugPortChannelScheduler)
+    uint32_t channel = m_channelScheduler.selectChannel(getChannelsReadyMask());
+    if (channel == debugPortChannel_commands)
+    {
+        p_cefBufferTransmit = checkoutCommandChannelTransmitBuffer(debugDataType);
+    }
+    else if (channel == debugPortChannel_logs)
+    {
+        p_cefBufferTransmit = checkoutLogChannelTransmitBuffer(debugDataType);
+    }
+    else if (channel < debugPortChannel_numChannels)
+    {
+        p_cefBufferTransmit = checkoutChannelSourceTransmitBuffer(channel, debugDataType);
+    }
+
+    // With nothing else to send, let the host know if it can send another command
+    if (p_cefBufferTransmit == nullptr)
+    {
+        p_cefBufferTransmit = checkoutFlowControlTransmitBuffer(debugDataType);
+    }
+
+    if (p_cefBufferTransmit != nullptr)
+    {
+        /**
+         * Buffers are checked in in the order they are checked out, and at most m_numTransmitBuffers are
+         * checked out, so the next transmit buffer is never one still being transmitted.
+         */
+        ++m_numTransmitBuffersCheckedOut;
+        m_nextTransmitBufferIndex = (m_nextTransmitBufferIndex + 1) % m_numTransmitBuffers;
+    }
+
+    return p_cefBufferTransmit;
 }
 
 void CommandDebugPortRouter::checkinCefTransmitBuffer(CefBuffer *p_cefBuffer)
@@ -355,47 +734,157 @@ void CommandDebugPortRouter::checkinCefTransmitBuffer(CefBuffer *p_cefBuffer)
                 0, 0, 0);
     }
 
+    // Packed and batched logs (and batched command responses) were returned when they were copied into a transmit
+    // payload, so a transmit payload has nothing to return
+    uint8_t* p_bufferStart = (uint8_t*) p_cefBuffer->getBufferStartAddress();
+    bool isTransmitPayload = (p_bufferStart >= &m_transmitPayload[0][0]) &&
+                             (p_bufferStart < (&m_transmitPayload[0][0] + sizeof(m_transmitPayload)));
+
     // Is this the Cef Command Buffer?
     if (p_cefBuffer == &m_cefCommandBuffer)
     {
         checkinCefCommandTransmitBuffer(p_cefBuffer);
     }
-    // Then this must be a log buffer
-    else
+    // Else, unless it is a transmit payload, this must be a log buffer
+    else if (isTransmitPayload == false)
     {
         cefLog_t *p_cefLog = (cefLog_t*) p_cefBuffer->getBufferStartAddress();
         checkinLogTransmitBuffer(p_cefLog);
     }
 
     // Mark that done/checked in the transmit buffer
-    mp_cefBufferTransmit = nullptr;
+    if (m_numTransmitBuffersCheckedOut == 0)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Programming Error:  Transmit Buffer returned when none are checked out!",
+                0, 0, 0);
+    }
+    --m_numTransmitBuffersCheckedOut;
+}
+
+CefBuffer* CommandDebugPortRouter::checkoutFlowControlTransmitBuffer(debugPacketDataType_t &debugDataType)
+{
+    uint8_t commandCreditLimit = getFlowControlCredits() & DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK;
+    if (commandCreditLimit == (m_advertisedFlowControlCredits & DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK))
+    {
+        // The host already knows; changes in log capacity alone go out with the next packet
+        return nullptr;
+    }
+
+    // The packet has no payload, the credits are in its header
+    uint8_t* p_transmitPayload = &m_transmitPayload[m_nextTransmitBufferIndex][0];
+    CefBuffer* p_cefBufferTransmit = (CefBuffer*) new ((void*) &m_cefBufferTransmit[m_nextTransmitBufferIndex])
+            CefBuffer((void*) p_transmitPayload, sizeof(m_transmitPayload[0]));
+    p_cefBufferTransmit->setNumberOfValidBytes(0);
+    debugDataType = debugPacketType_flowControl;
+    return p_cefBufferTransmit;
+}
+
+uint8_t CommandDebugPortRouter::getFlowControlCredits()
+{
+    /**
+     * The command credit limit is the number of commands done with plus the number of free receive slots.
+     * The receive slot is counted as free while a command is in it, as the command is counted once it is freed.
+     * No command is received while handling a fatal error, so there are no receive slots then.
+     */
+    uint32_t commandCreditLimit = m_numCommandBuffersFreed;
+    if (m_fatalErrorHandling == false)
+    {
+        commandCreditLimit += DEBUG_PORT_NUM_COMMAND_RECEIVE_SLOTS;
+    }
+
+    uint32_t logCapacity = MIN(m_logPool.getNumFreeBuffers(), DEBUG_PORT_CREDITS_LOG_CAPACITY_MAX);
+
+    return (uint8_t) ((commandCreditLimit & DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK) |
+                      (logCapacity << DEBUG_PORT_CREDITS_LOG_CAPACITY_SHIFT));
+}
+
+uint8_t CommandDebugPortRouter::advertiseFlowControlCredits()
+{
+    m_advertisedFlowControlCredits = getFlowControlCredits();
+    return m_advertisedFlowControlCredits;
+}
+
+void CommandDebugPortRouter::registerChannelSource(debugPortChannel_t channel, DebugPortChannelSource* p_source)
+{
+    if ((channel == debugPortChannel_commands) || (channel == debugPortChannel_logs) || (channel >= debugPortChannel_numChannels))
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Can not register a source for debug port channel={:d}", channel, 0, 0);
+        return;
+    }
+
+    mp_channelSources[channel] = p_source;
+}
+
+void CommandDebugPortRouter::setChannelQuantum(debugPortChannel_t channel, uint32_t quantumNumBytes)
+{
+    m_channelScheduler.setChannelQuantum(channel, quantumNumBytes);
+}
+
+bool CommandDebugPortRouter::setDebugPortDriver(DebugPortDriver* p_debugPortDriver)
+{
+    return m_debugTransportLayer.setDebugPortDriver(p_debugPortDriver);
 }
 
-void CommandDebugPortRouter::discardOlderLogs()
+void CommandDebugPortRouter::getDebugPortStats(debugPortStats_t& stats)
+{
+    m_debugTransportLayer.getStats(stats);
+}
+
+void CommandDebugPortRouter::discardOlderLogs(logType_t logType)
 {
     // What percentage of the logs should we discard (33 is 33%) to make room for more logs
     const uint32_t percentToDiscard = 33;
 
-    uint32_t numLogsToDiscard = (m_logsToSend.getMaximumNumberOfElements() * percentToDiscard) / 100;
-
-    uint32_t numCurrentLogs = m_logsToSend.getCurrentNumberOfEntries();
+    uint32_t numLogsToDiscard = (m_logsToSend[0].getMaximumNumberOfElements() * percentToDiscard) / 100;
 
-    numLogsToDiscard = MIN(numLogsToDiscard, numCurrentLogs);
+    // Discard the lowest severity logs first, but never a log with a higher severity than the log that needs room
+    uint32_t maxLogQueueIndexToDiscard = MIN((uint32_t) logType, m_numLogQueues - 1);
 
-    // Remove log from send list, and return it to allocate list
-    for (uint32_t i = 0; i < numLogsToDiscard; ++i)
+    for (uint32_t logQueueIndex = 0; (logQueueIndex <= maxLogQueueIndexToDiscard) && (numLogsToDiscard > 0); ++logQueueIndex)
     {
+        // Remove log from send list (oldest first), and return it to allocate list
         void* p_log;
-        if (m_logsToSend.get(p_log) == false)
+        while ((numLogsToDiscard > 0) && (m_logsToSend[logQueueIndex].get(p_log) == true))
         {
-            // This is unexpected as should be enough logs to fetch...but try to continue continue
-            LOG_ERROR(Logging::LogModuleIdCefInfrastructure, "Failed to discard {:d} logs, only discarded {:d} logs",
-                    numLogsToDiscard, i, 0);
-            break;
+            // Return the log memory to be used for a "new" log
+            m_logPool.free((cefLog_t*)p_log);
+            ++m_numDroppedLogs[logQueueIndex];
+            --numLogsToDiscard;
         }
+    }
+}
+
+void CommandDebugPortRouter::logDropped(logType_t logType)
+{
+    ++m_numDroppedLogs[MIN((uint32_t) logType, m_numLogQueues - 1)];
+}
+
+void CommandDebugPortRouter::logDroppedLogsSummary()
+{
+    m_droppedLogsSummaryPending = false;
 
-        // Return the log memory to be used for a "new" log
-        m_logPool.free((cefLog_t*)p_log);
+    // One summary per log type, so each count has its own field
+    for (uint32_t logQueueIndex = 0; logQueueIndex < m_numLogQueues; ++logQueueIndex)
+    {
+        // Only add a summary when there is room for it without discarding other logs (it is a warning).  The counts
+        // left are reported once more logs have been sent.
+        if (m_logPool.getNumFreeBuffers() <= m_numReservedErrorLogEntries)
+        {
+            return;
+        }
+
+        // Logs may be dropped from interrupts, so read and clear the count with interrupts disabled
+        uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+        uint32_t numDroppedLogs = m_numDroppedLogs[logQueueIndex];
+        m_numDroppedLogs[logQueueIndex] = 0;
+        ShimBase::getInstance().restoreInterrupts(interruptState);
+
+        if (numDroppedLogs > 0)
+        {
+            // Sent straight to logMessage() as the summary must not be filtered or rate limited
+            Logging::instance().logMessage(logTypeWarning, Logging::LogModuleIdCefInfrastructure,
+                    "Logs dropped: {:d} logs of log type {:d}", __JUST_FILENAME__, __LINE__, numDroppedLogs, logQueueIndex, 0);
+        }
     }
 }
 
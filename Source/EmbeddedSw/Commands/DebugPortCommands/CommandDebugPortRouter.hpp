@@ -33,6 +33,36 @@
 #include "cefContract.hpp"
 #include "CefBuffer.hpp"
 #include "DebugPortTransportLayer.hpp"
+#include "LogPacker.hpp"
+#include "DebugPortChannelScheduler.hpp"
+#include "DebugPortChannelSource.hpp"
+
+/**
+ * When 1, logs are transmitted in the packed logging format (several logs per packet, see cefContract.hpp).
+ * When 0, each log is transmitted as a cefLog_t in its own packet.
+ */
+#ifndef DEBUG_PORT_PACKED_LOGGING
+    #define DEBUG_PORT_PACKED_LOGGING 1
+#endif
+
+/**
+ * When 1, a command response and the queued logs are sent together in one batch packet (see cefContract.hpp), and
+ * debug, info and warning logs are held (up to DEBUG_PORT_BATCH_LINGER_MS) until there are enough of them to be
+ * worth a packet.  When 0, a command response is sent in its own packet, and logs are sent as soon as possible.
+ */
+#ifndef DEBUG_PORT_BATCHING
+    #define DEBUG_PORT_BATCHING 1
+#endif
+
+//! Longest time a log is held waiting for more logs to batch with
+#ifndef DEBUG_PORT_BATCH_LINGER_MS
+    #define DEBUG_PORT_BATCH_LINGER_MS 20
+#endif
+
+//! Number of queued logs that are sent without waiting for DEBUG_PORT_BATCH_LINGER_MS
+#ifndef DEBUG_PORT_BATCH_MIN_NUM_LOGS
+    #define DEBUG_PORT_BATCH_MIN_NUM_LOGS 4
+#endif
 
 class CommandDebugPortRouter: public CommandBase
 {
@@ -43,8 +73,10 @@ public:
      * @param logBufferPoolId  		log buffer pool ID (for debug), from BufferPoolBase::BufferPoolIdxx
      * @param numBytesPerLogEntry  	Number of bytes per log entry
      * @param maxNumLogEntries  	Maximum number of log entries to keep in the system at one time
+     * @param numReservedErrorLogEntries  Number of log entries that only error and fatal logs can use
      */
-    CommandDebugPortRouter(uint32_t logBufferPoolId, uint32_t numBytesPerLoggingEntry, uint32_t maxNumLoggingEntries);
+    CommandDebugPortRouter(uint32_t logBufferPoolId, uint32_t numBytesPerLoggingEntry, uint32_t maxNumLoggingEntries,
+                           uint32_t numReservedErrorLogEntries);
 
     /**
      *  Obtain a reference to the Command Debug Port.
@@ -60,11 +92,13 @@ public:
 
     /**
      * Checks out a log buffer that must be returned once the log data is filled in
+     *      Debug, info and warning logs can not use the log entries reserved for error and fatal logs
+     *
+     * @param logType  type of the log that will be put in the buffer
      *
      * @return returns nullptr if no buffer is available; pointer to log structure otherwise
      */
-    //*cefLog_t checkoutLogBuffer();
-    cefLog_t* checkoutLogBufferLogging();
+    cefLog_t* checkoutLogBufferLogging(logType_t logType);
 
     /**
      * Returns a cefLog_t log pointer that was previously checked out
@@ -83,8 +117,21 @@ public:
      * latest logs are likely to have the more valuable data, so we discard older logs.
      * For example, if there is no room for a log_fatal(), let alone the possible error logs leading up to the log_fatal(),
      * then it is difficult to diagnose what is going on from the log data.
+     *
+     * The lowest severity logs are discarded first (oldest first within a severity), and a log is never discarded
+     * to make room for a log of lower severity.  So a burst of debug/info logs can't discard the error that explains
+     * a later fatal.  Discarded logs are counted and reported in a "logs dropped" log once there is room.
+     *
+     * @param logType  type of the log that needs room
+     */
+    void discardOlderLogs(logType_t logType);
+
+    /**
+     * Counts a log that logging could not find room for (it is reported in the next "logs dropped" log)
+     *
+     * @param logType  type of the log that was dropped
      */
-    void discardOlderLogs();
+    void logDropped(logType_t logType);
 
 
     /**
@@ -140,6 +187,47 @@ public:
      */
     void checkinCefTransmitBuffer(CefBuffer *p_cefBuffer);
 
+    /**
+     * Registers the source of the packets sent on a channel.  The router is the source of the commands and
+     * logs channels, so only the other channels (telemetry, bulk transfer, events) can be registered.
+     *
+     * @param channel   debugPortChannel_t the source sends on
+     * @param p_source  source of the channel's packets (nullptr to unregister)
+     */
+    void registerChannelSource(debugPortChannel_t channel, DebugPortChannelSource* p_source);
+
+    /**
+     * Sets a channel's share of the debug port bandwidth (see DebugPortChannelScheduler)
+     *
+     * @param channel          debugPortChannel_t to configure
+     * @param quantumNumBytes  number of bytes the channel may send per scheduling round
+     */
+    void setChannelQuantum(debugPortChannel_t channel, uint32_t quantumNumBytes);
+
+    /**
+     * Changes the driver the debug port runs on (see DebugPortTransportLayer::setDebugPortDriver())
+     *
+     * @param p_debugPortDriver  driver to use from now on
+     *
+     * @return true if the driver was changed
+     */
+    bool setDebugPortDriver(DebugPortDriver* p_debugPortDriver);
+
+    /**
+     * Gets the debug port error counts (see DebugPortTransportLayer::getStats())
+     *
+     * @param stats  filled in with the counts
+     */
+    void getDebugPortStats(debugPortStats_t& stats);
+
+    /**
+     * Gets the flow control credits to advertise in the header of a packet being transmitted (see
+     * "Flow Control Credits" in cefContract.hpp), and remembers them as the last credits advertised
+     *
+     * @return m_flowControlCredits for the packet header
+     */
+    uint8_t advertiseFlowControlCredits();
+
     /**
      * If a fatal error occurs, then we still want to try and transmit what caused the error
      * out of the debug port (see Logging.cpp for more discussion on this topic).  Yes, the
@@ -170,11 +258,112 @@ private:
 
     /**
      * Checks out next cefLog_t buffer for transmitting logging information
+     *      Logs are queued by severity, so the log with the oldest sequence number across all the
+     *      queues is sent next.  This keeps the logs in sequence number order on the debug port.
      *
      * @return nullptr if there is no logging data to be transmitted, valid pointer otherwise
      */
     cefLog_t* checkoutLogTransmitBuffer();
 
+    /**
+     * Finds the log queue holding the log with the oldest sequence number
+     *
+     * @return index into m_logsToSend, or m_numLogQueues if there are no logs to send
+     */
+    uint32_t findOldestLogQueue();
+
+    /**
+     * Packs as many logs (oldest first) as fit into a buffer in the packed logging format.  The logs are returned
+     * to the log pool as they are packed.
+     *
+     * @param p_destination     where to pack the logs
+     * @param maxNumBytes       size of the destination in bytes
+     *
+     * @return number of bytes of packed logs (0 if there were no logs to send)
+     */
+    uint32_t packLogs(uint8_t* p_destination, uint32_t maxNumBytes);
+
+    /**
+     * Packs as many logs as fit into the next transmit payload, so that it is the only thing checked out for transmit.
+     *
+     * @return nullptr if there is no logging data to be transmitted, pointer to the packed log CefBuffer otherwise
+     */
+    CefBuffer* checkoutPackedLogTransmitBuffer();
+
+    /**
+     * Builds the next packet to transmit in the next transmit payload: the command response (if requested) followed by
+     * logs.  A packet with a single record is sent as that record's packet type rather than as a batch.
+     * The command response and logs are returned as soon as they are copied, so the command buffer can receive
+     * the next command while the packet is transmitted.
+     *
+     * @param includeCommandResponse  true to start the packet with the command response (which must be ready to transmit)
+     * @param debugDataType  what type of data is being transmitted (returned as a reference)
+     *
+     * @return nullptr if there is nothing to transmit yet, pointer to CefBuffer otherwise
+     */
+    CefBuffer* checkoutBatchTransmitBuffer(bool includeCommandResponse, debugPacketDataType_t &debugDataType);
+
+    /**
+     * Gets the next packet to transmit on the commands channel (the command response)
+     *
+     * @param debugDataType  what type of data is being transmitted (returned as a reference)
+     *
+     * @return nullptr if there is nothing to transmit, pointer to CefBuffer otherwise
+     */
+    CefBuffer* checkoutCommandChannelTransmitBuffer(debugPacketDataType_t &debugDataType);
+
+    /**
+     * Gets the next packet to transmit on the logs channel
+     *
+     * @param debugDataType  what type of data is being transmitted (returned as a reference)
+     *
+     * @return nullptr if there is nothing to transmit, pointer to CefBuffer otherwise
+     */
+    CefBuffer* checkoutLogChannelTransmitBuffer(debugPacketDataType_t &debugDataType);
+
+    /**
+     * Gets the next packet to transmit from a registered channel source
+     *
+     * @param channel        debugPortChannel_t with a registered source
+     * @param debugDataType  what type of data is being transmitted (returned as a reference)
+     *
+     * @return nullptr if there is nothing to transmit, pointer to CefBuffer otherwise
+     */
+    CefBuffer* checkoutChannelSourceTransmitBuffer(uint32_t channel, debugPacketDataType_t &debugDataType);
+
+    /**
+     * Gets an empty debugPacketType_flowControl packet to transmit if the command credit limit has changed
+     * since it was last advertised, so the host learns about it without waiting for other traffic
+     *
+     * @param debugDataType  what type of data is being transmitted (returned as a reference)
+     *
+     * @return nullptr if the host already knows the command credit limit, pointer to CefBuffer otherwise
+     */
+    CefBuffer* checkoutFlowControlTransmitBuffer(debugPacketDataType_t &debugDataType);
+
+    /**
+     * Calculates the current flow control credits (see "Flow Control Credits" in cefContract.hpp)
+     *
+     * @return m_flowControlCredits for a packet header
+     */
+    uint8_t getFlowControlCredits();
+
+    /**
+     * Finds the channels with a packet ready to transmit
+     *
+     * @return bit (1 << channel) set for each channel with a packet ready to transmit
+     */
+    uint32_t getChannelsReadyMask();
+
+    /**
+     * Decides whether the queued logs should be sent now, or held for more logs to batch with.
+     * Logs are sent right away if an error or fatal log is queued, if DEBUG_PORT_BATCH_MIN_NUM_LOGS are queued,
+     * if only the reserved log entries are left, after DEBUG_PORT_BATCH_LINGER_MS, or when handling a fatal error.
+     *
+     * @return true if the logs should be sent now
+     */
+    bool shouldSendLogs();
+
     /**
      * Returns a cefLog_t pointer of log data that was previously checked out for transmitting
      *      Note:  It is a fatal error to return memory that was not previously checked out from
@@ -202,11 +391,30 @@ private:
      */
     void checkinCefCommandTransmitBuffer(CefBuffer *p_cefBuffer);
 
+    /**
+     * For each log type (severity) with dropped logs, if there is room for a log, adds a warning log with the
+     * number of logs of that type dropped and clears that count.
+     * Called from execute(), never while the logs to send are being walked (the summaries are logs themselves).
+     */
+    void logDroppedLogsSummary();
+
+    //! One queue of logs to send per log type (severity)
+    static const uint32_t m_numLogQueues = logTypeFatal + 1;
+
     //! Pool of cefLog_t to allocate for logging
     BufferPoolBase m_logPool;
 
-    //! List of logs that have been filled out and ready to be sent.
-    RingBufferOfVoidPointers m_logsToSend;
+    //! Lists of logs that have been filled out and ready to be sent, indexed by log type
+    RingBufferOfVoidPointers m_logsToSend[m_numLogQueues];
+
+    //! Number of log entries that only error and fatal logs can use
+    uint32_t m_numReservedErrorLogEntries;
+
+    //! Number of logs dropped (by log type) since the last "logs dropped" log
+    uint32_t m_numDroppedLogs[m_numLogQueues];
+
+    //! True if a log buffer was freed since the last logDroppedLogsSummary(), so dropped logs may now be reported
+    bool m_droppedLogsSummaryPending;
 
     //! There is only one CEF command that can be in existence at one time
     //! Reserve space for this command here
@@ -216,11 +424,38 @@ private:
     //!     CefBuffer.getNumberOfValidBytes() describes how many valid bytes are in the buffer
     CefBuffer m_cefCommandBuffer;
 
-    //! CefBuffer that describes the log being transmitted (re-initialized for each transmit log)
-    CefBuffer m_cefLogBufferTransmit;
+    /**
+     * Number of buffers that can be checked out for transmit at once (one for each packet the transport layer
+     * can have in flight), so the next packet can be built while the current one is being sent
+     */
+    static const uint32_t m_numTransmitBuffers = DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT;
+
+    //! CefBuffers that describe what is being transmitted (re-initialized for each transmit)
+    CefBuffer m_cefBufferTransmit[m_numTransmitBuffers];
+
+    //! Payloads assembled for transmit (packed logs and batches)
+    uint8_t m_transmitPayload[m_numTransmitBuffers][DEBUG_PORT_MAX_APPLICATION_PAYLOAD];
+
+    //! Index of the m_cefBufferTransmit and m_transmitPayload to use for the next transmit
+    uint32_t m_nextTransmitBufferIndex;
+
+    //! Packs logs in the packed logging format
+    LogPacker m_logPacker;
 
-    //! This is used as a sanity check to make sure in correct state
-    CefBuffer *mp_cefBufferTransmit;
+    //! True while queued logs are being held for more logs to batch with
+    bool m_logLingerActive;
+
+    //! Tick (ms) when the queued logs started being held
+    uint32_t m_logLingerStartTickMs;
+
+    //! Decides which channel transmits next
+    DebugPortChannelScheduler m_channelScheduler;
+
+    //! Registered channel sources, indexed by channel (nullptr for the router's own channels and unused channels)
+    DebugPortChannelSource* mp_channelSources[debugPortChannel_numChannels];
+
+    //! Number of buffers checked out for transmit.  This is used as a sanity check to make sure in correct state
+    uint32_t m_numTransmitBuffersCheckedOut;
 
     //! Number of valid bytes in the cef Command response (including the header)
     uint32_t m_numBytesInCefCommandResponse;
@@ -228,6 +463,12 @@ private:
     //! cefCommandPacket memory's state
     uint32_t m_cefCommandBufferState;
 
+    //! Number of times the CEF command buffer was made available to receive another command since power up
+    uint32_t m_numCommandBuffersFreed;
+
+    //! Flow control credits in the header of the last packet transmitted
+    uint8_t m_advertisedFlowControlCredits;
+
     /**
      * True if router is in fatal error handling mode (triggered when have a fatal error).
      * In short, true means that only do what is necessary to transmit the log data out of the
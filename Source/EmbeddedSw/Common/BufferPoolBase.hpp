@@ -62,6 +62,16 @@ public:
      */
     void free(void *p_bufferMemory);
 
+    /**
+     * Returns the number of buffers that can currently be allocated
+     *
+     * @return number of free buffers in the pool
+     */
+    uint32_t getNumFreeBuffers()
+    {
+        return m_ringBufferOfBufferMemory.getCurrentNumberOfEntries();
+    }
+
 private:
     // Align the memory for each buffer.  For now, align to a void* pointer as void* should be the alignment
     // requirement for structures as well.
@@ -73,6 +73,18 @@ bool RingBufferOfVoidPointers::get(void*& getPointer)
 	return true;
 }
 
+bool RingBufferOfVoidPointers::peek(void*& peekPointer)
+{
+	if (isEmpty() == true)
+	{
+		return false;
+	}
+
+	peekPointer = mp_ringArray[m_tail];
+
+	return true;
+}
+
 uint32_t RingBufferOfVoidPointers::getCurrentNumberOfEntries()
 {
 	// if m_tail == m_head, then numEntries is zero as this signifies an empty array
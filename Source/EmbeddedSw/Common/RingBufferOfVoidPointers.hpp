@@ -79,6 +79,15 @@ class RingBufferOfVoidPointers
          */
 		bool get(void*& getPointer);
 
+        /**
+         * Gets the next pointer from the ring buffer without removing it
+         *
+         *@param peekPointer	(reference) the next value that get() would return
+         *
+         * @return	true if the ring buffer has a pointer; false if ring buffer was empty
+         */
+		bool peek(void*& peekPointer);
+
 		/**
 		 * Returns the maximum number of elements that can be added to the ring buffer
 		 *
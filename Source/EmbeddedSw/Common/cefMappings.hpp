@@ -44,6 +44,10 @@ extern "C" {
 
 
 #ifdef __SIMULATOR__
+	// C++ standard headers (e.g. chrono) declare templates, which can't have the C linkage this file is wrapped in
+	#ifdef __cplusplus
+	extern "C++" {
+	#endif
 	#include <cassert>
 	#include <chrono>
 	#include <cstdint>
@@ -56,6 +60,9 @@ extern "C" {
 	#include <stdarg.h>
 	#include <termios.h>
 	#include <unistd.h>
+	#ifdef __cplusplus
+	}
+	#endif
 
 	using namespace std;
 
@@ -0,0 +1,94 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include <string.h>
+#include "Cobs.hpp"
+
+
+void Cobs::startFrame(uint8_t* p_frame)
+{
+	mp_frameStart = p_frame;
+	mp_code = p_frame;
+	mp_write = p_frame + 1;
+	m_code = 1;
+}
+
+void Cobs::encode(const void* p_source, uint32_t numBytes)
+{
+	const uint8_t* p_read = (const uint8_t*) p_source;
+	const uint8_t* p_end = p_read + numBytes;
+
+	while (p_read < p_end)
+	{
+		uint8_t byte = *p_read++;
+		if (byte == 0)
+		{
+			// End the block; the zero is implied by the code
+			*mp_code = m_code;
+			mp_code = mp_write++;
+			m_code = 1;
+		}
+		else
+		{
+			*mp_write++ = byte;
+			if (++m_code == m_maxCode)
+			{
+				// Block is full
+				*mp_code = m_code;
+				mp_code = mp_write++;
+				m_code = 1;
+			}
+		}
+	}
+}
+
+uint32_t Cobs::finishFrame(void)
+{
+	*mp_code = m_code;
+	*mp_write++ = DEBUG_PORT_COBS_DELIMITER;
+	return (uint32_t) (mp_write - mp_frameStart);
+}
+
+bool Cobs::decode(uint8_t* p_frame, uint32_t numBytes, uint32_t& numDecodedBytes)
+{
+	// The decoded data is never longer than the encoded data, so it is written over the frame as it is read
+	uint32_t readOffset = 0;
+	uint32_t writeOffset = 0;
+
+	while (readOffset < numBytes)
+	{
+		uint32_t code = p_frame[readOffset];
+		if ((code == DEBUG_PORT_COBS_DELIMITER) || ((readOffset + code) > numBytes))
+		{
+			// Corrupted; a code can't be the delimiter or run past the end of the frame
+			numDecodedBytes = 0;
+			return false;
+		}
+
+		memmove(&p_frame[writeOffset], &p_frame[readOffset + 1], code - 1);
+		readOffset += code;
+		writeOffset += code - 1;
+
+		if ((code != m_maxCode) && (readOffset < numBytes))
+		{
+			p_frame[writeOffset++] = 0;
+		}
+	}
+
+	numDecodedBytes = writeOffset;
+	return true;
+}
@@ -0,0 +1,90 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __COBS_H
+#define __COBS_H
+#include "cefContract.hpp"
+
+/**
+ * COBS (Consistent Overhead Byte Stuffing) encoder/decoder for the debug port framing (see DEBUG_PORT_FRAMING_COBS)
+ *
+ * The data is split into blocks at each zero byte.  Each block is sent as a code byte (1 + number of bytes in the
+ * block) followed by the block's non-zero bytes, and the zero is implied.  A block of 254 non-zero bytes has the
+ * code 0xFF and no implied zero.  So the encoded data never contains a zero, and a zero delimits frames.
+ *
+ * The encoder can encode a frame from several pieces (e.g. the packet header and the payload) without copying
+ * them together first.
+ */
+class Cobs {
+public:
+	//! Constructor.
+	Cobs():
+	mp_frameStart(nullptr),
+	mp_write(nullptr),
+	mp_code(nullptr),
+	m_code(0)
+	{}
+
+   /**
+    * Starts encoding a frame
+    *
+    * @param p_frame  where to put the frame; must have room for DEBUG_PORT_COBS_MAX_ENCODED_SIZE_BYTES() of the
+    *                 total number of bytes encoded, plus the delimiter
+    */
+   void startFrame(uint8_t* p_frame);
+
+   /**
+    * Encodes the next piece of the frame
+    *
+    * @param p_source  data to encode
+    * @param numBytes  number of bytes to encode
+    */
+   void encode(const void* p_source, uint32_t numBytes);
+
+   /**
+    * Finishes the frame (adds the delimiter)
+    *
+    * @return number of bytes in the frame, including the delimiter
+    */
+   uint32_t finishFrame(void);
+
+   /**
+    * Decodes a frame in place
+    *
+    * @param p_frame          the frame, without the delimiter (replaced with the decoded data)
+    * @param numBytes         number of bytes in the frame
+    * @param numDecodedBytes  number of bytes of decoded data (returned as a reference)
+    *
+    * @return false if the frame is not valid COBS (e.g. it was corrupted)
+    */
+   static bool decode(uint8_t* p_frame, uint32_t numBytes, uint32_t& numDecodedBytes);
+
+   //! Code of a block of 254 non-zero bytes (no implied zero)
+   static const uint8_t m_maxCode = 0xFF;
+
+private:
+
+   //! Start of the frame being encoded
+   uint8_t* mp_frameStart;
+   //! Where the next encoded byte goes
+   uint8_t* mp_write;
+   //! Where the code of the current block goes
+   uint8_t* mp_code;
+   //! Code of the current block (1 + number of bytes in the block so far)
+   uint8_t m_code;
+};
+
+#endif  // end header guard
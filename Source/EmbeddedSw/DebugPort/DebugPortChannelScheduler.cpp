@@ -0,0 +1,116 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include "DebugPortChannelScheduler.hpp"
+#include "Logging.hpp"
+
+
+DebugPortChannelScheduler::DebugPortChannelScheduler() :
+        m_quantumNumBytes{DEBUG_PORT_CHANNEL_QUANTUM_COMMANDS, DEBUG_PORT_CHANNEL_QUANTUM_LOGS, DEBUG_PORT_CHANNEL_QUANTUM_TELEMETRY,
+                          DEBUG_PORT_CHANNEL_QUANTUM_BULK_TRANSFER, DEBUG_PORT_CHANNEL_QUANTUM_EVENTS},
+        m_deficitNumBytes{0},
+        m_currentChannel(0)
+{
+    STATIC_ASSERT(debugPortChannel_numChannels == 5, m_quantumNumBytes_initializer_must_match_number_of_channels);
+    STATIC_ASSERT(debugPortChannel_numChannels <= 32, channels_ready_mask_must_have_a_bit_per_channel);
+}
+
+void DebugPortChannelScheduler::setChannelQuantum(uint32_t channel, uint32_t quantumNumBytes)
+{
+    if (channel >= debugPortChannel_numChannels)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Invalid debug port channel={:d}", channel, 0, 0);
+        return;
+    }
+
+    // A quantum of 0 would never let the channel send
+    m_quantumNumBytes[channel] = MAX(quantumNumBytes, 1);
+}
+
+uint32_t DebugPortChannelScheduler::getChannelQuantum(uint32_t channel)
+{
+    if (channel >= debugPortChannel_numChannels)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Invalid debug port channel={:d}", channel, 0, 0);
+        return 0;
+    }
+
+    return m_quantumNumBytes[channel];
+}
+
+uint32_t DebugPortChannelScheduler::selectChannel(uint32_t channelsReadyMask)
+{
+    const uint32_t allChannelsMask = (1 << debugPortChannel_numChannels) - 1;
+    channelsReadyMask &= allChannelsMask;
+    if (channelsReadyMask == 0)
+    {
+        return debugPortChannel_numChannels;
+    }
+
+    /**
+     * Every ready channel can owe bytes (up to a packet), in which case whole rounds would go by with no channel
+     * able to send.  Skip them, by giving each ready channel the quanta for those rounds.
+     */
+    uint32_t numRoundsToSkip = UINT32_MAX;
+    for (uint32_t channel = 0; channel < debugPortChannel_numChannels; ++channel)
+    {
+        if ((channelsReadyMask & (1 << channel)) != 0)
+        {
+            uint32_t numRoundsUntilCanSend = (m_deficitNumBytes[channel] > 0) ? 0 :
+                                             ((uint32_t) -m_deficitNumBytes[channel] / m_quantumNumBytes[channel]);
+            numRoundsToSkip = MIN(numRoundsToSkip, numRoundsUntilCanSend);
+        }
+    }
+    for (uint32_t channel = 0; channel < debugPortChannel_numChannels; ++channel)
+    {
+        if ((channelsReadyMask & (1 << channel)) != 0)
+        {
+            m_deficitNumBytes[channel] += (int32_t) (numRoundsToSkip * m_quantumNumBytes[channel]);
+        }
+    }
+
+    // A channel keeps its turn while it has packets ready and bytes left to send, then the turn moves on
+    while (true)
+    {
+        if ((channelsReadyMask & (1 << m_currentChannel)) == 0)
+        {
+            // Idle channels don't save up bytes (but still owe what they overdrew)
+            m_deficitNumBytes[m_currentChannel] = MIN(m_deficitNumBytes[m_currentChannel], 0);
+        }
+        else if (m_deficitNumBytes[m_currentChannel] > 0)
+        {
+            return m_currentChannel;
+        }
+
+        m_currentChannel = (m_currentChannel + 1) % debugPortChannel_numChannels;
+        if ((channelsReadyMask & (1 << m_currentChannel)) != 0)
+        {
+            m_deficitNumBytes[m_currentChannel] += (int32_t) m_quantumNumBytes[m_currentChannel];
+        }
+    }
+}
+
+void DebugPortChannelScheduler::channelSent(uint32_t channel, uint32_t numBytes)
+{
+    if (channel >= debugPortChannel_numChannels)
+    {
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Invalid debug port channel={:d}", channel, 0, 0);
+        return;
+    }
+
+    m_deficitNumBytes[channel] -= (int32_t) numBytes;
+}
@@ -0,0 +1,101 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __DEBUG_PORT_CHANNEL_SCHEDULER_H
+#define __DEBUG_PORT_CHANNEL_SCHEDULER_H
+#include "cefContract.hpp"
+
+/**
+ * Default number of bytes each channel may send per scheduling round.  When several channels have packets
+ * ready, each gets a share of the debug port bandwidth of its quantum / the sum of the quanta of the ready channels.
+ */
+#ifndef DEBUG_PORT_CHANNEL_QUANTUM_COMMANDS
+    #define DEBUG_PORT_CHANNEL_QUANTUM_COMMANDS DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+#endif
+#ifndef DEBUG_PORT_CHANNEL_QUANTUM_LOGS
+    #define DEBUG_PORT_CHANNEL_QUANTUM_LOGS DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+#endif
+#ifndef DEBUG_PORT_CHANNEL_QUANTUM_TELEMETRY
+    #define DEBUG_PORT_CHANNEL_QUANTUM_TELEMETRY DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+#endif
+#ifndef DEBUG_PORT_CHANNEL_QUANTUM_BULK_TRANSFER
+    #define DEBUG_PORT_CHANNEL_QUANTUM_BULK_TRANSFER (DEBUG_PORT_MAX_APPLICATION_PAYLOAD / 2)
+#endif
+#ifndef DEBUG_PORT_CHANNEL_QUANTUM_EVENTS
+    #define DEBUG_PORT_CHANNEL_QUANTUM_EVENTS DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+#endif
+
+/**
+ * Decides which debug port channel (see debugPortChannel_t) sends the next packet, using deficit round robin.
+ *
+ * The channels take turns.  On its turn a channel with a packet ready is given its quantum of bytes, and keeps
+ * sending packets until it has sent at least that many (or runs out of packets).  A channel that sends more than
+ * its quantum (packets are not split) owes the difference on its next turn, and a channel with nothing to send
+ * doesn't save up bytes for later.  So every ready channel is guaranteed its share of the bandwidth, no matter
+ * how much the other channels have to send.
+ */
+class DebugPortChannelScheduler {
+public:
+	//! Constructor.
+	DebugPortChannelScheduler();
+
+   /**
+    * Sets the number of bytes a channel may send per scheduling round (i.e. its share of the bandwidth)
+    *
+    * @param channel          debugPortChannel_t to configure
+    * @param quantumNumBytes  number of bytes per round (at least 1)
+    */
+   void setChannelQuantum(uint32_t channel, uint32_t quantumNumBytes);
+
+   /**
+    * Gets the number of bytes a channel may send per scheduling round
+    *
+    * @param channel  debugPortChannel_t
+    *
+    * @return number of bytes per round
+    */
+   uint32_t getChannelQuantum(uint32_t channel);
+
+   /**
+    * Picks the channel to send the next packet.  The caller must report what the channel sent
+    * with channelSent().
+    *
+    * @param channelsReadyMask  bit (1 << channel) set for each channel with a packet ready to send
+    *
+    * @return channel to send the next packet, debugPortChannel_numChannels if no channel is ready
+    */
+   uint32_t selectChannel(uint32_t channelsReadyMask);
+
+   /**
+    * Charges a channel for the bytes it sent
+    *
+    * @param channel   debugPortChannel_t that sent
+    * @param numBytes  number of bytes sent
+    */
+   void channelSent(uint32_t channel, uint32_t numBytes);
+
+private:
+   //! Number of bytes each channel may send per round
+   uint32_t m_quantumNumBytes[debugPortChannel_numChannels];
+
+   //! Number of bytes each channel may still send this round (negative when it sent more than its quantum)
+   int32_t m_deficitNumBytes[debugPortChannel_numChannels];
+
+   //! Channel whose turn it is
+   uint32_t m_currentChannel;
+};
+
+#endif  // end header guard
@@ -0,0 +1,41 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+/**
+ * Implementation of DebugPortChannelSource functions
+ * Note:  Pure virtual functions can cause the compiler/linker to pull in
+ * an excess amount of code.  So, pure virtual functions should be implemented to
+ * fail at run time instead (not ideal, but the least bad option).
+ */
+
+#include "DebugPortChannelSource.hpp"
+#include "Logging.hpp"
+
+
+bool DebugPortChannelSource::hasDataToSend(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortChannelSource::hasDataToSend() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return false;
+}
+
+uint32_t DebugPortChannelSource::fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortChannelSource::fillTransmitPayload() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return 0;
+}
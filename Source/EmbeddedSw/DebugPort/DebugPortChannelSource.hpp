@@ -0,0 +1,53 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __DEBUG_PORT_CHANNEL_SOURCE_H
+#define __DEBUG_PORT_CHANNEL_SOURCE_H
+#include "cefContract.hpp"
+
+/**
+ * Base class for the source of the packets sent on a debug port channel (see debugPortChannel_t).
+ * The source is registered with the CommandDebugPortRouter, which asks the source for a packet
+ * whenever the channel scheduler gives the channel its turn to transmit.
+ * The router itself is the source of the commands and logs channels.
+ */
+class DebugPortChannelSource {
+public:
+	//! Constructor.
+	DebugPortChannelSource() {}
+
+   /**
+    * Returns if the source has a packet ready to send.  Only channels with a packet ready are
+    * given a turn to transmit (and a share of the bandwidth).
+    *
+    * @return true if a packet is ready to send
+    */
+   virtual bool hasDataToSend(void);
+
+   /**
+    * Fills in the payload of the next packet to send on the channel.
+    * The payload is copied out of the source, so the source is free to re-use its memory on return.
+    *
+    * @param p_payload      where to put the payload
+    * @param maxNumBytes    maximum number of bytes that fit in p_payload
+    * @param debugDataType  packet type of the payload (returned as a reference)
+    *
+    * @return number of bytes in the payload (0 if there is nothing to send)
+    */
+   virtual uint32_t fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType);
+};
+
+#endif  // end header guard
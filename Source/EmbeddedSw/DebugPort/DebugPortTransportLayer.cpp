@@ -33,173 +33,543 @@ uint32_t DebugPortTransportLayer::calculateChecksum(void* p_byteArray, uint32_t
 	return myChecksum;
 }
 
-void DebugPortTransportLayer::generatePacketHeader()
+uint32_t DebugPortTransportLayer::copyAndCalculateChecksum(void* p_destination, const void* p_source, uint32_t numBytes)
 {
-    uint32_t numBytesInPayload = mp_transmitPayload->getNumberOfValidBytes();
-    void* p_payload = mp_transmitPayload->getBufferStartAddress();
+	uint32_t myChecksum = 0;
+	const unsigned char* p_read = (const unsigned char *)p_source;
+	unsigned char* p_write = (unsigned char *)p_destination;
+	for (uint32_t i=0; i<numBytes; i++)
+	{
+		p_write[i] = p_read[i];
+		myChecksum += p_read[i];
+	}
+	return myChecksum;
+}
+
+void DebugPortTransportLayer::generatePacketHeader(transmitPacket_t& transmitPacket, debugPacketDataType_t debugDataType)
+{
+    uint32_t numBytesInPayload = transmitPacket.numDataBytes;
+    cefCommandDebugPortHeader_t& header = transmitPacket.header;
 
 	// GENERATE HEADER
     for (uint32_t i = 0 ; i < numElementsInDebugPacketFramingSignature; ++i)
     {
-        m_transmitPacketHeader.m_framingSignature[i] = debugPacketFramingSignature[i];
+        header.m_framingSignature[i] = debugPacketFramingSignature[i];
     }
 
-    m_transmitPacketHeader.m_packetPayloadChecksum = calculateChecksum(p_payload, numBytesInPayload);
+    header.m_packetPayloadChecksum = transmitPacket.dataChecksum;
 
-    m_transmitPacketHeader.m_payloadSize = numBytesInPayload;
+    header.m_payloadSize = numBytesInPayload;
 
-    m_transmitPacketHeader.m_packetType = m_transmitDebugDataType;
+    header.m_packetType = debugDataType;
 
-	//0 for checksum
-    m_transmitPacketHeader.m_reserve = 0;
+    // Let the host know how much room there is (see "Flow Control Credits" in cefContract.hpp)
+    header.m_flowControlCredits = CommandDebugPortRouter::instance().advertiseFlowControlCredits();
 
 	//0 to calculate checksum
-    m_transmitPacketHeader.m_packetHeaderChecksum = 0;
+    header.m_packetHeaderChecksum = 0;
 
 	//Calculate checksum
-    m_transmitPacketHeader.m_packetHeaderChecksum = calculateChecksum(&m_transmitPacketHeader, sizeof(m_transmitPacketHeader));
+    header.m_packetHeaderChecksum = calculateChecksum(&header, sizeof(header));
+}
+
+bool DebugPortTransportLayer::checkPacketHeaderChecksum(cefCommandDebugPortHeader_t* p_header)
+{
+	uint32_t headerCheck = calculateChecksum(p_header, (sizeof(cefCommandDebugPortHeader_t)-sizeof(cefCommandDebugPortHeader_t::m_packetHeaderChecksum)));
+	uint16_t packetHeaderChecksum = p_header->m_packetHeaderChecksum;
+	if(headerCheck != packetHeaderChecksum)
+	{
+		//Checksum header does not match
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer Header Checksum does not match. actual=0x{:x}, expected=0x{:x}",
+		        headerCheck, packetHeaderChecksum, 0);
+		m_receiveErrorStatus = errorCode_debugPortTransportPacketHeaderChecksumMismatch;
+		return false;
+	}
+	return true;
+}
+
+uint16_t DebugPortTransportLayer::receiveCobsFrame(void)
+{
+	uint32_t numFrameBytes = mp_debugPortDriver->getReceivedFrameNumBytes();
+	if(numFrameBytes == 0)
+	{
+		// Complete frame not received yet
+		return stateRecvWaitForPacketHeader;
+	}
+
+	/**
+	 * The driver only hands over complete frames, so a corrupted frame costs just that frame; the next
+	 * frame starts right after the delimiter, without having to search for the framing signature.
+	 */
+	uint8_t* p_frame = (uint8_t*)myReceiveCefBuffer.getBufferStartAddress();
+	uint32_t numDecodedBytes = 0;
+	if(Cobs::decode(p_frame, numFrameBytes, numDecodedBytes) == false)
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer invalid COBS frame. numBytes={:d}",
+		        numFrameBytes, 0, 0);
+		m_receiveErrorStatus = errorCode_debugPortTransportFramingError;
+		return stateReceiveFinished;
+	}
+
+	cefCommandDebugPortHeader_t* p_header = (cefCommandDebugPortHeader_t*)p_frame;
+	if(numDecodedBytes < sizeof(cefCommandDebugPortHeader_t))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer COBS frame too short for a packet header. numBytes={:d}",
+		        numDecodedBytes, 0, 0);
+		m_receiveErrorStatus = errorCode_debugPortTransportFramingError;
+		return stateReceiveFinished;
+	}
+
+	if(checkPacketHeaderChecksum(p_header) == false)
+	{
+		return stateReceiveFinished;
+	}
+
+	m_expectedNumBytesInReceivePacket = p_header->m_payloadSize + sizeof(cefCommandDebugPortHeader_t);
+	if(numDecodedBytes != m_expectedNumBytesInReceivePacket)
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer COBS frame size does not match packet. actual={:d}, expected={:d}",
+		        numDecodedBytes, m_expectedNumBytesInReceivePacket, 0);
+		m_receiveErrorStatus = errorCode_debugPortTransportFramingError;
+		return stateReceiveFinished;
+	}
+	return stateRecvFinishedRecv;
+}
+
+errorCode_t DebugPortTransportLayer::copyReceivedCommand(const uint8_t* p_payload, uint32_t numBytesInPayload)
+{
+    if (numBytesInPayload > mp_commandReceiveCefBuffer->getMaxBufferSizeInBytes())
+    {
+        // The checked out buffer is not big enough to accept the command!
+        LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer checked out buffer to small for payload.  Actual={%d), Received={%d}",
+                numBytesInPayload, mp_commandReceiveCefBuffer->getMaxBufferSizeInBytes(), 0);
+        return errorCode_debugPortTransportBufferNotBigEnoughForPayload;
+    }
+    //! Update how many valid bytes are in the buffer
+    mp_commandReceiveCefBuffer->setNumberOfValidBytes(numBytesInPayload);
+
+    memcpy(mp_commandReceiveCefBuffer->getBufferStartAddress(), p_payload, numBytesInPayload);
+    return errorCode_OK;
+}
+
+void DebugPortTransportLayer::startDriverReceive(void)
+{
+    if (mp_errorCallbackDebugPortDriver != mp_debugPortDriver)
+    {
+        mp_debugPortDriver->setErrorCallback();
+        mp_errorCallbackDebugPortDriver = mp_debugPortDriver;
+    }
+
+    m_numBytesReceivedAtLastCheck = 0;
+    mp_debugPortDriver->startReceive(myReceiveCefBuffer.getBufferStartAddress(),
+                                      myReceiveCefBuffer.getMaxBufferSizeInBytes());
+}
+
+bool DebugPortTransportLayer::checkReceiveTimeout(void)
+{
+    /**
+     * Waiting for a packet to start never times out.  Once bytes of a packet have been received (the framing
+     * signature search or a COBS frame has started), the packet has to keep arriving, or it is dropped so the
+     * host's next packet is received (without it, the receive would wait for the rest of the packet forever).
+     */
+    uint32_t tickMs = ShimBase::getInstance().getTickMs();
+    uint32_t numBytesReceived = mp_debugPortDriver->getCurrentBytesReceived();
+    if (numBytesReceived != m_numBytesReceivedAtLastCheck)
+    {
+        if (m_numBytesReceivedAtLastCheck == 0)
+        {
+            m_receivePacketStartTickMs = tickMs;
+        }
+        m_receiveProgressTickMs = tickMs;
+        m_numBytesReceivedAtLastCheck = numBytesReceived;
+    }
+
+    if (numBytesReceived == 0)
+    {
+        return false;
+    }
+
+    bool interByteTimeout = (DEBUG_PORT_RECEIVE_INTER_BYTE_TIMEOUT_MS != 0) &&
+            ((tickMs - m_receiveProgressTickMs) >= DEBUG_PORT_RECEIVE_INTER_BYTE_TIMEOUT_MS);
+    bool packetTimeout = (DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS != 0) &&
+            ((tickMs - m_receivePacketStartTickMs) >= DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS);
+    if ((interByteTimeout == false) && (packetTimeout == false))
+    {
+        return false;
+    }
+
+    mp_debugPortDriver->stopReceive();
+    ++m_numReceiveTimeouts;
+    LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer receive timed out. numBytesReceived={:d}, msSinceLastByte={:d}, msSincePacketStart={:d}",
+            numBytesReceived, tickMs - m_receiveProgressTickMs, tickMs - m_receivePacketStartTickMs);
+    m_receiveErrorStatus = errorCode_debugPortTransportReceiveTimeout;
+    return true;
+}
+
+bool DebugPortTransportLayer::checkReceiveError(void)
+{
+    errorCode_t receiveError = mp_debugPortDriver->getReceiveError();
+    if (receiveError == errorCode_OK)
+    {
+        return false;
+    }
+
+    /**
+     * Bytes were lost or corrupted (the driver has counted the error).  If a packet had started, it can't be trusted,
+     * so it is dropped like a corrupted packet.  The next receive resynchronizes on the next packet.
+     */
+    mp_debugPortDriver->stopReceive();
+    uint32_t numBytesReceived = mp_debugPortDriver->getCurrentBytesReceived();
+    if (numBytesReceived == 0)
+    {
+        // No packet had started (e.g. noise on an idle line), nothing to drop
+        startDriverReceive();
+        return false;
+    }
+
+    ++m_numReceiveErrorPacketsDropped;
+    LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer receive error, packet dropped. error={:d}, numBytesReceived={:d}",
+            receiveError, numBytesReceived, 0);
+    m_receiveErrorStatus = receiveError;
+    return true;
+}
+
+void DebugPortTransportLayer::checkTransmitTimeout(void)
+{
+    uint32_t tickMs = ShimBase::getInstance().getTickMs();
+    if ((DEBUG_PORT_TRANSMIT_TIMEOUT_MS == 0) || ((tickMs - m_transmitProgressTickMs) < DEBUG_PORT_TRANSMIT_TIMEOUT_MS))
+    {
+        return;
+    }
+
+    /**
+     * The driver stopped finishing sends (e.g. a lost transmit complete interrupt, or a host that stopped reading).
+     * Everything queued to it is abandoned, so the packets are checked in from the next pass on and the debug port
+     * keeps going, rather than the transmit state machine waiting for them until reboot.
+     */
+    mp_debugPortDriver->abortSends();
+    ++m_numTransmitTimeouts;
+    m_transmitProgressTickMs = tickMs;
+    LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer transmit timed out. numPacketsInFlight={:d}",
+            m_numTransmitPacketsQueued - m_numTransmitPacketsFinished, 0, 0);
 }
 
 uint16_t DebugPortTransportLayer::receivePacketHeader() //receive = request
 {
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+	return receiveCobsFrame();
+#else
     cefCommandDebugPortHeader_t* p_header = (cefCommandDebugPortHeader_t*)myReceiveCefBuffer.getBufferStartAddress();
 
 	//Check to see if we have received enough bytes for a full packet header
 	uint32_t headerSizeInBytes = sizeof(cefCommandDebugPortHeader_t);
-	if(m_myDebugPortDriver.getCurrentBytesReceived() >= headerSizeInBytes)
+	if(mp_debugPortDriver->getCurrentBytesReceived() >= headerSizeInBytes)
 	{
 		//Check to see if Checksum header matches
-		uint32_t headerCheck = calculateChecksum(p_header, (sizeof(cefCommandDebugPortHeader_t)-sizeof(cefCommandDebugPortHeader_t::m_packetHeaderChecksum)));
-		uint16_t packetHeaderChecksum = p_header->m_packetHeaderChecksum;
-		if(headerCheck != packetHeaderChecksum)
+		if(checkPacketHeaderChecksum(p_header) == false)
+		{
+			return stateReceiveFinished;
+		}
+		// The header passed its checksum, but the payload still has to fit in the receive buffer
+		if(p_header->m_payloadSize > (myReceiveCefBuffer.getMaxBufferSizeInBytes() - headerSizeInBytes))
 		{
-			//Checksum header does not match
-			LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer Header Checksum does not match. actual=0x{:x}, expected=0x{:x}",
-			        headerCheck, packetHeaderChecksum, 0);
-			m_receiveErrorStatus = errorCode_debugPortTransportPacketHeaderChecksumMismatch;
+			LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer receive buffer too small for payload.  Actual={:d}, Received={:d}",
+			        myReceiveCefBuffer.getMaxBufferSizeInBytes() - headerSizeInBytes, p_header->m_payloadSize, 0);
+			m_receiveErrorStatus = errorCode_debugPortTransportBufferNotBigEnoughForPayload;
 			return stateReceiveFinished;
 		}
+
 		//Get/Set packet size (header + packet)
 		m_expectedNumBytesInReceivePacket = p_header->m_payloadSize + sizeof(cefCommandDebugPortHeader_t);
-		m_myDebugPortDriver.editReceiveSize(m_expectedNumBytesInReceivePacket);
+		mp_debugPortDriver->editReceiveSize(m_expectedNumBytesInReceivePacket);
 		return stateRecvWaitForCefPacket;
 	}
 	return stateRecvWaitForPacketHeader;
+#endif
 }
 
 void DebugPortTransportLayer::transmitStateMachine(void) //transmit = cefResponse 
 {
+    STATIC_ASSERT((DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT & (DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT - 1)) == 0,
+            transmit_packets_in_flight_must_be_a_power_of_2);
+    STATIC_ASSERT((2 * DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT) <= SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS,
+            driver_must_be_able_to_queue_a_header_and_payload_for_each_packet_in_flight);
+#if defined(__SIMULATOR__) && (DEBUG_PORT_DRIVER == DEBUG_PORT_DRIVER_SHARED_MEMORY)
+    STATIC_ASSERT((2 * DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT) <= SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS,
+            shared_memory_driver_must_be_able_to_queue_a_header_and_payload_for_each_packet_in_flight);
+#endif
+
     /**
+     * The header and payload of a packet are queued to the driver together, and the driver starts each
+     * send from the transmit complete interrupt of the previous one.  So there is no gap between a header
+     * and its payload, and while one packet is being sent the next one is queued behind it, keeping the
+     * debug port busy without waiting for this state machine to poll for completion.
+     *
      * To make sure the transport layer doesn't consume more than it's fair share of the
-     * processor resources, only one state is executed each time through the loop.  This
-     * is probably way conservative, but it avoids having to know how much work is going
-     * on in each state.
+     * processor resources, at most one packet is checked in and one packet queued each time through the loop.
      */
 
-	switch (m_transmitState)
-	{
-        case stateXmitWaitingForBuffer:
+    // Check in the oldest packet once it has been sent
+    if (m_numTransmitPacketsFinished != m_numTransmitPacketsQueued)
+    {
+        transmitPacket_t& oldestPacket = m_transmitPackets[m_numTransmitPacketsFinished & (DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT - 1)];
+
+        // The send counts wrap, so compare the signed difference
+        if ((int32_t) (mp_debugPortDriver->getNumSendsCompleted() - oldestPacket.sendCountWhenSent) >= 0)
         {
-            mp_transmitPayload = CommandDebugPortRouter::instance().checkoutCefTransmitBuffer(m_transmitDebugDataType);
-            if(mp_transmitPayload == nullptr)
+            if (oldestPacket.p_payload != nullptr)
             {
-                //If buffer is not ready leave state machine don't block
-                break;
+                CommandDebugPortRouter::instance().checkinCefTransmitBuffer(oldestPacket.p_payload);
             }
-
-            //When buffer is ready generate packet header
-            m_transmitState = stateXmitGeneratePacketHeader;
-            break;
+            oldestPacket.p_payload = nullptr;
+            ++m_numTransmitPacketsFinished;
+            m_transmitProgressTickMs = ShimBase::getInstance().getTickMs();
         }
-
-        case stateXmitGeneratePacketHeader:
+        else
         {
-            generatePacketHeader();
-            m_transmitState = stateXmitStartHeaderTransmit;
-            break;
+            checkTransmitTimeout();
         }
+    }
 
-        case stateXmitStartHeaderTransmit:
-        {
-            bool sendDataStartedSuccessfully = m_myDebugPortDriver.sendData(
-                    &m_transmitPacketHeader,
-                    sizeof(m_transmitPacketHeader));
-            if (sendDataStartedSuccessfully == false)
-            {
-                /**
-                 * We should be able to setup to send data successfully per design.
-                 * Eventually we may want to make
-                 * some time of error recovery, but for now we should deal with the error
-                 * as we likely have some type of logic error.*/
-                LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Failed to start sendData in DebugTransportLayer Transmit State Machine.",
-                        m_transmitState, 0, 0);
-            }
+    // Queue the next packet if there is room for it
+    if ((m_numTransmitPacketsQueued - m_numTransmitPacketsFinished) >= DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT)
+    {
+        return;
+    }
 
-            m_transmitState = stateXmitWaitForHeaderToTransmit;
-            break;
-        }
+    debugPacketDataType_t debugDataType = debugPacketType_invalid;
+    transmitPacket_t& packet = m_transmitPackets[m_numTransmitPacketsQueued & (DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT - 1)];
+
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+    retransmitSlot_t* p_slot = nullptr;
+    if (prepareReliableTransmitPacket(packet, debugDataType, p_slot) == false)
+    {
+        return;
+    }
 
-        case stateXmitWaitForHeaderToTransmit:
+    queueTransmitPacket(packet, debugDataType);
+    if (p_slot != nullptr)
+    {
+        p_slot->sendCountWhenSent = packet.sendCountWhenSent;
+    }
+#else
+    CefBuffer* p_transmitPayload = CommandDebugPortRouter::instance().checkoutCefTransmitBuffer(debugDataType);
+    if (p_transmitPayload == nullptr)
+    {
+        //If buffer is not ready leave state machine don't block
+        return;
+    }
+
+    packet.p_payload = p_transmitPayload;
+    packet.p_data = p_transmitPayload->getBufferStartAddress();
+    packet.numDataBytes = p_transmitPayload->getNumberOfValidBytes();
+    packet.dataChecksum = calculateChecksum(packet.p_data, packet.numDataBytes);
+    queueTransmitPacket(packet, debugDataType);
+#endif
+}
+
+void DebugPortTransportLayer::queueTransmitPacket(transmitPacket_t& packet, debugPacketDataType_t debugDataType)
+{
+    generatePacketHeader(packet, debugDataType);
+
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+    // The header and payload are encoded into a single frame, sent with a single send
+    m_cobsEncoder.startFrame(&packet.frame[0]);
+    m_cobsEncoder.encode(&packet.header, sizeof(packet.header));
+    m_cobsEncoder.encode(packet.p_data, packet.numDataBytes);
+    uint32_t numFrameBytes = m_cobsEncoder.finishFrame();
+    bool sendDataStartedSuccessfully = mp_debugPortDriver->sendData(&packet.frame[0], numFrameBytes);
+#else
+    bool sendDataStartedSuccessfully = mp_debugPortDriver->sendData(&packet.header, sizeof(packet.header));
+    if (sendDataStartedSuccessfully == true)
+    {
+        sendDataStartedSuccessfully = mp_debugPortDriver->sendData(packet.p_data, packet.numDataBytes);
+    }
+#endif
+    if (sendDataStartedSuccessfully == false)
+    {
+        /**
+         * We should be able to setup to send data successfully per design, as the driver can queue
+         * the sends for every packet in flight.  Eventually we may want to make
+         * some time of error recovery, but for now we should deal with the error
+         * as we likely have some type of logic error.*/
+        LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Failed to start sendData in DebugTransportLayer Transmit State Machine.",
+                m_numTransmitPacketsQueued, m_numTransmitPacketsFinished, 0);
+    }
+
+    packet.sendCountWhenSent = mp_debugPortDriver->getNumSendsQueued();
+    if (m_numTransmitPacketsQueued == m_numTransmitPacketsFinished)
+    {
+        // Nothing was being sent, so the transmit timeout starts now
+        m_transmitProgressTickMs = ShimBase::getInstance().getTickMs();
+    }
+    ++m_numTransmitPacketsQueued;
+}
+
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+bool DebugPortTransportLayer::prepareReliableTransmitPacket(transmitPacket_t& packet, debugPacketDataType_t& debugDataType,
+                                                            retransmitSlot_t*& p_slot)
+{
+    uint32_t tickMs = ShimBase::getInstance().getTickMs();
+    uint32_t numSendsCompleted = mp_debugPortDriver->getNumSendsCompleted();
+    uint8_t numUnacked = (uint8_t) (m_nextTransmitSequenceNumber - m_oldestUnackedSequenceNumber);
+    p_slot = nullptr;
+
+    /**
+     * A packet still queued to the driver is not sent again (the host gets it anyway), and its retransmit
+     * slot is not reused until it has been sent.
+     */
+    if (m_retransmitRequested == true)
+    {
+        m_retransmitRequested = false;
+        retransmitSlot_t& slot = m_retransmitSlots[m_retransmitSequenceNumber & (DEBUG_PORT_RELIABLE_WINDOW_SIZE - 1)];
+        if (((uint8_t) (m_retransmitSequenceNumber - m_oldestUnackedSequenceNumber) < numUnacked) &&
+            ((int32_t) (numSendsCompleted - slot.sendCountWhenSent) >= 0))
         {
-            //check if sending is finished
-            if(m_myDebugPortDriver.getSendInProgress())
-            {
-                //Sending not finished leave state machine
-                //TODO make a timeout if it takes to long
-                break;
-            }
-            //sending finished
-            m_transmitState = stateXmitStartPayloadTransmit;
-            break;
+            p_slot = &slot;
         }
+    }
 
-        case stateXmitStartPayloadTransmit:
+    if ((p_slot == nullptr) && (numUnacked > 0))
+    {
+        retransmitSlot_t& slot = m_retransmitSlots[m_oldestUnackedSequenceNumber & (DEBUG_PORT_RELIABLE_WINDOW_SIZE - 1)];
+        if (((tickMs - slot.lastSendTickMs) >= DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS) &&
+            ((int32_t) (numSendsCompleted - slot.sendCountWhenSent) >= 0))
         {
-            bool sendDataStartedSuccessfully = m_myDebugPortDriver.sendData(
-                    mp_transmitPayload->getBufferStartAddress(),
-                    mp_transmitPayload->getNumberOfValidBytes());
-            if (sendDataStartedSuccessfully == false)
-            {
-                /**
-                 * We should be able to setup to send data successfully as we just finished checking
-                 * that we were done sending the last packet.  Eventually we may want to make
-                 * some time of error recovery, but for now we should deal with the error
-                 * as we likely have some type of logic error.*/
-                LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Failed to start sendData in DebugTransportLayer Transmit State Machine.",
-                        m_transmitState, 0, 0);
-            }
-            m_transmitState = stateXmitWaitForPayloadToTransmit;
-            break;
+            p_slot = &slot;
         }
+    }
 
-        case stateXmitWaitForPayloadToTransmit:
+    if ((p_slot == nullptr) && (numUnacked < DEBUG_PORT_RELIABLE_WINDOW_SIZE))
+    {
+        retransmitSlot_t& slot = m_retransmitSlots[m_nextTransmitSequenceNumber & (DEBUG_PORT_RELIABLE_WINDOW_SIZE - 1)];
+        if ((int32_t) (numSendsCompleted - slot.sendCountWhenSent) >= 0)
         {
-            //check if sending is finished
-            if(m_myDebugPortDriver.getSendInProgress())
+            CefBuffer* p_transmitPayload = CommandDebugPortRouter::instance().checkoutCefTransmitBuffer(debugDataType);
+            if (p_transmitPayload != nullptr)
             {
-                //Sending not finished leave state machine
-                //TODO make a timeout if it takes to long
-                break;
+                /**
+                 * The payload is copied for retransmission, so the router gets its buffer back right away.  Its checksum
+                 * is added up while copying, and kept for retransmissions (only the reliable header changes).
+                 */
+                uint32_t numBytesInPayload = p_transmitPayload->getNumberOfValidBytes();
+                slot.payloadChecksum = copyAndCalculateChecksum(&slot.data[sizeof(cefReliableHeader_t)],
+                                                                p_transmitPayload->getBufferStartAddress(), numBytesInPayload);
+                CommandDebugPortRouter::instance().checkinCefTransmitBuffer(p_transmitPayload);
+
+                cefReliableHeader_t* p_reliableHeader = (cefReliableHeader_t*) &slot.data[0];
+                p_reliableHeader->m_sequenceNumber = m_nextTransmitSequenceNumber;
+                p_reliableHeader->m_flags = 0;
+                if ((m_transmitSynchronized == false) && (m_nextTransmitSequenceNumber == 0))
+                {
+                    p_reliableHeader->m_flags = DEBUG_PORT_RELIABLE_FLAG_SYNC;
+                }
+                p_reliableHeader->m_padding1 = 0;
+                slot.numDataBytes = sizeof(cefReliableHeader_t) + numBytesInPayload;
+                slot.packetType = debugDataType;
+                ++m_nextTransmitSequenceNumber;
+                p_slot = &slot;
             }
-            //sending finished
-            m_transmitState = stateXmitFinishedSendingPacket;
-            break;
         }
+    }
+
+    if (p_slot != nullptr)
+    {
+        fillInReliableAcks(*(cefReliableHeader_t*) &p_slot->data[0]);
+        p_slot->lastSendTickMs = tickMs;
+        packet.p_payload = nullptr;
+        packet.p_data = &p_slot->data[0];
+        packet.numDataBytes = p_slot->numDataBytes;
+        packet.dataChecksum = calculateChecksum(&p_slot->data[0], sizeof(cefReliableHeader_t)) + p_slot->payloadChecksum;
+        debugDataType = p_slot->packetType;
+        return true;
+    }
+
+    if ((m_ackPending == true) || (m_nackPending == true))
+    {
+        packet.ackPayload.m_sequenceNumber = 0;
+        packet.ackPayload.m_padding1 = 0;
+        packet.ackPayload.m_flags = 0;
+        fillInReliableAcks(packet.ackPayload);
+        packet.p_payload = nullptr;
+        packet.p_data = &packet.ackPayload;
+        packet.numDataBytes = sizeof(packet.ackPayload);
+        packet.dataChecksum = calculateChecksum(&packet.ackPayload, sizeof(packet.ackPayload));
+        debugDataType = debugPacketType_ack;
+        return true;
+    }
 
-	case stateXmitFinishedSendingPacket:
+    return false;
+}
+
+void DebugPortTransportLayer::fillInReliableAcks(cefReliableHeader_t& reliableHeader)
+{
+    reliableHeader.m_ackSequenceNumber = m_nextReceiveSequenceNumber;
+    reliableHeader.m_nackSequenceNumber = m_nextReceiveSequenceNumber;
+    reliableHeader.m_flags &= ~DEBUG_PORT_RELIABLE_FLAG_NACK;
+    if (m_nackPending == true)
+    {
+        reliableHeader.m_flags |= DEBUG_PORT_RELIABLE_FLAG_NACK;
+    }
+
+    // Every packet tells the host what has been received
+    m_ackPending = false;
+    m_nackPending = false;
+}
+
+void DebugPortTransportLayer::processReliableAcks(const cefReliableHeader_t& reliableHeader)
+{
+    // Acks are cumulative; one for a packet that isn't outstanding is from before a restart, so is ignored
+    uint8_t numUnacked = (uint8_t) (m_nextTransmitSequenceNumber - m_oldestUnackedSequenceNumber);
+    uint8_t numAcked = (uint8_t) (reliableHeader.m_ackSequenceNumber - m_oldestUnackedSequenceNumber);
+    if ((numAcked > 0) && (numAcked <= numUnacked))
+    {
+        m_oldestUnackedSequenceNumber = reliableHeader.m_ackSequenceNumber;
+        m_transmitSynchronized = true;
+    }
+
+    if ((reliableHeader.m_flags & DEBUG_PORT_RELIABLE_FLAG_NACK) != 0)
+    {
+        m_retransmitRequested = true;
+        m_retransmitSequenceNumber = reliableHeader.m_nackSequenceNumber;
+    }
+}
+
+bool DebugPortTransportLayer::acceptReliablePacket(const cefReliableHeader_t& reliableHeader, uint8_t packetType)
+{
+    if (packetType == debugPacketType_ack)
+    {
+        return false;
+    }
+
+    // A packet the host sent again, because it didn't get the ack, is one of the last window's worth received
+    uint8_t numBehind = (uint8_t) (m_nextReceiveSequenceNumber - reliableHeader.m_sequenceNumber - 1);
+    bool duplicate = (numBehind < DEBUG_PORT_RELIABLE_WINDOW_SIZE);
+
+    if (((reliableHeader.m_flags & DEBUG_PORT_RELIABLE_FLAG_SYNC) != 0) && (duplicate == false))
+    {
+        // The host has (re)started, start expecting its sequence numbers
+        m_nextReceiveSequenceNumber = reliableHeader.m_sequenceNumber;
+    }
+
+    if (reliableHeader.m_sequenceNumber != m_nextReceiveSequenceNumber)
+    {
+        if (duplicate == true)
         {
-            CommandDebugPortRouter::instance().checkinCefTransmitBuffer(mp_transmitPayload);
-            m_transmitState = stateXmitWaitingForBuffer;
-            break;
+            m_ackPending = true;
         }
-	default:
+        else
         {
-            LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer Transmit State Machien in unknown state.",
-                    0, 0, 0);
-            break;
+            LOG_DEBUG(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer packet received out of order. received={:d}, expected={:d}",
+                    reliableHeader.m_sequenceNumber, m_nextReceiveSequenceNumber, 0);
+            m_nackPending = true;
         }
-	}
+        return false;
+    }
+
+    return true;
 }
+#endif
 
 void DebugPortTransportLayer::receiveStateMachine(void)
 {
@@ -214,6 +584,13 @@ void DebugPortTransportLayer::receiveStateMachine(void)
 	{
         case stateRecvWaitForBuffer:
         {
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+            /**
+             * With reliable delivery the transport is always receiving, so acks from the host get through while a
+             * command is being executed.  The router's buffer is checked out once a command has been received.
+             */
+            mp_commandReceiveCefBuffer = nullptr;
+#else
             // Wait until we have a buffer to receive data into
             mp_commandReceiveCefBuffer = CommandDebugPortRouter::instance().checkoutCefCommandReceiveBuffer();
 
@@ -236,11 +613,11 @@ void DebugPortTransportLayer::receiveStateMachine(void)
                 // Exit out of here and try for a buffer next time
                 break;
             }
+#endif
 
             m_receiveErrorStatus = errorCode_OK;
 
-            m_myDebugPortDriver.startReceive(myReceiveCefBuffer.getBufferStartAddress(),
-                                             myReceiveCefBuffer.getMaxBufferSizeInBytes());
+            startDriverReceive();
             m_receiveState = stateRecvWaitForPacketHeader;
 
             break;
@@ -248,14 +625,25 @@ void DebugPortTransportLayer::receiveStateMachine(void)
 
         case stateRecvWaitForPacketHeader:
         {
+            if((checkReceiveError() == true) || (checkReceiveTimeout() == true))
+            {
+                m_receiveState = stateReceiveFinished;
+                break;
+            }
             m_receiveState = receivePacketHeader();
             break;
         }
 
         case stateRecvWaitForCefPacket:
         {
+            if((checkReceiveError() == true) || (checkReceiveTimeout() == true))
+            {
+                m_receiveState = stateReceiveFinished;
+                break;
+            }
+
             // Wait until have all the bytes in the packet
-            if(m_myDebugPortDriver.getCurrentBytesReceived() < m_expectedNumBytesInReceivePacket)
+            if(mp_debugPortDriver->getCurrentBytesReceived() < m_expectedNumBytesInReceivePacket)
             {
                 break;
             }
@@ -265,11 +653,15 @@ void DebugPortTransportLayer::receiveStateMachine(void)
 
         case stateRecvFinishedRecv:
         {
-            //ensure the payload checksum matches what is expected
+            /**
+             * Ensure the payload checksum matches what is expected.  The driver adds it up as the bytes are received,
+             * so the packet doesn't have to be read through again.
+             */
             cefCommandDebugPortHeader_t* p_Header = (cefCommandDebugPortHeader_t*)myReceiveCefBuffer.getBufferStartAddress();
             uint8_t* p_payload = (uint8_t*)p_Header + sizeof(cefCommandDebugPortHeader_t);
+            uint32_t numBytesInPayload = p_Header->m_payloadSize;
 
-            uint32_t headerCheck = calculateChecksum(p_payload, p_Header->m_payloadSize);
+            uint32_t headerCheck = mp_debugPortDriver->getReceivedPayloadChecksum();
             if(headerCheck != p_Header->m_packetPayloadChecksum)
             {
                 LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer debug packet checksum does not match.  Actual=0x{:x), Expected=0x{:x}",
@@ -279,32 +671,82 @@ void DebugPortTransportLayer::receiveStateMachine(void)
                 break;
             }
 
-            /* We have a valid command, copy it into the checked out buffer if there is room */
-            uint32_t numBytesInPayload = p_Header->m_payloadSize;
-            if (numBytesInPayload > mp_commandReceiveCefBuffer->getMaxBufferSizeInBytes())
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+            if (numBytesInPayload < sizeof(cefReliableHeader_t))
             {
-                // The checked out buffer is not big enough to accept the command!
-                LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer checked out buffer to small for payload.  Actual={%d), Received={%d}",
-                        numBytesInPayload, mp_commandReceiveCefBuffer->getMaxBufferSizeInBytes(), 0);
-                m_receiveErrorStatus = errorCode_debugPortTransportBufferNotBigEnoughForPayload;
+                m_receiveErrorStatus = errorCode_debugPortTransportFramingError;
                 m_receiveState = stateReceiveFinished;
                 break;
             }
-            //! Update how many valid bytes are in the buffer
-            mp_commandReceiveCefBuffer->setNumberOfValidBytes(numBytesInPayload);
 
-            memcpy(mp_commandReceiveCefBuffer->getBufferStartAddress(), p_payload, numBytesInPayload);
+            // Acks are handled here, only the next data packet goes to the router
+            cefReliableHeader_t* p_reliableHeader = (cefReliableHeader_t*)p_payload;
+            processReliableAcks(*p_reliableHeader);
+            if (acceptReliablePacket(*p_reliableHeader, p_Header->m_packetType) == false)
+            {
+                m_receiveState = stateReceiveFinished;
+                break;
+            }
 
+            m_receiveState = stateRecvWaitForCommandBuffer;
+#else
+            /* We have a valid command, copy it into the checked out buffer if there is room */
+            m_receiveErrorStatus = copyReceivedCommand(p_payload, numBytesInPayload);
             m_receiveState = stateReceiveFinished;
+#endif
             break;
         }
 
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+        case stateRecvWaitForCommandBuffer:
+        {
+            /**
+             * The command waits here until the router has room for it (the host sent it before getting credit),
+             * rather than being dropped and retransmitted.  It is acknowledged once it is handed to the router.
+             */
+            mp_commandReceiveCefBuffer = CommandDebugPortRouter::instance().checkoutCefCommandReceiveBuffer();
+            if (mp_commandReceiveCefBuffer == nullptr)
+            {
+                break;
+            }
+            ++m_nextReceiveSequenceNumber;
+            m_ackPending = true;
+
+            cefCommandDebugPortHeader_t* p_Header = (cefCommandDebugPortHeader_t*)myReceiveCefBuffer.getBufferStartAddress();
+            uint8_t* p_payload = (uint8_t*)p_Header + sizeof(cefCommandDebugPortHeader_t) + sizeof(cefReliableHeader_t);
+            m_receiveErrorStatus = copyReceivedCommand(p_payload, p_Header->m_payloadSize - sizeof(cefReliableHeader_t));
+            m_receiveState = stateReceiveFinished;
+            break;
+        }
+#endif
+
         case stateReceiveFinished:
         {
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+            if (mp_commandReceiveCefBuffer != nullptr)
+            {
+                CommandDebugPortRouter::instance().checkinCefCommandReceiveBuffer(mp_commandReceiveCefBuffer, m_receiveErrorStatus);
+                mp_commandReceiveCefBuffer = nullptr;
+            }
+            else if (m_receiveErrorStatus != errorCode_OK)
+            {
+                // Nothing for the router (an ack, a duplicate, or a corrupted packet, which the host is asked to send again)
+                m_nackPending = true;
+            }
+
+            /**
+             * No router buffer is needed to receive, so the next packet is started right away.  The host may send an
+             * ack and a command back to back; the driver keeps the bytes that arrive before the receive is restarted.
+             */
+            m_receiveErrorStatus = errorCode_OK;
+            startDriverReceive();
+            m_receiveState = stateRecvWaitForPacketHeader;
+#else
             // Finished as much as we could do (we could have ran into an error) so return/checkin the buffer
             CommandDebugPortRouter::instance().checkinCefCommandReceiveBuffer(mp_commandReceiveCefBuffer, m_receiveErrorStatus);
 
             m_receiveState= stateRecvWaitForBuffer;
+#endif
             break;
         }
 
@@ -313,3 +755,37 @@ void DebugPortTransportLayer::receiveStateMachine(void)
 		break;
 	}
 }
+
+bool DebugPortTransportLayer::setDebugPortDriver(DebugPortDriver* p_debugPortDriver)
+{
+	if(p_debugPortDriver == nullptr)
+	{
+		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer debug port driver can not be null.", 0, 0, 0);
+		return false;
+	}
+
+	/**
+	 * Receiving is only started when a packet is wanted, and the sends in flight are counted by the driver they
+	 * were queued to, so the driver can only be changed while neither is going on.
+	 */
+	if((m_receiveState != stateRecvWaitForBuffer) || (m_numTransmitPacketsQueued != m_numTransmitPacketsFinished))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "DebugTransportLayer can not change debug port driver in the middle of a packet. receiveState={:d}",
+		        m_receiveState, 0, 0);
+		return false;
+	}
+
+	mp_debugPortDriver = p_debugPortDriver;
+	return true;
+}
+
+void DebugPortTransportLayer::getStats(debugPortStats_t& stats)
+{
+	for(uint32_t i = 0; i < DEBUG_PORT_DRIVER_NUM_ERROR_CLASSES; ++i)
+	{
+		stats.numReceiveErrors[i] = mp_debugPortDriver->getNumReceiveErrors((errorCode_t) (errorCode_debugPortErrorCodeNone + i));
+	}
+	stats.numReceiveErrorPacketsDropped = m_numReceiveErrorPacketsDropped;
+	stats.numReceiveTimeouts = m_numReceiveTimeouts;
+	stats.numTransmitTimeouts = m_numTransmitTimeouts;
+}
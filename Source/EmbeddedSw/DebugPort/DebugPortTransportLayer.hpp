@@ -18,7 +18,10 @@ written permission of Syncroness.
 #define __DEBUG_PORT_TRANSPORT_LAYER_H
 #include "cefContract.hpp"
 #include "SerialPortDriverHwImpl.hpp"
+#include "SocketPortDriverImpl.hpp"
+#include "SharedMemoryPortDriverImpl.hpp"
 #include "CefBuffer.hpp"
+#include "Cobs.hpp"
 
 /**
  * DebugPortTransportLayer runs a state machine for the Transmit and Receive process
@@ -36,32 +39,98 @@ written permission of Syncroness.
 
 /**
  * Only one DebugPortDriver should be instantiated.
- * Currently there is only one type of driver, but eventually there could be multiple
- * physical interfaces (serial port, ethernet, simulator...)
- *
- * For now, we just have the serial port
+ * The driver the transport layer is built with is picked with DEBUG_PORT_DRIVER (see DebugPortDriver.hpp),
+ * the serial port by default.  The simulator can instead serve the debug port on a localhost socket, or on
+ * shared memory for the highest throughput.
  */
 
+#if (DEBUG_PORT_DRIVER == DEBUG_PORT_DRIVER_SERIAL)
 typedef SerialPortDriverHwImpl MyDebugPortDriver;
+#elif defined(__SIMULATOR__) && ((DEBUG_PORT_DRIVER == DEBUG_PORT_DRIVER_TCP) || (DEBUG_PORT_DRIVER == DEBUG_PORT_DRIVER_UDP))
+typedef SocketPortDriverImpl MyDebugPortDriver;
+#elif defined(__SIMULATOR__) && (DEBUG_PORT_DRIVER == DEBUG_PORT_DRIVER_SHARED_MEMORY)
+typedef SharedMemoryPortDriverImpl MyDebugPortDriver;
+#else
+    #error "DEBUG_PORT_DRIVER is not a driver available on this platform"
+#endif
+
+/**
+ * Number of packets that can be queued to the driver at once.  With 2, the next packet is prepared and
+ * queued while the current one is sent, so the driver starts it as soon as the current one finishes.
+ */
+#ifndef DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT
+    #define DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT 2
+#endif
+
+/**
+ * Timeouts (ms, 0 to disable) that keep a glitch from stalling the debug port.  A packet that stops arriving
+ * (no byte for DEBUG_PORT_RECEIVE_INTER_BYTE_TIMEOUT_MS, or not complete DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS
+ * after its first byte) is dropped and receiving starts over.  Sends the driver has not finished
+ * DEBUG_PORT_TRANSMIT_TIMEOUT_MS after the last one finished are aborted.  The packet and transmit timeouts
+ * must allow for the biggest packet at the slowest baud rate.
+ */
+#ifndef DEBUG_PORT_RECEIVE_INTER_BYTE_TIMEOUT_MS
+    #define DEBUG_PORT_RECEIVE_INTER_BYTE_TIMEOUT_MS 100
+#endif
+#ifndef DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS
+    #define DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS 2000
+#endif
+#ifndef DEBUG_PORT_TRANSMIT_TIMEOUT_MS
+    #define DEBUG_PORT_TRANSMIT_TIMEOUT_MS 2000
+#endif
 
 
 
+//! Debug port error counts since power up (see cefCommandDebugPortStatsResponse_t)
+typedef struct
+{
+   //! Receive errors reported by the driver, indexed by error class (error code - errorCode_debugPortErrorCodeNone)
+   uint32_t numReceiveErrors[DEBUG_PORT_DRIVER_NUM_ERROR_CLASSES];
+   //! Packets dropped because of a receive error
+   uint32_t numReceiveErrorPacketsDropped;
+   //! Packets dropped because they stopped arriving
+   uint32_t numReceiveTimeouts;
+   //! Times the sends queued to the driver were aborted
+   uint32_t numTransmitTimeouts;
+} debugPortStats_t;
+
+
 class DebugPortTransportLayer {
 public:
 	//! Constructor.
 	DebugPortTransportLayer():
-        m_transmitState(stateXmitWaitingForBuffer),
-        m_receiveState(stateXmitWaitingForBuffer),
+        m_receiveState(stateRecvWaitForBuffer),
+        mp_debugPortDriver(&m_myDebugPortDriver),
         m_expectedNumBytesInReceivePacket(0),
         myReceiveCefBuffer(&myReceiveBuffer[0], NUM_ELEMENTS(myReceiveBuffer)),
         mp_commandReceiveCefBuffer(nullptr),
         m_receiveErrorStatus(errorCode_OK),
-        mp_transmitPayload(nullptr),
-        m_transmitDebugDataType(debugPacketType_invalid)
+        m_numTransmitPacketsQueued(0),
+        m_numTransmitPacketsFinished(0),
+        m_transmitProgressTickMs(0),
+        m_receivePacketStartTickMs(0),
+        m_receiveProgressTickMs(0),
+        m_numBytesReceivedAtLastCheck(0),
+        m_numReceiveTimeouts(0),
+        m_numTransmitTimeouts(0),
+        m_numReceiveErrorPacketsDropped(0),
+        mp_errorCallbackDebugPortDriver(nullptr)
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+        ,
+        m_nextTransmitSequenceNumber(0),
+        m_oldestUnackedSequenceNumber(0),
+        m_nextReceiveSequenceNumber(0),
+        m_transmitSynchronized(false),
+        m_ackPending(false),
+        m_nackPending(false),
+        m_retransmitRequested(false),
+        m_retransmitSequenceNumber(0)
+#endif
         { }
 
    /**
-    * State machine to transmit a packet.
+    * Transmits packets.  Each pass checks in the oldest packet once the driver has finished sending it,
+    * and queues the next packet (header and payload together) to the driver if there is room.
     */
    void transmitStateMachine(void);
 
@@ -70,22 +139,85 @@ public:
     */
    void receiveStateMachine(void);
 
+   /**
+    * Changes the driver the debug port runs on (by default the one it is built with, see MyDebugPortDriver),
+    * e.g. for a simulator to pick a transport at run time.  The driver can only be changed while nothing is
+    * being sent or received: before the debug port first runs, or (without DEBUG_PORT_RELIABLE_DELIVERY, which
+    * always keeps a receive going) between packets.
+    *
+    * @param p_debugPortDriver - driver to use from now on
+    *
+    * @return true if the driver was changed
+    */
+   bool setDebugPortDriver(DebugPortDriver* p_debugPortDriver);
 
-private:
    /**
-    * Transmit States Machine - See transmitStateMachine()
+    * Returns the number of packets dropped because they stopped arriving (see DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS)
+    *
+    * @return number of receive timeouts since power up
     */
-      enum
-      {
-         stateXmitWaitingForBuffer          = 0,
-         stateXmitGeneratePacketHeader      = 1,
-         stateXmitStartHeaderTransmit       = 2,
-         stateXmitWaitForHeaderToTransmit   = 3,
-         stateXmitStartPayloadTransmit      = 4,
-         stateXmitWaitForPayloadToTransmit  = 5,
-         stateXmitFinishedSendingPacket     = 6,
-      };
-      typedef uint16_t debugPortTransmitStates_t;
+   uint32_t getNumReceiveTimeouts(void) { return m_numReceiveTimeouts; }
+
+   /**
+    * Returns the number of times sends were aborted because the driver stopped finishing them
+    * (see DEBUG_PORT_TRANSMIT_TIMEOUT_MS)
+    *
+    * @return number of transmit timeouts since power up
+    */
+   uint32_t getNumTransmitTimeouts(void) { return m_numTransmitTimeouts; }
+
+   /**
+    * Gets the debug port error counts (of the driver in use, for the receive errors)
+    *
+    * @param stats - filled in with the counts
+    */
+   void getStats(debugPortStats_t& stats);
+
+
+private:
+   //! A packet queued to the driver for transmit
+   typedef struct
+   {
+      //! Buffer checked out from the router for the payload, checked back in once sent (nullptr if none)
+      CefBuffer* p_payload;
+      //! Payload sent after the Transport Header (must stay valid until the packet has been sent)
+      void* p_data;
+      //! Number of bytes in the payload
+      uint32_t numDataBytes;
+      //! Byte checksum of the payload (filled in with the payload, so it can be added up as the payload is copied)
+      uint32_t dataChecksum;
+      //! Driver send count once the packet has been sent (see DebugPortDriver::getNumSendsCompleted())
+      uint32_t sendCountWhenSent;
+      //! Packet Header (must stay valid until the packet has been sent)
+      cefCommandDebugPortHeader_t header;
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+      //! Payload of an ack packet (must stay valid until the packet has been sent)
+      cefReliableHeader_t ackPayload;
+#endif
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+      //! COBS frame of the header and payload (must stay valid until the packet has been sent)
+      uint8_t frame[DEBUG_PORT_MAX_FRAME_SIZE_BYTES];
+#endif
+   } transmitPacket_t;
+
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+   //! A data packet kept until the host acknowledges it, for retransmission
+   typedef struct
+   {
+      //! cefReliableHeader_t followed by the payload
+      uint8_t data[sizeof(cefReliableHeader_t) + DEBUG_PORT_MAX_APPLICATION_PAYLOAD];
+      //! Number of bytes in data
+      uint32_t numDataBytes;
+      //! Byte checksum of the payload after the cefReliableHeader_t (added up as the payload is copied in)
+      uint32_t payloadChecksum;
+      //! What type of packet it is
+      debugPacketDataType_t packetType;
+      //! Tick (ms) when last sent
+      uint32_t lastSendTickMs;
+      //! Driver send count once the last send has been sent (see DebugPortDriver::getNumSendsCompleted())
+      uint32_t sendCountWhenSent;
+   } retransmitSlot_t;
+#endif
 
    /**
     * Receive States Machine - receiveStateMachine()
@@ -97,13 +229,105 @@ private:
          stateRecvWaitForCefPacket          = 2,
          stateRecvFinishedRecv              = 3,
          stateReceiveFinished               = 4,
+         stateRecvWaitForCommandBuffer      = 5,
       };
       typedef uint16_t debugPortReceiveStates_t;
 
    /**
     * Generates the cefCommandDebugPortHeader_t for the packet to transmit
+    *
+    * @param transmitPacket    packet to generate the header for (the payload and its checksum must be filled in)
+    * @param debugDataType     what type of packet is being transmitted
+    */
+   void generatePacketHeader(transmitPacket_t& transmitPacket, debugPacketDataType_t debugDataType);
+
+   /**
+    * Generates the header of a packet and queues the packet to the driver
+    *
+    * @param transmitPacket    packet to send (the payload must be filled in)
+    * @param debugDataType     what type of packet is being transmitted
+    */
+   void queueTransmitPacket(transmitPacket_t& transmitPacket, debugPacketDataType_t debugDataType);
+
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+   /**
+    * Picks the next packet to send with reliable delivery, in order: a retransmit the host asked for, a retransmit
+    * of the oldest unacknowledged packet once it times out, a new packet from the router (if the window has room),
+    * or an ack packet if the host needs to be told what was received.
+    *
+    * @param transmitPacket    packet to fill in
+    * @param debugDataType     what type of packet it is (returned as a reference)
+    * @param p_slot            retransmit slot the packet is sent from, nullptr for an ack packet (returned as a reference)
+    *
+    * @return false if there is nothing to send
+    */
+   bool prepareReliableTransmitPacket(transmitPacket_t& transmitPacket, debugPacketDataType_t& debugDataType,
+                                      retransmitSlot_t*& p_slot);
+
+   /**
+    * Fills in what has been received from the host (cumulative ack, and nack if a packet needs to be
+    * retransmitted) in a reliable header being sent
+    *
+    * @param reliableHeader   header to fill in
+    */
+   void fillInReliableAcks(cefReliableHeader_t& reliableHeader);
+
+   /**
+    * Handles the acks and nacks of a reliable header received from the host
+    *
+    * @param reliableHeader   header received
     */
-   void generatePacketHeader(void);
+   void processReliableAcks(const cefReliableHeader_t& reliableHeader);
+
+   /**
+    * Decides if a packet received from the host is the next data packet expected.  Duplicates are acknowledged
+    * again, and a packet received after a missing one asks for the missing one (it is dropped and retransmitted).
+    *
+    * @param reliableHeader   header received
+    * @param packetType       debugPacketDataType_t of the packet received
+    *
+    * @return true if the packet is the next data packet
+    */
+   bool acceptReliablePacket(const cefReliableHeader_t& reliableHeader, uint8_t packetType);
+#endif
+
+   /**
+    * Copies a received command into the buffer checked out from the router
+    *
+    * @param p_payload           command received
+    * @param numBytesInPayload   size of the command
+    *
+    * @return errorCode_OK, or the error to check the buffer in with
+    */
+   errorCode_t copyReceivedCommand(const uint8_t* p_payload, uint32_t numBytesInPayload);
+
+   /**
+    * Starts the driver receiving a packet into myReceiveCefBuffer, and the receive timeouts over
+    */
+   void startDriverReceive(void);
+
+   /**
+    * Checks if the packet being received has stopped arriving (see DEBUG_PORT_RECEIVE_PACKET_TIMEOUT_MS).  If so,
+    * the driver's receive is stopped and the receive error status set.
+    *
+    * @return true if the packet timed out
+    */
+   bool checkReceiveTimeout(void);
+
+   /**
+    * Checks if the driver reported an error (e.g. UART noise) while receiving.  If bytes of a packet had been
+    * received, the packet is dropped (the driver's receive is stopped and the receive error status set); otherwise
+    * receiving is just started over.
+    *
+    * @return true if the packet was dropped
+    */
+   bool checkReceiveError(void);
+
+   /**
+    * Checks if the oldest packet queued to the driver has taken too long to send (see DEBUG_PORT_TRANSMIT_TIMEOUT_MS).
+    * If so, every send queued to the driver is aborted, and the packets are checked in as if sent.
+    */
+   void checkTransmitTimeout(void);
 
    /**
     * Waiting on packet header.  Checks to see if complete packet header has been received and checksum matches
@@ -112,6 +336,23 @@ private:
     */
    uint16_t receivePacketHeader(void);
 
+   /**
+    * With COBS framing, waits for a complete frame, decodes it in place and validates the packet header
+    * and packet size.
+    *
+    * @return debugPortReceiveStates_t - Returns the receive state
+    */
+   uint16_t receiveCobsFrame(void);
+
+   /**
+    * Checks the packet header checksum of the received packet, setting the receive error status if it does not match
+    *
+    * @param p_header   received packet header
+    *
+    * @return true if the packet header checksum matches
+    */
+   bool checkPacketHeaderChecksum(cefCommandDebugPortHeader_t* p_header);
+
    /**
     * Calculates the byte checksum of a byte array
     *
@@ -122,8 +363,16 @@ private:
     */
    uint32_t calculateChecksum(void* p_byteArray, uint32_t numBytes);
 
-   //! Transmit state machine state
-   debugPortTransmitStates_t  m_transmitState;
+   /**
+    * Copies a byte array and calculates its byte checksum in the same pass
+    *
+    * @param p_destination   where to copy the byte array
+    * @param p_source        start of byte array to copy and calculate checksum for
+    * @param numBytes        number of bytes in the byte array
+    *
+    * @return uint32_t  checksum
+    */
+   uint32_t copyAndCalculateChecksum(void* p_destination, const void* p_source, uint32_t numBytes);
 
    //! Receive state machine statee
    debugPortReceiveStates_t   m_receiveState;
@@ -131,11 +380,18 @@ private:
    //! Instance of debug port driver
    MyDebugPortDriver m_myDebugPortDriver;
 
+   //! Debug port driver in use (m_myDebugPortDriver unless changed with setDebugPortDriver())
+   DebugPortDriver* mp_debugPortDriver;
+
    //! Number of bytes currently expected in receive packet (debug port packet header & debug packet)
    uint32_t m_expectedNumBytesInReceivePacket;
 
-   //! Local memory to receive data into
+   //! Local memory to receive data into (with COBS framing, the frame is received and then decoded in place)
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+   uint8_t myReceiveBuffer[DEBUG_PORT_MAX_FRAME_SIZE_BYTES];
+#else
    uint8_t myReceiveBuffer[DEBUG_PORT_MAX_PACKET_SIZE_BYTES];
+#endif
 
    //! CefBuffer object used internally that is setup during the constructor so
    //! it is guaranteed to be a non-null memory.  Contains memory for both header and payload.
@@ -148,14 +404,72 @@ private:
    //! Receive error status
    errorCode_t m_receiveErrorStatus;
 
-   //! Buffer with the transmit payload (does not include Transport Header)
-   CefBuffer* mp_transmitPayload;
+   //! Packets queued to the driver, indexed by packet count (modulo the number of packets in flight)
+   transmitPacket_t m_transmitPackets[DEBUG_PORT_NUM_TRANSMIT_PACKETS_IN_FLIGHT];
+
+   //! Number of packets queued to the driver since power up
+   uint32_t m_numTransmitPacketsQueued;
+
+   //! Number of packets sent (and checked back in) since power up
+   uint32_t m_numTransmitPacketsFinished;
+
+   //! Tick (ms) when the oldest packet queued to the driver became the oldest
+   uint32_t m_transmitProgressTickMs;
+
+   //! Tick (ms) when the first byte of the packet being received was seen
+   uint32_t m_receivePacketStartTickMs;
+
+   //! Tick (ms) when more bytes of the packet being received were last seen
+   uint32_t m_receiveProgressTickMs;
+
+   //! Number of bytes the driver had received when last checked for a timeout
+   uint32_t m_numBytesReceivedAtLastCheck;
+
+   //! Number of packets dropped by a receive timeout since power up
+   uint32_t m_numReceiveTimeouts;
+
+   //! Number of transmit timeouts since power up
+   uint32_t m_numTransmitTimeouts;
+
+   //! Number of packets dropped by a receive error since power up
+   uint32_t m_numReceiveErrorPacketsDropped;
+
+   //! Driver the error callback has been set for (the driver's setErrorCallback() is called when it is first used)
+   DebugPortDriver* mp_errorCallbackDebugPortDriver;
+
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+   //! Encodes the transmit packets into COBS frames
+   Cobs m_cobsEncoder;
+#endif
+
+#if (DEBUG_PORT_RELIABLE_DELIVERY == 1)
+   //! Data packets sent and not yet acknowledged, indexed by sequence number (modulo the window size)
+   retransmitSlot_t m_retransmitSlots[DEBUG_PORT_RELIABLE_WINDOW_SIZE];
+
+   //! Sequence number of the next new data packet sent
+   uint8_t m_nextTransmitSequenceNumber;
+
+   //! Sequence number of the oldest data packet not acknowledged by the host
+   uint8_t m_oldestUnackedSequenceNumber;
+
+   //! Sequence number of the next data packet expected from the host
+   uint8_t m_nextReceiveSequenceNumber;
+
+   //! True once the host has acknowledged a packet (until then the first packet is sent with DEBUG_PORT_RELIABLE_FLAG_SYNC)
+   bool m_transmitSynchronized;
+
+   //! True if the host needs to be told what has been received
+   bool m_ackPending;
+
+   //! True if the host needs to retransmit m_nextReceiveSequenceNumber (a packet was lost or corrupted)
+   bool m_nackPending;
 
-   //! What type of packet we are currently transmitting
-   debugPacketDataType_t m_transmitDebugDataType;
+   //! True if the host asked for m_retransmitSequenceNumber to be retransmitted
+   bool m_retransmitRequested;
 
-   //! Packet Header for Transmit (re-built for each transmit sequence)
-   cefCommandDebugPortHeader_t m_transmitPacketHeader;
+   //! Sequence number the host asked to be retransmitted
+   uint8_t m_retransmitSequenceNumber;
+#endif
 };
 
 #endif  // end header guard
@@ -23,6 +23,8 @@ written permission of Syncroness.
  */
 
 #include "DebugPortDriver.hpp"
+#include "FramingSignatureVerify.hpp"
+#include "Cobs.hpp"
 #include "Logging.hpp"
 
 
@@ -33,6 +35,26 @@ bool DebugPortDriver::sendData(void* sendBuffer, uint32_t packetSize)
 	return false;
 }
 
+uint32_t DebugPortDriver::getNumSendsQueued(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::getNumSendsQueued() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return 0;
+}
+
+uint32_t DebugPortDriver::getNumSendsCompleted(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::getNumSendsCompleted() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return 0;
+}
+
+void DebugPortDriver::abortSends(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::abortSends() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+}
+
 bool DebugPortDriver::getSendInProgress(void)
 {
 	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::getSendBusy() called, supposed to be implemented in derived class",
@@ -49,15 +71,34 @@ bool DebugPortDriver::startReceive(void* receiveBuffer, uint32_t receiveSize)
 
 uint32_t DebugPortDriver::getCurrentBytesReceived(void)
 {
-	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::getCurrentBytesReceived() called, supposed to be implemented in derived class",
-	        0, 0, 0);
-	return 0;
+	return m_currentBufferOffset;
+}
+
+uint32_t DebugPortDriver::getReceivedFrameNumBytes(void)
+{
+	return m_receivedFrameNumBytes;
+}
+
+uint32_t DebugPortDriver::getReceivedPayloadChecksum(void)
+{
+	return m_receivedPayloadChecksum;
 }
 
 void DebugPortDriver::editReceiveSize(uint32_t newReceiveSize)
 {
-	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::editReceiveSize() called, supposed to be implemented in derived class",
-	        0, 0, 0);
+    /**
+     * The new size comes from a packet header, so the receive size can only shrink; it is never made bigger
+     * than the buffer the receive was started with, and mp_receiveBuffer + newReceiveSize can't overflow.
+     */
+    if(newReceiveSize < m_receiveBufferSize)
+    {
+        m_receiveBufferSize = newReceiveSize;
+    }
+
+	if(m_currentBufferOffset >= m_receiveBufferSize)
+	{
+		stopReceive();
+	}
 }
 
 void DebugPortDriver::stopReceive()
@@ -79,3 +120,241 @@ errorCode_t DebugPortDriver::errorCallback(void)
 	return errorCode_LogFatalReturn;
 }
 
+bool DebugPortDriver::receivedByteDriverHwCallback(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::receivedByteDriverHwCallback() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+	return false;
+}
+
+void DebugPortDriver::sendCompleteDriverHwCallback(void)
+{
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Base class DebugPortDriver::sendCompleteDriverHwCallback() called, supposed to be implemented in derived class",
+	        0, 0, 0);
+}
+
+void DebugPortDriver::errorCallback(errorCode_t error)
+{
+	// Interrupt context, so no logging here (the transport layer logs the dropped packet)
+	if((error < errorCode_debugPortErrorCodeNone) || (error > errorCode_debugPortErrorCodeUnknown))
+	{
+		error = errorCode_debugPortErrorCodeUnknown;
+	}
+	++m_numReceiveErrors[error - errorCode_debugPortErrorCodeNone];
+
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+	bool receiveFinished = (m_receivedFrameNumBytes != 0) || (m_currentBufferOffset >= m_receiveBufferSize);
+#else
+	bool receiveFinished = (m_currentBufferOffset >= m_receivedPacketNumBytes) || (m_currentBufferOffset >= m_receiveBufferSize);
+#endif
+	if((mp_receiveBuffer == nullptr) || (receiveFinished == true) || (m_receiveError != errorCode_OK))
+	{
+		// Not receiving (the bytes received are fine), or the receive has already failed
+		return;
+	}
+
+	m_receiveError = error;
+	m_resynchronizeFrame = ((m_currentBufferOffset > 0) || (m_discardingFrame == true));
+}
+
+errorCode_t DebugPortDriver::getReceiveError(void)
+{
+	return m_receiveError;
+}
+
+uint32_t DebugPortDriver::getNumReceiveErrors(errorCode_t errorClass)
+{
+	if((errorClass < errorCode_debugPortErrorCodeNone) || (errorClass > errorCode_debugPortErrorCodeUnknown))
+	{
+		return 0;
+	}
+	return m_numReceiveErrors[errorClass - errorCode_debugPortErrorCodeNone];
+}
+
+bool DebugPortDriver::resetReceive(void* receiveBuffer, uint32_t receiveSize)
+{
+	m_receiveBufferSize = receiveSize;
+	mp_receiveBuffer = receiveBuffer;
+	m_currentBufferOffset = 0;
+	m_receivedFrameNumBytes = 0;
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+	// Bytes of a frame that was corrupted part way are still to come, discard them up to the frame's delimiter
+	m_discardingFrame = m_resynchronizeFrame;
+#else
+	m_discardingFrame = false;
+#endif
+	m_resynchronizeFrame = false;
+	m_receiveError = errorCode_OK;
+	startReceivedPayloadChecksum();
+	if((mp_receiveBuffer != nullptr) && (m_currentBufferOffset < m_receiveBufferSize))
+	{
+		return true;
+	}
+
+	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Start debug receive as null buffer or overrun max buffer size.",
+	        0, 0, 0);
+	return false;
+}
+
+bool DebugPortDriver::receivedByte(void)
+{
+#if (DEBUG_PORT_FRAMING_COBS == 1)
+	return receivedCobsByte();
+#else
+
+	/**
+	 * Keep looking for the framing signature and resetting where add to
+	 * buffer until the beginning of the buffer contains a complete framing
+	 * signature.
+	 * After a framing signature is found, continue to add data to the buffer until
+	 * the packet (as sized by its header) is complete, or run out of buffer space
+	 */
+
+	if(m_currentBufferOffset < numElementsInDebugPacketFramingSignature)
+	{
+		/**Check framing signature can return increment if the byte matches the framing signature
+		 * Or it can return "0" if the framing signature is not correct and the buffer offset needs to be 
+		 * set back to starting point.*/
+		m_currentBufferOffset = FramingSignatureVerify::checkFramingSignatureByte(mp_receiveBuffer, m_currentBufferOffset);
+	}
+	else // If past framing signature, add it to the payload checksum and increment offset for the next buffer receive point
+	{
+		addToReceivedPayloadChecksum();
+		m_currentBufferOffset++;
+	}
+
+	//Check to see if receive is finished/ buffer is full
+	if((m_currentBufferOffset >= m_receivedPacketNumBytes) || (m_currentBufferOffset >= m_receiveBufferSize))
+	{
+		/**Stop receiving data till startReceive is invoked again, so the bytes of the host's next packet
+		 * are left with the driver rather than received into this one.
+		 * Router/TransportLayer job to check the packet (header and payload checksums).
+		 *
+		 * It is the responsibility of the transport layer to make sure the buffer
+		 * is big enough to receive a complete packet.  The transport layer should start
+		 * out with a buffer big enough for the largest expected packet size.
+		 * */
+		return false;
+	}
+
+	//Receive has not finished/still room left in the buffer
+	return true;
+#endif
+}
+
+bool DebugPortDriver::receivedBytes(const uint8_t* p_data, uint32_t numBytes, uint32_t& numBytesUsed)
+{
+	bool receiveInProgress = true;
+	numBytesUsed = 0;
+	while((numBytesUsed < numBytes) && (receiveInProgress == true))
+	{
+#if (DEBUG_PORT_FRAMING_COBS == 0)
+		if(m_currentBufferOffset == 0)
+		{
+			// Looking for a framing signature, skip the bytes that can't start one
+			numBytesUsed += FramingSignatureVerify::findFramingSignature(&p_data[numBytesUsed], numBytes - numBytesUsed);
+			if(numBytesUsed == numBytes)
+			{
+				break;
+			}
+		}
+#endif
+		((uint8_t*) mp_receiveBuffer)[m_currentBufferOffset] = p_data[numBytesUsed++];
+		receiveInProgress = receivedByte();
+	}
+	return receiveInProgress;
+}
+
+bool DebugPortDriver::receivedCobsByte(void)
+{
+	/**
+	 * The delimiter never appears inside a COBS frame, so there is no framing signature to search for;
+	 * every delimiter ends a frame, and the next byte starts the next frame.
+	 */
+	uint8_t receivedByte = ((uint8_t*) mp_receiveBuffer)[m_currentBufferOffset];
+	if(receivedByte == DEBUG_PORT_COBS_DELIMITER)
+	{
+		if((m_discardingFrame == true) || (m_currentBufferOffset == 0))
+		{
+			// End of a discarded (or empty) frame, start over with the next frame
+			m_discardingFrame = false;
+			m_currentBufferOffset = 0;
+			startReceivedPayloadChecksum();
+			return true;
+		}
+
+		// Frame complete, stop receiving data till startReceive is invoked again
+		m_receivedFrameNumBytes = m_currentBufferOffset;
+		return false;
+	}
+
+	if(m_discardingFrame == false)
+	{
+		addToReceivedCobsPayloadChecksum(receivedByte);
+		m_currentBufferOffset++;
+		if(m_currentBufferOffset >= m_receiveBufferSize)
+		{
+			// Too big to be a valid frame (likely lost the delimiter), discard it up to the next delimiter
+			m_discardingFrame = true;
+			m_currentBufferOffset = 0;
+		}
+	}
+
+	return true;
+}
+
+void DebugPortDriver::startReceivedPayloadChecksum(void)
+{
+	m_receivedPayloadChecksum = 0;
+	// Nothing is payload until the packet header has been received
+	m_receivedPacketNumBytes = sizeof(cefCommandDebugPortHeader_t);
+	m_numDecodedBytes = 0;
+	m_numBytesLeftInCobsBlock = 0;
+	m_cobsBlockEndsWithZero = false;
+}
+
+void DebugPortDriver::addToReceivedPayloadChecksum(void)
+{
+	const uint32_t headerSizeInBytes = sizeof(cefCommandDebugPortHeader_t);
+	if(m_currentBufferOffset >= headerSizeInBytes)
+	{
+		// The receive finishes at the end of the packet, so every byte after the header is payload
+		m_receivedPayloadChecksum += ((uint8_t*) mp_receiveBuffer)[m_currentBufferOffset];
+	}
+	else if(m_currentBufferOffset == (headerSizeInBytes - 1))
+	{
+		/**
+		 * Header complete (if it is corrupted, the transport layer drops the packet on its header checksum).  The payload
+		 * size isn't checked yet, so the packet is never taken to be bigger than the receive buffer.
+		 */
+		uint32_t payloadSize = ((cefCommandDebugPortHeader_t*) mp_receiveBuffer)->m_payloadSize;
+		m_receivedPacketNumBytes = m_receiveBufferSize;
+		if(payloadSize < (m_receiveBufferSize - headerSizeInBytes))
+		{
+			m_receivedPacketNumBytes = headerSizeInBytes + payloadSize;
+		}
+	}
+}
+
+void DebugPortDriver::addToReceivedCobsPayloadChecksum(uint8_t receivedByte)
+{
+	if(m_numBytesLeftInCobsBlock == 0)
+	{
+		// A code byte; the zero ending the previous block (if it had one) is decoded before this block's bytes
+		if(m_cobsBlockEndsWithZero == true)
+		{
+			m_numDecodedBytes++;
+		}
+		m_numBytesLeftInCobsBlock = receivedByte - 1;
+		m_cobsBlockEndsWithZero = (receivedByte != Cobs::m_maxCode);
+		return;
+	}
+
+	// The frame is the packet, so every decoded byte after the header is payload
+	if(m_numDecodedBytes >= sizeof(cefCommandDebugPortHeader_t))
+	{
+		m_receivedPayloadChecksum += receivedByte;
+	}
+	m_numDecodedBytes++;
+	m_numBytesLeftInCobsBlock--;
+}
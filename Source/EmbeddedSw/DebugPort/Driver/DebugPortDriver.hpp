@@ -18,28 +18,86 @@ written permission of Syncroness.
 #define __DEBUG_PORT_DRIVER_H
 #include "cefContract.hpp"
 
+/**
+ * Debug port drivers the transport layer can be built with (DEBUG_PORT_DRIVER).  The socket and shared memory
+ * drivers are for the simulator only, where they let the Python utilities connect to it without a serial port.
+ */
+#define DEBUG_PORT_DRIVER_SERIAL 0
+#define DEBUG_PORT_DRIVER_TCP 1
+#define DEBUG_PORT_DRIVER_UDP 2
+#define DEBUG_PORT_DRIVER_SHARED_MEMORY 3
+#ifndef DEBUG_PORT_DRIVER
+    #define DEBUG_PORT_DRIVER DEBUG_PORT_DRIVER_SERIAL
+#endif
+
+//! Number of classes of receive errors counted (errorCode_debugPortErrorCodeNone to errorCode_debugPortErrorCodeUnknown)
+#define DEBUG_PORT_DRIVER_NUM_ERROR_CLASSES (errorCode_debugPortErrorCodeUnknown - errorCode_debugPortErrorCodeNone + 1)
+
 /**
  * Base Class for DebugPortDriver
  * Send Data/Receive Data/Stop Receive
+ *
+ * The transport layer only uses this interface, so any byte stream (a UART, a socket, ...) can carry the
+ * debug port by deriving a driver from it.  The framing of received bytes (framing signature search or COBS
+ * frames) is the same for every driver, so it is done here: a driver stores each received byte at
+ * mp_receiveBuffer + m_currentBufferOffset and calls receivedByte() to find out if it should receive another.
  */
 
 class DebugPortDriver {
 
 public:
 	//! Constructor.
-	DebugPortDriver() {}
+	DebugPortDriver():
+	m_receiveBufferSize(0),
+	m_currentBufferOffset(0),
+	mp_receiveBuffer(nullptr),
+	m_receivedFrameNumBytes(0),
+	m_discardingFrame(false),
+	m_receivedPayloadChecksum(0),
+	m_receivedPacketNumBytes(0),
+	m_numDecodedBytes(0),
+	m_numBytesLeftInCobsBlock(0),
+	m_cobsBlockEndsWithZero(false),
+	m_receiveError(errorCode_OK),
+	m_resynchronizeFrame(false),
+	m_numReceiveErrors()
+	{}
 
 
    /**
     * Start Send Debug Data transfer. Command response and logging are the two data that can be sent.
+    * Sends are queued, and each is started as soon as the previous one finishes (the buffer must stay
+    * valid until getNumSendsCompleted() shows the send has completed).
     * 
     * @param sendBuffer - Pointer to start of buffer to send
     * @param packetSize - Number of Bytes to send
     *
-    * @return true if successfully setup to sendData
+    * @return true if successfully setup to sendData (false if the send queue is full)
     */
    virtual bool sendData(void* sendBuffer, uint32_t packetSize);
 
+   /**
+    * Returns the number of sends queued with sendData() since power up (wraps at 32 bits)
+    *
+    * @return number of sends queued
+    */
+   virtual uint32_t getNumSendsQueued(void);
+
+   /**
+    * Returns the number of sends completed since power up (wraps at 32 bits).  A send is complete once
+    * getNumSendsCompleted() has reached the getNumSendsQueued() value read right after queuing it.
+    *
+    * @return number of sends completed
+    */
+   virtual uint32_t getNumSendsCompleted(void);
+
+   /**
+    * Abandons the send in progress and every queued send, e.g. when the transport layer gives up waiting for them.
+    * They are counted as completed, so their buffers can be reused right away (what was already sent of the send
+    * in progress is a truncated packet to the host).
+    */
+   virtual void abortSends(void);
+
    /**
     * Returns Status on if Send is in progress
     * 
@@ -49,7 +107,8 @@ public:
    bool getSendInProgress(void);
    
    /**
-    * Start receiving data from Python utilities
+    * Start receiving data from Python utilities (derived classes reset the receive with resetReceive(),
+    * then arm receiving the first byte)
     * 
     * @param receive buffer location
     * @param size of packet to receive
@@ -65,12 +124,29 @@ public:
     */
    virtual uint32_t getCurrentBytesReceived(void);
 
+   /**
+    * With COBS framing (DEBUG_PORT_FRAMING_COBS), returns the size of the frame received once its delimiter
+    * has been received.  Receiving stops at the delimiter (the delimiter is not stored).
+    *
+    * @return number of bytes in the received frame, 0 if a complete frame has not been received yet
+    */
+   virtual uint32_t getReceivedFrameNumBytes(void);
+
+   /**
+    * Returns the byte checksum of the payload received so far (the bytes after the packet header, up to the payload
+    * size in the header; with COBS framing, of the decoded bytes).  It is added up as each byte is received, so once
+    * the last byte of a packet is received its payload checksum can be checked without another pass over the packet.
+    *
+    * @return payload checksum (see cefCommandDebugPortHeader_t::m_packetPayloadChecksum)
+    */
+   uint32_t getReceivedPayloadChecksum(void);
+
    /**
     * Changes the number of bytes receive is expecting for packet to be finished.  The number of bytes received will
     * not be known until the packet header is received and decoded.  At this point the expected receive may change from
     * max to new amount.  
     * Rules
-    * - Receive size can not exceed Max Bytes
+    * - Receive size can not exceed Max Bytes (a bigger size is ignored)
     * - If receive size is less then or equal to m_currentBufferOffset receive will be stopped
     * 
     * @param newReceiveSize - new expected bytes to receive in packet
@@ -79,6 +155,7 @@ public:
 
    /**
     * Stops receiving data. This will instantly stop the receive of data even in the middle of a packet.
+    * Bytes that arrive afterwards are kept by the driver (as far as it has room) for the next receive.
     * */
    virtual void stopReceive(void);
 
@@ -94,6 +171,153 @@ public:
     */
    virtual errorCode_t errorCallback(void);
 
+   /**
+    * Callback from the hardware shim (interrupt context) once the byte armed with
+    * ShimBase::startInterruptReceive() has been received
+    *
+    * @return returns true if receiving is not finished and was able to arm
+    * receive to retrieve next byte of data
+    */
+   virtual bool receivedByteDriverHwCallback(void);
+
+   /**
+    * Callback from the hardware shim (interrupt context) once the send started with
+    * ShimBase::startInterruptSend() has finished
+    */
+   virtual void sendCompleteDriverHwCallback(void);
+
+   /**
+    * Callback from the hardware shim (interrupt context) for a receiving error (parity, noise, framing, overrun...).
+    * The error is counted, and if it happened while receiving, the receive is marked as failed (see getReceiveError()).
+    * Nothing else is done here, so recovering is left to the transport layer's main loop context.
+    *
+    * @param error - current error (errorCode_debugPortErrorCodeNone to errorCode_debugPortErrorCodeUnknown)
+    */
+   virtual void errorCallback(errorCode_t error);
+
+   /**
+    * Returns the error that made the current receive fail.  The bytes received are then not to be trusted, so the
+    * packet is dropped and receiving started over.  With COBS framing, the next receive starts by discarding the
+    * rest of the corrupted frame (up to the next delimiter); otherwise the framing signature search skips it.
+    *
+    * @return errorCode_OK, or the first error since the receive was started
+    */
+   errorCode_t getReceiveError(void);
+
+   /**
+    * Returns the number of receive errors of a class since power up
+    *
+    * @param errorClass - errorCode_debugPortErrorCodeNone to errorCode_debugPortErrorCodeUnknown
+    *
+    * @return number of errors
+    */
+   uint32_t getNumReceiveErrors(errorCode_t errorClass);
+
+protected:
+   /**
+    * Resets the receive state (offset, frame, framing) for a new receive into receiveBuffer
+    *
+    * @param receiveBuffer - receive buffer location
+    * @param receiveSize - size of packet to receive
+    *
+    * @return true if the buffer is valid to receive into
+    */
+   bool resetReceive(void* receiveBuffer, uint32_t receiveSize);
+
+   /**
+    * Frames the byte just stored at mp_receiveBuffer + m_currentBufferOffset, and moves the offset to
+    * where the next byte is to be stored.
+    * Without COBS framing, the framing signature is searched for (the offset starts over until the beginning
+    * of the buffer holds a complete framing signature), then bytes are added until the packet its header
+    * describes is complete (or the buffer is full).
+    * With COBS framing (DEBUG_PORT_FRAMING_COBS), bytes are stored until the delimiter is received.  A frame
+    * too big for the buffer is discarded up to the next delimiter, where receiving starts over.
+    *
+    * @return true if another byte should be received, false if the receive is finished
+    */
+   bool receivedByte(void);
+
+   /**
+    * Chunk version of receivedByte(), for drivers that receive bytes in chunks.  Each byte is stored at
+    * mp_receiveBuffer + m_currentBufferOffset and framed, except that while no part of a framing signature has been
+    * received, the bytes that can't start one are skipped all at once (see FramingSignatureVerify::findFramingSignature()).
+    * A framing signature cut off by the end of the chunk is completed by the next chunk.
+    *
+    * @param p_data         bytes received
+    * @param numBytes       number of bytes received
+    * @param numBytesUsed   number of bytes taken (returned as a reference); bytes after the end of the receive are
+    *                       left for the next receive
+    *
+    * @return true if more bytes should be received, false if the receive is finished
+    */
+   bool receivedBytes(const uint8_t* p_data, uint32_t numBytes, uint32_t& numBytesUsed);
+
+   //! Number of bytes to receive
+   uint32_t m_receiveBufferSize;
+
+   //! Current offset of the receive buffer
+   uint32_t m_currentBufferOffset;
+
+   //! Pointer to receive buffer
+   void* mp_receiveBuffer;
+
+   //! Number of bytes in the received frame (COBS framing), 0 until the frame's delimiter is received
+   uint32_t m_receivedFrameNumBytes;
+
+   //! True while discarding a frame that is too big for the receive buffer, or was corrupted (COBS framing)
+   bool m_discardingFrame;
+
+   //! Byte checksum of the payload received so far (see getReceivedPayloadChecksum())
+   uint32_t m_receivedPayloadChecksum;
+
+   //! Number of bytes in the packet being received, from its header once received (without COBS framing)
+   uint32_t m_receivedPacketNumBytes;
+
+   //! Number of bytes the frame received so far decodes to (COBS framing)
+   uint32_t m_numDecodedBytes;
+
+   //! Number of bytes before the next COBS code byte in the frame being received (COBS framing)
+   uint8_t m_numBytesLeftInCobsBlock;
+
+   //! True if the current COBS block ends with an implied zero (COBS framing)
+   bool m_cobsBlockEndsWithZero;
+
+   //! First receive error since the receive was started (set from interrupt context)
+   volatile errorCode_t m_receiveError;
+
+   //! True if the next receive has to discard the rest of a corrupted frame (COBS framing, set from interrupt context)
+   volatile bool m_resynchronizeFrame;
+
+   //! Receive errors since power up, indexed by error class (error code - errorCode_debugPortErrorCodeNone)
+   uint32_t m_numReceiveErrors[DEBUG_PORT_DRIVER_NUM_ERROR_CLASSES];
+
+private:
+   /**
+    * COBS framing (DEBUG_PORT_FRAMING_COBS) version of receivedByte()
+    *
+    * @return true if another byte should be received, false if the frame is complete
+    */
+   bool receivedCobsByte(void);
+
+   /**
+    * Starts the payload checksum over, for a new packet or frame
+    */
+   void startReceivedPayloadChecksum(void);
+
+   /**
+    * Adds the byte just stored at mp_receiveBuffer + m_currentBufferOffset to the payload checksum if it is part
+    * of the payload (called for the bytes after the framing signature)
+    */
+   void addToReceivedPayloadChecksum(void);
+
+   /**
+    * COBS framing version of addToReceivedPayloadChecksum(); follows the code bytes to know which decoded byte
+    * each received byte is (the implied zeros don't change the checksum)
+    *
+    * @param receivedByte   byte of the frame just received (not a delimiter)
+    */
+   void addToReceivedCobsPayloadChecksum(uint8_t receivedByte);
+
 };
 
 #endif  // end header guard
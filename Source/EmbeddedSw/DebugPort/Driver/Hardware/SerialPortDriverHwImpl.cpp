@@ -17,125 +17,193 @@ written permission of Syncroness.
 
 #include "SerialPortDriverHwImpl.hpp"
 #include "ShimBase.hpp"
-#include "FramingSignatureVerify.hpp"
 #include "Logging.hpp"
 
-bool SerialPortDriverHwImpl::sendData(void* sendBuffer, int packetSize)
+STATIC_ASSERT((SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS & (SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)) == 0,
+        serial_port_driver_send_queue_size_must_be_a_power_of_2);
+STATIC_ASSERT((SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES & (SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES - 1)) == 0,
+        serial_port_driver_receive_ring_size_must_be_a_power_of_2);
+
+bool SerialPortDriverHwImpl::sendData(void* sendBuffer, uint32_t packetSize)
 {
-	return ShimBase::getInstance().startInterruptSend(sendBuffer, packetSize);
+	if(packetSize == 0)
+	{
+		// Nothing to send (and the HAL would reject a zero length send)
+		return true;
+	}
+
+	// The transmit interrupt also updates the queue, so it is disabled while queuing
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	bool sendQueued = false;
+	uint32_t numSendsOutstanding = m_numSendsQueued - m_numSendsCompleted;
+	if(numSendsOutstanding < SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS)
+	{
+		queuedSend_t& queuedSend = m_queuedSends[m_numSendsQueued & (SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)];
+		queuedSend.p_buffer = sendBuffer;
+		queuedSend.numBytes = packetSize;
+		m_numSendsQueued++;
+		sendQueued = true;
+
+		// If nothing was being sent, start now; otherwise the transmit interrupt starts it when its turn comes
+		if(numSendsOutstanding == 0)
+		{
+			sendQueued = startNextSend();
+			if(sendQueued == false)
+			{
+				m_numSendsQueued--;
+			}
+		}
+	}
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+	return sendQueued;
 }
 
-uint32_t SerialPortDriverHwImpl::getCurrentBytesReceived(void)
+uint32_t SerialPortDriverHwImpl::getNumSendsQueued(void)
 {
-	return m_currentBufferOffset;
+	return m_numSendsQueued;
 }
 
-bool SerialPortDriverHwImpl::getSendInProgress(void)
+uint32_t SerialPortDriverHwImpl::getNumSendsCompleted(void)
 {
-	return ShimBase::getInstance().getSendInProgress();
+	return m_numSendsCompleted;
 }
 
-bool SerialPortDriverHwImpl::startReceive(void* receiveBuffer, uint32_t receiveSize)
+void SerialPortDriverHwImpl::abortSends(void)
 {
-	m_receiveBufferSize = receiveSize;
-	mp_receiveBuffer = receiveBuffer;
-	m_currentBufferOffset = 0;
-	if((mp_receiveBuffer != nullptr) && (m_currentBufferOffset < m_receiveBufferSize))
-	{
-		return armReceiveNextByte();
-	}
-	else
+	// The transmit interrupt also updates the queue, so it is disabled while the queue is emptied
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+	if(m_numSendsCompleted != m_numSendsQueued)
 	{
-		LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Start debug receive as null buffer or overrun max buffer size.",
-		        0, 0, 0);
-		return false;
+		ShimBase::getInstance().forceStopSend();
+		m_numSendsCompleted = m_numSendsQueued;
 	}
+	ShimBase::getInstance().restoreInterrupts(interruptState);
 }
 
-void SerialPortDriverHwImpl::editReceiveSize(uint32_t newReceiveSize)
+bool SerialPortDriverHwImpl::startNextSend()
 {
-    /**
-     * It is the responsibility of the calling routine to ensure that
-     * that mp_receiveBuffer + newReceiveSize does not overflow as the
-     * the SerialPortDriverHwImpl does not have the knowledge to make
-     * this decision.
-     */
-    m_receiveBufferSize = newReceiveSize;
-
-	if(m_currentBufferOffset >= newReceiveSize)
+	queuedSend_t& queuedSend = m_queuedSends[m_numSendsCompleted & (SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)];
+	return ShimBase::getInstance().startInterruptSend(queuedSend.p_buffer, queuedSend.numBytes,
+	        this, &DebugPortDriver::sendCompleteDriverHwCallback);
+}
+
+void SerialPortDriverHwImpl::sendCompleteDriverHwCallback(void)
+{
+	m_numSendsCompleted++;
+
+	// Chain the next queued send right away, rather than waiting for the transport layer to poll for completion
+	if(m_numSendsCompleted != m_numSendsQueued)
 	{
-		stopReceive();
+		if(startNextSend() == false)
+		{
+			/**
+			 * The UART just finished sending, so it should always accept the next send.  The queued sends
+			 * are counted as completed so the transport layer doesn't wait forever for them.
+			 */
+			m_numSendsCompleted = m_numSendsQueued;
+		}
 	}
 }
 
-void SerialPortDriverHwImpl::stopReceive()
+bool SerialPortDriverHwImpl::getSendInProgress(void)
 {
-	ShimBase::getInstance().forceStopReceive();
+	return (m_numSendsQueued != m_numSendsCompleted);
 }
 
-bool SerialPortDriverHwImpl::receivedByteDriverHwCallback()
+bool SerialPortDriverHwImpl::startReceive(void* receiveBuffer, uint32_t receiveSize)
+{
+	// The receive interrupt also frames bytes, so it is disabled while the receive is started
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	m_receiveInProgress = resetReceive(receiveBuffer, receiveSize);
+
+	// Bytes that arrived since the last receive finished are received first
+	frameRingBytes();
+	bool receiveArmed = armReceiveNextByte();
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+	return (m_receiveInProgress == true) && (receiveArmed == true);
+}
+
+void SerialPortDriverHwImpl::stopReceive()
 {
 	/**
-	 * Keep looking for the framing signature and resetting where add to
-	 * buffer until the beginning of the buffer contains a complete framing
-	 * signature.
-	 * After a framing signature is found, continue to add data to the buffer until
-	 * run out of buffer space
+	 * The UART keeps receiving into the ring, so bytes the host sends while the transport layer is busy
+	 * (e.g. an ack and a command back to back) are there for the next receive.
 	 */
+	m_receiveInProgress = false;
+}
 
-	if(m_currentBufferOffset < numElementsInDebugPacketFramingSignature)
-	{
-		/**Check framing signature can return increment if the byte matches the framing signature
-		 * Or it can return "0" if the framing signature is not correct and the buffer offset needs to be 
-		 * set back to starting point.*/
-		m_currentBufferOffset = FramingSignatureVerify::checkFramingSignatureByte(mp_receiveBuffer, m_currentBufferOffset);
-	}
-	else // If past framing signature, increment offset for the next buffer receive point
-	{
-		m_currentBufferOffset++;
-	}
+bool SerialPortDriverHwImpl::receivedByteDriverHwCallback()
+{
+	// The armed byte has been received into the ring
+	m_receiveArmed = false;
+	m_receiveRingWriteIndex++;
 
-	//Check to see if receive is finished/ buffer is full
-	if(m_currentBufferOffset >= m_receiveBufferSize)
-	{
-		/**Router/TransportLayer job to know when a complete packet has been received.
-		 * Stop receiving data till startReceive is invoked again.
-		 *
-		 * It is the responsibility of the transport layer to make sure the buffer
-		 * is big enough to receive a complete packet.  The transport layer should start
-		 * out with a buffer big enough for the largest expected packet size.
-		 * */
-		return false;
-	}
+	frameRingBytes();
 
-	//Receive has not finished/still room left in the buffer
 	//Set up receive next byte
 	return armReceiveNextByte();
 }
 
-bool SerialPortDriverHwImpl::armReceiveNextByte()
+void SerialPortDriverHwImpl::errorCallback(errorCode_t error)
 {
-	/**Error should be handled by the higher level routine that calls receiveNextByte.
-	 * We do a final check to make sure we are not over-writing memory here.
-	 */
-	if(mp_receiveBuffer != nullptr && m_currentBufferOffset < m_receiveBufferSize)
+	DebugPortDriver::errorCallback(error);
+
+	// The HAL stops receiving on some errors (e.g. an overrun), so the receive of the next byte is started over
+	ShimBase::getInstance().forceStopReceive();
+	m_receiveArmed = false;
+	armReceiveNextByte();
+}
+
+void SerialPortDriverHwImpl::frameRingBytes()
+{
+	// Bytes past the end of the packet are left in the ring for the next receive
+	while((m_receiveInProgress == true) && (m_receiveRingReadIndex != m_receiveRingWriteIndex))
 	{
-	    uint8_t* p_receiveMemoryAddress = (uint8_t*) mp_receiveBuffer + m_currentBufferOffset;
-		ShimBase::getInstance().startInterruptReceive(p_receiveMemoryAddress,
-		        this, &SerialPortDriverHwImpl::receivedByteDriverHwCallback);
-		return true;
+		uint32_t ringOffset = m_receiveRingReadIndex & (SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES - 1);
+		uint32_t numBytes = m_receiveRingWriteIndex - m_receiveRingReadIndex;
+		if(numBytes > (SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES - ringOffset))
+		{
+			// Up to the end of the ring, the rest is framed on the next time through
+			numBytes = SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES - ringOffset;
+		}
+
+		uint32_t numBytesUsed = 0;
+		m_receiveInProgress = receivedBytes(&m_receiveRing[ringOffset], numBytes, numBytesUsed);
+		m_receiveRingReadIndex += numBytesUsed;
 	}
-	return false;
 }
 
-void SerialPortDriverHwImpl::setErrorCallback(void)
+bool SerialPortDriverHwImpl::armReceiveNextByte()
 {
-	ShimBase::getInstance().startErrorCallback(this, &SerialPortDriverHwImpl::errorCallback);
+	if(m_receiveArmed == true)
+	{
+		return true;
+	}
+
+	if((m_receiveRingWriteIndex - m_receiveRingReadIndex) >= SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES)
+	{
+		/**
+		 * The ring is full (the transport layer hasn't received for a while), so the UART is left unarmed and the
+		 * bytes that follow are lost.  That is counted as an overrun, and receiving resumes once startReceive()
+		 * frees up room.
+		 */
+		DebugPortDriver::errorCallback(errorCode_debugPortErrorCodeOverrun);
+		return false;
+	}
+
+	uint8_t* p_receiveMemoryAddress = &m_receiveRing[m_receiveRingWriteIndex & (SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES - 1)];
+	m_receiveArmed = true;
+	ShimBase::getInstance().startInterruptReceive(p_receiveMemoryAddress,
+	        this, &DebugPortDriver::receivedByteDriverHwCallback);
+	return true;
 }
 
-void SerialPortDriverHwImpl::errorCallback(errorCode_t error)
+void SerialPortDriverHwImpl::setErrorCallback(void)
 {
-	LOG_FATAL(Logging::LogModuleIdCefInfrastructure, "Implement in CmdDebugPort",
-	        0, 0, 0);
+	ShimBase::getInstance().startErrorCallback(this, &DebugPortDriver::errorCallback);
 }
 
@@ -19,6 +19,23 @@ written permission of Syncroness.
 #include <stdio.h>
 #include "DebugPortDriver.hpp"
 
+/**
+ * Number of sends that can be queued at once (must be a power of 2).  The transport layer queues a
+ * header and a payload for each packet it has in flight.
+ */
+#ifndef SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS
+    #define SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS 4
+#endif
+
+/**
+ * Number of bytes the driver keeps while the transport layer is not receiving (must be a power of 2).  The host
+ * can send packets back to back (e.g. an ack and a command), so the bytes of the next packet arrive while the
+ * transport layer is still handling the previous one.
+ */
+#ifndef SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES
+    #define SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES 256
+#endif
+
 /**
  * Serial Port Driver for Hardware.
  * It drives the non blocking serial receive and send for hardware impl
@@ -27,20 +44,30 @@ written permission of Syncroness.
  * the hardware/HAL layer has some kind of a fifo that is able to handle 
  * doing this without dropping data.  If data starts getting dropped and we miss packets
  * this will have to be refactored.
+ *
+ * Sends are queued, and the next queued send is started from the transmit complete interrupt of
+ * the previous one, so a packet header and its payload (and back to back packets) go out without a gap.
+ *
+ * Receiving never stops: each byte is received into a ring, and the next one armed right away from the
+ * receive interrupt.  The bytes are framed into the transport layer's buffer while a receive is in progress,
+ * and are kept in the ring for the next receive otherwise.
  */
 class SerialPortDriverHwImpl : public DebugPortDriver {
 public:
 	//! Constructor.
 	SerialPortDriverHwImpl():DebugPortDriver(),
-   m_receiveBufferSize(0),
-	m_currentBufferOffset(0),
-	mp_receiveBuffer(nullptr)
+	m_numSendsQueued(0),
+	m_numSendsCompleted(0),
+	m_receiveRingReadIndex(0),
+	m_receiveRingWriteIndex(0),
+	m_receiveInProgress(false),
+	m_receiveArmed(false)
 	{}
 
    /**
     * See base class for method documentation
     */
-   bool sendData(void* sendBuffer, int packetSize);
+   bool sendData(void* sendBuffer, uint32_t packetSize);
 
    /**
     * See base class for method documentation
@@ -50,70 +77,110 @@ public:
    /**
     * See base class for method documentation
     */
-   uint32_t getCurrentBytesReceived(void);
+   uint32_t getNumSendsQueued(void);
 
    /**
     * See base class for method documentation
     */
-   bool getSendInProgress(void);
+   uint32_t getNumSendsCompleted(void);
+
+   /**
+    * See base class for method documentation
+    */
+   void abortSends(void);
 
    /**
     * See base class for method documentation
     */
-   void editReceiveSize(uint32_t newReceiveSize);
-   
+   bool getSendInProgress(void);
+
    /**
     * See base class for method documentation
     * */
    void stopReceive();
 
    /**
-    * Callback function when a startReceive has been called and 
-    * receive has been successfully armed this callback will be called
-    * once one byte has been received.
-    * To continue receiving it will check and preform the following 
-    * 1) If the number of expected bytes have been received
-    * 2) If there is additional room in the buffer to receive a byte
-    * 3) Check for a framing signature if needed
-    * 4) Incroment buffer offset as needed
-    * 5) Call receive next byte 
+    * Callback function (interrupt context) once the byte armed by armReceiveNextByte() has been received
+    * into the ring.
+    * The bytes in the ring are framed by DebugPortDriver::receivedBytes() if a receive is in progress, and
+    * the next byte is armed.
     * 
-    * @return returns true if receiving is not finished and was able to arm 
-    * receive to retrieve next byte of data
+    * @return returns true if was able to arm receive to retrieve next byte of data
     */
    bool receivedByteDriverHwCallback(void);
 
    /**
-    * Sets the callback to receive any errors
+    * See base class for method documentation.  The receive of the next byte is also armed again, as the
+    * HAL stops receiving on some errors.
     */
-   void setErrorCallback(void);
+   void errorCallback(errorCode_t error);
 
    /**
-    * Callback function for sending or receiving error
-    * 
-    * @param error - current error
+    * Callback function (interrupt context) when the send started by startNextSend() has finished.
+    * Counts the send as completed, and starts the next queued send (if there is one).
     */
-   void errorCallback(errorCode_t error);
+   void sendCompleteDriverHwCallback(void);
+
+   /**
+    * Sets the callback to receive any errors (the UART errors are handled by DebugPortDriver::errorCallback())
+    */
+   void setErrorCallback(void);
 
 private:
    /**
-    * Sets on interupt driven receive 
+    * Sets on interupt driven receive (unless it is already armed)
     * Arms to receive 1 byte of data
-    * Arm to receive that byte at the (m_receiveBuffer + m_currentBufferOffset)
+    * Arm to receive that byte at the ring's write index
+    * Note:  Called with the receive interrupt disabled, or from the receive interrupt.
     * 
-    * @return - return true if buffers to allocate data are valid 
+    * @return - return true if armed, false if the ring is full
     */
    bool armReceiveNextByte();
 
-   //! Number of bytes to receive
-   uint32_t m_receiveBufferSize;
+   /**
+    * Frames the bytes in the ring while a receive is in progress
+    * Note:  Called with the receive interrupt disabled, or from the receive interrupt.
+    */
+   void frameRingBytes();
+
+   /**
+    * Starts sending the oldest queued send (the one after the last completed send)
+    * Note:  Called with the transmit interrupt disabled, or from the transmit interrupt.
+    *
+    * @return - return true if the send was started
+    */
+   bool startNextSend();
+
+   //! A queued send
+   typedef struct
+   {
+      void* p_buffer;      //!< Start of the data to send
+      uint32_t numBytes;   //!< Number of bytes to send
+   } queuedSend_t;
+
+   //! Sends queued with sendData(), indexed by send count (modulo the queue size)
+   queuedSend_t m_queuedSends[SERIAL_PORT_DRIVER_MAX_NUM_QUEUED_SENDS];
+
+   //! Number of sends queued since power up (only changed by sendData())
+   volatile uint32_t m_numSendsQueued;
+
+   //! Number of sends completed since power up (only changed by the transmit interrupt, or with it disabled)
+   volatile uint32_t m_numSendsCompleted;
+
+   //! Bytes received, indexed by byte count (modulo the ring size)
+   uint8_t m_receiveRing[SERIAL_PORT_DRIVER_RECEIVE_NUM_BYTES];
+
+   //! Number of bytes framed since power up
+   volatile uint32_t m_receiveRingReadIndex;
 
-   //! Current offset of the receive buffer
+   //! Number of bytes received since power up
+   volatile uint32_t m_receiveRingWriteIndex;
 
-   uint32_t m_currentBufferOffset;
+   //! True while the bytes received are framed into the transport layer's buffer (from startReceive() until it is finished)
+   volatile bool m_receiveInProgress;
 
-   //! Pointer to receive buffer
-   void* mp_receiveBuffer;
+   //! True while the UART is armed to receive the byte at the ring's write index
+   volatile bool m_receiveArmed;
 
 };
 
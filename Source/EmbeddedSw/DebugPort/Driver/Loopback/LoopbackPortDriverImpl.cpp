@@ -0,0 +1,150 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include "LoopbackPortDriverImpl.hpp"
+#include <string.h>
+#include "ShimBase.hpp"
+
+STATIC_ASSERT((DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES & (DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES - 1)) == 0,
+        loopback_receive_size_must_be_a_power_of_2);
+STATIC_ASSERT((LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS & (LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)) == 0,
+        loopback_port_driver_send_queue_size_must_be_a_power_of_2);
+
+bool LoopbackPortDriverImpl::sendData(void* sendBuffer, uint32_t packetSize)
+{
+	if(packetSize == 0)
+	{
+		return true;
+	}
+
+	if((m_numSendsQueued - m_numSendsCompleted) >= LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS)
+	{
+		return false;
+	}
+
+	queuedSend_t& queuedSend = m_queuedSends[m_numSendsQueued & (LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)];
+	queuedSend.p_buffer = (const uint8_t*) sendBuffer;
+	queuedSend.numBytes = packetSize;
+	m_numSendsQueued++;
+	return true;
+}
+
+uint32_t LoopbackPortDriverImpl::getNumSendsQueued(void)
+{
+	return m_numSendsQueued;
+}
+
+uint32_t LoopbackPortDriverImpl::getNumSendsCompleted(void)
+{
+	return m_numSendsCompleted;
+}
+
+void LoopbackPortDriverImpl::abortSends(void)
+{
+	m_numSendsCompleted = m_numSendsQueued;
+	m_numBytesOfSendPulled = 0;
+}
+
+bool LoopbackPortDriverImpl::startReceive(void* receiveBuffer, uint32_t receiveSize)
+{
+	m_receiveInProgress = resetReceive(receiveBuffer, receiveSize);
+	return m_receiveInProgress;
+}
+
+uint32_t LoopbackPortDriverImpl::getCurrentBytesReceived(void)
+{
+	receiveWaitingBytes();
+	return m_currentBufferOffset;
+}
+
+uint32_t LoopbackPortDriverImpl::getReceivedFrameNumBytes(void)
+{
+	receiveWaitingBytes();
+	return m_receivedFrameNumBytes;
+}
+
+void LoopbackPortDriverImpl::stopReceive()
+{
+	m_receiveInProgress = false;
+}
+
+void LoopbackPortDriverImpl::setErrorCallback(void)
+{
+	// There are no line errors, but the simulator's shim can inject them (see ShimSimulator::injectReceiveError())
+	ShimBase::getInstance().startErrorCallback(this, &DebugPortDriver::errorCallback);
+}
+
+uint32_t LoopbackPortDriverImpl::pushReceiveData(const void* p_data, uint32_t numBytes)
+{
+	uint32_t numBytesFree = DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES - (m_receiveWriteIndex - m_receiveReadIndex);
+	if(numBytes > numBytesFree)
+	{
+		numBytes = numBytesFree;
+	}
+
+	const uint8_t* p_byte = (const uint8_t*) p_data;
+	for(uint32_t i = 0; i < numBytes; ++i)
+	{
+		m_receiveData[m_receiveWriteIndex & (DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES - 1)] = p_byte[i];
+		m_receiveWriteIndex++;
+	}
+	return numBytes;
+}
+
+uint32_t LoopbackPortDriverImpl::pullTransmitData(void* p_buffer, uint32_t maxNumBytes)
+{
+	uint8_t* p_destination = (uint8_t*) p_buffer;
+	uint32_t numBytesPulled = 0;
+	while((m_numSendsCompleted != m_numSendsQueued) && (numBytesPulled < maxNumBytes))
+	{
+		const queuedSend_t& queuedSend = m_queuedSends[m_numSendsCompleted & (LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)];
+		uint32_t numBytesToCopy = queuedSend.numBytes - m_numBytesOfSendPulled;
+		if(numBytesToCopy > (maxNumBytes - numBytesPulled))
+		{
+			numBytesToCopy = maxNumBytes - numBytesPulled;
+		}
+
+		memcpy(&p_destination[numBytesPulled], queuedSend.p_buffer + m_numBytesOfSendPulled, numBytesToCopy);
+		numBytesPulled += numBytesToCopy;
+		m_numBytesOfSendPulled += numBytesToCopy;
+		if(m_numBytesOfSendPulled == queuedSend.numBytes)
+		{
+			m_numSendsCompleted++;
+			m_numBytesOfSendPulled = 0;
+		}
+	}
+	return numBytesPulled;
+}
+
+void LoopbackPortDriverImpl::receiveWaitingBytes(void)
+{
+	// Bytes past the end of the packet are left waiting for the next receive
+	while((m_receiveReadIndex != m_receiveWriteIndex) && (m_receiveInProgress == true))
+	{
+		// The bytes up to the write index, or up to the end of the buffer if they wrap around it
+		uint32_t bufferOffset = m_receiveReadIndex & (DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES - 1);
+		uint32_t numBytes = m_receiveWriteIndex - m_receiveReadIndex;
+		if(numBytes > (DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES - bufferOffset))
+		{
+			numBytes = DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES - bufferOffset;
+		}
+
+		uint32_t numBytesUsed;
+		m_receiveInProgress = receivedBytes(&m_receiveData[bufferOffset], numBytes, numBytesUsed);
+		m_receiveReadIndex += numBytesUsed;
+	}
+}
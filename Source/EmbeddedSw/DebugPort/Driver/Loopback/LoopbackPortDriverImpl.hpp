@@ -0,0 +1,161 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __LOOPBACK_PORT_DRIVER_IMPL_H
+#define __LOOPBACK_PORT_DRIVER_IMPL_H
+#include "DebugPortDriver.hpp"
+
+//! Number of bytes from the host that can wait to be received (must be a power of 2)
+#ifndef DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES
+    #define DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES 4096
+#endif
+
+/**
+ * Number of sends that can be queued at once (must be a power of 2).  The transport layer queues a
+ * header and a payload for each packet it has in flight.
+ */
+#ifndef LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS
+    #define LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS 4
+#endif
+
+/**
+ * Loopback Port Driver.
+ * An in memory debug port for a host in the same process as the target (e.g. Python tests running the
+ * target from libcefsim, see CefSimulatorApi.hpp).  The host hands bytes to the target with
+ * pushReceiveData(), and takes the bytes the target sends with pullTransmitData().
+ *
+ * Nothing happens on its own: received bytes are framed (see DebugPortDriver::receivedByte()) when the
+ * transport layer asks how many bytes have been received, and a send completes once the host has pulled
+ * all of it (the bytes are pulled straight from the transport layer's buffer).
+ */
+class LoopbackPortDriverImpl : public DebugPortDriver {
+public:
+	//! Constructor.
+	LoopbackPortDriverImpl():DebugPortDriver(),
+	m_receiveInProgress(false),
+	m_receiveWriteIndex(0),
+	m_receiveReadIndex(0),
+	m_numSendsQueued(0),
+	m_numSendsCompleted(0),
+	m_numBytesOfSendPulled(0)
+	{}
+
+   /**
+    * See base class for method documentation
+    */
+   bool sendData(void* sendBuffer, uint32_t packetSize);
+
+   /**
+    * See base class for method documentation
+    */
+   uint32_t getNumSendsQueued(void);
+
+   /**
+    * See base class for method documentation
+    */
+   uint32_t getNumSendsCompleted(void);
+
+   /**
+    * See base class for method documentation
+    */
+   void abortSends(void);
+
+   /**
+    * See base class for method documentation
+    */
+   bool startReceive(void* receiveBuffer, uint32_t receiveSize);
+
+   /**
+    * See base class for method documentation (the bytes waiting from the host are received first)
+    */
+   uint32_t getCurrentBytesReceived(void);
+
+   /**
+    * See base class for method documentation (the bytes waiting from the host are received first)
+    */
+   uint32_t getReceivedFrameNumBytes(void);
+
+   /**
+    * See base class for method documentation
+    * */
+   void stopReceive();
+
+   /**
+    * Sets the callback to receive any errors (a loopback can't have errors, so there is nothing to set)
+    */
+   void setErrorCallback(void);
+
+   /**
+    * Hands bytes from the host to the target
+    *
+    * @param p_data - bytes from the host
+    * @param numBytes - number of bytes
+    *
+    * @return number of bytes taken (the rest have to be pushed again once the target has received more)
+    */
+   uint32_t pushReceiveData(const void* p_data, uint32_t numBytes);
+
+   /**
+    * Takes the bytes the target has sent
+    *
+    * @param p_buffer - where to copy the bytes to
+    * @param maxNumBytes - size of the buffer
+    *
+    * @return number of bytes copied
+    */
+   uint32_t pullTransmitData(void* p_buffer, uint32_t maxNumBytes);
+
+private:
+   /**
+    * Frames the bytes waiting from the host into the receive buffer, until the receive is finished or
+    * no more bytes are waiting
+    */
+   void receiveWaitingBytes(void);
+
+   //! A queued send
+   typedef struct
+   {
+      const uint8_t* p_buffer;   //!< Start of the data to send
+      uint32_t numBytes;         //!< Number of bytes to send
+   } queuedSend_t;
+
+   //! True from startReceive() until the receive is finished or stopped
+   bool m_receiveInProgress;
+
+   //! Bytes from the host waiting to be received
+   uint8_t m_receiveData[DEBUG_PORT_LOOPBACK_RECEIVE_NUM_BYTES];
+
+   //! Number of bytes pushed by the host (free running, the ring is empty when equal to m_receiveReadIndex)
+   uint32_t m_receiveWriteIndex;
+
+   //! Number of bytes received by the target (free running)
+   uint32_t m_receiveReadIndex;
+
+   //! Sends queued with sendData(), indexed by send count (modulo the queue size)
+   queuedSend_t m_queuedSends[LOOPBACK_PORT_DRIVER_MAX_NUM_QUEUED_SENDS];
+
+   //! Number of sends queued since power up
+   uint32_t m_numSendsQueued;
+
+   //! Number of sends completed (all pulled by the host) since power up
+   uint32_t m_numSendsCompleted;
+
+   //! Number of bytes of the oldest queued send already pulled by the host
+   uint32_t m_numBytesOfSendPulled;
+
+};
+
+#endif  // end header guard
@@ -0,0 +1,258 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include "SharedMemoryPortDriverImpl.hpp"
+
+#ifdef __SIMULATOR__
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "Logging.hpp"
+#include "ShimBase.hpp"
+
+STATIC_ASSERT((DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES & (DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - 1)) == 0,
+        shared_memory_ring_size_must_be_a_power_of_2);
+STATIC_ASSERT((SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS & (SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)) == 0,
+        shared_memory_port_driver_send_queue_size_must_be_a_power_of_2);
+STATIC_ASSERT(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), shared_memory_ring_indices_must_be_plain_32_bit_words);
+STATIC_ASSERT(sizeof(sharedMemoryPortHeader_t) == 320, shared_memory_layout_must_match_DebugSharedMemoryPort_py);
+
+bool SharedMemoryPortDriverImpl::sendData(void* sendBuffer, uint32_t packetSize)
+{
+	if(packetSize == 0)
+	{
+		return true;
+	}
+
+	if((m_numSendsQueued - m_numSendsCompleted) >= SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS)
+	{
+		return false;
+	}
+
+	queuedSend_t& queuedSend = m_queuedSends[m_numSendsQueued & (SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)];
+	queuedSend.p_buffer = (const uint8_t*) sendBuffer;
+	queuedSend.numBytes = packetSize;
+	m_numSendsQueued++;
+
+	// Start right away, rather than waiting for the transport layer to poll for completion
+	transmitQueuedSends();
+	return true;
+}
+
+uint32_t SharedMemoryPortDriverImpl::getNumSendsQueued(void)
+{
+	return m_numSendsQueued;
+}
+
+uint32_t SharedMemoryPortDriverImpl::getNumSendsCompleted(void)
+{
+	transmitQueuedSends();
+	return m_numSendsCompleted;
+}
+
+void SharedMemoryPortDriverImpl::abortSends(void)
+{
+	// The host stopped reading the ring, what was already copied into it stays there for the host to read
+	m_numSendsCompleted = m_numSendsQueued;
+	m_numBytesOfSendCopied = 0;
+}
+
+bool SharedMemoryPortDriverImpl::startReceive(void* receiveBuffer, uint32_t receiveSize)
+{
+	m_receiveInProgress = resetReceive(receiveBuffer, receiveSize);
+	return m_receiveInProgress;
+}
+
+uint32_t SharedMemoryPortDriverImpl::getCurrentBytesReceived(void)
+{
+	receiveWaitingBytes();
+	return m_currentBufferOffset;
+}
+
+uint32_t SharedMemoryPortDriverImpl::getReceivedFrameNumBytes(void)
+{
+	receiveWaitingBytes();
+	return m_receivedFrameNumBytes;
+}
+
+void SharedMemoryPortDriverImpl::stopReceive()
+{
+	m_receiveInProgress = false;
+}
+
+void SharedMemoryPortDriverImpl::setErrorCallback(void)
+{
+	// There are no line errors, but the simulator's shim can inject them (see ShimSimulator::injectReceiveError())
+	ShimBase::getInstance().startErrorCallback(this, &DebugPortDriver::errorCallback);
+}
+
+void SharedMemoryPortDriverImpl::transmitQueuedSends(void)
+{
+	if(m_numSendsCompleted == m_numSendsQueued)
+	{
+		return;
+	}
+
+	if(openSharedMemory() == false)
+	{
+		// Like a serial port with nothing attached, the data is lost
+		m_numSendsCompleted = m_numSendsQueued;
+		m_numBytesOfSendCopied = 0;
+		return;
+	}
+
+	sharedMemoryRing_t& ring = mp_sharedMemory->toHost;
+	uint32_t writeIndex = ring.writeIndex.load(std::memory_order_relaxed);
+	uint32_t numBytesFree = DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - (writeIndex - ring.readIndex.load(std::memory_order_acquire));
+	if(numBytesFree == 0)
+	{
+		// The host is behind, try again next time
+		return;
+	}
+
+	while((m_numSendsCompleted != m_numSendsQueued) && (numBytesFree > 0))
+	{
+		const queuedSend_t& queuedSend = m_queuedSends[m_numSendsCompleted & (SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS - 1)];
+		uint32_t numBytesToCopy = queuedSend.numBytes - m_numBytesOfSendCopied;
+		if(numBytesToCopy > numBytesFree)
+		{
+			numBytesToCopy = numBytesFree;
+		}
+
+		// Up to the end of the ring, then the rest from the start
+		uint32_t ringOffset = writeIndex & (DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - 1);
+		uint32_t numBytesToEnd = DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - ringOffset;
+		const uint8_t* p_data = queuedSend.p_buffer + m_numBytesOfSendCopied;
+		if(numBytesToCopy <= numBytesToEnd)
+		{
+			memcpy(&mp_toHostData[ringOffset], p_data, numBytesToCopy);
+		}
+		else
+		{
+			memcpy(&mp_toHostData[ringOffset], p_data, numBytesToEnd);
+			memcpy(&mp_toHostData[0], p_data + numBytesToEnd, numBytesToCopy - numBytesToEnd);
+		}
+
+		writeIndex += numBytesToCopy;
+		numBytesFree -= numBytesToCopy;
+		m_numBytesOfSendCopied += numBytesToCopy;
+		if(m_numBytesOfSendCopied == queuedSend.numBytes)
+		{
+			m_numSendsCompleted++;
+			m_numBytesOfSendCopied = 0;
+		}
+	}
+
+	/**
+	 * Publish the data, then wake the host if it is sleeping on the write index.  Both are sequentially
+	 * consistent, so the host can't miss the new write index after saying it is going to sleep.
+	 */
+	ring.writeIndex.store(writeIndex, std::memory_order_seq_cst);
+	if(ring.consumerWaiting.load(std::memory_order_seq_cst) != 0)
+	{
+		syscall(SYS_futex, &ring.writeIndex, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+	}
+}
+
+void SharedMemoryPortDriverImpl::receiveWaitingBytes(void)
+{
+	if((m_receiveInProgress == false) || (openSharedMemory() == false))
+	{
+		return;
+	}
+
+	sharedMemoryRing_t& ring = mp_sharedMemory->toTarget;
+	uint32_t readIndex = ring.readIndex.load(std::memory_order_relaxed);
+	uint32_t writeIndex = ring.writeIndex.load(std::memory_order_acquire);
+	if(readIndex == writeIndex)
+	{
+		return;
+	}
+
+	// Bytes past the end of the packet are left in the ring for the next receive
+	while((readIndex != writeIndex) && (m_receiveInProgress == true))
+	{
+		// The bytes up to the write index, or up to the end of the ring if they wrap around it
+		uint32_t ringOffset = readIndex & (DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - 1);
+		uint32_t numBytes = writeIndex - readIndex;
+		if(numBytes > (DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - ringOffset))
+		{
+			numBytes = DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES - ringOffset;
+		}
+
+		uint32_t numBytesUsed;
+		m_receiveInProgress = receivedBytes(&mp_toTargetData[ringOffset], numBytes, numBytesUsed);
+		readIndex += numBytesUsed;
+	}
+
+	ring.readIndex.store(readIndex, std::memory_order_release);
+}
+
+bool SharedMemoryPortDriverImpl::openSharedMemory(void)
+{
+	if(mp_sharedMemory != nullptr)
+	{
+		return true;
+	}
+	if(m_sharedMemoryOpenFailed == true)
+	{
+		return false;
+	}
+
+	/**
+	 * A region left over from a previous run is replaced rather than reused, so the host sees a fresh start
+	 * (a host still attached to the old region keeps a valid mapping of it, and has to reopen)
+	 */
+	uint32_t numBytesInRegion = sizeof(sharedMemoryPortHeader_t) + (2 * DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES);
+	void* p_region = MAP_FAILED;
+	shm_unlink(mp_name);
+	int sharedMemoryFile = shm_open(mp_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if((sharedMemoryFile >= 0) && (ftruncate(sharedMemoryFile, numBytesInRegion) == 0))
+	{
+		p_region = mmap(nullptr, numBytesInRegion, PROT_READ | PROT_WRITE, MAP_SHARED, sharedMemoryFile, 0);
+	}
+	int openErrno = errno;
+	if(sharedMemoryFile >= 0)
+	{
+		close(sharedMemoryFile);
+	}
+
+	if(p_region == MAP_FAILED)
+	{
+		// Not fatal, as the fatal error handling would try to send the log out of this driver
+		m_sharedMemoryOpenFailed = true;
+		LOG_ERROR(Logging::LogModuleIdCefInfrastructure, "Debug port shared memory could not be created. errno={:d}",
+		        openErrno, 0, 0);
+		return false;
+	}
+
+	// The region is all zeros (empty rings), the host uses it once the magic number is set
+	mp_sharedMemory = (sharedMemoryPortHeader_t*) p_region;
+	mp_sharedMemory->ringNumBytes = DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES;
+	mp_toTargetData = (uint8_t*) p_region + sizeof(sharedMemoryPortHeader_t);
+	mp_toHostData = mp_toTargetData + DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES;
+	mp_sharedMemory->magic.store(DEBUG_PORT_SHARED_MEMORY_MAGIC, std::memory_order_release);
+	return true;
+}
+
+#endif // __SIMULATOR__
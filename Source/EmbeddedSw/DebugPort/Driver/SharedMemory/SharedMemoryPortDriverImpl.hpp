@@ -0,0 +1,220 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __SHARED_MEMORY_PORT_DRIVER_IMPL_H
+#define __SHARED_MEMORY_PORT_DRIVER_IMPL_H
+#include "DebugPortDriver.hpp"
+
+#ifdef __SIMULATOR__
+#include <atomic>
+
+//! Name of the POSIX shared memory region the simulator serves the debug port on (/dev/shm/cefDebugPort)
+#ifndef DEBUG_PORT_SHARED_MEMORY_NAME
+    #define DEBUG_PORT_SHARED_MEMORY_NAME "/cefDebugPort"
+#endif
+
+//! Number of bytes in each ring (must be a power of 2)
+#ifndef DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES
+    #define DEBUG_PORT_SHARED_MEMORY_RING_NUM_BYTES 65536
+#endif
+
+/**
+ * Number of sends that can be queued at once (must be a power of 2).  The transport layer queues a
+ * header and a payload for each packet it has in flight.
+ */
+#ifndef SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS
+    #define SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS 4
+#endif
+
+//! Value of sharedMemoryPortHeader_t.magic once the region is ready for the host
+#define DEBUG_PORT_SHARED_MEMORY_MAGIC 0x53464543
+
+/**
+ * Indices of a single producer single consumer byte ring.  The indices are free running byte counts (they wrap
+ * at 32 bits), so the ring is empty when they are equal and full when they differ by the ring size.  Each index
+ * has its own cache line, so the producer and consumer don't slow each other down.
+ */
+typedef struct
+{
+   //! Number of bytes written since the region was created (only changed by the producer)
+   std::atomic<uint32_t> writeIndex;
+   uint8_t padding0[60];
+   //! Number of bytes read since the region was created (only changed by the consumer)
+   std::atomic<uint32_t> readIndex;
+   //! Non zero while the consumer sleeps on writeIndex (futex), so the producer knows to wake it
+   std::atomic<uint32_t> consumerWaiting;
+   uint8_t padding1[56];
+} sharedMemoryRing_t;
+
+/**
+ * Start of the shared memory region.  The data of the ring to the target follows the header, then the data of
+ * the ring to the host.  Must match DebugSharedMemoryPort.py.
+ */
+typedef struct
+{
+   //! DEBUG_PORT_SHARED_MEMORY_MAGIC once the rest of the region has been set up
+   std::atomic<uint32_t> magic;
+   //! Number of bytes in each ring
+   uint32_t ringNumBytes;
+   uint8_t padding[56];
+   //! Bytes from the host to the target
+   sharedMemoryRing_t toTarget;
+   //! Bytes from the target to the host
+   sharedMemoryRing_t toHost;
+} sharedMemoryPortHeader_t;
+
+/**
+ * Shared Memory Port Driver for the simulator.
+ * It serves the debug port on a POSIX shared memory region holding two lock free single producer single
+ * consumer byte rings, so a host on the same machine (DebugSharedMemoryPort.py) exchanges packets without
+ * a system call per send or receive.
+ *
+ * The target never waits: as with the socket driver, the ring from the host is framed (see
+ * DebugPortDriver::receivedByte()) when the transport layer asks how many bytes have been received, and
+ * queued sends are copied into the ring to the host when the transport layer asks how many have completed.
+ * A send completes once it has all been copied, so a host that stops reading holds up the transport layer
+ * rather than losing packets.  The host sleeps on the ring's write index (futex) when it has nothing to
+ * read, and is woken by the target only then.
+ *
+ * The region is created on first use (replacing one left over from a previous run), so the host must
+ * open it after the simulator has started.
+ */
+class SharedMemoryPortDriverImpl : public DebugPortDriver {
+public:
+	/**
+	 * Constructor.  The region is created on first use, so a driver can be constructed before the simulator
+	 * is ready for it (e.g. as a static).
+	 *
+	 * @param p_name - name of the POSIX shared memory region
+	 */
+	SharedMemoryPortDriverImpl(const char* p_name = DEBUG_PORT_SHARED_MEMORY_NAME):DebugPortDriver(),
+	mp_name(p_name),
+	mp_sharedMemory(nullptr),
+	mp_toTargetData(nullptr),
+	mp_toHostData(nullptr),
+	m_sharedMemoryOpenFailed(false),
+	m_receiveInProgress(false),
+	m_numSendsQueued(0),
+	m_numSendsCompleted(0),
+	m_numBytesOfSendCopied(0)
+	{}
+
+   /**
+    * See base class for method documentation
+    */
+   bool sendData(void* sendBuffer, uint32_t packetSize);
+
+   /**
+    * See base class for method documentation
+    */
+   uint32_t getNumSendsQueued(void);
+
+   /**
+    * See base class for method documentation (queued sends are copied into the ring first)
+    */
+   uint32_t getNumSendsCompleted(void);
+
+   /**
+    * See base class for method documentation
+    */
+   void abortSends(void);
+
+   /**
+    * See base class for method documentation
+    */
+   bool startReceive(void* receiveBuffer, uint32_t receiveSize);
+
+   /**
+    * See base class for method documentation (the bytes waiting in the ring are received first)
+    */
+   uint32_t getCurrentBytesReceived(void);
+
+   /**
+    * See base class for method documentation (the bytes waiting in the ring are received first)
+    */
+   uint32_t getReceivedFrameNumBytes(void);
+
+   /**
+    * See base class for method documentation
+    * */
+   void stopReceive();
+
+   /**
+    * Sets the callback to receive any errors (the rings can't have errors, so there is nothing to set)
+    */
+   void setErrorCallback(void);
+
+private:
+   /**
+    * Creates the shared memory region if it is not open yet
+    *
+    * @return true if the region is open
+    */
+   bool openSharedMemory(void);
+
+   /**
+    * Copies as much of the queued sends as there is room for into the ring to the host
+    */
+   void transmitQueuedSends(void);
+
+   /**
+    * Frames the bytes waiting in the ring from the host into the receive buffer, until the receive is
+    * finished or no more bytes are waiting
+    */
+   void receiveWaitingBytes(void);
+
+   //! A queued send
+   typedef struct
+   {
+      const uint8_t* p_buffer;   //!< Start of the data to send
+      uint32_t numBytes;         //!< Number of bytes to send
+   } queuedSend_t;
+
+   //! Name of the POSIX shared memory region
+   const char* mp_name;
+
+   //! The shared memory region, nullptr until created
+   sharedMemoryPortHeader_t* mp_sharedMemory;
+
+   //! Data of the ring from the host
+   uint8_t* mp_toTargetData;
+
+   //! Data of the ring to the host
+   uint8_t* mp_toHostData;
+
+   //! True once creating the region has failed (so the failure is only logged once)
+   bool m_sharedMemoryOpenFailed;
+
+   //! True from startReceive() until the receive is finished or stopped
+   bool m_receiveInProgress;
+
+   //! Sends queued with sendData(), indexed by send count (modulo the queue size)
+   queuedSend_t m_queuedSends[SHARED_MEMORY_PORT_DRIVER_MAX_NUM_QUEUED_SENDS];
+
+   //! Number of sends queued since power up
+   uint32_t m_numSendsQueued;
+
+   //! Number of sends completed (all copied into the ring to the host) since power up
+   uint32_t m_numSendsCompleted;
+
+   //! Number of bytes of the oldest queued send already copied into the ring to the host
+   uint32_t m_numBytesOfSendCopied;
+
+};
+
+#endif // __SIMULATOR__
+
+#endif  // end header guard
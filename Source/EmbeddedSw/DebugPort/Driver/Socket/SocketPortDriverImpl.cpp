@@ -0,0 +1,264 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+
+#include "SocketPortDriverImpl.hpp"
+
+#ifdef __SIMULATOR__
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "Logging.hpp"
+#include "ShimBase.hpp"
+
+//! How long a send waits for the host to make room for the data before the host is dropped
+static const int socketSendTimeoutMs = 1000;
+
+bool SocketPortDriverImpl::sendData(void* sendBuffer, uint32_t packetSize)
+{
+	// Like a serial port with nothing attached, data sent while no host is listening is lost
+	m_numSends++;
+	if((packetSize == 0) || (openServerSocket() == false))
+	{
+		return true;
+	}
+
+	if(m_socketType == socketTypeUdp)
+	{
+		if(m_hostPort != 0)
+		{
+			struct sockaddr_in hostAddress;
+			memset(&hostAddress, 0, sizeof(hostAddress));
+			hostAddress.sin_family = AF_INET;
+			hostAddress.sin_addr.s_addr = m_hostIpAddress;
+			hostAddress.sin_port = m_hostPort;
+			sendto(m_serverSocket, sendBuffer, packetSize, 0, (struct sockaddr*) &hostAddress, sizeof(hostAddress));
+		}
+		return true;
+	}
+
+	if(m_connectionSocket < 0)
+	{
+		// Accept a host that is waiting, so the logs sent before its first command are not lost
+		readSocket();
+	}
+
+	const uint8_t* p_data = (const uint8_t*) sendBuffer;
+	while((packetSize > 0) && (m_connectionSocket >= 0))
+	{
+		ssize_t numBytesSent = send(m_connectionSocket, p_data, packetSize, MSG_NOSIGNAL);
+		if(numBytesSent > 0)
+		{
+			p_data += numBytesSent;
+			packetSize -= (uint32_t) numBytesSent;
+		}
+		else if((numBytesSent < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+		{
+			// The host is behind, wait for it to read
+			struct pollfd pollSocket = {m_connectionSocket, POLLOUT, 0};
+			if(poll(&pollSocket, 1, socketSendTimeoutMs) == 0)
+			{
+				closeConnection();
+			}
+		}
+		else
+		{
+			closeConnection();
+		}
+	}
+	return true;
+}
+
+uint32_t SocketPortDriverImpl::getNumSendsQueued(void)
+{
+	return m_numSends;
+}
+
+uint32_t SocketPortDriverImpl::getNumSendsCompleted(void)
+{
+	return m_numSends;
+}
+
+void SocketPortDriverImpl::abortSends(void)
+{
+	// Nothing to do, each send is complete by the time sendData() returns
+}
+
+bool SocketPortDriverImpl::startReceive(void* receiveBuffer, uint32_t receiveSize)
+{
+	m_receiveInProgress = resetReceive(receiveBuffer, receiveSize);
+	return m_receiveInProgress;
+}
+
+uint32_t SocketPortDriverImpl::getCurrentBytesReceived(void)
+{
+	receiveWaitingBytes();
+	return m_currentBufferOffset;
+}
+
+uint32_t SocketPortDriverImpl::getReceivedFrameNumBytes(void)
+{
+	receiveWaitingBytes();
+	return m_receivedFrameNumBytes;
+}
+
+void SocketPortDriverImpl::stopReceive()
+{
+	m_receiveInProgress = false;
+}
+
+void SocketPortDriverImpl::setErrorCallback(void)
+{
+	// There are no line errors, but the simulator's shim can inject them (see ShimSimulator::injectReceiveError())
+	ShimBase::getInstance().startErrorCallback(this, &DebugPortDriver::errorCallback);
+}
+
+void SocketPortDriverImpl::receiveWaitingBytes(void)
+{
+	while(m_receiveInProgress == true)
+	{
+		if(m_socketReceiveOffset >= m_socketReceiveNumBytes)
+		{
+			if(readSocket() == false)
+			{
+				return;
+			}
+		}
+
+		uint32_t numBytesUsed;
+		m_receiveInProgress = receivedBytes(&m_socketReceiveBuffer[m_socketReceiveOffset],
+		        m_socketReceiveNumBytes - m_socketReceiveOffset, numBytesUsed);
+		m_socketReceiveOffset += numBytesUsed;
+	}
+}
+
+bool SocketPortDriverImpl::readSocket(void)
+{
+	if(openServerSocket() == false)
+	{
+		return false;
+	}
+
+	ssize_t numBytesRead;
+	if(m_socketType == socketTypeUdp)
+	{
+		struct sockaddr_in hostAddress;
+		socklen_t hostAddressSize = sizeof(hostAddress);
+		numBytesRead = recvfrom(m_serverSocket, m_socketReceiveBuffer, sizeof(m_socketReceiveBuffer), 0,
+		        (struct sockaddr*) &hostAddress, &hostAddressSize);
+		if(numBytesRead >= 0)
+		{
+			// Reply to whoever sent the last datagram (an empty one just says where to send to)
+			m_hostIpAddress = hostAddress.sin_addr.s_addr;
+			m_hostPort = hostAddress.sin_port;
+		}
+	}
+	else
+	{
+		if(m_connectionSocket < 0)
+		{
+			m_connectionSocket = accept4(m_serverSocket, nullptr, nullptr, SOCK_NONBLOCK);
+			if(m_connectionSocket < 0)
+			{
+				return false;
+			}
+			int noDelay = 1;
+			setsockopt(m_connectionSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		}
+
+		numBytesRead = recv(m_connectionSocket, m_socketReceiveBuffer, sizeof(m_socketReceiveBuffer), 0);
+		if((numBytesRead == 0) || ((numBytesRead < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+		{
+			// The host disconnected, the next host starts with a new packet
+			closeConnection();
+			return false;
+		}
+	}
+
+	if(numBytesRead <= 0)
+	{
+		return false;
+	}
+	m_socketReceiveNumBytes = (uint32_t) numBytesRead;
+	m_socketReceiveOffset = 0;
+	return true;
+}
+
+bool SocketPortDriverImpl::openServerSocket(void)
+{
+	if(m_serverSocket >= 0)
+	{
+		return true;
+	}
+
+	int socketType = (m_socketType == socketTypeUdp) ? SOCK_DGRAM : SOCK_STREAM;
+	int serverSocket = socket(AF_INET, socketType | SOCK_NONBLOCK, 0);
+	if(serverSocket < 0)
+	{
+		return false;
+	}
+
+	int reuseAddress = 1;
+	setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+
+	struct sockaddr_in serverAddress;
+	memset(&serverAddress, 0, sizeof(serverAddress));
+	serverAddress.sin_family = AF_INET;
+	serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	serverAddress.sin_port = htons(m_port);
+	if((bind(serverSocket, (struct sockaddr*) &serverAddress, sizeof(serverAddress)) != 0) ||
+	   ((m_socketType == socketTypeTcp) && (listen(serverSocket, 1) != 0)))
+	{
+		int openErrno = errno;
+		close(serverSocket);
+		if(m_socketOpenFailed == false)
+		{
+			// Not fatal, as the fatal error handling would try to send the log out of this socket
+			m_socketOpenFailed = true;
+			LOG_ERROR(Logging::LogModuleIdCefInfrastructure, "Debug port socket could not be opened. port={:d}, errno={:d}",
+			        m_port, openErrno, 0);
+		}
+		return false;
+	}
+
+	m_serverSocket = serverSocket;
+	return true;
+}
+
+void SocketPortDriverImpl::closeConnection(void)
+{
+	if(m_connectionSocket >= 0)
+	{
+		close(m_connectionSocket);
+		m_connectionSocket = -1;
+	}
+
+	/**
+	 * Whatever was left of the host's data is discarded.  A packet the host was in the middle of is completed
+	 * by the next host's data, and then rejected by the transport layer (checksum), as a packet cut short on a
+	 * serial port would be.
+	 */
+	m_socketReceiveNumBytes = 0;
+	m_socketReceiveOffset = 0;
+}
+
+#endif // __SIMULATOR__
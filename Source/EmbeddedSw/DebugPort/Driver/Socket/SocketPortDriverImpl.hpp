@@ -0,0 +1,194 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __SOCKET_PORT_DRIVER_IMPL_H
+#define __SOCKET_PORT_DRIVER_IMPL_H
+#include "DebugPortDriver.hpp"
+
+#ifdef __SIMULATOR__
+
+//! Localhost port the simulator serves the debug port on
+#ifndef DEBUG_PORT_SOCKET_PORT
+    #define DEBUG_PORT_SOCKET_PORT 50000
+#endif
+
+//! Number of bytes read from the socket at once (a UDP datagram bigger than this is truncated)
+#ifndef DEBUG_PORT_SOCKET_RECEIVE_BUFFER_SIZE
+    #define DEBUG_PORT_SOCKET_RECEIVE_BUFFER_SIZE 2048
+#endif
+
+/**
+ * Socket Port Driver for the simulator.
+ * It serves the debug port on a localhost (127.0.0.1) TCP or UDP socket, so the Python utilities
+ * (DebugSocketPort.py) can connect to a simulated target without a serial port.
+ *
+ * The socket is non blocking and there are no interrupts in the simulator, so received bytes are read from
+ * the socket when the transport layer asks how many bytes have been received, and framed byte by byte
+ * (see DebugPortDriver::receivedByte()) exactly as the serial driver frames them.  Bytes read past the end
+ * of a packet are kept for the next receive.
+ *
+ * TCP:  one host at a time, a new host can connect once the previous one has disconnected.
+ * UDP:  replies go to the host the last datagram came from.  Datagrams are handled as a byte stream (packet
+ *       boundaries come from the framing, not from the datagrams), so nothing is sent until the host has sent
+ *       a datagram (an empty one will do).
+ *
+ * Sends complete before sendData() returns, so a send is never left in flight.
+ */
+class SocketPortDriverImpl : public DebugPortDriver {
+public:
+   //! Socket types
+   typedef enum
+   {
+      socketTypeTcp,
+      socketTypeUdp
+   } socketType_t;
+
+	/**
+	 * Constructor.  The socket is opened on first use, so a driver can be constructed before the simulator
+	 * is ready for it (e.g. as a static).
+	 *
+	 * @param socketType - TCP or UDP (by default the one picked with DEBUG_PORT_DRIVER)
+	 * @param port - localhost port to serve the debug port on
+	 */
+	SocketPortDriverImpl(socketType_t socketType =
+	        ((DEBUG_PORT_DRIVER == DEBUG_PORT_DRIVER_UDP) ? socketTypeUdp : socketTypeTcp),
+	        uint16_t port = DEBUG_PORT_SOCKET_PORT):DebugPortDriver(),
+	m_socketType(socketType),
+	m_port(port),
+	m_serverSocket(-1),
+	m_connectionSocket(-1),
+	m_socketOpenFailed(false),
+	m_hostIpAddress(0),
+	m_hostPort(0),
+	m_receiveInProgress(false),
+	m_socketReceiveNumBytes(0),
+	m_socketReceiveOffset(0),
+	m_numSends(0)
+	{}
+
+   /**
+    * See base class for method documentation
+    */
+   bool sendData(void* sendBuffer, uint32_t packetSize);
+
+   /**
+    * See base class for method documentation
+    */
+   uint32_t getNumSendsQueued(void);
+
+   /**
+    * See base class for method documentation
+    */
+   uint32_t getNumSendsCompleted(void);
+
+   /**
+    * See base class for method documentation
+    */
+   void abortSends(void);
+
+   /**
+    * See base class for method documentation
+    */
+   bool startReceive(void* receiveBuffer, uint32_t receiveSize);
+
+   /**
+    * See base class for method documentation (the bytes waiting on the socket are received first)
+    */
+   uint32_t getCurrentBytesReceived(void);
+
+   /**
+    * See base class for method documentation (the bytes waiting on the socket are received first)
+    */
+   uint32_t getReceivedFrameNumBytes(void);
+
+   /**
+    * See base class for method documentation
+    * */
+   void stopReceive();
+
+   /**
+    * Sets the callback to receive any errors (socket errors are handled by dropping the connection,
+    * so there is nothing to set)
+    */
+   void setErrorCallback(void);
+
+private:
+   /**
+    * Opens the server socket if it is not open yet
+    *
+    * @return true if the server socket is open
+    */
+   bool openServerSocket(void);
+
+   /**
+    * Closes the connection to the host (TCP), so the next host can connect
+    */
+   void closeConnection(void);
+
+   /**
+    * Frames the bytes waiting on the socket into the receive buffer, until the receive is finished or
+    * no more bytes are waiting
+    */
+   void receiveWaitingBytes(void);
+
+   /**
+    * Reads the bytes waiting on the socket into m_socketReceiveBuffer (accepting a host first with TCP)
+    *
+    * @return true if bytes were read
+    */
+   bool readSocket(void);
+
+   //! TCP or UDP
+   socketType_t m_socketType;
+
+   //! Localhost port the debug port is served on
+   uint16_t m_port;
+
+   //! Listening socket (TCP) or the socket (UDP), -1 until opened
+   int m_serverSocket;
+
+   //! Socket connected to the host (TCP), -1 if no host is connected
+   int m_connectionSocket;
+
+   //! True once opening the server socket has failed (so the failure is only logged once)
+   bool m_socketOpenFailed;
+
+   //! Address of the host the last datagram came from (UDP, network byte order), 0 until one is received
+   uint32_t m_hostIpAddress;
+
+   //! Port of the host the last datagram came from (UDP, network byte order)
+   uint16_t m_hostPort;
+
+   //! True from startReceive() until the receive is finished or stopped
+   bool m_receiveInProgress;
+
+   //! Bytes read from the socket that have not been framed yet
+   uint8_t m_socketReceiveBuffer[DEBUG_PORT_SOCKET_RECEIVE_BUFFER_SIZE];
+
+   //! Number of bytes read into m_socketReceiveBuffer
+   uint32_t m_socketReceiveNumBytes;
+
+   //! Offset of the next byte in m_socketReceiveBuffer to frame
+   uint32_t m_socketReceiveOffset;
+
+   //! Number of sends since power up (each one is complete by the time sendData() returns)
+   uint32_t m_numSends;
+
+};
+
+#endif // __SIMULATOR__
+
+#endif  // end header guard
@@ -14,6 +14,7 @@ with any information storage or retrieval system, without the prior
 written permission of Syncroness.
 ****************************************************************** */
 
+#include <string.h>
 #include "FramingSignatureVerify.hpp"
 #include "cefContract.hpp"
 #include "Logging.hpp"
@@ -48,6 +49,100 @@ uint8_t FramingSignatureVerify::checkFramingSignatureByte(void* receiveBuffer, u
 			uint8_t nextVal = byteOffset  + 1;
 			return nextVal;
 		}
-    //If not the correct framing signature byte back to 0 offset in write buffer
+
+	/**
+	 * Not the correct framing signature byte.  A framing signature may still start after the first byte received
+	 * (e.g. "CCEFS"), so move the longest run of bytes received that is the start of a framing signature to the
+	 * start of the write buffer (without this, the framing signature would be missed and its packet skipped)
+	 */
+	uint8_t* p_received = (uint8_t *)receiveBuffer;
+	for(uint8_t start = 1; start <= byteOffset; ++start)
+	{
+		uint8_t numBytesMatched = byteOffset + 1 - start;
+		if(memcmp(&p_received[start], debugPacketFramingSignature, numBytesMatched) == 0)
+		{
+			memmove(p_received, &p_received[start], numBytesMatched);
+			return numBytesMatched;
+		}
+	}
+
+    //If not the start of a framing signature back to 0 offset in write buffer
 	return 0;
 }
+
+uint32_t FramingSignatureVerify::findFramingSignature(const void* p_data, uint32_t numBytes)
+{
+	const uint8_t* p_bytes = (const uint8_t*) p_data;
+	uint32_t offset = findFirstFramingSignatureByte(p_bytes, 0, numBytes);
+	while(offset < numBytes)
+	{
+		// Compare the rest of the framing signature (as much of it as is in the data)
+		uint32_t numBytesToCompare = numBytes - offset;
+		if(numBytesToCompare > numElementsInDebugPacketFramingSignature)
+		{
+			numBytesToCompare = numElementsInDebugPacketFramingSignature;
+		}
+		if(memcmp(&p_bytes[offset], debugPacketFramingSignature, numBytesToCompare) == 0)
+		{
+			return offset;
+		}
+		offset = findFirstFramingSignatureByte(p_bytes, offset + 1, numBytes);
+	}
+	return numBytes;
+}
+
+uint32_t FramingSignatureVerify::findFirstFramingSignatureByte(const uint8_t* p_data, uint32_t offset, uint32_t numBytes)
+{
+	if(offset >= numBytes)
+	{
+		return numBytes;
+	}
+
+#if defined(__SIMULATOR__)
+	// The host's C library searches with SSE2/AVX2 (or NEON) compares
+	const uint8_t* p_found = (const uint8_t*) memchr(&p_data[offset], debugPacketFramingSignature[0], numBytes - offset);
+	if(p_found == nullptr)
+	{
+		return numBytes;
+	}
+	return (uint32_t) (p_found - p_data);
+#else
+	// Bytes up to a word boundary one at a time
+	while((offset < numBytes) && ((((uintptr_t) &p_data[offset]) & (sizeof(uint32_t) - 1)) != 0))
+	{
+		if(p_data[offset] == debugPacketFramingSignature[0])
+		{
+			return offset;
+		}
+		offset++;
+	}
+
+	/**
+	 * Then a word at a time: XOR with the first byte repeated in every byte lane makes the lanes that match zero,
+	 * and (word - 0x01010101) & ~word & 0x80808080 is non-zero if any lane is zero
+	 */
+	const uint32_t firstBytePattern = 0x01010101u * debugPacketFramingSignature[0];
+	while((numBytes - offset) >= sizeof(uint32_t))
+	{
+		uint32_t word;
+		memcpy(&word, &p_data[offset], sizeof(word));
+		word ^= firstBytePattern;
+		if(((word - 0x01010101u) & ~word & 0x80808080u) != 0)
+		{
+			break;
+		}
+		offset += sizeof(uint32_t);
+	}
+
+	// The word holding a match, and bytes after the last whole word, one at a time
+	while(offset < numBytes)
+	{
+		if(p_data[offset] == debugPacketFramingSignature[0])
+		{
+			return offset;
+		}
+		offset++;
+	}
+	return numBytes;
+#endif
+}
@@ -17,6 +17,7 @@ written permission of Syncroness.
 #ifndef __FRAMING_SIGNATURE_VERIFY_H
 #define __FRAMING_SIGNATURE_VERIFY_H
 #include <stdio.h>
+#include <cstdint>
 
 /**
  * Helper to check framing signature
@@ -49,10 +50,37 @@ private:
     * @param byte to check in the framing signature 
     * 
     * @return When the data is the same it will return the byteOffset + 1
-    *  - When the data does not match the framing signature it will return 0
+    *  - When the data does not match the framing signature, the bytes received so far (including this one) may still
+    *    hold the start of a framing signature; it is moved to the start of the buffer and the number of its bytes is
+    *    returned (0 if there is none)
     *  - If byteOffset is greater than the framing signature size it will return 0
     */
    static uint8_t checkFramingSignatureByte(void* receiveBuffer, uint8_t byteOffset);
+
+   /**
+    * Searches a chunk of received data for the framing signature, without looking at each byte one at a time
+    * (the first framing signature byte is searched for a word at a time, or with memchr() on the simulator,
+    * which the C library vectorizes)
+    *
+    * @param p_data     received data
+    * @param numBytes   number of bytes of received data
+    *
+    * @return offset of the first framing signature in the data, or of the start of one cut off by the end of the
+    *  data (the rest may be in the next chunk); numBytes if the data holds neither
+    */
+   static uint32_t findFramingSignature(const void* p_data, uint32_t numBytes);
+
+private:
+   /**
+    * Searches for the first byte of the framing signature
+    *
+    * @param p_data     data to search
+    * @param offset     where to start searching
+    * @param numBytes   number of bytes of data
+    *
+    * @return offset of the first framing signature byte at or after offset, numBytes if there is none
+    */
+   static uint32_t findFirstFramingSignatureByte(const uint8_t* p_data, uint32_t offset, uint32_t numBytes);
 };
 
 #endif  // end header guard
@@ -0,0 +1,114 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include <string.h>
+
+#include "EventQueue.hpp"
+#include "CommandDebugPortRouter.hpp"
+#include "ShimBase.hpp"
+
+/**
+ * Implementation of EventQueue Methods
+ * See notes in EventQueue.hpp for the use model of the class
+ */
+
+STATIC_ASSERT((EVENT_QUEUE_NUM_EVENTS & (EVENT_QUEUE_NUM_EVENTS - 1)) == 0, event_queue_size_must_be_a_power_of_2);
+STATIC_ASSERT((CEF_EVENT_MAX_DATA_BYTES % sizeof(uint64_t)) == 0, event_data_must_be_padded_to_64_bits);
+
+//! Number of bytes an event takes in an event packet (its data is padded to a multiple of 8 bytes)
+static uint32_t eventPacketNumBytes(uint16_t numDataBytes)
+{
+	return (uint32_t) sizeof(cefEventHeader_t) + (((uint32_t) numDataBytes + 7) & ~((uint32_t) 7));
+}
+
+//! Singleton instantiation of EventQueue
+static EventQueue eventQueueSingleton;
+
+EventQueue& EventQueue::instance()
+{
+	return eventQueueSingleton;
+}
+
+bool EventQueue::raiseEvent(uint16_t eventId, const void* p_data, uint16_t numDataBytes)
+{
+	if (numDataBytes > CEF_EVENT_MAX_DATA_BYTES)
+	{
+		return false;
+	}
+
+	uint64_t timeStamp = ShimBase::getInstance().getTimeNs();
+
+	// Events are raised from interrupts too, so the slot is claimed and filled with interrupts off
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	uint32_t eventSequenceNumber = m_eventSequenceNumber++;
+	if ((m_numEventsWritten - m_numEventsRead) >= EVENT_QUEUE_NUM_EVENTS)
+	{
+		m_numEventsDropped++;
+		ShimBase::getInstance().restoreInterrupts(interruptState);
+		return false;
+	}
+
+	queuedEvent_t* p_event = &m_events[m_numEventsWritten & (EVENT_QUEUE_NUM_EVENTS - 1)];
+	p_event->m_header.m_eventId = eventId;
+	p_event->m_header.m_numDataBytes = numDataBytes;
+	p_event->m_header.m_eventSequenceNumber = eventSequenceNumber;
+	p_event->m_header.m_timeStamp = timeStamp;
+	if (numDataBytes > 0)
+	{
+		memcpy(p_event->m_data, p_data, numDataBytes);
+	}
+	// Padding is sent too, so it is cleared rather than leaking an earlier event's data
+	memset(p_event->m_data + numDataBytes, 0, CEF_EVENT_MAX_DATA_BYTES - numDataBytes);
+	m_numEventsWritten = m_numEventsWritten + 1;
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+
+	// Registering only stores a pointer, so it is safe from interrupts
+	CommandDebugPortRouter::instance().registerChannelSource(debugPortChannel_events, this);
+
+	return true;
+}
+
+bool EventQueue::hasDataToSend(void)
+{
+	return (m_numEventsWritten != m_numEventsRead);
+}
+
+uint32_t EventQueue::fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType)
+{
+	uint32_t numBytes = 0;
+	uint32_t numEventsWritten = m_numEventsWritten;
+
+	// Events are read from the main loop only, so a slot is not reused until m_numEventsRead moves past it
+	while (m_numEventsRead != numEventsWritten)
+	{
+		const queuedEvent_t* p_event = &m_events[m_numEventsRead & (EVENT_QUEUE_NUM_EVENTS - 1)];
+		uint32_t eventNumBytes = eventPacketNumBytes(p_event->m_header.m_numDataBytes);
+		if ((numBytes + eventNumBytes) > maxNumBytes)
+		{
+			break;
+		}
+
+		memcpy(p_payload + numBytes, p_event, eventNumBytes);
+		numBytes += eventNumBytes;
+		m_numEventsRead = m_numEventsRead + 1;
+	}
+
+	debugDataType = debugPacketType_event;
+
+	return numBytes;
+}
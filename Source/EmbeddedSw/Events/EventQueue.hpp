@@ -0,0 +1,98 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_EVENT_QUEUE_H
+#define __CEF_EVENT_QUEUE_H
+
+
+/**
+ * Interface definition for the Event Queue
+ *
+ * The source of the events channel (see Events in cefContract.hpp).  Commands, the application and interrupt
+ * handlers raise events, which wait in the queue until the channel scheduler gives the events channel a turn.  Then
+ * as many events as fit are sent in one debugPacketType_event packet.  So Python is told something happened one
+ * packet time after it happened, instead of polling for it with commands.
+ */
+
+#include "cefContract.hpp"
+#include "DebugPortChannelSource.hpp"
+
+//! Number of events that can wait to be sent (must be a power of 2)
+#ifndef EVENT_QUEUE_NUM_EVENTS
+    #define EVENT_QUEUE_NUM_EVENTS 16
+#endif
+
+class EventQueue : public DebugPortChannelSource
+{
+	public:
+		//! Constructor
+		EventQueue() :
+			m_events{},
+			m_numEventsWritten(0),
+			m_numEventsRead(0),
+			m_eventSequenceNumber(0),
+			m_numEventsDropped(0)
+			{ }
+
+		/**
+		 *  Obtain a reference to the Instance of this Singleton
+		 *
+		 *  @return a reference to the Instance of this Singleton
+		 */
+		static EventQueue& instance();
+
+		/**
+		 * Queues an event to send to Python.  May be called from interrupt handlers.
+		 *
+		 * @param eventId        what happened (eventId_t, or an application id from eventId_firstApplicationEvent on)
+		 * @param p_data         data sent with the event (may be nullptr when numDataBytes is 0)
+		 * @param numDataBytes   number of bytes of data (at most CEF_EVENT_MAX_DATA_BYTES)
+		 *
+		 * @return false if the event was dropped (the queue is full or there is too much data)
+		 */
+		bool raiseEvent(uint16_t eventId, const void* p_data, uint16_t numDataBytes);
+
+		//! @return number of events dropped because the queue was full
+		uint32_t getNumEventsDropped(void) { return m_numEventsDropped; }
+
+		//! See base class for method description
+		bool hasDataToSend(void);
+		uint32_t fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType);
+
+	private:
+		//! An event waiting to be sent
+		typedef struct
+		{
+			cefEventHeader_t m_header;
+			uint8_t m_data[CEF_EVENT_MAX_DATA_BYTES];
+		} queuedEvent_t;
+
+		queuedEvent_t m_events[EVENT_QUEUE_NUM_EVENTS];
+
+		/**
+		 * Free running counts of the events written (by raiseEvent()) and read (by fillTransmitPayload()).  Only
+		 * raiseEvent() writes m_numEventsWritten and only fillTransmitPayload() writes m_numEventsRead.
+		 */
+		volatile uint32_t m_numEventsWritten;
+		volatile uint32_t m_numEventsRead;
+
+		//! Sequence number of the next event raised (dropped events use up a number, so Python sees the gap)
+		uint32_t m_eventSequenceNumber;
+
+		uint32_t m_numEventsDropped;
+};
+
+#endif  // end header guard
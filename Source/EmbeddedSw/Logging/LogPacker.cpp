@@ -0,0 +1,140 @@
+/*******************************************************************
+ @copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+ Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+ All rights reserved.
+
+ This material contains the valuable properties and trade secrets of
+ Syncroness of Westminster, CO, United States of America
+ embodying substantial creative efforts and confidential information,
+ ideas and expressions, no part of which may be reproduced or
+ transmitted in any form or by any means, electronic, mechanical, or
+ otherwise, including photocopying and recording or in connection
+ with any information storage or retrieval system, without the prior
+ written permission of Syncroness.
+ ****************************************************************** */
+
+/**
+ * Implementation of LogPacker methods
+ */
+
+#include "LogPacker.hpp"
+
+
+void LogPacker::startPacket(uint8_t* p_packetStart, uint32_t maxNumBytes)
+{
+    mp_packetStart = p_packetStart;
+    m_maxNumBytes = maxNumBytes;
+    m_numBytes = 0;
+    m_numLogs = 0;
+    m_previousTimeStamp = 0;
+}
+
+bool LogPacker::packLog(const cefLog_t* p_log)
+{
+    if (mp_packetStart == nullptr)
+    {
+        return false;
+    }
+
+    /**
+     * The packed size isn't known until the log is packed, so when the packet might not have room for
+     * the worst case packed log, pack into a scratch record first and only copy it if it fits.
+     */
+    uint8_t scratchRecord[m_maxPackedLogSizeInBytes];
+    bool useScratchRecord = ((m_maxNumBytes - m_numBytes) < m_maxPackedLogSizeInBytes);
+    uint8_t* p_packed = (useScratchRecord == true) ? scratchRecord : (mp_packetStart + m_numBytes);
+    uint32_t numBytes = 0;
+
+    // Only send variables up to the last non zero variable
+    uint64_t logVariables[] = {p_log->m_logVariable1, p_log->m_logVariable2, p_log->m_logVariable3};
+    uint32_t numVariables = NUM_ELEMENTS(logVariables);
+    while ((numVariables > 0) && (logVariables[numVariables - 1] == 0))
+    {
+        --numVariables;
+    }
+
+    uint8_t flags = (uint8_t) numVariables;
+    if (m_numLogs == 0)
+    {
+        flags |= LOG_PACKED_FLAG_ABSOLUTE_TIMESTAMP;
+    }
+    if (p_log->m_numSuppressedLogs != 0)
+    {
+        flags |= LOG_PACKED_FLAG_SUPPRESSED_LOGS;
+    }
+
+    p_packed[numBytes++] = flags;
+    p_packed[numBytes++] = p_log->m_logType;
+    p_packed[numBytes++] = p_log->m_moduleId;
+    numBytes += writeVarint(&p_packed[numBytes], p_log->m_logSequenceNumber);
+
+    if (m_numLogs == 0)
+    {
+        numBytes += writeVarint(&p_packed[numBytes], p_log->m_timeStamp);
+    }
+    else
+    {
+        numBytes += writeVarint(&p_packed[numBytes], zigZag((int64_t) (p_log->m_timeStamp - m_previousTimeStamp)));
+    }
+
+    for (uint32_t i = 0; i < numVariables; ++i)
+    {
+        numBytes += writeVarint(&p_packed[numBytes], zigZag((int64_t) logVariables[i]));
+    }
+
+    numBytes += writeVarint(&p_packed[numBytes], p_log->m_fileLineNumber);
+
+    if (p_log->m_numSuppressedLogs != 0)
+    {
+        numBytes += writeVarint(&p_packed[numBytes], p_log->m_numSuppressedLogs);
+    }
+
+    numBytes += writeString(&p_packed[numBytes], p_log->m_logString, sizeof(p_log->m_logString));
+    numBytes += writeString(&p_packed[numBytes], p_log->m_fileName, sizeof(p_log->m_fileName));
+
+    if (useScratchRecord == true)
+    {
+        if (numBytes > (m_maxNumBytes - m_numBytes))
+        {
+            // No room for this log in the packet
+            return false;
+        }
+        memcpy(mp_packetStart + m_numBytes, scratchRecord, numBytes);
+    }
+
+    m_numBytes += numBytes;
+    ++m_numLogs;
+    m_previousTimeStamp = p_log->m_timeStamp;
+
+    return true;
+}
+
+uint32_t LogPacker::writeVarint(uint8_t* p_destination, uint64_t value)
+{
+    uint32_t numBytes = 0;
+
+    while (value >= 0x80)
+    {
+        p_destination[numBytes++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    p_destination[numBytes++] = (uint8_t) value;
+
+    return numBytes;
+}
+
+uint32_t LogPacker::writeString(uint8_t* p_destination, const char* p_string, uint32_t maxNumCharacters)
+{
+    // strnlen() is not available on all tool chains
+    uint32_t stringLength = 0;
+    while ((stringLength < maxNumCharacters) && (p_string[stringLength] != '\0'))
+    {
+        ++stringLength;
+    }
+
+    uint32_t numBytes = writeVarint(p_destination, stringLength);
+    memcpy(&p_destination[numBytes], p_string, stringLength);
+
+    return numBytes + stringLength;
+}
@@ -0,0 +1,142 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __LOG_PACKER_H
+#define __LOG_PACKER_H
+
+
+/**
+ * Packs cefLog_t logs into the packed logging format (see "Packed Logging Format" in cefContract.hpp).
+ *
+ * Most logs have few (often zero) variables, short strings, and time stamps that are close to the previous
+ * log's time stamp, yet a cefLog_t always carries three uint64_t variables, a uint64_t time stamp, and fixed
+ * size strings.  The packed format only sends what is used, and sends numbers as varints.
+ *
+ * A packet of packed logs is built by calling packLog() for each log, in order, with the same LogPacker.
+ * The first log in a packet has an absolute time stamp; the others have the time stamp delta from the previous log.
+ */
+
+#include "cefMappings.hpp"
+#include "cefContract.hpp"
+
+
+class LogPacker
+{
+    public:
+        //! Constructor
+        LogPacker() :
+            mp_packetStart(nullptr),
+            m_maxNumBytes(0),
+            m_numBytes(0),
+            m_numLogs(0),
+            m_previousTimeStamp(0)
+            { }
+
+        /**
+         * Starts a new packet of packed logs
+         *
+         * @param p_packetStart     where the packed logs are written
+         * @param maxNumBytes       size of the packet buffer in bytes
+         */
+        void startPacket(uint8_t* p_packetStart, uint32_t maxNumBytes);
+
+        /**
+         * Adds a log to the packet
+         *
+         * @param p_log     log to add
+         *
+         * @return true if the log was added, false if there was not enough room (the packet is not changed)
+         */
+        bool packLog(const cefLog_t* p_log);
+
+        /**
+         * @return number of bytes of packed logs in the packet
+         */
+        uint32_t getNumBytes()
+        {
+            return m_numBytes;
+        }
+
+        /**
+         * @return number of logs in the packet
+         */
+        uint32_t getNumLogs()
+        {
+            return m_numLogs;
+        }
+
+        //! A uint64_t sent 7 bits at a time needs up to 10 bytes
+        static const uint32_t m_maxVarintSizeInBytes = 10;
+
+        /**
+         * Largest packed log: 3 single byte fields, 7 varints (sequence number, time stamp, 3 variables, line
+         * number, suppressed logs) at their maximum size, and both full length strings with their varint lengths
+         */
+        static const uint32_t m_maxPackedLogSizeInBytes = 3 + (7 * m_maxVarintSizeInBytes) +
+                                (2 * m_maxVarintSizeInBytes) + LOGGING_ASCII_LOG_STRING_MAX_NUM_CHARACTERS +
+                                LOGGING_ASCII_FILENAME_NUM_CHARACTERS;
+
+    private:
+        /**
+         * Writes an unsigned varint
+         *
+         * @param p_destination     where to write the varint (must have m_maxVarintSizeInBytes of room)
+         * @param value             value to write
+         *
+         * @return number of bytes written
+         */
+        static uint32_t writeVarint(uint8_t* p_destination, uint64_t value);
+
+        /**
+         * Writes a string's length as a varint followed by the string characters (without the null)
+         *
+         * @param p_destination     where to write the string
+         * @param p_string          string to write
+         * @param maxNumCharacters  maximum size of the string (it may not be null terminated at this size)
+         *
+         * @return number of bytes written
+         */
+        static uint32_t writeString(uint8_t* p_destination, const char* p_string, uint32_t maxNumCharacters);
+
+        /**
+         * Zig-zag encodes a signed value so that small negative values become small unsigned values
+         *
+         * @param value     value to encode
+         *
+         * @return zig-zag encoded value
+         */
+        static uint64_t zigZag(int64_t value)
+        {
+            return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+        }
+
+        //! Start of the packet being built
+        uint8_t* mp_packetStart;
+
+        //! Size of the packet buffer in bytes
+        uint32_t m_maxNumBytes;
+
+        //! Number of bytes of packed logs in the packet
+        uint32_t m_numBytes;
+
+        //! Number of logs in the packet
+        uint32_t m_numLogs;
+
+        //! Time stamp of the previous log in the packet (time stamps are sent as a delta from it)
+        uint64_t m_previousTimeStamp;
+};
+
+#endif  // end header guard
@@ -21,6 +21,7 @@
 #include "Logging.hpp"
 #include "CommandDebugPortRouter.hpp"
 #include "AppMain.hpp"
+#include "ShimBase.hpp"
 
 uint16_t Logging::m_logSequenceNumber = 0;
 
@@ -33,7 +34,7 @@ Logging& Logging::instance()
 }
 
 void Logging::logMessage(logType_t logType, logModuleId_t logModuleId, const char* message,
-        const char* fileName, uint32_t lineNum, uint64_t var1, uint64_t var2, uint64_t var3)
+        const char* fileName, uint32_t lineNum, uint64_t var1, uint64_t var2, uint64_t var3, logCallSite_t* p_callSite)
 {
     /**
      * We could end up recursively calling into logMessage if within the logging infrastructure
@@ -57,16 +58,20 @@ void Logging::logMessage(logType_t logType, logModuleId_t logModuleId, const cha
     // Mark that logging is in progress
     m_loggingInProgress = true;
 
-    /** Until we have the real time clock working, pick an arbitrary timestamp to start with.
-     *  Then increment the time stamp by a fixed amount each time so we can see that the time 
-     * is changing with each log entry in python utilities.
-     */
-    static uint64_t fakeTimestamp = (29.720638091 * (float)(LOGGING_UINT64_NSEC_TO_SECONDS));
-    //increment just a bit more than a 0.1 seconds so can always see that digit move
-    static uint64_t fakeTimestampIncrement = (0.139124163 * (float)(LOGGING_UINT64_NSEC_TO_SECONDS));
+    // Rate limit/coalesce before a log is allocated so a noisy call site can't cause other logs to be discarded
+    uint32_t numSuppressedLogs = 0;
+    if ((p_callSite != nullptr) && (logType != logTypeFatal) &&
+        (isLogSuppressed(p_callSite, var1, var2, var3, numSuppressedLogs) == true))
+    {
+        m_loggingInProgress = false;
+        return;
+    }
+
+    // Time stamp the log before allocating it, so the time stamp is as close to the log call as possible
+    uint64_t timeStamp = ShimBase::getInstance().getTimeNs();
 
     // Allocate a log
-    cefLog_t* p_log = CommandDebugPortRouter::instance().checkoutLogBufferLogging();
+    cefLog_t* p_log = CommandDebugPortRouter::instance().checkoutLogBufferLogging(logType);
     if (p_log == nullptr)
     {
         /**
@@ -75,15 +80,16 @@ void Logging::logMessage(logType_t logType, logModuleId_t logModuleId, const cha
          * "newer" logs are likely to tell us why we are transmitting so much data.  Plus,
          * This means that a log_fatal always has room to be added to the queue (and any
          * error messages that may have occurred before the fatal are reported).
+         * Only logs of the same or lower severity are discarded (see CommandDebugPortRouter::discardOlderLogs()).
          *
          * The python code is responsible for detecting a discontinuity and adding an appropriate message
          * to the user console output when logs are "dropped".  The discontinuity is detected by
          * looking at m_logSequenceNumber.
          */
-        CommandDebugPortRouter::instance().discardOlderLogs();
+        CommandDebugPortRouter::instance().discardOlderLogs(logType);
 
         // Try again to get a log
-        p_log = CommandDebugPortRouter::instance().checkoutLogBufferLogging();
+        p_log = CommandDebugPortRouter::instance().checkoutLogBufferLogging(logType);
         if (p_log == nullptr)
         {
             /**
@@ -98,8 +104,15 @@ void Logging::logMessage(logType_t logType, logModuleId_t logModuleId, const cha
              *         be reported in a debug command).
              *
              * Option 3 will be implemented, for now.
+             *
+             * Lower severity logs are expected to be dropped when the queue is full of higher severity
+             * logs, so only count them (the router reports the count in a "logs dropped" log).
              */
-            AppMain::instance().setSystemErrorCode(errorCode_UnableToCreateLoggingSpace);
+            if (logType >= logTypeError)
+            {
+                AppMain::instance().setSystemErrorCode(errorCode_UnableToCreateLoggingSpace);
+            }
+            CommandDebugPortRouter::instance().logDropped(logType);
             m_loggingInProgress = false;
             return;
         }
@@ -119,10 +132,10 @@ void Logging::logMessage(logType_t logType, logModuleId_t logModuleId, const cha
     p_log->m_logVariable2 = var2;
     p_log->m_logVariable3 = var3;
     p_log->m_logSequenceNumber = m_logSequenceNumber++;
+    p_log->m_numSuppressedLogs = numSuppressedLogs;
+    p_log->m_padding1 = 0;
 
-    //@todo once have clocks working, add time stamp here
-    p_log->m_timeStamp = fakeTimestamp;
-    fakeTimestamp += fakeTimestampIncrement;
+    p_log->m_timeStamp = timeStamp;
 
     p_log->m_fileLineNumber = lineNum;
 
@@ -142,6 +155,89 @@ void Logging::logMessage(logType_t logType, logModuleId_t logModuleId, const cha
     m_loggingInProgress = false;
 }
 
+bool Logging::isLogSuppressed(logCallSite_t* p_callSite, uint64_t var1, uint64_t var2, uint64_t var3, uint32_t& numSuppressedLogs)
+{
+    // Without a clock the token buckets would never refill, so every call site would go silent for good
+    if (ShimBase::getInstance().hasClock() == false)
+    {
+        return false;
+    }
+
+    // Tick differences are used throughout so that the tick wrapping is harmless
+    uint32_t tickMs = ShimBase::getInstance().getTickMs();
+
+    if (p_callSite->m_initialized == false)
+    {
+        p_callSite->m_numTokens = LOG_RATE_LIMIT_BURST;
+        p_callSite->m_lastRefillTickMs = tickMs;
+        p_callSite->m_numSuppressedLogs = 0;
+        p_callSite->m_initialized = true;
+    }
+    else
+    {
+        // Refill the token bucket for the time that has passed, and detect a repeat of the last log
+        uint32_t numNewTokens = (tickMs - p_callSite->m_lastRefillTickMs) / LOG_RATE_LIMIT_TOKEN_PERIOD_MS;
+        if (numNewTokens > 0)
+        {
+            uint32_t numTokens = p_callSite->m_numTokens + numNewTokens;
+            p_callSite->m_numTokens = (numTokens > LOG_RATE_LIMIT_BURST) ? LOG_RATE_LIMIT_BURST : numTokens;
+            p_callSite->m_lastRefillTickMs += numNewTokens * LOG_RATE_LIMIT_TOKEN_PERIOD_MS;
+        }
+
+        bool isRepeat = (var1 == p_callSite->m_lastVar1) && (var2 == p_callSite->m_lastVar2) &&
+                        (var3 == p_callSite->m_lastVar3) &&
+                        ((tickMs - p_callSite->m_lastLogTickMs) < LOG_REPEAT_COALESCE_WINDOW_MS);
+
+        if ((isRepeat == true) || (p_callSite->m_numTokens == 0))
+        {
+            if (p_callSite->m_numSuppressedLogs < UINT32_MAX)
+            {
+                ++p_callSite->m_numSuppressedLogs;
+            }
+            return true;
+        }
+    }
+
+    --p_callSite->m_numTokens;
+    numSuppressedLogs = p_callSite->m_numSuppressedLogs;
+    p_callSite->m_numSuppressedLogs = 0;
+    p_callSite->m_lastVar1 = var1;
+    p_callSite->m_lastVar2 = var2;
+    p_callSite->m_lastVar3 = var3;
+    p_callSite->m_lastLogTickMs = tickMs;
+
+    return false;
+}
+
+errorCode_t Logging::setLogThreshold(uint8_t logModuleId, uint8_t logThreshold, uint8_t& previousLogThreshold)
+{
+    // Fatal logs are never filtered, so the highest threshold that can be set is logTypeFatal (i.e. only fatal logs)
+    if (logThreshold > logTypeFatal)
+    {
+        return errorCode_CmdSetLogThresholdInvalidLogType;
+    }
+
+    if (logModuleId == LOGGING_MODULE_ID_ALL_MODULES)
+    {
+        previousLogThreshold = m_logThreshold[0];
+        for (uint32_t i = 0; i < NUM_ELEMENTS(m_logThreshold); ++i)
+        {
+            m_logThreshold[i] = logThreshold;
+        }
+        return errorCode_OK;
+    }
+
+    if (logModuleId >= LogModuleIdNumModules)
+    {
+        return errorCode_CmdSetLogThresholdInvalidModuleId;
+    }
+
+    previousLogThreshold = m_logThreshold[logModuleId];
+    m_logThreshold[logModuleId] = logThreshold;
+
+    return errorCode_OK;
+}
+
 void Logging::postHandlingOfFatalError()
 {
     /**
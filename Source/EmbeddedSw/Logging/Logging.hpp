@@ -27,7 +27,10 @@ extern "C" {
  * Contains the API for logging.
  *
  * Each Log has a unique moduleID to better control logging fidelity when debugging.
- * The initial release of the code will not support filtering by logging module id.
+ * Logs are filtered in two stages:
+ *  1. At compile time, log statements below LOG_COMPILE_TIME_LEVEL_FLOOR are compiled out entirely
+ *  2. At run time, each logging module has a threshold (changed with CommandSetLogThreshold).  Logs below
+ *     the module's threshold are discarded before a log buffer is allocated.  Fatal logs are never filtered.
  *
  * Variadic functions are not used because:
  *  1. The MicroChip compiler (at least some versions) don't support Variadic functions
@@ -51,21 +54,81 @@ extern "C" {
 #include "cefContract.hpp"
 
 
+/**
+ * Compile time log level floor.  Log statements below the floor are removed by the preprocessor.
+ * The value is a logType_t value, but must be a plain number so it can be used in #if statements.
+ * A project may override the floor on the compiler command line (e.g. -DLOG_COMPILE_TIME_LEVEL_FLOOR=2).
+ * LOG_FATAL is never compiled out.
+ */
+#ifndef LOG_COMPILE_TIME_LEVEL_FLOOR
+    #ifdef DEBUG_BUILD
+        #define LOG_COMPILE_TIME_LEVEL_FLOOR 0      // logTypeDebug
+    #else
+        #define LOG_COMPILE_TIME_LEVEL_FLOOR 1      // logTypeInfo
+    #endif
+#endif
+
+//! Run time threshold each logging module starts with (everything that was compiled in is sent)
+#define LOG_RUNTIME_DEFAULT_THRESHOLD LOG_COMPILE_TIME_LEVEL_FLOOR
+
+/**
+ * Per call site rate limiting.  Each log statement (other than LOG_FATAL) has a token bucket that holds up to
+ * LOG_RATE_LIMIT_BURST tokens and gains a token every LOG_RATE_LIMIT_TOKEN_PERIOD_MS.  In addition, a log statement
+ * that repeats with the same variables within LOG_REPEAT_COALESCE_WINDOW_MS of its previous log is coalesced.
+ * Suppressed logs are counted, and the count is sent in m_numSuppressedLogs of the call site's next log.
+ * Rate limiting is off on platforms without a clock (see ShimBase::hasClock()).
+ */
+#ifndef LOG_RATE_LIMIT_BURST
+    #define LOG_RATE_LIMIT_BURST 5
+#endif
+#ifndef LOG_RATE_LIMIT_TOKEN_PERIOD_MS
+    #define LOG_RATE_LIMIT_TOKEN_PERIOD_MS 200
+#endif
+#ifndef LOG_REPEAT_COALESCE_WINDOW_MS
+    #define LOG_REPEAT_COALESCE_WINDOW_MS 1000
+#endif
+
+STATIC_ASSERT((logTypeDebug == 0) && (logTypeInfo == 1) && (logTypeWarning == 2) && (logTypeError == 3),
+                LOG_COMPILE_TIME_LEVEL_FLOOR_VALUES_MUST_MATCH_LOG_TYPES);
+
+
 class Logging
 {
     public:
         //! Constructor
         Logging() :
             m_loggingInProgress(false)
-            { }
+            {
+                for (uint32_t i = 0; i < NUM_ELEMENTS(m_logThreshold); ++i)
+                {
+                    m_logThreshold[i] = LOG_RUNTIME_DEFAULT_THRESHOLD;
+                }
+            }
 
         typedef enum logModuleId
         {
             LogModuleIdCefInfrastructure,
 			LogModuleIdCefDebugCommands,
 
+            LogModuleIdNumModules,  // Must be last entry
         } logModuleId_t;
 
+        /**
+         * Rate limiting state of one log statement.  The logging macros declare one of these as a function
+         * static at each call site, so it is zero initialized (m_initialized is false) before first use.
+         */
+        typedef struct
+        {
+            uint64_t m_lastVar1;            //!< variables of the last log sent from this call site
+            uint64_t m_lastVar2;
+            uint64_t m_lastVar3;
+            uint32_t m_lastLogTickMs;       //!< when the last log was sent from this call site
+            uint32_t m_lastRefillTickMs;    //!< when the token bucket was last refilled
+            uint32_t m_numSuppressedLogs;   //!< logs suppressed since the last log sent from this call site
+            uint16_t m_numTokens;           //!< logs that can be sent before rate limiting starts
+            bool m_initialized;
+        } logCallSite_t;
+
 
         /**
          *  Obtain a reference to the Logging Singleton.
@@ -87,9 +150,39 @@ class Logging
          * @param var1          1st user variable in log statement
          * @param var2          2nd user variable in log statement
          * @param var3          3rd user variable in log statement
+         * @param p_callSite    rate limiting state of the log statement (nullptr if the log must not be rate limited)
          */
         void logMessage(logType_t logType, logModuleId_t logModuleId, const char* message, const char* fileName, uint32_t lineNum,
-                        uint64_t var1, uint64_t var2, uint64_t var3);
+                        uint64_t var1, uint64_t var2, uint64_t var3, logCallSite_t* p_callSite = nullptr);
+
+        /**
+         * Checks the run time threshold of a logging module.  This is inline as it is called for every log statement.
+         *
+         * @param logType       what type of log is this (debug, info...)
+         * @param logModuleId   what module generated this log
+         *
+         * @return true if the log should be sent, false if it is filtered out
+         */
+        bool isLogEnabled(logType_t logType, logModuleId_t logModuleId)
+        {
+            if ((logType == logTypeFatal) || (logModuleId >= LogModuleIdNumModules))
+            {
+                // Fatal logs are never filtered; an unknown module id is sent so the bad id can be seen
+                return true;
+            }
+            return (logType >= m_logThreshold[logModuleId]);
+        }
+
+        /**
+         * Sets the run time threshold of one (or all) logging modules
+         *
+         * @param logModuleId   module to change, or LOGGING_MODULE_ID_ALL_MODULES for all modules
+         * @param logThreshold  logs of this type and above are sent
+         * @param previousLogThreshold  returns the threshold before the change (of the first module if all modules)
+         *
+         * @return errorCode_OK on success, else the reason the threshold could not be changed
+         */
+        errorCode_t setLogThreshold(uint8_t logModuleId, uint8_t logThreshold, uint8_t& previousLogThreshold);
 
         /**
          * After a log fatal message has been posted, this routine is responsible for
@@ -98,9 +191,26 @@ class Logging
         void postHandlingOfFatalError();
 
     private:
+        /**
+         * Applies the call site's token bucket and repeat coalescing
+         *
+         * @param p_callSite        rate limiting state of the log statement
+         * @param var1              1st user variable in log statement
+         * @param var2              2nd user variable in log statement
+         * @param var3              3rd user variable in log statement
+         * @param numSuppressedLogs returns the number of logs suppressed since the call site's previous log (if not suppressed)
+         *
+         * @return true if this log is suppressed, false if it should be sent
+         */
+        bool isLogSuppressed(logCallSite_t* p_callSite, uint64_t var1, uint64_t var2, uint64_t var3, uint32_t& numSuppressedLogs);
+
         //! Flag that is true when logging is in progress (used to detect recursive logging call)
         bool m_loggingInProgress;
 
+        //! Run time threshold (logType_t) of each logging module
+        uint8_t m_logThreshold[LogModuleIdNumModules];
+        STATIC_ASSERT(LogModuleIdNumModules < LOGGING_MODULE_ID_ALL_MODULES, LOG_MODULE_IDS_MUST_FIT_IN_CONTRACT_MODULE_ID);
+
         //! rolling line Sequence Number
         static uint16_t m_logSequenceNumber;
         STATIC_ASSERT(sizeof(m_logSequenceNumber) == sizeof(cefLog_t::m_logSequenceNumber),\
@@ -134,23 +244,44 @@ class Logging
 //! We only want the filename, and not the complete path name so it doesn't take so many characters to transmit
 #define __JUST_FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 
-#ifdef DEBUG_BUILD
+/**
+ * Common body of the rate limited logging macros.  The braces give each log statement its own call site state.
+ */
+#define LOG_MESSAGE_RATE_LIMITED(logType, logModuleId, msg, var1, var2, var3) \
+    { \
+        static Logging::logCallSite_t logCallSite; \
+        if (Logging::instance().isLogEnabled(logType, logModuleId)) \
+        { Logging::instance().logMessage(logType, logModuleId, msg, __JUST_FILENAME__, __LINE__, var1, var2, var3, &logCallSite); } \
+    }
+
+#if defined(DEBUG_BUILD) && (LOG_COMPILE_TIME_LEVEL_FLOOR <= 0)
 #define LOG_DEBUG(logModuleId, msg, var1, var2, var3) \
-    Logging::instance().logMessage(logTypeDebug, logModuleId, msg, __JUST_FILENAME__, __LINE__, var1, var2, var3);
+    LOG_MESSAGE_RATE_LIMITED(logTypeDebug, logModuleId, msg, var1, var2, var3)
 #else
     // Compile out debug log statements for non-debug builds
     #define LOG_DEBUG(msg, ...)
 #endif
 
-
+#if (LOG_COMPILE_TIME_LEVEL_FLOOR <= 1)
 #define LOG_INFO(logModuleId, msg, var1, var2, var3) \
-    Logging::instance().logMessage(logTypeInfo, logModuleId, msg, __JUST_FILENAME__, __LINE__, var1, var2, var3);
+    LOG_MESSAGE_RATE_LIMITED(logTypeInfo, logModuleId, msg, var1, var2, var3)
+#else
+    #define LOG_INFO(msg, ...)
+#endif
 
+#if (LOG_COMPILE_TIME_LEVEL_FLOOR <= 3)
 #define LOG_ERROR(logModuleId, msg, var1, var2, var3) \
-    Logging::instance().logMessage(logTypeError, logModuleId, msg, __JUST_FILENAME__, __LINE__, var1, var2, var3);
+    LOG_MESSAGE_RATE_LIMITED(logTypeError, logModuleId, msg, var1, var2, var3)
+#else
+    #define LOG_ERROR(msg, ...)
+#endif
 
+#if (LOG_COMPILE_TIME_LEVEL_FLOOR <= 2)
 #define LOG_WARNING(logModuleId, msg, var1, var2, var3) \
-    Logging::instance().logMessage(logTypeWarning, logModuleId, msg, __JUST_FILENAME__, __LINE__, var1, var2, var3);
+    LOG_MESSAGE_RATE_LIMITED(logTypeWarning, logModuleId, msg, var1, var2, var3)
+#else
+    #define LOG_WARNING(msg, ...)
+#endif
 
 #define LOG_FATAL(logModuleId, msg, var1, var2, var3) \
     /* First log the fact that something went badly */ \
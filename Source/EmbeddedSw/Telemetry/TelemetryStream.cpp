@@ -0,0 +1,335 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+
+#include <string.h>
+
+#include "TelemetryStream.hpp"
+#include "CommandDebugPortRouter.hpp"
+#include "ShimBase.hpp"
+#include "Logging.hpp"
+
+/**
+ * Implementation of TelemetryStream Methods
+ * See notes in TelemetryStream.hpp for the use model of the class
+ */
+
+STATIC_ASSERT((sizeof(cefTelemetryFrameHeader_t) + TELEMETRY_FRAME_NUM_DATA_BYTES) <= DEBUG_PORT_MAX_APPLICATION_PAYLOAD,
+        telemetry_frame_must_fit_in_a_packet);
+
+//! Number of bytes of a sample of each telemetryType_t
+static const uint8_t telemetryTypeNumBytes[telemetryType_numTypes] = {1, 1, 2, 2, 4, 4, 8, 8, 4, 8};
+
+//! Singleton instantiation of TelemetryStream
+static TelemetryStream telemetryStreamSingleton;
+
+TelemetryStream& TelemetryStream::instance()
+{
+	return telemetryStreamSingleton;
+}
+
+bool TelemetryStream::registerChannel(const char* p_name, telemetryType_t type, const volatile void* p_variable, uint16_t decimation)
+{
+	if ((m_numChannels >= TELEMETRY_MAX_NUM_CHANNELS) || (type >= telemetryType_numTypes))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefInfrastructure, "Can not register telemetry channel {:d} of type {:d}", m_numChannels, type, 0);
+		return false;
+	}
+
+	addChannel(p_name, type, p_variable, decimation, false);
+
+	return true;
+}
+
+errorCode_t TelemetryStream::registerAddressChannel(const char* p_name, uint64_t address, telemetryType_t type, uint16_t decimation)
+{
+	if ((m_numChannels >= TELEMETRY_MAX_NUM_CHANNELS) || (m_numAddressChannels >= TELEMETRY_MAX_NUM_ADDRESS_CHANNELS) ||
+	    (isAddressChannelValid(address, type) == false))
+	{
+		LOG_WARNING(Logging::LogModuleIdCefDebugCommands, "Can not add address channel 0x{:X} of type {:d} ({:d} channels)",
+		        address, type, m_numChannels);
+		return errorCode_CmdSoftwareScopeInvalidEntry;
+	}
+
+	char* p_channelName = m_addressChannelNames[m_numAddressChannels];
+	strncpy(p_channelName, p_name, TELEMETRY_CHANNEL_NAME_NUM_BYTES - 1);
+	p_channelName[TELEMETRY_CHANNEL_NAME_NUM_BYTES - 1] = 0;
+	m_numAddressChannels++;
+
+	addChannel(p_channelName, type, (const volatile void*) (uintptr_t) address, decimation, true);
+
+	return errorCode_OK;
+}
+
+bool TelemetryStream::isAddressChannelValid(uint64_t address, telemetryType_t type)
+{
+	if ((type >= telemetryType_numTypes) || (address > UINTPTR_MAX))
+	{
+		return false;
+	}
+
+	/**
+	 * Each variable is read with a single access of its size, which has to be aligned (so it can't wrap around the
+	 * end of the address space either).  It is read every tick, so it also has to be in memory the platform can read.
+	 */
+	uint8_t numBytes = telemetryTypeNumBytes[type];
+	return (((address % numBytes) == 0) && (ShimBase::getInstance().isAddressRangeReadable(address, numBytes) == true));
+}
+
+void TelemetryStream::removeAddressChannels(void)
+{
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	uint16_t numChannels = 0;
+	for (uint32_t channelIndex = 0; channelIndex < m_numChannels; ++channelIndex)
+	{
+		if (m_channels[channelIndex].isAddressChannel == false)
+		{
+			m_channels[numChannels++] = m_channels[channelIndex];
+		}
+	}
+	m_numChannels = numChannels;
+	m_numAddressChannels = 0;
+	restartStream();
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+}
+
+void TelemetryStream::sample(void)
+{
+	if (m_streaming == false)
+	{
+		return;
+	}
+
+	uint64_t timeNs = ShimBase::getInstance().getTimeNs();
+
+	// Make room for the samples of this tick
+	uint32_t numTickBytes = 0;
+	for (uint32_t channelIndex = 0; channelIndex < m_numChannels; ++channelIndex)
+	{
+		if ((m_channels[channelIndex].decimation != 0) && (m_channels[channelIndex].ticksUntilSample == 0))
+		{
+			numTickBytes += m_channels[channelIndex].numBytes;
+		}
+	}
+	if ((m_frames[m_fillFrameIndex].m_numSampleBytes + numTickBytes) > TELEMETRY_FRAME_NUM_DATA_BYTES)
+	{
+		finishFrame();
+	}
+
+	telemetryFrame_t* p_frame = &m_frames[m_fillFrameIndex];
+	if (p_frame->m_header.m_numTicks == 0)
+	{
+		p_frame->m_header.m_firstTick = m_tick;
+		p_frame->m_header.m_firstTickTimeStamp = timeNs;
+	}
+
+	uint8_t* p_sample = &p_frame->m_samples[p_frame->m_numSampleBytes];
+	for (uint32_t channelIndex = 0; channelIndex < m_numChannels; ++channelIndex)
+	{
+		telemetryChannel_t* p_channel = &m_channels[channelIndex];
+		if (p_channel->decimation == 0)
+		{
+			continue;
+		}
+		if (p_channel->ticksUntilSample != 0)
+		{
+			p_channel->ticksUntilSample--;
+			continue;
+		}
+		p_channel->ticksUntilSample = p_channel->decimation - 1;
+
+		// Each variable is read with a single access of its size, so a variable changed by an interrupt isn't torn
+		switch (p_channel->numBytes)
+		{
+			case 1:
+			{
+				uint8_t value = *(const volatile uint8_t*) p_channel->p_variable;
+				*p_sample = value;
+				break;
+			}
+			case 2:
+			{
+				uint16_t value = *(const volatile uint16_t*) p_channel->p_variable;
+				memcpy(p_sample, &value, sizeof(value));
+				break;
+			}
+			case 4:
+			{
+				uint32_t value = *(const volatile uint32_t*) p_channel->p_variable;
+				memcpy(p_sample, &value, sizeof(value));
+				break;
+			}
+			default:
+			{
+				uint64_t value = *(const volatile uint64_t*) p_channel->p_variable;
+				memcpy(p_sample, &value, sizeof(value));
+				break;
+			}
+		}
+		p_sample += p_channel->numBytes;
+	}
+
+	p_frame->m_numSampleBytes += numTickBytes;
+	p_frame->m_header.m_numTicks++;
+	p_frame->m_header.m_lastTickTimeStamp = timeNs;
+	m_tick++;
+
+	if ((p_frame->m_header.m_numTicks == UINT16_MAX) ||
+	    ((timeNs - p_frame->m_header.m_firstTickTimeStamp) >= ((uint64_t) TELEMETRY_MAX_FRAME_LATENCY_MS * 1000000)))
+	{
+		finishFrame();
+	}
+}
+
+errorCode_t TelemetryStream::setChannelDecimation(uint16_t channelIndex, uint16_t decimation)
+{
+	if (channelIndex >= m_numChannels)
+	{
+		return errorCode_CmdTelemetryInvalidChannel;
+	}
+
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	m_channels[channelIndex].decimation = decimation;
+	restartStream();
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+
+	return errorCode_OK;
+}
+
+void TelemetryStream::setStreaming(bool streaming)
+{
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	restartStream();
+	m_streaming = streaming;
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+}
+
+bool TelemetryStream::getChannel(uint16_t channelIndex, const char*& p_name, telemetryType_t& type, uint16_t& decimation)
+{
+	if (channelIndex >= m_numChannels)
+	{
+		return false;
+	}
+
+	p_name = m_channels[channelIndex].p_name;
+	type = (telemetryType_t) m_channels[channelIndex].type;
+	decimation = m_channels[channelIndex].decimation;
+
+	return true;
+}
+
+bool TelemetryStream::hasDataToSend(void)
+{
+	return ((m_frames[0].m_readyToSend == true) || (m_frames[1].m_readyToSend == true));
+}
+
+uint32_t TelemetryStream::fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType)
+{
+	// Only one frame is ever waiting to be sent (a frame that is finished while another waits is dropped)
+	for (uint32_t frameIndex = 0; frameIndex < 2; ++frameIndex)
+	{
+		telemetryFrame_t* p_frame = &m_frames[frameIndex];
+		uint32_t numBytes = (uint32_t) sizeof(cefTelemetryFrameHeader_t) + p_frame->m_numSampleBytes;
+		if ((p_frame->m_readyToSend == false) || (numBytes > maxNumBytes))
+		{
+			continue;
+		}
+
+		memcpy(p_payload, &p_frame->m_header, sizeof(cefTelemetryFrameHeader_t));
+		memcpy(p_payload + sizeof(cefTelemetryFrameHeader_t), p_frame->m_samples, p_frame->m_numSampleBytes);
+
+		// sample() may now reuse the frame
+		p_frame->m_readyToSend = false;
+		debugDataType = debugPacketType_telemetry;
+
+		return numBytes;
+	}
+
+	return 0;
+}
+
+void TelemetryStream::addChannel(const char* p_name, telemetryType_t type, const volatile void* p_variable, uint16_t decimation,
+                                 bool isAddressChannel)
+{
+	uint32_t interruptState = ShimBase::getInstance().disableInterrupts();
+
+	telemetryChannel_t* p_channel = &m_channels[m_numChannels];
+	p_channel->p_name = p_name;
+	p_channel->p_variable = p_variable;
+	p_channel->decimation = decimation;
+	p_channel->type = type;
+	p_channel->numBytes = telemetryTypeNumBytes[type];
+	p_channel->isAddressChannel = isAddressChannel;
+	m_numChannels++;
+	restartStream();
+
+	ShimBase::getInstance().restoreInterrupts(interruptState);
+}
+
+void TelemetryStream::finishFrame(void)
+{
+	telemetryFrame_t* p_frame = &m_frames[m_fillFrameIndex];
+	if (p_frame->m_numSampleBytes == 0)
+	{
+		// Nothing to send (no channel was due), the ticks are simply restarted in a new frame
+		startFrame(p_frame);
+		return;
+	}
+
+	p_frame->m_header.m_frameSequenceNumber = m_frameSequenceNumber++;
+
+	telemetryFrame_t* p_nextFrame = &m_frames[m_fillFrameIndex ^ 1];
+	if (p_nextFrame->m_readyToSend == true)
+	{
+		// The router is still holding the previous frame, the gap in frame sequence numbers shows the drop
+		m_numFramesDropped++;
+		startFrame(p_frame);
+		return;
+	}
+
+	p_frame->m_readyToSend = true;
+	m_fillFrameIndex ^= 1;
+	startFrame(p_nextFrame);
+
+	// Registering only stores a pointer, so it is safe from interrupts
+	CommandDebugPortRouter::instance().registerChannelSource(debugPortChannel_telemetry, this);
+}
+
+void TelemetryStream::restartStream(void)
+{
+	finishFrame();
+
+	m_tick = 0;
+	for (uint32_t channelIndex = 0; channelIndex < m_numChannels; ++channelIndex)
+	{
+		m_channels[channelIndex].ticksUntilSample = 0;
+	}
+	m_configurationNumber++;
+	startFrame(&m_frames[m_fillFrameIndex]);
+}
+
+void TelemetryStream::startFrame(telemetryFrame_t* p_frame)
+{
+	p_frame->m_header.m_numTicks = 0;
+	p_frame->m_header.m_configurationNumber = m_configurationNumber;
+	p_frame->m_header.m_padding1 = 0;
+	p_frame->m_numSampleBytes = 0;
+}
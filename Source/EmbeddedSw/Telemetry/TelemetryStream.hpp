@@ -0,0 +1,231 @@
+/*******************************************************************
+@copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+
+Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+All rights reserved.
+
+This material contains the valuable properties and trade secrets of
+Syncroness of Westminster, CO, United States of America
+embodying substantial creative efforts and confidential information,
+ideas and expressions, no part of which may be reproduced or
+transmitted in any form or by any means, electronic, mechanical, or
+otherwise, including photocopying and recording or in connection
+with any information storage or retrieval system, without the prior
+written permission of Syncroness.
+****************************************************************** */
+/* Header guard */
+#ifndef __CEF_TELEMETRY_STREAM_H
+#define __CEF_TELEMETRY_STREAM_H
+
+
+/**
+ * Interface definition for the Telemetry Stream
+ *
+ * The source of the telemetry channel (see Telemetry in cefContract.hpp).  The application registers the variables
+ * to watch as telemetry channels, and sample() is called once per tick.  The samples of the channels due on each
+ * tick are appended to a frame, and a full frame is handed to the router to send while sample() fills the other
+ * frame.  So variables are watched at rates limited by the debug port bandwidth, not by command round trips.
+ * Python can also add channels for any address (address channels, see Software Scope in cefContract.hpp).
+ *
+ * sample() may be called from a timer interrupt, the other methods are called from the main loop.
+ */
+
+#include "cefContract.hpp"
+#include "DebugPortChannelSource.hpp"
+
+//! Number of bytes of samples in a frame (by default, as many as fit in a packet)
+#ifndef TELEMETRY_FRAME_NUM_DATA_BYTES
+    #define TELEMETRY_FRAME_NUM_DATA_BYTES (DEBUG_PORT_MAX_APPLICATION_PAYLOAD - sizeof(cefTelemetryFrameHeader_t))
+#endif
+
+//! A frame that is not full is sent this long after its first tick, so slow channels still show up promptly
+#ifndef TELEMETRY_MAX_FRAME_LATENCY_MS
+    #define TELEMETRY_MAX_FRAME_LATENCY_MS 100
+#endif
+
+//! When 1, sample() is called on every pass of the AppMain while loop.  Set to 0 to call it from a timer instead.
+#ifndef TELEMETRY_SAMPLE_FROM_MAIN_LOOP
+    #define TELEMETRY_SAMPLE_FROM_MAIN_LOOP 1
+#endif
+
+class TelemetryStream : public DebugPortChannelSource
+{
+	public:
+		//! Constructor
+		TelemetryStream() :
+			m_channels{},
+			m_numChannels(0),
+			m_addressChannelNames{},
+			m_numAddressChannels(0),
+			m_frames{},
+			m_fillFrameIndex(0),
+			m_tick(0),
+			m_frameSequenceNumber(0),
+			m_configurationNumber(0),
+			m_streaming(false),
+			m_numFramesDropped(0)
+			{ }
+
+		/**
+		 *  Obtain a reference to the Instance of this Singleton
+		 *
+		 *  @return a reference to the Instance of this Singleton
+		 */
+		static TelemetryStream& instance();
+
+		/**
+		 * Adds a variable to the telemetry channels.  The channel index is the order channels are registered in.
+		 *
+		 * @param p_name       name of the channel (kept by pointer, so it must not go away, e.g. a string literal)
+		 * @param type         type of the variable
+		 * @param p_variable   the variable, read on each tick the channel is due
+		 * @param decimation   the channel is sampled every decimation ticks (0 registers it turned off)
+		 *
+		 * @return false if TELEMETRY_MAX_NUM_CHANNELS are already registered
+		 */
+		bool registerChannel(const char* p_name, telemetryType_t type, const volatile void* p_variable, uint16_t decimation);
+
+		/**
+		 * Adds a channel for a variable at an address (e.g. from a Software Scope sampling list)
+		 *
+		 * @param p_name       name of the channel (copied, at most TELEMETRY_CHANNEL_NAME_NUM_BYTES, need not be terminated)
+		 * @param address      address of the variable, aligned to the size of type
+		 * @param type         type of the variable
+		 * @param decimation   the channel is sampled every decimation ticks (0 adds it turned off)
+		 *
+		 * @return errorCode_CmdSoftwareScopeInvalidEntry if the address channels are full, or the address can't be
+		 *         sampled (see isAddressChannelValid())
+		 */
+		errorCode_t registerAddressChannel(const char* p_name, uint64_t address, telemetryType_t type, uint16_t decimation);
+
+		//! Removes all of the address channels (the application's channels keep their order)
+		void removeAddressChannels(void);
+
+		//! @return number of address channels
+		uint16_t getNumAddressChannels(void) { return m_numAddressChannels; }
+
+		/**
+		 * Returns if a variable can be sampled by an address channel
+		 *
+		 * @param address   address of the variable
+		 * @param type      type of the variable
+		 *
+		 * @return false if the type is not a telemetryType_t, or the address is not aligned to its size, doesn't fit
+		 *         in the target's address space, or is not readable memory (see ShimBase::isAddressRangeReadable())
+		 */
+		static bool isAddressChannelValid(uint64_t address, telemetryType_t type);
+
+		/**
+		 * Samples the channels due on this tick.  Called once per tick, from the main loop or a timer interrupt.
+		 */
+		void sample(void);
+
+		/**
+		 * Changes how often a channel is sampled
+		 *
+		 * @param channelIndex   index of the channel
+		 * @param decimation     the channel is sampled every decimation ticks (0 turns it off)
+		 *
+		 * @return errorCode_CmdTelemetryInvalidChannel if there is no such channel
+		 */
+		errorCode_t setChannelDecimation(uint16_t channelIndex, uint16_t decimation);
+
+		/**
+		 * Starts or stops sampling.  A stop sends the samples taken so far.
+		 *
+		 * @param streaming   true to start
+		 */
+		void setStreaming(bool streaming);
+
+		/**
+		 * Returns a channel's registration
+		 *
+		 * @param channelIndex   index of the channel
+		 * @param p_name         name of the channel (returned as a reference)
+		 * @param type           type of the channel (returned as a reference)
+		 * @param decimation     decimation of the channel, 0 if it is off (returned as a reference)
+		 *
+		 * @return false if there is no such channel
+		 */
+		bool getChannel(uint16_t channelIndex, const char*& p_name, telemetryType_t& type, uint16_t& decimation);
+
+		//! @return number of registered channels
+		uint16_t getNumChannels(void) { return m_numChannels; }
+
+		//! @return true if the stream is started
+		bool isStreaming(void) { return m_streaming; }
+
+		//! @return configuration number of the frames sent from now on
+		uint16_t getConfigurationNumber(void) { return m_configurationNumber; }
+
+		//! @return number of frames dropped because the previous frame had not been sent yet
+		uint32_t getNumFramesDropped(void) { return m_numFramesDropped; }
+
+		//! See base class for method description
+		bool hasDataToSend(void);
+		uint32_t fillTransmitPayload(uint8_t* p_payload, uint32_t maxNumBytes, debugPacketDataType_t& debugDataType);
+
+	private:
+		//! A registered variable
+		typedef struct
+		{
+			const char* p_name;
+			const volatile void* p_variable;
+			uint16_t decimation;
+			uint16_t ticksUntilSample;		// the channel is due when 0
+			uint8_t type;
+			uint8_t numBytes;
+			bool isAddressChannel;
+		} telemetryChannel_t;
+
+		//! A frame being filled or waiting to be sent
+		typedef struct
+		{
+			cefTelemetryFrameHeader_t m_header;
+			uint8_t m_samples[TELEMETRY_FRAME_NUM_DATA_BYTES];
+			uint32_t m_numSampleBytes;
+			volatile bool m_readyToSend;	// set by sample(), cleared once the router has copied the frame
+		} telemetryFrame_t;
+
+		/**
+		 * Adds a channel (with room and type already checked)
+		 */
+		void addChannel(const char* p_name, telemetryType_t type, const volatile void* p_variable, uint16_t decimation,
+		                bool isAddressChannel);
+
+		/**
+		 * Hands the frame being filled to the router (if it has samples) and starts filling the other frame.  If the
+		 * router has not copied the other frame yet, the frame being filled is dropped instead.
+		 */
+		void finishFrame(void);
+
+		/**
+		 * Sends the samples taken so far, and restarts the ticks with a new configuration number.  Called with
+		 * interrupts disabled whenever the channels or the stream change, so each frame has a single configuration.
+		 */
+		void restartStream(void);
+
+		//! Empties a frame, for the current configuration
+		void startFrame(telemetryFrame_t* p_frame);
+
+		telemetryChannel_t m_channels[TELEMETRY_MAX_NUM_CHANNELS];
+		uint16_t m_numChannels;
+
+		//! Names of the address channels, which come from Python so can't be kept by pointer
+		char m_addressChannelNames[TELEMETRY_MAX_NUM_ADDRESS_CHANNELS][TELEMETRY_CHANNEL_NAME_NUM_BYTES];
+		uint16_t m_numAddressChannels;
+
+		//! Double buffer: sample() fills m_frames[m_fillFrameIndex] while the other one waits to be sent
+		telemetryFrame_t m_frames[2];
+		uint32_t m_fillFrameIndex;
+
+		//! Tick number, from 0 at the last configuration change
+		uint32_t m_tick;
+
+		uint32_t m_frameSequenceNumber;
+		uint16_t m_configurationNumber;
+		bool m_streaming;
+		uint32_t m_numFramesDropped;
+};
+
+#endif  // end header guard
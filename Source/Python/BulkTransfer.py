@@ -0,0 +1,103 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+"""
+Reception of bulk data (see "Memory Read and Write" in cefContract).  After the target accepts a memory read, the
+data arrives in debugPacketType_bulkData packets, each a cefBulkDataHeader followed by the next data of the read, as
+fast as the debug port carries them.  The Router hands each packet to the BulkReceiver registered for its transfer id,
+which writes the data straight to its sink.
+"""
+
+import sys
+from os.path import dirname, abspath
+import ctypes
+import threading
+import time
+
+sys.path.append(dirname(dirname(abspath(__file__))))
+from Shared import cefContract
+
+
+class BulkReceiver:
+    """
+    Receives the data of one bulk transfer into a sink: an object with a write() method (e.g. a file) or a bytearray
+    """
+    def __init__(self, transferId, numBytes, sink=None):
+        self.transferId = transferId
+        self.numBytes = numBytes
+        self.sink = bytearray() if sink is None else sink
+        self.numBytesReceived = 0
+        self.failed = False
+        self.lastReceiveTime = time.time()
+        self.__done = threading.Event()
+        if numBytes == 0:
+            self.__done.set()
+
+    def receive(self, offset, data):
+        """
+        Write the data of a bulk data packet to the sink.  The target sends the data in order, so a packet that is
+        not the next one means data was lost, and the transfer fails.
+        @param offset: offset of the data within the transfer
+        @param data: bytes-like object
+        """
+        if self.__done.is_set():
+            return
+        if offset != self.numBytesReceived or offset + len(data) > self.numBytes:
+            print("Bulk transfer {} data lost - received offset: {}, expected: {}".format(self.transferId, offset, self.numBytesReceived))
+            self.failed = True
+            self.__done.set()
+            return
+
+        if hasattr(self.sink, 'write'):
+            self.sink.write(data)
+        else:
+            self.sink.extend(data)
+        self.numBytesReceived += len(data)
+        self.lastReceiveTime = time.time()
+        if self.numBytesReceived == self.numBytes:
+            self.__done.set()
+
+    def wait(self, timeoutInSeconds, poll=None):
+        """
+        Wait for the transfer to finish
+        @param timeoutInSeconds: longest time to wait without receiving any data
+        @param poll: function reading the port while waiting (Router.poll with a synchronous port), else None
+        @return: True if all of the data was received, else False
+        """
+        while not self.__done.is_set():
+            if poll is not None:
+                poll()
+            else:
+                self.__done.wait(0.01)
+            if self.__done.is_set():
+                break
+            if time.time() - self.lastReceiveTime > timeoutInSeconds:
+                print("Timeout occurred on bulk transfer {}, received {} of {} bytes".format(self.transferId, self.numBytesReceived, self.numBytes))
+                return False
+        return not self.failed
+
+
+def decodeBulkData(payload):
+    """
+    @param payload: payload of a debugPacketType_bulkData packet
+    @return: (transfer id, offset, data memoryview)
+    """
+    headerSize = ctypes.sizeof(cefContract.cefBulkDataHeader)
+    if len(payload) < headerSize:
+        raise ValueError("bulk data packet too short")
+    header = cefContract.cefBulkDataHeader.from_buffer_copy(payload[:headerSize])
+    return header.m_transferId, header.m_offset, memoryview(payload)[headerSize:]
@@ -0,0 +1,439 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+"""
+Binary capture of debug port traffic.
+
+CaptureWriter appends every framed packet (transport header and payload, exactly as received)
+to a binary capture file.  Nothing is formatted at capture time, so capture keeps up with the link.
+CaptureReader memory maps a capture file and lets the user seek by host time, log sequence number,
+log module or log level.  Packets are only decoded when the user asks for them.
+
+File layout (all fields little endian):
+    File Header     FILE_HEADER_STRUCT
+    Record          RECORD_HEADER_STRUCT followed by recordLength bytes
+    ...
+    Record          (every indexInterval packet records, an index record is written; see below)
+    ...
+    Trailer         TRAILER_STRUCT (only present if the capture was closed cleanly)
+
+A packet record's payload is the framed packet.  An index record's payload is an INDEX_BLOCK_HEADER_STRUCT
+followed by one INDEX_ENTRY_STRUCT per packet record written since the previous index record.
+Index records are chained backwards (each one holds the file offset of the previous index record), and
+the trailer holds the offset of the last index record.  If the trailer is missing (e.g. the capture was
+interrupted) the reader rebuilds the index by walking the record headers.
+"""
+
+import sys
+from os.path import dirname, abspath
+import ctypes
+import mmap
+import struct
+import time
+import threading
+from bisect import bisect_left
+from collections import namedtuple
+
+sys.path.append(dirname(dirname(abspath(__file__))))
+from Shared import cefContract
+from Logger import unpackLogs, _readVarint
+from Transport import unbatch
+
+
+CAPTURE_FILE_MAGIC = b'CEFCAP\x00\x00'
+CAPTURE_TRAILER_MAGIC = b'CEFCAPIX'
+CAPTURE_FILE_VERSION = 1
+
+#  magic, version, target endianness ('<' or '>'), reserved, index interval, capture start host time (ns)
+FILE_HEADER_STRUCT = struct.Struct('<8sHcBIQ')
+
+#  record length, record type, packet type, log type, log module id, host time (ns), log sequence number, reserved
+RECORD_HEADER_STRUCT = struct.Struct('<IBBBBQHH')
+
+#  previous index record offset, number of entries
+INDEX_BLOCK_HEADER_STRUCT = struct.Struct('<QI4x')
+
+#  record offset, host time (ns), log sequence number, packet type, log type, log module id
+INDEX_ENTRY_STRUCT = struct.Struct('<QQHBBB3x')
+
+#  magic, last index record offset
+TRAILER_STRUCT = struct.Struct('<8sQ')
+
+RECORD_TYPE_PACKET = 0
+RECORD_TYPE_INDEX = 1
+
+#! Value stored for log only fields (log type, module id) of packets that are not logs
+NOT_A_LOG = 0xff
+
+#! Offset value used for "no previous index record"
+NO_INDEX_OFFSET = 0xffffffffffffffff
+
+_DEBUG_PORT_HEADER_SIZE_BYTES = ctypes.sizeof(cefContract.cefCommandDebugPortHeader)
+_PACKET_TYPE_OFFSET = cefContract.cefCommandDebugPortHeader.m_packetType.offset
+_LOG_SEQUENCE_NUMBER_OFFSET = _DEBUG_PORT_HEADER_SIZE_BYTES + cefContract.cefLog.m_logSequenceNumber.offset
+_LOG_MODULE_ID_OFFSET = _DEBUG_PORT_HEADER_SIZE_BYTES + cefContract.cefLog.m_moduleId.offset
+_LOG_TYPE_OFFSET = _DEBUG_PORT_HEADER_SIZE_BYTES + cefContract.cefLog.m_logType.offset
+_PACKED_LOG_TYPE_OFFSET = _DEBUG_PORT_HEADER_SIZE_BYTES + 1
+_PACKED_LOG_MODULE_ID_OFFSET = _DEBUG_PORT_HEADER_SIZE_BYTES + 2
+_PACKED_LOG_SEQUENCE_NUMBER_OFFSET = _DEBUG_PORT_HEADER_SIZE_BYTES + 3
+
+
+def _targetStructPrefix():
+    """
+    @return: struct byte order prefix matching the cefContract structure endianness
+    """
+    return '<' if cefContract.structureEndiannessType == ctypes.LittleEndianStructure else '>'
+
+
+class CaptureWriter:
+    """
+    Appends framed packets to a binary capture file.  Writes are buffered, and only fixed size
+    headers are packed per packet, so the writer is cheap enough to be called from the transport read loop.
+    The transport read thread writes packets while another thread may close the writer, so writes and close
+    are serialized, and packets written after close are dropped.
+    """
+
+    DEFAULT_INDEX_INTERVAL = 1024
+    WRITE_BUFFER_SIZE_BYTES = 1024 * 1024
+
+    def __init__(self, fileName, indexInterval=DEFAULT_INDEX_INTERVAL):
+        self.fileName = fileName
+        self.indexInterval = indexInterval
+        self.__file = open(fileName, 'wb', buffering=self.WRITE_BUFFER_SIZE_BYTES)
+        self.__offset = 0
+        self.__lastIndexOffset = NO_INDEX_OFFSET
+        self.__pendingIndexEntries = []
+        self.__lock = threading.Lock()
+        self.__closed = False
+        self.__logSequenceNumberStruct = struct.Struct(_targetStructPrefix() + 'H')
+
+        self._write(FILE_HEADER_STRUCT.pack(CAPTURE_FILE_MAGIC, CAPTURE_FILE_VERSION, _targetStructPrefix().encode(),
+                                            0, indexInterval, time.time_ns()))
+
+    def _write(self, data):
+        self.__file.write(data)
+        self.__offset += len(data)
+
+    def writePacket(self, packet, hostTimeNs=None):
+        """
+        Append one framed packet to the capture
+        @param packet: bytes-like object holding the debug port header followed by the payload
+        @param hostTimeNs: host receive time in nanoseconds since the epoch (defaults to now)
+        """
+        if hostTimeNs is None:
+            hostTimeNs = time.time_ns()
+
+        with self.__lock:
+            if not self.__closed:
+                self._writePacket(packet, hostTimeNs)
+
+    def _writePacket(self, packet, hostTimeNs):
+        packetType = packet[_PACKET_TYPE_OFFSET]
+        logType = NOT_A_LOG
+        moduleId = NOT_A_LOG
+        logSequenceNumber = 0
+        if packetType == cefContract.debugPacketDataType.debugPacketType_loggingData.value and len(packet) > _LOG_TYPE_OFFSET:
+            logType = packet[_LOG_TYPE_OFFSET]
+            moduleId = packet[_LOG_MODULE_ID_OFFSET]
+            logSequenceNumber = self.__logSequenceNumberStruct.unpack_from(packet, _LOG_SEQUENCE_NUMBER_OFFSET)[0]
+        elif packetType == cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value and \
+             len(packet) > _PACKED_LOG_SEQUENCE_NUMBER_OFFSET:
+            # packed packets are indexed by their first log (flags, log type, module id, varint sequence number)
+            logType = packet[_PACKED_LOG_TYPE_OFFSET]
+            moduleId = packet[_PACKED_LOG_MODULE_ID_OFFSET]
+            logSequenceNumber = _readVarint(packet, _PACKED_LOG_SEQUENCE_NUMBER_OFFSET)[0] & 0xffff
+
+        self.__pendingIndexEntries.append(INDEX_ENTRY_STRUCT.pack(self.__offset, hostTimeNs, logSequenceNumber,
+                                                                  packetType, logType, moduleId))
+        self._write(RECORD_HEADER_STRUCT.pack(len(packet), RECORD_TYPE_PACKET, packetType, logType, moduleId,
+                                              hostTimeNs, logSequenceNumber, 0))
+        self._write(packet)
+
+        if len(self.__pendingIndexEntries) >= self.indexInterval:
+            self._writeIndex()
+
+    def _writeIndex(self):
+        """
+        Write an index record for all packet records written since the previous index record
+        """
+        if not self.__pendingIndexEntries:
+            return
+        indexOffset = self.__offset
+        indexPayload = INDEX_BLOCK_HEADER_STRUCT.pack(self.__lastIndexOffset, len(self.__pendingIndexEntries)) + \
+                       b''.join(self.__pendingIndexEntries)
+        self._write(RECORD_HEADER_STRUCT.pack(len(indexPayload), RECORD_TYPE_INDEX, 0, 0, 0, time.time_ns(), 0, 0))
+        self._write(indexPayload)
+        self.__lastIndexOffset = indexOffset
+        self.__pendingIndexEntries = []
+
+    def flush(self):
+        with self.__lock:
+            if not self.__closed:
+                self.__file.flush()
+
+    def close(self):
+        """
+        Write the final index record and trailer, then close the file
+        """
+        with self.__lock:
+            if self.__closed:
+                return
+            self._writeIndex()
+            self._write(TRAILER_STRUCT.pack(CAPTURE_TRAILER_MAGIC, self.__lastIndexOffset))
+            self.__file.close()
+            self.__closed = True
+
+
+CaptureIndexEntry = namedtuple('CaptureIndexEntry', ['recordOffset', 'hostTimeNs', 'logSequenceNumber',
+                                                     'packetType', 'logType', 'moduleId'])
+
+
+class CaptureRecord:
+    """
+    One captured packet.  The index information is available immediately; the packet itself is only
+    sliced out of the memory map (and decoded) on request.
+    """
+    def __init__(self, reader, indexEntry: CaptureIndexEntry):
+        self.__reader = reader
+        self.entry = indexEntry
+
+    @property
+    def hostTimeNs(self):
+        return self.entry.hostTimeNs
+
+    @property
+    def packetType(self):
+        return self.entry.packetType
+
+    def isLog(self):
+        return self.entry.packetType == cefContract.debugPacketDataType.debugPacketType_loggingData.value
+
+    def isPackedLogs(self):
+        return self.entry.packetType == cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value
+
+    def isBatch(self):
+        return self.entry.packetType == cefContract.debugPacketDataType.debugPacketType_batch.value
+
+    def packet(self):
+        """
+        @return: memoryview of the framed packet (debug port header and payload)
+        """
+        return self.__reader.packetAt(self.entry.recordOffset)
+
+    def payload(self):
+        """
+        @return: memoryview of the packet payload (without the debug port header)
+        """
+        return self.packet()[_DEBUG_PORT_HEADER_SIZE_BYTES:]
+
+    @staticmethod
+    def _decodeRecord(packetType, payload):
+        if packetType == cefContract.debugPacketDataType.debugPacketType_loggingData.value:
+            return cefContract.cefLog.from_buffer_copy(payload)
+        if packetType == cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value:
+            return unpackLogs(payload)
+        return cefContract.cefCommandHeader.from_buffer_copy(payload)
+
+    def decode(self):
+        """
+        @return: cefContract.cefLog for log packets, a list of cefContract.cefLog for packed log packets,
+                 cefContract.cefCommandHeader for anything else; a list of those for batch packets
+        """
+        payload = self.payload()
+        if self.isBatch():
+            return [self._decodeRecord(recordType, record) for recordType, record in unbatch(payload)]
+        return self._decodeRecord(self.entry.packetType, payload)
+
+    def logs(self):
+        """
+        @return: list of cefContract.cefLog held by the packet (empty for packets that are not logs)
+        """
+        if self.isBatch():
+            records = unbatch(self.payload())
+        else:
+            records = [(self.entry.packetType, self.payload())]
+
+        logs = []
+        for recordType, record in records:
+            if recordType == cefContract.debugPacketDataType.debugPacketType_loggingData.value:
+                logs.append(cefContract.cefLog.from_buffer_copy(record))
+            elif recordType == cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value:
+                logs.extend(unpackLogs(record))
+        return logs
+
+
+class CaptureReader:
+    """
+    Memory mapped reader for capture files written by CaptureWriter
+    """
+
+    def __init__(self, fileName):
+        self.fileName = fileName
+        self.__file = open(fileName, 'rb')
+        self.__map = mmap.mmap(self.__file.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, self.targetEndianness, _, self.indexInterval, self.startHostTimeNs = \
+            FILE_HEADER_STRUCT.unpack_from(self.__map, 0)
+        if magic != CAPTURE_FILE_MAGIC or version != CAPTURE_FILE_VERSION:
+            raise ValueError("{} is not a version {} CEF capture file".format(fileName, CAPTURE_FILE_VERSION))
+
+        self.__entries = self._loadIndexFromTrailer()
+        if self.__entries is None:
+            self.__entries = self._rebuildIndex()
+        self.__hostTimes = [e.hostTimeNs for e in self.__entries]
+
+    def close(self):
+        self.__map.close()
+        self.__file.close()
+
+    def __len__(self):
+        return len(self.__entries)
+
+    def __getitem__(self, i):
+        return CaptureRecord(self, self.__entries[i])
+
+    def __iter__(self):
+        for entry in self.__entries:
+            yield CaptureRecord(self, entry)
+
+    def packetAt(self, recordOffset):
+        """
+        @param recordOffset: file offset of a packet record
+        @return: memoryview of the framed packet stored in the record
+        """
+        recordLength = RECORD_HEADER_STRUCT.unpack_from(self.__map, recordOffset)[0]
+        start = recordOffset + RECORD_HEADER_STRUCT.size
+        return memoryview(self.__map)[start:start + recordLength]
+
+    def seekTime(self, hostTimeNs):
+        """
+        @param hostTimeNs: host time in nanoseconds since the epoch
+        @return: index of the first record at or after hostTimeNs
+        """
+        return bisect_left(self.__hostTimes, hostTimeNs)
+
+    def findLogSequenceNumber(self, logSequenceNumber, startIndex=0):
+        """
+        Log sequence numbers roll over, so the same number can appear many times in a long capture
+        @param logSequenceNumber: log sequence number to find
+        @param startIndex: record index to start searching from
+        @return: index of the next log record with the given sequence number, or None
+        """
+        multipleLogs = (cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value,
+                        cefContract.debugPacketDataType.debugPacketType_batch.value)
+        for i in range(startIndex, len(self.__entries)):
+            entry = self.__entries[i]
+            if entry.logType != NOT_A_LOG and entry.logSequenceNumber == logSequenceNumber:
+                return i
+            # packed and batch packets are at most indexed by their first log, so the rest have to be decoded
+            if entry.packetType in multipleLogs and \
+               any(log.m_logSequenceNumber == logSequenceNumber for log in CaptureRecord(self, entry).logs()):
+                return i
+        return None
+
+    def filter(self, startTimeNs=None, endTimeNs=None, moduleId=None, minLogType=None, packetType=None):
+        """
+        Generator of records matching all of the given criteria (None means "don't care").
+        Only the index is consulted; records are not decoded.  Packed log and batch packets hold several logs
+        but are at most indexed by their first log, so they are not filtered on moduleId/minLogType here - filter
+        their logs() instead.
+        @param minLogType: only logs at this cefContract.logType value or higher
+        """
+        multipleLogs = (cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value,
+                        cefContract.debugPacketDataType.debugPacketType_batch.value)
+        first = 0 if startTimeNs is None else self.seekTime(startTimeNs)
+        for i in range(first, len(self.__entries)):
+            entry = self.__entries[i]
+            if endTimeNs is not None and entry.hostTimeNs > endTimeNs:
+                break
+            if packetType is not None and entry.packetType != packetType:
+                continue
+            if entry.packetType not in multipleLogs:
+                if moduleId is not None and entry.moduleId != moduleId:
+                    continue
+                if minLogType is not None and (entry.logType == NOT_A_LOG or entry.logType < minLogType):
+                    continue
+            yield CaptureRecord(self, entry)
+
+    def _loadIndexFromTrailer(self):
+        """
+        @return: list of CaptureIndexEntry from the chained index records, or None if there is no valid trailer
+        """
+        if len(self.__map) < FILE_HEADER_STRUCT.size + TRAILER_STRUCT.size:
+            return None
+        magic, indexOffset = TRAILER_STRUCT.unpack_from(self.__map, len(self.__map) - TRAILER_STRUCT.size)
+        if magic != CAPTURE_TRAILER_MAGIC:
+            return None
+
+        blocks = []
+        while indexOffset != NO_INDEX_OFFSET:
+            _, recordType, _, _, _, _, _, _ = RECORD_HEADER_STRUCT.unpack_from(self.__map, indexOffset)
+            if recordType != RECORD_TYPE_INDEX:
+                return None
+            blockOffset = indexOffset + RECORD_HEADER_STRUCT.size
+            previousIndexOffset, numEntries = INDEX_BLOCK_HEADER_STRUCT.unpack_from(self.__map, blockOffset)
+            blocks.append((blockOffset + INDEX_BLOCK_HEADER_STRUCT.size, numEntries))
+            indexOffset = previousIndexOffset
+
+        entries = []
+        for entriesOffset, numEntries in reversed(blocks):
+            entries.extend(CaptureIndexEntry._make(e) for e in
+                           INDEX_ENTRY_STRUCT.iter_unpack(self.__map[entriesOffset:entriesOffset + numEntries * INDEX_ENTRY_STRUCT.size]))
+        return entries
+
+    def _rebuildIndex(self):
+        """
+        Walk every record header to rebuild the index (used when the capture has no trailer)
+        @return: list of CaptureIndexEntry
+        """
+        entries = []
+        offset = FILE_HEADER_STRUCT.size
+        end = len(self.__map)
+        while offset + RECORD_HEADER_STRUCT.size <= end:
+            recordLength, recordType, packetType, logType, moduleId, hostTimeNs, logSequenceNumber, _ = \
+                RECORD_HEADER_STRUCT.unpack_from(self.__map, offset)
+            if offset + RECORD_HEADER_STRUCT.size + recordLength > end:
+                break   # partially written record at the end of an interrupted capture
+            if recordType == RECORD_TYPE_PACKET:
+                entries.append(CaptureIndexEntry(offset, hostTimeNs, logSequenceNumber, packetType, logType, moduleId))
+            offset += RECORD_HEADER_STRUCT.size + recordLength
+        return entries
+
+
+if __name__ == '__main__':
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Print log records from a CEF capture file')
+    parser.add_argument('fileName')
+    parser.add_argument('--module', type=int, default=None, help='only logs from this module id')
+    parser.add_argument('--level', type=int, default=None, help='only logs at or above this logType value')
+    parser.add_argument('--start', type=float, default=None, help='seconds from the start of the capture')
+    parser.add_argument('--end', type=float, default=None, help='seconds from the start of the capture')
+    args = parser.parse_args()
+
+    reader = CaptureReader(args.fileName)
+    startTimeNs = None if args.start is None else reader.startHostTimeNs + int(args.start * cefContract.LOGGING_UINT64_NSEC_TO_SECONDS)
+    endTimeNs = None if args.end is None else reader.startHostTimeNs + int(args.end * cefContract.LOGGING_UINT64_NSEC_TO_SECONDS)
+    for record in reader.filter(startTimeNs, endTimeNs, args.module, args.level):
+        for log in record.logs():
+            if args.module is not None and log.m_moduleId != args.module:
+                continue
+            if args.level is not None and log.m_logType < args.level:
+                continue
+            print("{:.6f}, {}, {}, {}, {}:{}".format((record.hostTimeNs - reader.startHostTimeNs) / cefContract.LOGGING_UINT64_NSEC_TO_SECONDS,
+                                                    cefContract.logType(log.m_logType).name, log.m_logSequenceNumber,
+                                                    bytes.decode(log.m_logString, errors='replace'),
+                                                    bytes.decode(log.m_fileName, errors='replace'), log.m_fileLineNumber))
+    reader.close()
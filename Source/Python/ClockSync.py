@@ -0,0 +1,123 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+"""
+Correlation of target time stamps with host time.
+
+The target time stamps logs and time sync responses with a free running monotonic nanosecond count
+(ShimBase::getTimeNs()).  Each time sync command gives four time stamps:
+    t0 host transmit, t1 target receive, t2 target transmit, t3 host receive
+from which (as in NTP):
+    round trip time         = (t3 - t0) - (t2 - t1)
+    host - target offset    = ((t0 - t1) + (t3 - t2)) / 2
+The offset is exact if the link delay is the same in both directions, and is never wrong by more than half of
+the round trip time, so the sample with the smallest round trip time is kept from each group of samples.
+Host times are time.time_ns() nanoseconds, the same host clock used by Capture.py.
+"""
+
+import sys
+from os.path import dirname, abspath
+
+sys.path.append(dirname(dirname(abspath(__file__))))
+from Shared import cefContract
+
+
+class ClockSyncPoint:
+    """
+    One target/host clock correlation: at target time targetTimeNs, host time = target time + offsetNs (+/- errorNs)
+    """
+    def __init__(self, targetTimeNs, offsetNs, roundTripTimeNs):
+        self.targetTimeNs = targetTimeNs
+        self.offsetNs = offsetNs
+        self.roundTripTimeNs = roundTripTimeNs
+        self.errorNs = roundTripTimeNs // 2
+
+
+class ClockSync:
+    """
+    Converts target time stamps to host time.  Each call to addSamples() adds a sync point; once two sync points
+    are at least MIN_DRIFT_SPAN_NS apart, the target clock's drift relative to the host clock is corrected as well.
+    """
+
+    #! Sync points must be this far apart before drift is estimated, so their errors don't dominate the estimate
+    MIN_DRIFT_SPAN_NS = 10 * cefContract.LOGGING_UINT64_NSEC_TO_SECONDS
+
+    def __init__(self):
+        self.syncPoints = []
+        self.drift = 0.0    # host nanoseconds gained per target nanosecond
+
+    @staticmethod
+    def calculateSample(hostTransmitNs, targetReceiveNs, targetTransmitNs, hostReceiveNs):
+        """
+        @return: (host - target clock offset, round trip time) of one time sync exchange, in nanoseconds
+        """
+        roundTripTimeNs = (hostReceiveNs - hostTransmitNs) - (targetTransmitNs - targetReceiveNs)
+        offsetNs = ((hostTransmitNs - targetReceiveNs) + (hostReceiveNs - targetTransmitNs)) // 2
+        return offsetNs, roundTripTimeNs
+
+    def addSamples(self, samples):
+        """
+        Add a sync point from the best (smallest round trip time) of a group of time sync exchanges
+        @param samples: list of (host transmit, target receive, target transmit, host receive) nanosecond tuples
+        @return: the new ClockSyncPoint
+        """
+        bestSample = None
+        for sample in samples:
+            offsetNs, roundTripTimeNs = self.calculateSample(*sample)
+            if roundTripTimeNs < 0:
+                continue    # a time stamp was taken out of order, the sample is meaningless
+            if bestSample is None or roundTripTimeNs < bestSample.roundTripTimeNs:
+                targetTimeNs = (sample[1] + sample[2]) // 2
+                bestSample = ClockSyncPoint(targetTimeNs, offsetNs, roundTripTimeNs)
+
+        if bestSample is None:
+            raise ValueError("no valid time sync samples")
+
+        # a target reset restarts the target clock, so earlier sync points no longer apply
+        if self.syncPoints and bestSample.targetTimeNs < self.syncPoints[-1].targetTimeNs:
+            self.syncPoints = []
+            self.drift = 0.0
+
+        self.syncPoints.append(bestSample)
+        firstSyncPoint = self.syncPoints[0]
+        targetSpanNs = bestSample.targetTimeNs - firstSyncPoint.targetTimeNs
+        if targetSpanNs >= self.MIN_DRIFT_SPAN_NS:
+            self.drift = (bestSample.offsetNs - firstSyncPoint.offsetNs) / targetSpanNs
+
+        return bestSample
+
+    def isSynchronized(self):
+        return len(self.syncPoints) > 0
+
+    def targetToHostNs(self, targetTimeNs):
+        """
+        @param targetTimeNs: target time stamp (e.g. cefLog.m_timeStamp)
+        @return: the corresponding host time in nanoseconds, or None if there has been no time sync
+        """
+        if not self.syncPoints:
+            return None
+        syncPoint = self.syncPoints[-1]
+        return targetTimeNs + syncPoint.offsetNs + int(self.drift * (targetTimeNs - syncPoint.targetTimeNs))
+
+    def errorBoundNs(self):
+        """
+        @return: worst case error of targetToHostNs() at the latest sync point (the error grows with the distance
+                 from it by any drift that has not been corrected), or None if there has been no time sync
+        """
+        if not self.syncPoints:
+            return None
+        return self.syncPoints[-1].errorNs
@@ -35,6 +35,7 @@ class CommandBase(ABC):
         self.expectedResponse = None
         self.receivedResponse = None
         self.expectedResponseType = None
+        self.responseReceiveTimeNs = None   # host time.time_ns() time the response was read from the debug port
 
     @abstractmethod
     def buildCommand(self):
@@ -76,3 +77,17 @@ class CommandBase(ABC):
 
     def expectedResponseLength(self):
         return len(bytes(self.expectedResponse))
+
+    def validateResponseLength(self, length):
+        """
+        @param length: number of bytes in the received response
+        @return boolean: True if the response is the expected length
+        """
+        return length == self.expectedResponseLength()
+
+    def decodeResponse(self, payload):
+        """
+        @param payload: the received response, already checked by validateResponseLength()
+        @return: the response decoded into its contract structure (the contract structure handles endianness)
+        """
+        return type(self.expectedResponse).from_buffer_copy(payload)
@@ -0,0 +1,66 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class CommandDebugPortStats(CommandBase):
+    """
+    Read the target's debug port error counters: receive errors by class (parity, noise, framing, overrun),
+    packets dropped because of them, and receive and transmit timeouts
+    """
+
+    def __init__(self):
+        super().__init__()
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandDebugPortStatsResponse)
+
+    def buildCommand(self):
+        """
+        Create the Debug Port Stats request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeDebugPortStats.value
+        self.header.m_commandNumBytes = ctypes.sizeof(cefContract.cefCommandDebugPortStatsRequest)
+
+        # build the body (header only)
+        self.request = cefContract.cefCommandDebugPortStatsRequest()
+        self.request.m_header = self.header
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandDebugPortStatsResponse()
+        self.expectedResponse.m_header = self.header
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandDebugPortStatsResponse):
+        """
+        Any counter values are valid, keep them for stats()
+        """
+        self.receivedResponse = receivedResponse
+        return True
+
+    def stats(self):
+        """
+        @return: dictionary of the counters, by name without the 'm_num' prefix (e.g. 'ParityErrors')
+        """
+        return {name[len('m_num'):]: getattr(self.receivedResponse, name)
+                for name, fieldType in cefContract.cefCommandDebugPortStatsResponse._fields_ if name.startswith('m_num')}
@@ -0,0 +1,43 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+from .FragmentedCommandBase import *
+
+
+class CommandFragmentLoopback(FragmentedCommandBase):
+    """
+    Checks out fragmented commands: the target sends the request data back as the response data
+    """
+
+    def __init__(self, requestData):
+        """
+        @param requestData: bytes-like object of any size, expected back from the target
+        """
+        super().__init__(cefContract.commandOpCode.commandOpCodeFragmentLoopback, requestData)
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandFragment):
+        """
+        Fragment Loopback specific response checking, once the transfer is complete
+        """
+        if not super().validateResponseBody(receivedResponse):
+            return False
+        if self.transferComplete and self.responseSink != self.requestData:
+            print("Invalid Fragment Loopback response, {} bytes sent, {} bytes received".format(
+                len(self.requestData), len(self.responseSink)))
+            return False
+        return True
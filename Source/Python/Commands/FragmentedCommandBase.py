@@ -0,0 +1,128 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class FragmentedCommandBase(CommandBase):
+    """
+    Base class for commands whose request or response data is sent in fragments (see "Fragmented Commands" in
+    cefContract).  Each execution of the command sends the next fragment of request data (an empty fragment once it
+    has all been sent) and receives the next fragment of response data, until the target ends the transfer
+    (transferComplete).  Response data is written to responseSink as it arrives, so it can be a file.
+    """
+
+    def __init__(self, commandOpCode: cefContract.commandOpCode, requestData=b'', responseSink=None):
+        """
+        @param commandOpCode: the command's opcode
+        @param requestData: bytes-like object with all of the request data
+        @param responseSink: object with a write() method (e.g. a file) or a bytearray, default is a new bytearray
+        """
+        super().__init__()
+        self.commandOpCode = commandOpCode
+        self.requestData = memoryview(requestData).cast('B')
+        self.responseSink = bytearray() if responseSink is None else responseSink
+        self.requestNumBytesSent = 0
+        self.responseNumBytesReceived = 0
+        self.responseTotalNumBytes = None
+        self.transferComplete = False
+        self.__numFragmentsSent = 0
+        self.__fragmentNumBytes = 0
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandFragment)
+
+    def buildCommand(self):
+        """
+        Create the fragment request (filled in for each fragment at transmit-time) and the expected response
+        according to cefContract
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = self.commandOpCode.value
+        self.header.m_commandNumBytes = cefContract.CEF_FRAGMENT_HEADERS_NUM_BYTES
+
+        # build the body
+        self.request = cefContract.cefCommandFragment()
+        self.request.m_header = self.header
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandFragment()
+        self.expectedResponse.m_header = self.header
+
+    def payload(self):
+        """
+        @return: the next fragment of the request, only as many bytes as it has data
+        """
+        offset = self.requestNumBytesSent
+        data = self.requestData[offset:offset + cefContract.CEF_FRAGMENT_MAX_DATA_BYTES]
+        self.__fragmentNumBytes = len(data)
+
+        fragment = self.request.m_fragment
+        fragment.m_totalNumBytes = len(self.requestData)
+        fragment.m_offset = offset
+        fragment.m_numBytes = len(data)
+        fragment.m_flags = cefContract.CEF_FRAGMENT_FLAG_FIRST if self.__numFragmentsSent == 0 else 0
+        ctypes.memmove(self.request.m_data, bytes(data), len(data))
+
+        numBytes = cefContract.CEF_FRAGMENT_HEADERS_NUM_BYTES + len(data)
+        self.request.m_header.m_commandNumBytes = numBytes
+        self.__numFragmentsSent += 1
+        return bytes(self.request)[:numBytes]
+
+    def validateResponseLength(self, length):
+        """
+        A response has the headers and up to a fragment of data, an error response only has the command header
+        """
+        return ctypes.sizeof(cefContract.cefCommandHeader) <= length <= self.expectedResponseLength()
+
+    def decodeResponse(self, payload):
+        response = cefContract.cefCommandFragment()
+        ctypes.memmove(ctypes.addressof(response), bytes(payload), len(payload))
+        return response
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandFragment):
+        """
+        Fragment response checking; the response data is written to responseSink
+        """
+        self.receivedResponse = receivedResponse
+        fragment = receivedResponse.m_fragment
+        numBytes = cefContract.CEF_FRAGMENT_HEADERS_NUM_BYTES + fragment.m_numBytes
+        if receivedResponse.m_header.m_commandNumBytes != numBytes or fragment.m_numBytes > cefContract.CEF_FRAGMENT_MAX_DATA_BYTES:
+            print("Invalid fragment response size - numBytes: {}, fragment numBytes: {}".format(
+                receivedResponse.m_header.m_commandNumBytes, fragment.m_numBytes))
+            return False
+        if fragment.m_offset != self.responseNumBytesReceived:
+            print("Fragment response out of order - offset: {}, expected: {}".format(fragment.m_offset, self.responseNumBytesReceived))
+            return False
+
+        data = bytes(receivedResponse)[cefContract.CEF_FRAGMENT_HEADERS_NUM_BYTES:numBytes]
+        if hasattr(self.responseSink, 'write'):
+            self.responseSink.write(data)
+        else:
+            self.responseSink.extend(data)
+
+        # the target has the request fragment, and the response fragment is here
+        self.requestNumBytesSent += self.__fragmentNumBytes
+        self.responseNumBytesReceived += fragment.m_numBytes
+        self.responseTotalNumBytes = fragment.m_totalNumBytes
+        if fragment.m_flags & cefContract.CEF_FRAGMENT_FLAG_LAST:
+            self.transferComplete = True
+        return True
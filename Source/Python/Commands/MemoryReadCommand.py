@@ -0,0 +1,77 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class CommandMemoryRead(CommandBase):
+    """
+    Starts a read of target memory.  The response only accepts the read; the data follows in bulk data packets
+    (see BulkTransfer.py), so the read is not slowed down by a round trip per packet.
+    """
+
+    def __init__(self, address, numBytes, transferId):
+        """
+        @param address: target address to read from
+        @param numBytes: number of bytes to read (0 ends a read in progress)
+        @param transferId: sent by the target in each bulk data packet of the read
+        """
+        super().__init__()
+        self.address = address
+        self.numBytes = numBytes
+        self.transferId = transferId
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandMemoryReadResponse)
+
+    def buildCommand(self):
+        """
+        Create the Memory Read request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeMemoryRead.value
+        self.header.m_commandNumBytes = ctypes.sizeof(cefContract.cefCommandMemoryReadRequest)
+
+        # build the body
+        self.request = cefContract.cefCommandMemoryReadRequest()
+        self.request.m_header = self.header
+        self.request.m_address = self.address
+        self.request.m_numBytes = self.numBytes
+        self.request.m_transferId = self.transferId
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandMemoryReadResponse()
+        self.expectedResponse.m_header = self.header
+        self.expectedResponse.m_numBytes = self.numBytes
+        self.expectedResponse.m_transferId = self.transferId
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandMemoryReadResponse):
+        """
+        Memory Read specific response field checking
+        """
+        self.receivedResponse = receivedResponse
+        if receivedResponse.m_numBytes != self.expectedResponse.m_numBytes or \
+            receivedResponse.m_transferId != self.expectedResponse.m_transferId:
+            print("Invalid Memory Read response, read {} bytes transfer {}".format(receivedResponse.m_numBytes, receivedResponse.m_transferId))
+            return False
+        else:
+            return True
@@ -0,0 +1,78 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class CommandMemoryWrite(CommandBase):
+    """
+    Writes up to CEF_MEMORY_WRITE_MAX_DATA_BYTES to target memory.  Only the data is sent, not the whole request
+    structure.
+    """
+
+    def __init__(self, address, data):
+        """
+        @param address: target address to write to
+        @param data: bytes-like object, at most cefContract.CEF_MEMORY_WRITE_MAX_DATA_BYTES
+        """
+        super().__init__()
+        self.address = address
+        self.data = bytes(data)
+        if len(self.data) > cefContract.CEF_MEMORY_WRITE_MAX_DATA_BYTES:
+            raise ValueError("Memory write of {} bytes, the most is {}".format(len(self.data), cefContract.CEF_MEMORY_WRITE_MAX_DATA_BYTES))
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandMemoryWriteResponse)
+
+    def buildCommand(self):
+        """
+        Create the Memory Write request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeMemoryWrite.value
+        self.header.m_commandNumBytes = cefContract.CEF_MEMORY_WRITE_HEADERS_NUM_BYTES + len(self.data)
+
+        # build the body
+        self.request = cefContract.cefCommandMemoryWriteRequest()
+        self.request.m_header = self.header
+        self.request.m_address = self.address
+        self.request.m_numBytes = len(self.data)
+        ctypes.memmove(self.request.m_data, self.data, len(self.data))
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandMemoryWriteResponse()
+        self.expectedResponse.m_header = self.header
+        self.expectedResponse.m_numBytes = len(self.data)
+
+    def payload(self):
+        return bytes(self.request)[:self.header.m_commandNumBytes]
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandMemoryWriteResponse):
+        """
+        Memory Write specific response field checking
+        """
+        self.receivedResponse = receivedResponse
+        if receivedResponse.m_numBytes != self.expectedResponse.m_numBytes:
+            print("Invalid Memory Write response, wrote {} bytes".format(receivedResponse.m_numBytes))
+            return False
+        else:
+            return True
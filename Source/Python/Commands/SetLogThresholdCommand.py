@@ -0,0 +1,67 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class CommandSetLogThreshold(CommandBase):
+    """
+    Changes the run time logging threshold of one logging module (or all of them) on the target.
+    Logs below the threshold are dropped on the target before they use any log buffer or debug port bandwidth.
+    """
+
+    def __init__(self, logThreshold: cefContract.logType, moduleId=cefContract.LOGGING_MODULE_ID_ALL_MODULES):
+        super().__init__()
+        self.logThreshold = logThreshold
+        self.moduleId = moduleId
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandSetLogThresholdResponse)
+
+    def buildCommand(self):
+        """
+        Create the Set Log Threshold request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeSetLogThreshold.value
+        self.header.m_commandNumBytes = ctypes.sizeof(cefContract.cefCommandSetLogThresholdRequest)
+
+        # build the body
+        self.request = cefContract.cefCommandSetLogThresholdRequest()
+        self.request.m_header = self.header
+        self.request.m_moduleId = self.moduleId
+        self.request.m_logThreshold = self.logThreshold.value
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandSetLogThresholdResponse()
+        self.expectedResponse.m_header = self.header
+        self.expectedResponse.m_moduleId = self.moduleId
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandSetLogThresholdResponse):
+        """
+        Set Log Threshold specific response field checking
+        """
+        self.receivedResponse = receivedResponse
+        if receivedResponse.m_moduleId != self.expectedResponse.m_moduleId:
+            print("Invalid Set Log Threshold response module id: {}".format(receivedResponse.m_moduleId))
+            return False
+        else:
+            return True
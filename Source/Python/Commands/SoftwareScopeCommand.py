@@ -0,0 +1,85 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class CommandSoftwareScope(CommandBase):
+    """
+    Upload a list of target addresses to sample on the telemetry stream (see "Software Scope" in cefContract).  Only
+    the entries are sent, not the whole request structure.
+    """
+
+    def __init__(self, entries, replace=True):
+        """
+        @param entries: list of (name, address, cefContract.telemetryType, decimation), at most
+                        cefContract.TELEMETRY_MAX_NUM_ADDRESS_CHANNELS
+        @param replace: True to remove the addresses sampled so far first
+        """
+        super().__init__()
+        self.entries = list(entries)
+        self.replace = replace
+        if len(self.entries) > cefContract.TELEMETRY_MAX_NUM_ADDRESS_CHANNELS:
+            raise ValueError("Software scope of {} addresses, the most is {}".format(len(self.entries), cefContract.TELEMETRY_MAX_NUM_ADDRESS_CHANNELS))
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandSoftwareScopeResponse)
+
+    def buildCommand(self):
+        """
+        Create the Software Scope request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeSoftwareScope.value
+        self.header.m_commandNumBytes = cefContract.CEF_SOFTWARE_SCOPE_HEADERS_NUM_BYTES + \
+                                        len(self.entries) * ctypes.sizeof(cefContract.cefSoftwareScopeEntry)
+
+        # build the body
+        self.request = cefContract.cefCommandSoftwareScopeRequest()
+        self.request.m_header = self.header
+        self.request.m_numEntries = len(self.entries)
+        self.request.m_replace = 1 if self.replace else 0
+        for entry, (name, address, telemetryType, decimation) in zip(self.request.m_entries, self.entries):
+            entry.m_address = address
+            entry.m_decimation = decimation
+            entry.m_type = telemetryType.value
+            # the target keeps TELEMETRY_CHANNEL_NAME_NUM_BYTES - 1 characters of the name
+            entry.m_name = name.encode()[:cefContract.TELEMETRY_CHANNEL_NAME_NUM_BYTES - 1]
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandSoftwareScopeResponse()
+        self.expectedResponse.m_header = self.header
+
+    def payload(self):
+        return bytes(self.request)[:self.header.m_commandNumBytes]
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandSoftwareScopeResponse):
+        """
+        Software Scope specific response field checking
+        """
+        self.receivedResponse = receivedResponse
+        if receivedResponse.m_numAddressChannels < len(self.entries):
+            print("Invalid Software Scope response, {} addresses sampled".format(receivedResponse.m_numAddressChannels))
+            return False
+        else:
+            return True
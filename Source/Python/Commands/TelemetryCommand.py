@@ -0,0 +1,72 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+
+import ctypes
+
+from .CommandBase import *
+
+
+class CommandTelemetry(CommandBase):
+    """
+    Read a telemetry channel's registration (name, type, decimation), and optionally change its decimation and
+    start or stop the telemetry stream
+    """
+
+    def __init__(self, channelIndex=0, decimation=cefContract.TELEMETRY_DECIMATION_UNCHANGED,
+                 control=cefContract.telemetryControl.telemetryControl_none):
+        super().__init__()
+        self.channelIndex = channelIndex
+        self.decimation = decimation
+        self.control = control
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandTelemetryResponse)
+
+    def buildCommand(self):
+        """
+        Create the Telemetry request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeTelemetry.value
+        self.header.m_commandNumBytes = ctypes.sizeof(cefContract.cefCommandTelemetryRequest)
+
+        # build the body
+        self.request = cefContract.cefCommandTelemetryRequest()
+        self.request.m_header = self.header
+        self.request.m_channelIndex = self.channelIndex
+        self.request.m_decimation = self.decimation
+        self.request.m_control = self.control.value
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandTelemetryResponse()
+        self.expectedResponse.m_header = self.header
+        self.expectedResponse.m_channelIndex = self.channelIndex
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandTelemetryResponse):
+        """
+        Telemetry specific response field checking
+        """
+        self.receivedResponse = receivedResponse
+        if receivedResponse.m_channelIndex != self.expectedResponse.m_channelIndex:
+            print("Invalid Telemetry response channel index: {}".format(receivedResponse.m_channelIndex))
+            return False
+        else:
+            return True
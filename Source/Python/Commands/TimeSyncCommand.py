@@ -0,0 +1,79 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+import ctypes
+import time
+
+from .CommandBase import *
+
+
+class CommandTimeSync(CommandBase):
+    """
+    NTP style time transfer with the target, see ClockSync.py.  The host transmit time is stamped when the
+    request payload is built for transmission, and the host receive time is the time the Transport read the response.
+    """
+
+    def __init__(self):
+        super().__init__()
+        self.buildCommand()
+        self.expectedResponseType = type(self.expectedResponse).__new__(cefContract.cefCommandTimeSyncResponse)
+
+    def buildCommand(self):
+        """
+        Create the Time Sync request for transmission and the expected corresponding response according
+        to cefContract.
+        """
+        # build the header
+        self.header.m_commandSequenceNumber = 0 # this is populated at transmit-time
+        self.header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        self.header.m_commandOpCode = cefContract.commandOpCode.commandOpCodeTimeSync.value
+        self.header.m_commandNumBytes = ctypes.sizeof(cefContract.cefCommandTimeSyncRequest)
+
+        # build the body (the host transmit time is populated at transmit-time)
+        self.request = cefContract.cefCommandTimeSyncRequest()
+        self.request.m_header = self.header
+
+        # template for the expected response from the target
+        self.expectedResponse = cefContract.cefCommandTimeSyncResponse()
+        self.expectedResponse.m_header = self.header
+
+    def payload(self):
+        self.request.m_hostTransmitTimeNs = time.time_ns()
+        self.expectedResponse.m_hostTransmitTimeNs = self.request.m_hostTransmitTimeNs
+        return super().payload()
+
+    def validateResponseBody(self, receivedResponse: cefContract.cefCommandTimeSyncResponse):
+        """
+        Time Sync specific response field checking
+        """
+        self.receivedResponse = receivedResponse
+        if receivedResponse.m_hostTransmitTimeNs != self.expectedResponse.m_hostTransmitTimeNs:
+            print("Invalid Time Sync response host transmit time: {}".format(receivedResponse.m_hostTransmitTimeNs))
+            return False
+        elif receivedResponse.m_targetTransmitTimeNs < receivedResponse.m_targetReceiveTimeNs:
+            print("Invalid Time Sync response, target transmit time {} is before target receive time {}".format(
+                receivedResponse.m_targetTransmitTimeNs, receivedResponse.m_targetReceiveTimeNs))
+            return False
+        else:
+            return True
+
+    def timeStamps(self):
+        """
+        @return: (host transmit, target receive, target transmit, host receive) times in nanoseconds
+        """
+        return (self.receivedResponse.m_hostTransmitTimeNs, self.receivedResponse.m_targetReceiveTimeNs,
+                self.receivedResponse.m_targetTransmitTimeNs, self.responseReceiveTimeNs)
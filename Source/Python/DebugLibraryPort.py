@@ -0,0 +1,232 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+import ctypes
+import threading
+import time
+
+from DebugPortDriver import DebugPortDriver
+from Shared import cefContract
+
+
+class DebugLibraryPort(DebugPortDriver):
+    """
+    Concrete implementation of the DebugPortDriver for a target running in this process: the simulator built
+    as a shared library (libcefsim, see CefSimulatorApi.hpp), whose debug port is an in memory loopback.
+    No serial port, socket or simulator process is involved, so a test can run many command round trips
+    per second, and can step the target itself (see step()).
+
+    The target only runs when stepped.  By default send(), receive() and poll() step it, and the port is
+    synchronous: the Router uses it without threads, stepping the target from the caller's thread until the
+    response to a command has been pulled, so a command round trip costs no thread switches or sleeps.  With
+    autoStep=False only step() does, and the Router reads the port from its threads like any other port.  The
+    library is not thread safe, so every call into it is made holding a lock.  A process can only load one
+    instance of the target.
+    """
+
+    # passes of the target's while loop each time the driver steps it
+    PASSES_PER_STEP = 20
+    # bytes pulled from the target at once
+    PULL_BUFFER_NUM_BYTES = 4096
+    # telemetry type of each ctypes variable type
+    TELEMETRY_TYPES = {
+        ctypes.c_uint8: cefContract.telemetryType.telemetryType_uint8,
+        ctypes.c_int8: cefContract.telemetryType.telemetryType_int8,
+        ctypes.c_uint16: cefContract.telemetryType.telemetryType_uint16,
+        ctypes.c_int16: cefContract.telemetryType.telemetryType_int16,
+        ctypes.c_uint32: cefContract.telemetryType.telemetryType_uint32,
+        ctypes.c_int32: cefContract.telemetryType.telemetryType_int32,
+        ctypes.c_uint64: cefContract.telemetryType.telemetryType_uint64,
+        ctypes.c_int64: cefContract.telemetryType.telemetryType_int64,
+        ctypes.c_float: cefContract.telemetryType.telemetryType_float32,
+        ctypes.c_double: cefContract.telemetryType.telemetryType_float64
+    }
+
+    def __init__(self, libraryPath='./libcefsim.so', autoStep=True, timeNsPerPass=None):
+        """
+        @param libraryPath: path of libcefsim.so
+        @param autoStep: True if send() and receive() step the target
+        @param timeNsPerPass: None for the target to use the host's clock, else the target's time only moves by
+                              this much per pass of its while loop (deterministic time)
+        """
+        self.__libraryPath = libraryPath
+        self.__autoStep = autoStep
+        self.__timeNsPerPass = timeNsPerPass
+        self.__timeNs = 0
+        self.__library = None
+        self.__lock = threading.Lock()
+        self.__pullBuffer = ctypes.create_string_buffer(self.PULL_BUFFER_NUM_BYTES)
+        self.__telemetryNames = []
+
+        self.synchronous = autoStep
+        self.bytesRx = 0
+
+    def open(self):
+        """
+        Load the target library
+        """
+        try:
+            library = ctypes.CDLL(self.__libraryPath)
+        except OSError:
+            print("DebugLibraryPort.open(): error")
+            raise
+        library.cef_step.argtypes = [ctypes.c_uint32]
+        library.cef_step.restype = None
+        library.cef_push_rx.argtypes = [ctypes.c_char_p, ctypes.c_uint32]
+        library.cef_push_rx.restype = ctypes.c_uint32
+        library.cef_pull_tx.argtypes = [ctypes.c_char_p, ctypes.c_uint32]
+        library.cef_pull_tx.restype = ctypes.c_uint32
+        library.cef_set_time_ns.argtypes = [ctypes.c_uint64]
+        library.cef_set_time_ns.restype = None
+        library.cef_inject_rx_error.argtypes = [ctypes.c_uint16]
+        library.cef_inject_rx_error.restype = None
+        library.cef_raise_event.argtypes = [ctypes.c_uint16, ctypes.c_char_p, ctypes.c_uint16]
+        library.cef_raise_event.restype = ctypes.c_uint32
+        library.cef_register_telemetry_channel.argtypes = [ctypes.c_char_p, ctypes.c_uint8, ctypes.c_void_p, ctypes.c_uint16]
+        library.cef_register_telemetry_channel.restype = ctypes.c_uint32
+        self.__library = library
+        if self.__timeNsPerPass is not None:
+            library.cef_set_time_ns(self.__timeNs)
+
+    def close(self):
+        """
+        Stop using the target (a library can't reliably be unloaded, so it keeps its state)
+        """
+        with self.__lock:
+            self.__library = None
+
+    def step(self, numPasses=1):
+        """
+        Run passes of the target's while loop
+        @param numPasses: number of passes
+        """
+        with self.__lock:
+            self._step(numPasses)
+
+    def injectReceiveError(self, errorCode: cefContract.errorCode):
+        """
+        Report a receive error to the target, as its UART would (e.g. to check the target recovers from noise)
+        @param errorCode: cefContract.errorCode.errorCode_debugPortErrorCodeParity, ...Noise, ...Frame or ...Overrun
+        """
+        with self.__lock:
+            self.__library.cef_inject_rx_error(errorCode.value)
+
+    def raiseEvent(self, eventId, data=b''):
+        """
+        Raise an event on the target, as its application or an interrupt handler would (see Events.py)
+        @param eventId: event id (cefContract.eventId or an int)
+        @param data: bytes sent with the event (at most cefContract.CEF_EVENT_MAX_DATA_BYTES)
+        @return: True if the target queued the event, False if it was dropped
+        """
+        eventId = eventId.value if isinstance(eventId, cefContract.eventId) else eventId
+        data = bytes(data)
+        with self.__lock:
+            return self.__library.cef_raise_event(eventId, data, len(data)) == 1
+
+    def registerTelemetryChannel(self, name, variable, decimation=1):
+        """
+        Register a telemetry channel on the target, as its application would (see Telemetry.py).  The target runs in
+        this process, so it samples the ctypes variable directly.
+        @param name: name of the channel
+        @param variable: ctypes variable to sample (c_uint8 ... c_int64, c_float or c_double), which must be kept
+        @param decimation: the variable is sampled every decimation passes of the target's while loop
+        @return: True if the target registered the channel
+        """
+        telemetryType = self.TELEMETRY_TYPES[type(variable)]
+        # the target keeps the name by pointer
+        nameBuffer = ctypes.create_string_buffer(name.encode())
+        self.__telemetryNames.append(nameBuffer)
+        with self.__lock:
+            return self.__library.cef_register_telemetry_channel(nameBuffer, telemetryType.value, ctypes.addressof(variable), decimation) == 1
+
+    def loadAddress(self, elfSymbols):
+        """
+        Address the library was loaded at, so the addresses in its ELF file can be sampled by the software scope
+        (e.g. elfSymbols.loadAddress = port.loadAddress(elfSymbols), see ElfSymbols.py)
+        @param elfSymbols: ElfSymbols of the library's ELF file
+        @return: address to add to the addresses in the ELF file
+        """
+        address = ctypes.cast(self.__library.cef_step, ctypes.c_void_p).value
+        return address - elfSymbols.symbolAddress('cef_step')
+
+    def send(self, data: bytes) -> int:
+        """
+        Hand the packet to the target, stepping the target when it has no room for more
+        @param data: bytearray to be written
+        @return bytesWritten: number of bytes successfully written
+        """
+        data = bytes(data)
+        sent = 0
+        with self.__lock:
+            while sent < len(data):
+                numBytes = self.__library.cef_push_rx(data[sent:], len(data) - sent)
+                sent += numBytes
+                if numBytes == 0:
+                    if not self.__autoStep:
+                        raise BufferError("DebugLibraryPort: the target must be stepped to take more data")
+                    self._step(self.PASSES_PER_STEP)
+            if self.__autoStep:
+                # let the target start on the packet right away
+                self._step(self.PASSES_PER_STEP)
+        return sent
+
+    def receive(self, maxNumBytes=1) -> bytes:
+        """
+        Take what the target has sent (up to maxNumBytes), stepping the target until it has sent something.
+        Blocks until at least one byte has been received.  This will block forever, it is the responsibility
+        of the application to apply threading/timeout logic
+        @param maxNumBytes: maximum number of bytes to return
+        @return readBytes: the bytes read
+        """
+        while True:
+            readBytes = self.poll(maxNumBytes)
+            if readBytes:
+                return readBytes
+            if not self.__autoStep or self.__library is None:
+                # only another thread can make the target send something, let it run
+                time.sleep(0.0001)
+
+    def poll(self, maxNumBytes=1) -> bytes:
+        """
+        Take what the target has sent (up to maxNumBytes), stepping the target once if it has sent nothing
+        (unless autoStep is False).  Doesn't block.
+        @param maxNumBytes: maximum number of bytes to return
+        @return readBytes: the bytes read (empty if the target has sent nothing)
+        """
+        maxNumBytes = min(maxNumBytes, self.PULL_BUFFER_NUM_BYTES)
+        with self.__lock:
+            if self.__library is None:
+                return b''
+            numBytes = self.__library.cef_pull_tx(self.__pullBuffer, maxNumBytes)
+            if numBytes == 0 and self.__autoStep:
+                self._step(self.PASSES_PER_STEP)
+                numBytes = self.__library.cef_pull_tx(self.__pullBuffer, maxNumBytes)
+            readBytes = self.__pullBuffer.raw[:numBytes]
+        self.bytesRx = self.bytesRx + numBytes
+        return readBytes
+
+    def _step(self, numPasses):
+        """
+        Run passes of the target's while loop (the lock must be held)
+        """
+        if self.__timeNsPerPass is None:
+            self.__library.cef_step(numPasses)
+            return
+        for _ in range(numPasses):
+            self.__library.cef_step(1)
+            self.__timeNs += self.__timeNsPerPass
+            self.__library.cef_set_time_ns(self.__timeNs)
@@ -25,6 +25,9 @@ class DebugPortDriver(ABC):
     is left to the child classes to implement.
     """
 
+    # True if the Router is to use the port without threads, reading it with poll() from the caller's thread
+    synchronous = False
+
     def __init__(self):
         pass
 
@@ -50,8 +53,19 @@ class DebugPortDriver(ABC):
         pass
 
     @abstractmethod
-    def receive(self):
+    def receive(self, maxNumBytes=1):
+        """
+        Read data in.  Blocks until at least one byte is available, then returns
+        whatever is available up to maxNumBytes
+        @param maxNumBytes: maximum number of bytes to return
+        @return: the bytes read
+        """
+        pass
+
+    def poll(self, maxNumBytes=1):
         """
-        Read data in
+        Read data in without blocking, for a synchronous port (see synchronous)
+        @param maxNumBytes: maximum number of bytes to return
+        @return: the bytes read (empty if none are available)
         """
-        pass
\ No newline at end of file
+        raise NotImplementedError("{} can only be read from a thread".format(type(self).__name__))
\ No newline at end of file
@@ -83,16 +83,18 @@ class DebugSerialPort(DebugPortDriver):
         bytesWritten = self.__serialPort.write(data)
         return bytesWritten
 
-    def receive(self) -> bytes:
+    def receive(self, maxNumBytes=1) -> bytes:
         """ 
-        Read a single byte from the serial port. This will block forever, it
+        Read from the serial port.  Blocks until at least one byte has been received, then
+        returns everything already waiting in the serial port's input buffer (up to maxNumBytes)
+        so the caller can process data in bulk rather than a byte at a time.  This will block forever, it
         is the responsibility of the application to apply threading/timeout logic
+        @param maxNumBytes: maximum number of bytes to return
+        @return readBytes: the bytes read
         """
-        readByte = self.__serialPort.read()
+        numBytesToRead = min(max(self.__serialPort.in_waiting, 1), maxNumBytes)
+        readBytes = self.__serialPort.read(numBytesToRead)
 
-        #if readByte:
-        self.bytesRx = self.bytesRx + 1
-        tempByte = int.from_bytes(readByte,"big",signed=False)
-        #print("bytes: {}      got byte 0x{:02x}".format(self.bytesRx, tempByte))
+        self.bytesRx = self.bytesRx + len(readBytes)
 
-        return readByte
+        return readBytes
@@ -0,0 +1,194 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+import ctypes
+import mmap
+import os
+import platform
+import struct
+import time
+
+from DebugPortDriver import DebugPortDriver
+
+
+class DebugSharedMemoryPort(DebugPortDriver):
+    """
+    Concrete implementation of the DebugPortDriver for a simulated target serving its debug port on POSIX
+    shared memory (SharedMemoryPortDriverImpl in the embedded sw, built with DEBUG_PORT_DRIVER_SHARED_MEMORY).
+    The region holds two single producer single consumer byte rings, one each way, so packets are exchanged
+    without a system call per send or receive.  When there is nothing to receive, the receive sleeps on the
+    ring's write index (futex) until the target writes to it.
+
+    The ring indices are loaded and stored with plain struct accesses, which are only ordered with the ring data
+    on x86 (loads aren't reordered with loads, nor stores with stores), so open() rejects any other host.
+    """
+
+    # layout of the region, must match sharedMemoryPortHeader_t in SharedMemoryPortDriverImpl.hpp
+    MAGIC = 0x53464543
+    MAGIC_OFFSET = 0
+    RING_NUM_BYTES_OFFSET = 4
+    TO_TARGET_RING_OFFSET = 64
+    TO_HOST_RING_OFFSET = 192
+    WRITE_INDEX_OFFSET = 0
+    READ_INDEX_OFFSET = 64
+    CONSUMER_WAITING_OFFSET = 68
+    HEADER_NUM_BYTES = 320
+
+    # hosts whose memory ordering the ring accesses rely on
+    X86_MACHINES = ('x86_64', 'AMD64', 'i386', 'i686')
+    # futex system call, by machine (None sleeps a little instead)
+    FUTEX_SYSCALL_NUMBERS = {'x86_64': 202, 'i386': 240, 'i686': 240}
+    FUTEX_WAIT = 0
+    # longest a receive sleeps before looking at the ring again
+    WAIT_TIMEOUT_NS = 10000000
+
+    def __init__(self, name='cefDebugPort', openTimeoutInSeconds=5):
+        self.__path = os.path.join('/dev/shm', name.lstrip('/'))
+        self.__openTimeoutInSeconds = openTimeoutInSeconds
+        self.__region = None
+        self.__ringNumBytes = 0
+        self.__futex = None
+
+        self.bytesRx = 0
+
+    def open(self):
+        """
+        Map the shared memory region, waiting (up to the open timeout) for the simulator to create it
+        """
+        if platform.machine() not in self.X86_MACHINES:
+            raise NotImplementedError("DebugSharedMemoryPort needs an x86 host, the ring accesses aren't ordered on {}".format(platform.machine()))
+
+        deadline = time.time() + self.__openTimeoutInSeconds
+        while True:
+            try:
+                with open(self.__path, 'r+b') as f:
+                    region = mmap.mmap(f.fileno(), 0)
+                if self._readWord(region, self.MAGIC_OFFSET) == self.MAGIC:
+                    break
+                region.close()
+            except (OSError, ValueError):
+                pass
+            if time.time() > deadline:
+                print("DebugSharedMemoryPort.open(): error")
+                raise TimeoutError("shared memory region {} was not created".format(self.__path))
+            time.sleep(0.01)
+
+        self.__region = region
+        self.__ringNumBytes = self._readWord(region, self.RING_NUM_BYTES_OFFSET)
+        self.__toTargetData = self.HEADER_NUM_BYTES
+        self.__toHostData = self.HEADER_NUM_BYTES + self.__ringNumBytes
+
+        syscallNumber = self.FUTEX_SYSCALL_NUMBERS.get(platform.machine())
+        if syscallNumber is not None:
+            libc = ctypes.CDLL(None, use_errno=True)
+            writeIndex = ctypes.c_uint32.from_buffer(region, self.TO_HOST_RING_OFFSET + self.WRITE_INDEX_OFFSET)
+            self.__futex = (libc.syscall, syscallNumber, ctypes.addressof(writeIndex))
+
+    def close(self):
+        """
+        Unmap the shared memory region
+        """
+        self.__futex = None
+        self.__region.close()
+
+    def send(self, data: bytes) -> int:
+        """
+        Writes the packet into the ring to the target, waiting for room when the target is behind
+        @param data: bytearray to be written
+        @return bytesWritten: number of bytes successfully written
+        """
+        ring = self.TO_TARGET_RING_OFFSET
+        data = bytes(data)
+        sent = 0
+        while sent < len(data):
+            writeIndex = self._readWord(self.__region, ring + self.WRITE_INDEX_OFFSET)
+            numBytesFree = self.__ringNumBytes - ((writeIndex - self._readWord(self.__region, ring + self.READ_INDEX_OFFSET)) & 0xffffffff)
+            if numBytesFree == 0:
+                time.sleep(0.0001)
+                continue
+
+            numBytes = min(numBytesFree, len(data) - sent)
+            self._copyIntoRing(self.__toTargetData, writeIndex, data[sent:sent + numBytes])
+            sent += numBytes
+            # publish the data once it is all in the ring
+            self._writeWord(ring + self.WRITE_INDEX_OFFSET, (writeIndex + numBytes) & 0xffffffff)
+        return sent
+
+    def receive(self, maxNumBytes=1) -> bytes:
+        """
+        Read from the ring from the target.  Blocks until at least one byte has been received, then
+        returns what has been received (up to maxNumBytes).  This will block forever, it is the responsibility
+        of the application to apply threading/timeout logic
+        @param maxNumBytes: maximum number of bytes to return
+        @return readBytes: the bytes read
+        """
+        ring = self.TO_HOST_RING_OFFSET
+        readIndex = self._readWord(self.__region, ring + self.READ_INDEX_OFFSET)
+        writeIndex = self._waitForData(readIndex)
+
+        numBytes = min((writeIndex - readIndex) & 0xffffffff, maxNumBytes)
+        offset = readIndex & (self.__ringNumBytes - 1)
+        numBytesToEnd = min(numBytes, self.__ringNumBytes - offset)
+        start = self.__toHostData
+        readBytes = self.__region[start + offset:start + offset + numBytesToEnd] + self.__region[start:start + numBytes - numBytesToEnd]
+        self._writeWord(ring + self.READ_INDEX_OFFSET, (readIndex + numBytes) & 0xffffffff)
+
+        self.bytesRx = self.bytesRx + len(readBytes)
+
+        return readBytes
+
+    def _waitForData(self, readIndex):
+        """
+        Wait for the target to write to the ring to the host
+        @param readIndex: read index of the ring to the host
+        @return: write index of the ring to the host, once it differs from readIndex
+        """
+        ring = self.TO_HOST_RING_OFFSET
+        while True:
+            writeIndex = self._readWord(self.__region, ring + self.WRITE_INDEX_OFFSET)
+            if writeIndex != readIndex:
+                return writeIndex
+
+            # say the receive is going to sleep, then look again so a write in between is not slept through
+            self._writeWord(ring + self.CONSUMER_WAITING_OFFSET, 1)
+            writeIndex = self._readWord(self.__region, ring + self.WRITE_INDEX_OFFSET)
+            if writeIndex == readIndex:
+                if self.__futex is None:
+                    time.sleep(0.0001)
+                else:
+                    # the timeout bounds the wait should a wake up still be missed
+                    syscall, syscallNumber, address = self.__futex
+                    timeout = (ctypes.c_long * 2)(0, self.WAIT_TIMEOUT_NS)
+                    syscall(ctypes.c_long(syscallNumber), ctypes.c_void_p(address), ctypes.c_int(self.FUTEX_WAIT),
+                            ctypes.c_uint32(writeIndex), timeout, None, ctypes.c_int(0))
+            self._writeWord(ring + self.CONSUMER_WAITING_OFFSET, 0)
+
+    def _copyIntoRing(self, dataOffset, writeIndex, data):
+        """
+        Copy data into a ring at its write index (up to the end of the ring, then the rest from the start)
+        """
+        offset = writeIndex & (self.__ringNumBytes - 1)
+        numBytesToEnd = min(len(data), self.__ringNumBytes - offset)
+        self.__region[dataOffset + offset:dataOffset + offset + numBytesToEnd] = data[:numBytesToEnd]
+        self.__region[dataOffset:dataOffset + len(data) - numBytesToEnd] = data[numBytesToEnd:]
+
+    @staticmethod
+    def _readWord(region, offset):
+        return struct.unpack_from('=I', region, offset)[0]
+
+    def _writeWord(self, offset, value):
+        struct.pack_into('=I', self.__region, offset, value)
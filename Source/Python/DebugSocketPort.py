@@ -0,0 +1,110 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+import socket
+
+from DebugPortDriver import DebugPortDriver
+
+
+class DebugSocketPort(DebugPortDriver):
+    """
+    Concrete implementation of the DebugPortDriver for a simulated target serving its debug port on a
+    localhost TCP or UDP socket (SocketPortDriverImpl in the embedded sw, built with DEBUG_PORT_DRIVER).
+    Packets are framed exactly as on a serial port, so UDP datagram boundaries are not packet boundaries.
+    """
+
+    # must match DEBUG_PORT_SOCKET_PORT in SocketPortDriverImpl.hpp
+    DEFAULT_PORT = 50000
+    # largest datagram the target sends (a COBS frame, or a packet header and payload)
+    MAX_DATAGRAM_SIZE = 65535
+
+    def __init__(self, socketType='tcp', port=DEFAULT_PORT, host='127.0.0.1'):
+        if socketType not in ('tcp', 'udp'):
+            raise ValueError("socketType must be 'tcp' or 'udp'")
+        self.__socketType = socketType
+        self.__port = port
+        self.__host = host
+        self.__socket = None
+        # the rest of a datagram bigger than a receive asked for
+        self.__pending = b''
+
+        self.bytesRx = 0
+
+    @property
+    def socketType(self):
+        return self.__socketType
+
+    @property
+    def port(self):
+        return self.__port
+
+    def open(self):
+        """
+        Connect to the simulated target.  With UDP, an empty datagram is sent so the target knows where
+        to send to (it sends nothing before it has heard from the host).
+        """
+        try:
+            if self.__socketType == 'tcp':
+                self.__socket = socket.create_connection((self.__host, self.__port))
+                self.__socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            else:
+                self.__socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+                self.__socket.connect((self.__host, self.__port))
+                self.__socket.send(b'')
+        except OSError:
+            print("DebugSocketPort.open(): error")
+            raise
+
+    def close(self):
+        """
+        Close the socket immediately
+        """
+        self.__socket.close()
+
+    def send(self, data: bytes) -> int:
+        """
+        Writes the packet to the socket
+        @param data: bytearray to be written
+        @return bytesWritten: number of bytes successfully written
+        """
+        self.__socket.sendall(data)
+        return len(data)
+
+    def receive(self, maxNumBytes=1) -> bytes:
+        """
+        Read from the socket.  Blocks until at least one byte has been received, then returns what has
+        been received (up to maxNumBytes).  This will block forever, it is the responsibility of the
+        application to apply threading/timeout logic
+        @param maxNumBytes: maximum number of bytes to return
+        @return readBytes: the bytes read
+        """
+        if not self.__pending:
+            if self.__socketType == 'tcp':
+                self.__pending = self.__socket.recv(max(maxNumBytes, 1))
+                if not self.__pending:
+                    raise ConnectionError("DebugSocketPort: the target closed the connection")
+            else:
+                # a datagram must be read whole, the part not returned now is returned by the next receive
+                while not self.__pending:
+                    self.__pending = self.__socket.recv(self.MAX_DATAGRAM_SIZE)
+
+        readBytes = self.__pending[:maxNumBytes]
+        self.__pending = self.__pending[maxNumBytes:]
+
+        self.bytesRx = self.bytesRx + len(readBytes)
+
+        return readBytes
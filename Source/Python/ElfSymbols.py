@@ -0,0 +1,657 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+"""
+Addresses and types of the global variables of the embedded sw, read from its ELF file, for the software scope (see
+"Software Scope" in cefContract).  The symbol table gives the address and size of every variable; the DWARF debug
+info (DWARF 2 to 5, when the embedded sw is built with -g) gives its type, so the telemetry frames are decoded with
+the variable's type, and structure members and array elements can be picked (e.g. "appStats.loopTimeUs[2]").
+No other packages are needed.  The simulator's ELF works the same way; for the simulator library (libcefsim.so) give
+the address it was loaded at (see DebugLibraryPort.loadAddress()).
+
+Usage:
+    python ElfSymbols.py <ELF file> [variable ...]
+"""
+
+import sys
+import struct
+import re
+from os.path import dirname, abspath
+
+sys.path.append(dirname(dirname(abspath(__file__))))
+from Shared import cefContract
+
+
+# ELF constants
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+STT_FUNC = 2
+
+# DWARF tags
+DW_TAG_array_type = 0x01
+DW_TAG_class_type = 0x02
+DW_TAG_enumeration_type = 0x04
+DW_TAG_member = 0x0d
+DW_TAG_pointer_type = 0x0f
+DW_TAG_reference_type = 0x10
+DW_TAG_structure_type = 0x13
+DW_TAG_typedef = 0x16
+DW_TAG_union_type = 0x17
+DW_TAG_subrange_type = 0x21
+DW_TAG_base_type = 0x24
+DW_TAG_const_type = 0x26
+DW_TAG_subprogram = 0x2e
+DW_TAG_variable = 0x34
+DW_TAG_volatile_type = 0x35
+DW_TAG_restrict_type = 0x37
+DW_TAG_namespace = 0x39
+DW_TAG_atomic_type = 0x47
+
+# DWARF attributes
+DW_AT_location = 0x02
+DW_AT_name = 0x03
+DW_AT_byte_size = 0x0b
+DW_AT_upper_bound = 0x2f
+DW_AT_count = 0x37
+DW_AT_data_member_location = 0x38
+DW_AT_bit_size = 0x0d
+DW_AT_declaration = 0x3c
+DW_AT_encoding = 0x3e
+DW_AT_specification = 0x47
+DW_AT_type = 0x49
+DW_AT_data_bit_offset = 0x6b
+DW_AT_str_offsets_base = 0x72
+DW_AT_addr_base = 0x73
+
+# DWARF base type encodings
+DW_ATE_boolean = 0x02
+DW_ATE_float = 0x04
+DW_ATE_signed = 0x05
+DW_ATE_signed_char = 0x06
+DW_ATE_unsigned = 0x07
+DW_ATE_unsigned_char = 0x08
+DW_ATE_UTF = 0x10
+
+# DWARF expression operations
+DW_OP_addr = 0x03
+DW_OP_plus_uconst = 0x23
+DW_OP_addrx = 0xa1
+DW_OP_GNU_addr_index = 0xfb
+
+# Tags that qualify the names of the variables inside them
+QUALIFYING_TAGS = (DW_TAG_namespace, DW_TAG_structure_type, DW_TAG_class_type, DW_TAG_union_type)
+# Tags that only qualify a type
+MODIFIER_TAGS = (DW_TAG_typedef, DW_TAG_const_type, DW_TAG_volatile_type, DW_TAG_restrict_type, DW_TAG_atomic_type)
+
+# telemetry type of each (signed, size) integer, and each float size
+INTEGER_TYPES = {
+    (False, 1): cefContract.telemetryType.telemetryType_uint8,
+    (True, 1): cefContract.telemetryType.telemetryType_int8,
+    (False, 2): cefContract.telemetryType.telemetryType_uint16,
+    (True, 2): cefContract.telemetryType.telemetryType_int16,
+    (False, 4): cefContract.telemetryType.telemetryType_uint32,
+    (True, 4): cefContract.telemetryType.telemetryType_int32,
+    (False, 8): cefContract.telemetryType.telemetryType_uint64,
+    (True, 8): cefContract.telemetryType.telemetryType_int64
+}
+FLOAT_TYPES = {
+    4: cefContract.telemetryType.telemetryType_float32,
+    8: cefContract.telemetryType.telemetryType_float64
+}
+
+
+class ElfVariable:
+    """
+    A variable (or a member or element of one) that can be sampled
+    """
+    def __init__(self, name, address, size, telemetryType):
+        self.name = name
+        self.address = address
+        self.size = size
+        self.type = telemetryType    # cefContract.telemetryType, None if the variable is not a number
+
+    def __repr__(self):
+        return "ElfVariable('{}', 0x{:X}, {} bytes, {})".format(self.name, self.address, self.size,
+                None if self.type is None else self.type.name)
+
+
+class _Die:
+    """
+    A DWARF debug information entry
+    """
+    __slots__ = ('offset', 'tag', 'attributes', 'children', 'parent', 'unit')
+
+    def __init__(self, offset, tag, parent, unit):
+        self.offset = offset
+        self.tag = tag
+        self.attributes = {}
+        self.children = []
+        self.parent = parent
+        self.unit = unit
+
+
+class _Unit:
+    """
+    A DWARF compilation unit
+    """
+    __slots__ = ('offset', 'version', 'addressSize', 'offsetSize', 'strOffsetsBase', 'addrBase')
+
+
+class _Reader:
+    """
+    Reads the numbers of an ELF or DWARF section
+    """
+    def __init__(self, data, offset, littleEndian):
+        self.data = data
+        self.offset = offset
+        self.prefix = '<' if littleEndian else '>'
+
+    def unsigned(self, numBytes):
+        value = int.from_bytes(self.data[self.offset:self.offset + numBytes], 'little' if self.prefix == '<' else 'big')
+        self.offset += numBytes
+        return value
+
+    def uleb(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.data[self.offset]
+            self.offset += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+
+    def sleb(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.data[self.offset]
+            self.offset += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                if byte & 0x40:
+                    value -= 1 << shift
+                return value
+
+    def string(self):
+        end = self.data.index(b'\0', self.offset)
+        value = self.data[self.offset:end].decode(errors='replace')
+        self.offset = end + 1
+        return value
+
+    def bytes(self, numBytes):
+        value = self.data[self.offset:self.offset + numBytes]
+        self.offset += numBytes
+        return value
+
+
+class ElfSymbols:
+    """
+    The global variables of an ELF file, by name (namespaces and classes are separated by '::')
+    """
+    def __init__(self, fileName, loadAddress=0):
+        """
+        @param fileName: ELF file of the embedded sw (or of the simulator)
+        @param loadAddress: address the file was loaded at, for a shared library (0 for the embedded sw)
+        """
+        with open(fileName, 'rb') as f:
+            self.__data = f.read()
+        self.loadAddress = loadAddress
+        # name: (address, size) of the variables and functions in the symbol table
+        self.__objectSymbols = {}
+        self.__functionSymbols = {}
+        # name: DIE of the global variables in the DWARF debug info
+        self.__variables = {}
+        self.__dies = {}
+        self.__sections = {}
+
+        self._readElf()
+        if '.debug_info' in self.__sections and '.debug_abbrev' in self.__sections:
+            self._readDwarf()
+
+    def names(self):
+        """
+        @return: sorted names of the global variables
+        """
+        return sorted(set(self.__variables) | set(self.__objectSymbols))
+
+    def symbolAddress(self, name):
+        """
+        @return: address of a variable or function in the symbol table (without the load address)
+        """
+        if name in self.__objectSymbols:
+            return self.__objectSymbols[name][0]
+        return self.__functionSymbols[name][0]
+
+    def lookup(self, path):
+        """
+        Find a variable, or a member or element of one
+        @param path: variable name, followed by any '.member' and '[index]', e.g. "appStats.loopTimeUs[2]"
+        @return: ElfVariable (its type is None if it is not a number)
+        @raise KeyError: if there is no such variable or member, or the index is out of range
+        """
+        match = re.match(r'([^.\[\]]+)', path)
+        if match is None:
+            raise KeyError(path)
+        name = match.group(1)
+        selectors = path[match.end():]
+
+        die = self.__variables.get(name)
+        if die is None:
+            if name not in self.__objectSymbols:
+                raise KeyError(path)
+            # no debug info, only the size is known, so the variable is read as an unsigned number
+            address, size = self.__objectSymbols[name]
+            if selectors:
+                raise KeyError("{}: {} has no debug info for members".format(path, name))
+            return ElfVariable(path, self.loadAddress + address, size, INTEGER_TYPES.get((False, size)))
+
+        if re.sub(r'\.([^.\[\]]+)|\[(\d+)\]', '', selectors):
+            raise KeyError("{}: can't read the members".format(path))
+        address = self.loadAddress + self._variableAddress(die)
+        typeDie = self._variableType(die)
+        for member, index in re.findall(r'\.([^.\[\]]+)|\[(\d+)\]', selectors):
+            typeDie = self._stripModifiers(typeDie)
+            if member:
+                offset, typeDie = self._member(typeDie, member, path)
+            else:
+                offset, typeDie = self._element(typeDie, int(index), path)
+            address += offset
+
+        return ElfVariable(path, address, self._typeSize(typeDie), self._telemetryType(typeDie))
+
+    # ------------------------------------------------------------------------------------------------- ELF
+
+    def _readElf(self):
+        data = self.__data
+        if data[:4] != b'\x7fELF':
+            raise ValueError("not an ELF file")
+        self.__is64Bit = data[4] == 2
+        self.__littleEndian = data[5] == 1
+        reader = _Reader(data, 0x28 if self.__is64Bit else 0x20, self.__littleEndian)
+        addressSize = 8 if self.__is64Bit else 4
+        sectionHeaderOffset = reader.unsigned(addressSize)
+        reader.offset += 4 + 2 + 2 + 2  # flags, header size, program header entry size and count
+        sectionHeaderSize = reader.unsigned(2)
+        numSections = reader.unsigned(2)
+        sectionNamesIndex = reader.unsigned(2)
+
+        sections = []
+        for index in range(numSections):
+            reader.offset = sectionHeaderOffset + index * sectionHeaderSize
+            nameOffset = reader.unsigned(4)
+            sectionType = reader.unsigned(4)
+            reader.offset += addressSize * 2  # flags, address
+            offset = reader.unsigned(addressSize)
+            size = reader.unsigned(addressSize)
+            link = reader.unsigned(4)
+            sections.append((nameOffset, sectionType, offset, size, link))
+
+        namesOffset = sections[sectionNamesIndex][2]
+        for nameOffset, sectionType, offset, size, link in sections:
+            name = _Reader(data, namesOffset + nameOffset, self.__littleEndian).string()
+            self.__sections[name] = data[offset:offset + size]
+            if sectionType == SHT_SYMTAB:
+                self._readSymbols(data[offset:offset + size], sections[link][2])
+
+    def _readSymbols(self, symbols, stringsOffset):
+        reader = _Reader(symbols, 0, self.__littleEndian)
+        entrySize = 24 if self.__is64Bit else 16
+        while reader.offset + entrySize <= len(symbols):
+            nameOffset = reader.unsigned(4)
+            if self.__is64Bit:
+                info = reader.unsigned(1)
+                reader.offset += 1 + 2
+                value = reader.unsigned(8)
+                size = reader.unsigned(8)
+            else:
+                value = reader.unsigned(4)
+                size = reader.unsigned(4)
+                info = reader.unsigned(1)
+                reader.offset += 1 + 2
+            if nameOffset == 0:
+                continue
+            name = _Reader(self.__data, stringsOffset + nameOffset, self.__littleEndian).string()
+            if info & 0xf == STT_OBJECT:
+                self.__objectSymbols[name] = (value, size)
+            elif info & 0xf == STT_FUNC:
+                self.__functionSymbols[name] = (value, size)
+
+    # ----------------------------------------------------------------------------------------------- DWARF
+
+    def _readDwarf(self):
+        info = self.__sections['.debug_info']
+        reader = _Reader(info, 0, self.__littleEndian)
+        abbreviationTables = {}
+        while reader.offset < len(info):
+            unit = _Unit()
+            unit.offset = reader.offset
+            length = reader.unsigned(4)
+            unit.offsetSize = 4
+            if length == 0xffffffff:
+                length = reader.unsigned(8)
+                unit.offsetSize = 8
+            end = reader.offset + length
+            unit.version = reader.unsigned(2)
+            if unit.version >= 5:
+                unitType = reader.unsigned(1)
+                unit.addressSize = reader.unsigned(1)
+                abbreviationOffset = reader.unsigned(unit.offsetSize)
+                if unitType in (2, 6):      # type units: type signature and offset
+                    reader.offset += 8 + unit.offsetSize
+                elif unitType in (4, 5):    # skeleton and split units: dwo id
+                    reader.offset += 8
+            else:
+                abbreviationOffset = reader.unsigned(unit.offsetSize)
+                unit.addressSize = reader.unsigned(1)
+            unit.strOffsetsBase = 8 if unit.offsetSize == 4 else 16
+            unit.addrBase = 8
+
+            if abbreviationOffset not in abbreviationTables:
+                abbreviationTables[abbreviationOffset] = self._readAbbreviations(abbreviationOffset)
+            self._readDies(reader, end, unit, abbreviationTables[abbreviationOffset])
+            reader.offset = end
+
+        for die in self.__dies.values():
+            if die.tag == DW_TAG_variable and DW_AT_location in die.attributes and self._isGlobal(die):
+                try:
+                    self._variableAddress(die)
+                except ValueError:
+                    continue
+                self.__variables.setdefault(self._qualifiedName(die), die)
+
+    def _readAbbreviations(self, offset):
+        reader = _Reader(self.__sections['.debug_abbrev'], offset, self.__littleEndian)
+        abbreviations = {}
+        while True:
+            code = reader.uleb()
+            if code == 0:
+                return abbreviations
+            tag = reader.uleb()
+            hasChildren = reader.unsigned(1) != 0
+            attributes = []
+            while True:
+                attribute = reader.uleb()
+                form = reader.uleb()
+                if attribute == 0 and form == 0:
+                    break
+                implicitConst = reader.sleb() if form == 0x21 else None
+                attributes.append((attribute, form, implicitConst))
+            abbreviations[code] = (tag, hasChildren, attributes)
+
+    def _readDies(self, reader, end, unit, abbreviations):
+        parents = [None]
+        while reader.offset < end:
+            offset = reader.offset
+            code = reader.uleb()
+            if code == 0:
+                # end of the children of the last DIE with children
+                if len(parents) > 1:
+                    parents.pop()
+                continue
+            tag, hasChildren, attributes = abbreviations[code]
+            die = _Die(offset, tag, parents[-1], unit)
+            for attribute, form, implicitConst in attributes:
+                die.attributes[attribute] = self._readForm(reader, form, unit, implicitConst)
+            self.__dies[offset] = die
+            if parents[-1] is not None:
+                parents[-1].children.append(die)
+            if die.tag == 0x11:     # DW_TAG_compile_unit, whose bases apply to the whole unit
+                if DW_AT_str_offsets_base in die.attributes:
+                    unit.strOffsetsBase = die.attributes[DW_AT_str_offsets_base]
+                if DW_AT_addr_base in die.attributes:
+                    unit.addrBase = die.attributes[DW_AT_addr_base]
+            if hasChildren:
+                parents.append(die)
+
+    def _readForm(self, reader, form, unit, implicitConst):
+        """
+        @return: the attribute value; strings as ('str', ...) tuples, references as ('ref', offset), and indexes
+                 as ('strx' / 'addrx', index), resolved when used (the unit's bases may follow the attribute)
+        """
+        if form == 0x01:                                    # addr
+            return reader.unsigned(unit.addressSize)
+        if form in (0x0b, 0x05, 0x06, 0x07):                # data1, data2, data4, data8
+            return reader.unsigned({0x0b: 1, 0x05: 2, 0x06: 4, 0x07: 8}[form])
+        if form == 0x1e:                                    # data16
+            return reader.bytes(16)
+        if form == 0x0d:                                    # sdata
+            return reader.sleb()
+        if form == 0x0f:                                    # udata
+            return reader.uleb()
+        if form == 0x08:                                    # string
+            return reader.string()
+        if form in (0x0e, 0x1f, 0x1d):                      # strp, line_strp, strp_sup
+            section = '.debug_line_str' if form == 0x1f else '.debug_str'
+            return ('str', section, reader.unsigned(unit.offsetSize))
+        if form == 0x1a:                                    # strx
+            return ('strx', reader.uleb())
+        if form in (0x25, 0x26, 0x27, 0x28):                # strx1 - strx4
+            return ('strx', reader.unsigned(form - 0x24))
+        if form == 0x0c:                                    # flag
+            return reader.unsigned(1) != 0
+        if form == 0x19:                                    # flag_present
+            return True
+        if form in (0x11, 0x12, 0x13, 0x14):                # ref1 - ref8
+            return ('ref', unit.offset + reader.unsigned({0x11: 1, 0x12: 2, 0x13: 4, 0x14: 8}[form]))
+        if form == 0x15:                                    # ref_udata
+            return ('ref', unit.offset + reader.uleb())
+        if form == 0x10:                                    # ref_addr
+            return ('ref', reader.unsigned(unit.addressSize if unit.version == 2 else unit.offsetSize))
+        if form == 0x20:                                    # ref_sig8 (type units are not followed)
+            return ('sig', reader.unsigned(8))
+        if form in (0x1c, 0x24):                            # ref_sup4, ref_sup8
+            return ('sup', reader.unsigned(4 if form == 0x1c else 8))
+        if form == 0x17:                                    # sec_offset
+            return reader.unsigned(unit.offsetSize)
+        if form in (0x18, 0x09):                            # exprloc, block
+            return reader.bytes(reader.uleb())
+        if form in (0x0a, 0x03, 0x04):                      # block1, block2, block4
+            return reader.bytes(reader.unsigned({0x0a: 1, 0x03: 2, 0x04: 4}[form]))
+        if form == 0x1b:                                    # addrx
+            return ('addrx', reader.uleb())
+        if form in (0x29, 0x2a, 0x2b, 0x2c):                # addrx1 - addrx4
+            return ('addrx', reader.unsigned(form - 0x28))
+        if form in (0x22, 0x23):                            # loclistx, rnglistx
+            return reader.uleb()
+        if form == 0x21:                                    # implicit_const
+            return implicitConst
+        if form == 0x16:                                    # indirect
+            return self._readForm(reader, reader.uleb(), unit, implicitConst)
+        raise ValueError("unknown DWARF form 0x{:X}".format(form))
+
+    def _string(self, die, attribute):
+        value = die.attributes.get(attribute)
+        if isinstance(value, tuple):
+            if value[0] == 'strx':
+                unit = die.unit
+                offsets = _Reader(self.__sections['.debug_str_offsets'], unit.strOffsetsBase + value[1] * unit.offsetSize,
+                                  self.__littleEndian)
+                value = ('str', '.debug_str', offsets.unsigned(unit.offsetSize))
+            return _Reader(self.__sections[value[1]], value[2], self.__littleEndian).string()
+        return value
+
+    def _reference(self, die, attribute):
+        value = die.attributes.get(attribute)
+        if isinstance(value, tuple) and value[0] == 'ref':
+            return self.__dies.get(value[1])
+        return None
+
+    def _constant(self, die, attribute, default=None):
+        value = die.attributes.get(attribute, default)
+        return value if isinstance(value, int) else default
+
+    def _declaration(self, die):
+        """
+        @return: the declaration of a variable definition (the one with its name and type), or the variable
+        """
+        specification = self._reference(die, DW_AT_specification)
+        return die if specification is None else specification
+
+    def _isGlobal(self, die):
+        parent = self._declaration(die).parent
+        while parent is not None:
+            if parent.tag == DW_TAG_subprogram:
+                return False
+            parent = parent.parent
+        return True
+
+    def _qualifiedName(self, die):
+        declaration = self._declaration(die)
+        names = [self._string(declaration, DW_AT_name) or '?']
+        parent = declaration.parent
+        while parent is not None:
+            if parent.tag in QUALIFYING_TAGS:
+                names.insert(0, self._string(parent, DW_AT_name) or '(anonymous)')
+            parent = parent.parent
+        return '::'.join(names)
+
+    def _variableAddress(self, die):
+        location = die.attributes.get(DW_AT_location)
+        if not isinstance(location, bytes) or len(location) == 0:
+            raise ValueError("variable has no static address")
+        unit = die.unit
+        reader = _Reader(location, 1, self.__littleEndian)
+        if location[0] == DW_OP_addr:
+            return reader.unsigned(unit.addressSize)
+        if location[0] in (DW_OP_addrx, DW_OP_GNU_addr_index):
+            addresses = _Reader(self.__sections['.debug_addr'], unit.addrBase + reader.uleb() * unit.addressSize,
+                                self.__littleEndian)
+            return addresses.unsigned(unit.addressSize)
+        raise ValueError("variable has no static address")
+
+    def _variableType(self, die):
+        typeDie = self._reference(die, DW_AT_type)
+        if typeDie is None:
+            typeDie = self._reference(self._declaration(die), DW_AT_type)
+        return typeDie
+
+    def _stripModifiers(self, typeDie):
+        while typeDie is not None and typeDie.tag in MODIFIER_TAGS:
+            typeDie = self._reference(typeDie, DW_AT_type)
+        return typeDie
+
+    def _member(self, typeDie, name, path):
+        if typeDie is None or typeDie.tag not in (DW_TAG_structure_type, DW_TAG_class_type, DW_TAG_union_type):
+            raise KeyError("{}: .{} of a variable that is not a structure".format(path, name))
+        for child in typeDie.children:
+            if child.tag == DW_TAG_member and self._string(child, DW_AT_name) == name:
+                if DW_AT_bit_size in child.attributes or DW_AT_data_bit_offset in child.attributes:
+                    raise KeyError("{}: bit fields can't be sampled".format(path))
+                location = child.attributes.get(DW_AT_data_member_location, 0)
+                if isinstance(location, bytes):
+                    # DWARF 2 style: DW_OP_plus_uconst <offset>
+                    if len(location) == 0 or location[0] != DW_OP_plus_uconst:
+                        raise KeyError("{}: can't work out where .{} is".format(path, name))
+                    location = _Reader(location, 1, self.__littleEndian).uleb()
+                return location, self._reference(child, DW_AT_type)
+        raise KeyError("{}: no member {}".format(path, name))
+
+    def _element(self, typeDie, index, path):
+        if typeDie is None or typeDie.tag != DW_TAG_array_type:
+            raise KeyError("{}: [{}] of a variable that is not an array".format(path, index))
+        dimensions = self._dimensions(typeDie)
+        elementType = self._elementType(typeDie)
+        if dimensions and dimensions[0] is not None and index >= dimensions[0]:
+            raise KeyError("{}: index {} out of range".format(path, index))
+        # a multi dimensional array is indexed one dimension at a time
+        stride = self._typeSize(elementType)
+        for dimension in dimensions[1:]:
+            stride *= dimension or 0
+        if len(dimensions) > 1:
+            return index * stride, _SubArray(dimensions[1:], elementType)
+        return index * stride, elementType
+
+    def _elementType(self, typeDie):
+        if isinstance(typeDie, _SubArray):
+            return typeDie.elementType
+        return self._reference(typeDie, DW_AT_type)
+
+    def _dimensions(self, typeDie):
+        if isinstance(typeDie, _SubArray):
+            return typeDie.dimensions
+        dimensions = []
+        for child in typeDie.children:
+            if child.tag == DW_TAG_subrange_type:
+                count = self._constant(child, DW_AT_count)
+                upperBound = self._constant(child, DW_AT_upper_bound)
+                dimensions.append(count if count is not None else (None if upperBound is None else upperBound + 1))
+        return dimensions
+
+    def _typeSize(self, typeDie):
+        typeDie = self._stripModifiers(typeDie)
+        if typeDie is None:
+            return 0
+        if typeDie.tag == DW_TAG_array_type:
+            size = self._typeSize(self._elementType(typeDie))
+            for dimension in self._dimensions(typeDie):
+                size *= dimension or 0
+            return size
+        if typeDie.tag in (DW_TAG_pointer_type, DW_TAG_reference_type) and DW_AT_byte_size not in typeDie.attributes:
+            return typeDie.unit.addressSize
+        size = self._constant(typeDie, DW_AT_byte_size)
+        if size is None and typeDie.tag == DW_TAG_enumeration_type:
+            return self._typeSize(self._reference(typeDie, DW_AT_type))
+        return size or 0
+
+    def _telemetryType(self, typeDie):
+        """
+        @return: cefContract.telemetryType to sample a variable of the type with, None if it is not a number
+        """
+        typeDie = self._stripModifiers(typeDie)
+        if typeDie is None or typeDie.tag == DW_TAG_array_type:
+            return None
+        size = self._typeSize(typeDie)
+        if typeDie.tag == DW_TAG_base_type:
+            encoding = self._constant(typeDie, DW_AT_encoding)
+            if encoding == DW_ATE_float:
+                return FLOAT_TYPES.get(size)
+            if encoding in (DW_ATE_signed, DW_ATE_signed_char):
+                return INTEGER_TYPES.get((True, size))
+            if encoding in (DW_ATE_unsigned, DW_ATE_unsigned_char, DW_ATE_boolean, DW_ATE_UTF):
+                return INTEGER_TYPES.get((False, size))
+            return None
+        if typeDie.tag == DW_TAG_enumeration_type:
+            underlying = self._reference(typeDie, DW_AT_type)
+            if underlying is not None:
+                return self._telemetryType(underlying)
+            return INTEGER_TYPES.get((False, size))
+        if typeDie.tag == DW_TAG_pointer_type:
+            return INTEGER_TYPES.get((False, size))
+        return None
+
+
+class _SubArray:
+    """
+    The rows of a multi dimensional array, after its first index
+    """
+    def __init__(self, dimensions, elementType):
+        self.tag = DW_TAG_array_type
+        self.dimensions = dimensions
+        self.elementType = elementType
+
+
+if __name__ == '__main__':
+    elf = ElfSymbols(sys.argv[1])
+    for name in (sys.argv[2:] or elf.names()):
+        try:
+            print(elf.lookup(name))
+        except KeyError as e:
+            print("{}: {}".format(name, e))
@@ -0,0 +1,75 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+"""
+Reception of events (see "Events" in cefContract).  The target sends an event as soon as something happens on it (a
+memory read finished, a threshold was crossed, a buffer was freed), so tests don't have to poll for it with commands.
+A debugPacketType_event packet holds one or more events, each a cefEventHeader followed by its data, padded to a
+multiple of 8 bytes.  The Router decodes each event and calls the callbacks added for its event id.
+"""
+
+import sys
+from os.path import dirname, abspath
+import ctypes
+
+sys.path.append(dirname(dirname(abspath(__file__))))
+from Shared import cefContract
+
+
+class CefEvent:
+    """
+    An event received from the target
+    """
+    def __init__(self, eventId, sequenceNumber, timeStamp, data):
+        self.eventId = eventId
+        self.sequenceNumber = sequenceNumber
+        self.timeStamp = timeStamp      # target time the event was raised (ns)
+        self.data = data                # bytes
+
+    def decodeData(self, structureType):
+        """
+        @param structureType: cefContract structure of the event's data (e.g. cefContract.cefEventMemoryReadDone)
+        @return: the data decoded as structureType
+        """
+        return structureType.from_buffer_copy(self.data[:ctypes.sizeof(structureType)])
+
+    def __repr__(self):
+        return "CefEvent(id=0x{:X}, seq={}, time={}, data={})".format(self.eventId, self.sequenceNumber, self.timeStamp, self.data.hex())
+
+
+def decodeEvents(payload):
+    """
+    @param payload: payload of a debugPacketType_event packet
+    @return: list of CefEvent
+    """
+    events = []
+    headerSize = ctypes.sizeof(cefContract.cefEventHeader)
+    offset = 0
+    while offset < len(payload):
+        if offset + headerSize > len(payload):
+            raise ValueError("event header truncated")
+        header = cefContract.cefEventHeader.from_buffer_copy(payload[offset:offset + headerSize])
+        offset += headerSize
+        numDataBytes = header.m_numDataBytes
+        if numDataBytes > cefContract.CEF_EVENT_MAX_DATA_BYTES or offset + numDataBytes > len(payload):
+            raise ValueError("event data truncated")
+        data = bytes(payload[offset:offset + numDataBytes])
+        # the data of each event is padded to a multiple of 8 bytes
+        offset += (numDataBytes + 7) & ~7
+        events.append(CefEvent(header.m_eventId, header.m_eventSequenceNumber, header.m_timeStamp, data))
+    return events
@@ -24,6 +24,86 @@ sys.path.append(dirname(dirname(abspath(__file__))))
 from Shared import cefContract
 
 
+def _readVarint(data, offset):
+    """
+    Decode an unsigned varint (7 bits per byte, least significant bits first)
+    @param data: bytes-like object
+    @param offset: offset of the varint in data
+    @return: (value, offset of the byte after the varint)
+    """
+    value = 0
+    shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7f) << shift
+        if byte < 0x80:
+            return value, offset
+        shift += 7
+
+
+def _unZigZag(value):
+    """
+    @return: the signed value of a zig-zag encoded value
+    """
+    return (value >> 1) ^ -(value & 1)
+
+
+def unpackLogs(payload):
+    """
+    Decode a packed logging packet payload (see "Packed Logging Format" in cefContract.hpp) into cefLog
+    structures, so packed logs are processed exactly like unpacked ones
+    @param payload: bytes-like object holding one or more packed log records
+    @return: list of cefContract.cefLog
+    """
+    logs = []
+    offset = 0
+    timeStamp = 0
+    payloadSize = len(payload)
+    mask64 = (1 << 64) - 1
+
+    while offset < payloadSize:
+        log = cefContract.cefLog()
+        flags = payload[offset]
+        log.m_logType = payload[offset + 1]
+        log.m_moduleId = payload[offset + 2]
+        offset += 3
+        log.m_logSequenceNumber, offset = _readVarint(payload, offset)
+
+        value, offset = _readVarint(payload, offset)
+        if flags & cefContract.LOG_PACKED_FLAG_ABSOLUTE_TIMESTAMP:
+            timeStamp = value
+        else:
+            timeStamp = (timeStamp + _unZigZag(value)) & mask64
+        log.m_timeStamp = timeStamp
+
+        logVariables = [0, 0, 0]
+        for i in range(flags & cefContract.LOG_PACKED_FLAGS_NUM_VARIABLES_MASK):
+            value, offset = _readVarint(payload, offset)
+            logVariables[i] = _unZigZag(value) & mask64
+        log.m_logVariable1, log.m_logVariable2, log.m_logVariable3 = logVariables
+
+        log.m_fileLineNumber, offset = _readVarint(payload, offset)
+        if flags & cefContract.LOG_PACKED_FLAG_SUPPRESSED_LOGS:
+            log.m_numSuppressedLogs, offset = _readVarint(payload, offset)
+
+        length, offset = _readVarint(payload, offset)
+        log.m_logString = bytes(payload[offset:offset + length])
+        offset += length
+        length, offset = _readVarint(payload, offset)
+        log.m_fileName = bytes(payload[offset:offset + length])
+        offset += length
+        if offset > payloadSize:
+            raise ValueError("packed log record truncated")
+
+        # packed logs carry no command header, fill it in as the target does for an unpacked log
+        log.m_header.m_commandNumBytes = ctypes.sizeof(cefContract.cefLog)
+        log.m_header.m_commandErrorCode = cefContract.errorCode.errorCode_OK.value
+        logs.append(log)
+
+    return logs
+
+
 class Logger:
     """
     Object for handling extracted log messages. Logs have a header and body, the
@@ -39,12 +119,15 @@ class Logger:
     def __init__(self):
         # default append to file, log all levels
         self._firstTimeFileWrite()
-        logging.basicConfig(filename=self.CEF_LOG_FILENAME, format='%(levelname)s, %(message)s', level=logging.DEBUG)
+        # The log file is opened once and shared with the logging module, so break lines stay in order with log entries
+        self.__logFile = open(self.CEF_LOG_FILENAME, 'a')
+        logging.basicConfig(stream=self.__logFile, format='%(levelname)s, %(message)s', level=logging.DEBUG)
         self._printBreak("RESTART") # add a discontinuity between startups
         self.printVarsInHex = True
         self.sequenceNumber = 0
         self.droppedLogs = 0
         self.fieldPattern = "{:X}" # this pattern should match what is used in the embedded sw for log strings with vars
+        self.clockSync = None # once set (and synchronized) log time stamps are written as host time, see ClockSync.py
 
     def _firstTimeFileWrite(self):
         """
@@ -61,9 +144,16 @@ class Logger:
         """
         Add a discontinuity line to the log
         """
-        f = open(self.CEF_LOG_FILENAME, 'a')
-        f.write('----------------------------------------------'+msg+'-----------------------------------------------\n')
-        f.close()
+        self.__logFile.write('----------------------------------------------'+msg+'-----------------------------------------------\n')
+
+    def _formatTimeStamp(self, timeStamp):
+        """
+        @param timeStamp: target time stamp in nanoseconds
+        @return: host time in seconds since the epoch if the target clock has been synchronized, else the raw time stamp
+        """
+        if self.clockSync is None or not self.clockSync.isSynchronized():
+            return str(timeStamp)
+        return "{:.6f}".format(self.clockSync.targetToHostNs(timeStamp) / cefContract.LOGGING_UINT64_NSEC_TO_SECONDS)
 
     def validateResponseHeader(self, responseHeader: cefContract.cefCommandHeader):
         """
@@ -118,13 +208,17 @@ class Logger:
                 else:
                     logString = logString.replace(self.fieldPattern, str(logVars[n]), 1)
 
+        # logs the target rate limited or coalesced at this call site are reported with the call site's next log
+        if log.m_numSuppressedLogs > 0:
+            logString += " (+{} similar logs suppressed)".format(log.m_numSuppressedLogs)
+
         # 3. prepare the full log entry
         rawData = str(bytes(log)) # for extra debug, the full byte-dump of the log at the end of the entry
         fileAndLine = bytes.decode(log.m_fileName) + ":" + str(log.m_fileLineNumber)
         
         # edits here should be accompanied by edits to the HEADER_STRING at the top of the class
         logEntry = ", ".join([str(log.m_logSequenceNumber),\
-                              str(log.m_timeStamp),\
+                              self._formatTimeStamp(log.m_timeStamp),\
                               logString,\
                               fileAndLine,\
                               str(log.m_moduleId),\
@@ -27,33 +27,59 @@ from DebugPortDriver import DebugPortDriver
 from Transport import Transport
 from Commands.CommandBase import *
 from Common import CefCommonDefines
-from Logger import Logger
+from Logger import Logger, unpackLogs
+from Capture import CaptureWriter
+from BulkTransfer import BulkReceiver, decodeBulkData
+from Events import decodeEvents
+from Telemetry import TelemetryReceiver
 
 class Router:
     """
     Object for dispositioning incoming packets to command and logging handlers. Packets
     are continuously read from the transport layer queue with a separate forever loop on its own
-    thread.
+    thread.  With a synchronous port (see DebugPortDriver.synchronous) no threads are started: the
+    port is read, and the packets handled, from the caller's thread by poll().  Test utilities poll
+    while waiting for a response, so packets that arrive in between (logs, events, telemetry) are
+    only handled then, or when the application calls poll().
+
+    Commands are only sent when the target has advertised room for them (see "Flow Control Credits" in
+    cefContract), so sending faster than the target can take commands does not drop them.
     """
-    def __init__(self, debugPortInterface: DebugPortDriver, responseTimeoutInSeconds=5, sendTimeoutInSeconds=5):                       
+    def __init__(self, debugPortInterface: DebugPortDriver, responseTimeoutInSeconds=5, sendTimeoutInSeconds=5, captureFileName=None,
+                 threaded=None):
         if (cefContract.structureEndiannessType == ctypes.LittleEndianStructure):
         	self.__endianness = CefCommonDefines.LITTLE_ENDIAN
         else:
             self.__endianness = CefCommonDefines.BIG_ENDIAN
             
-        self.__transport = Transport(debugPortInterface, self.__endianness)
+        # When a capture file is requested, every received packet is stored in binary form (see Capture.py)
+        self.__captureWriter = None if captureFileName is None else CaptureWriter(captureFileName)
+        # threads are only used when the port has to be read from one
+        self.threaded = (not debugPortInterface.synchronous) if threaded is None else threaded
+        self.__transport = Transport(debugPortInterface, self.__endianness, self.__captureWriter, threaded=self.threaded)
         self.__logger = Logger()
         self.__packetReadThread = Thread(target=self._readPackets)
         self.__sequenceNumber = 0
         self.__lastSentCommand = None
         self.__lastSendTime = None
+        # Number of commands sent, modulo the range of the target's command credit limit
+        self.__numCommandsSent = 0
         self.commandResponsePending = False
         self.responseTimeoutInSeconds = responseTimeoutInSeconds
         self.sendTimeoutInSeconds = sendTimeoutInSeconds
         self.timeoutOccurred = False
         self.commandSuccess = False
+        # Bulk transfers being received, by transfer id (see BulkTransfer.py)
+        self.__bulkReceivers = {}
+        # Callbacks for received events, by event id (None for callbacks of every event, see Events.py)
+        self.__eventCallbacks = {}
+        self.__nextEventSequenceNumber = None
+        self.droppedEvents = 0
+        # Receiver of the telemetry frames (see Telemetry.py), frames are discarded when there is none
+        self.__telemetryReceiver = None
 
-        self.__packetReadThread.start()
+        if self.threaded:
+            self.__packetReadThread.start()
 
     def send(self, command: CommandBase):
         """
@@ -67,7 +93,11 @@ class Router:
         if self.commandResponsePending:
             print("Cannot send, awaiting pending response")
             return False
+        elif not self._waitForCommandCredit():
+            print("Cannot send, target has no room for another command")
+            return False
         else:
+            self.__numCommandsSent = (self.__numCommandsSent + 1) & cefContract.DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK
             self.__sequenceNumber += 1
             command.setRequestSequenceNumber(self.__sequenceNumber)
             self.timeoutOccurred = False
@@ -76,12 +106,17 @@ class Router:
             self.__lastSentCommand = command
             self.__lastSendTime = time.time()
 
+            if not self.threaded:
+                # a synchronous port takes the command right away
+                self._send(command)
+                return True
+
             # start a thread to send the command - this makes the send
             # non-blocking and allows for timeout checking
             sendThread = Thread(target=self._send, args=(command,))
             sendThread.start()
             sendThread.join(timeout=self.sendTimeoutInSeconds)
-            if sendThread.isAlive():
+            if sendThread.is_alive():
                 self.commandResponsePending = False
                 self.timeoutOccurred = True
                 print("Timeout occurred on command request (send)")
@@ -89,7 +124,133 @@ class Router:
             
             return True
 
-    def _send(self, command):  
+    def getCommandCredits(self):
+        """
+        Number of commands the target has room for beyond those already sent. The target advertises a running
+        count (commands it is done with plus its free receive slots), so a packet it sent before receiving the
+        last command does not make that command look like it was never sent.
+        @return: number of commands that may be sent now
+        """
+        slots = cefContract.DEBUG_PORT_NUM_COMMAND_RECEIVE_SLOTS
+        credits = self.__transport.getFlowControlCredits()
+        if credits is None:
+            # nothing received from the target yet, assume its receive slots are free
+            return max(0, slots - self.__numCommandsSent)
+
+        commandCreditLimit = credits[0]
+        available = (commandCreditLimit - self.__numCommandsSent) & cefContract.DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK
+        if available > slots:
+            # the target has counted commands this Router did not send (e.g. before it was started), resynchronize
+            self.__numCommandsSent = (commandCreditLimit - slots) & cefContract.DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK
+            available = slots
+        return available
+
+    def getTargetLogCapacity(self):
+        """
+        @return: number of free log entries the target last advertised (saturates at
+                 cefContract.DEBUG_PORT_CREDITS_LOG_CAPACITY_MAX), or None if nothing has been received from the target
+        """
+        credits = self.__transport.getFlowControlCredits()
+        return None if credits is None else credits[1]
+
+    def _waitForCommandCredit(self):
+        """
+        Wait (up to the send timeout) for the target to have room for another command
+        @return: True if a command may be sent
+        """
+        deadline = time.time() + self.sendTimeoutInSeconds
+        while self.getCommandCredits() == 0:
+            if time.time() > deadline:
+                return False
+            if self.threaded:
+                time.sleep(0.001)
+            else:
+                self.poll()
+        return True
+
+    def poll(self):
+        """
+        Read the port and handle the packets received (only with a synchronous port, where no packet read thread
+        does it).  Does nothing with a threaded port.
+        """
+        if self.threaded:
+            return
+        self.__transport.poll()
+        self._checkResponseTimeout()
+        packet = self.__transport.getNextPacket()
+        while packet is not None:
+            self._handlePacket(packet)
+            packet = self.__transport.getNextPacket()
+
+    def _resynchronizeCommandCredits(self):
+        """
+        A command that was lost on the way is never counted by the target, so when a command times out it is
+        assumed lost, and the count of commands sent is resynchronized with the target's command credit limit
+        """
+        credits = self.__transport.getFlowControlCredits()
+        if credits is None:
+            self.__numCommandsSent = 0
+        else:
+            self.__numCommandsSent = (credits[0] - cefContract.DEBUG_PORT_NUM_COMMAND_RECEIVE_SLOTS) & cefContract.DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK
+
+    def addBulkReceiver(self, receiver: BulkReceiver):
+        """
+        Route the bulk data packets of a transfer to a receiver.  Add it before sending the command that starts the
+        transfer, as the data may arrive before the command response.
+        @param receiver: BulkReceiver for the transfer id
+        """
+        self.__bulkReceivers[receiver.transferId] = receiver
+
+    def removeBulkReceiver(self, receiver: BulkReceiver):
+        """
+        Stop routing the bulk data packets of a transfer (any still to come are discarded)
+        """
+        self.__bulkReceivers.pop(receiver.transferId, None)
+
+    def addEventCallback(self, eventId, callback):
+        """
+        Call a function whenever the target sends an event.  Callbacks are called from the packet read thread (or poll()), so
+        they should be quick (e.g. set a threading.Event) and must not send commands.
+        @param eventId: event id (cefContract.eventId or an int) to call back for, or None for every event
+        @param callback: function taking the CefEvent
+        """
+        if isinstance(eventId, cefContract.eventId):
+            eventId = eventId.value
+        self.__eventCallbacks.setdefault(eventId, []).append(callback)
+
+    def removeEventCallback(self, eventId, callback):
+        """
+        Stop calling a function added with addEventCallback()
+        """
+        if isinstance(eventId, cefContract.eventId):
+            eventId = eventId.value
+        callbacks = self.__eventCallbacks.get(eventId, [])
+        if callback in callbacks:
+            callbacks.remove(callback)
+
+    def setTelemetryReceiver(self, receiver: TelemetryReceiver):
+        """
+        Route telemetry frames to a receiver.  Set it before sending the command that starts the stream.
+        @param receiver: TelemetryReceiver, or None to discard telemetry frames
+        """
+        self.__telemetryReceiver = receiver
+
+    def closeCapture(self):
+        """
+        Finish the binary capture file (final index and trailer), if a capture was requested
+        """
+        if self.__captureWriter is not None:
+            self.__transport.setCaptureWriter(None)
+            self.__captureWriter.close()
+            self.__captureWriter = None
+
+    def setClockSync(self, clockSync):
+        """
+        @param clockSync: ClockSync used to write log time stamps as host time, or None for raw target time stamps
+        """
+        self.__logger.clockSync = clockSync
+
+    def _send(self, command):
         """
         Sends the command to the transport layer
         """  
@@ -101,125 +262,162 @@ class Router:
         are decoded (if necessary) and saved to file.
         """
         while(True):
-            # check for timeout on the current request/response transaction
-            currentTime = time.time()
-            if self.commandResponsePending and not self.timeoutOccurred and abs(currentTime - self.__lastSendTime) > self.responseTimeoutInSeconds:
-                self.commandResponsePending = False
-                self.timeoutOccurred = True
-                print("Timeout occurred on command response (receive)")
-
-            # get the next packet in the queue and handle according to type - new packet types added
-            # to the CEF contract should have handling added here
+            self._checkResponseTimeout()
             packet = self.__transport.getNextPacket()
             if packet is not None:
-                packetType = packet.header.m_packetType
-                if packetType == cefContract.debugPacketDataType.debugPacketType_commandResponse.value:
-                    self.commandSuccess = self._handleCommandResponse(packet)
-                    self.commandResponsePending = False
-                    print("Got a command response")
-                elif packetType == cefContract.debugPacketDataType.debugPacketType_loggingData.value:
-                    print("Got a log packet")
-                    self._handleLog(packet)
-
-                else:
-                    raise Exception("Unknown packet type")
+                self._handlePacket(packet)
+
+    def _checkResponseTimeout(self):
+        """
+        Check for timeout on the current request/response transaction
+        """
+        currentTime = time.time()
+        if self.commandResponsePending and not self.timeoutOccurred and abs(currentTime - self.__lastSendTime) > self.responseTimeoutInSeconds:
+            self.commandResponsePending = False
+            self.timeoutOccurred = True
+            self._resynchronizeCommandCredits()
+            print("Timeout occurred on command response (receive)")
+
+    def _handlePacket(self, packet):
+        """
+        Handle a packet according to its type - new packet types added to the CEF contract should have handling added here
+        @param packet: the full packet received from the transport layer
+        """
+        packetType = packet.header.m_packetType
+        if packetType == cefContract.debugPacketDataType.debugPacketType_commandResponse.value:
+            self.__lastSentCommand.responseReceiveTimeNs = packet.hostReceiveTimeNs
+            self.commandSuccess = self._handleCommandResponse(packet)
+            self.commandResponsePending = False
+            print("Got a command response")
+        elif packetType == cefContract.debugPacketDataType.debugPacketType_loggingData.value:
+            print("Got a log packet")
+            self._handleLog(packet)
+        elif packetType == cefContract.debugPacketDataType.debugPacketType_loggingDataPacked.value:
+            self._handlePackedLogs(packet)
+        elif packetType == cefContract.debugPacketDataType.debugPacketType_bulkData.value:
+            self._handleBulkData(packet)
+        elif packetType == cefContract.debugPacketDataType.debugPacketType_event.value:
+            self._handleEvents(packet)
+        elif packetType == cefContract.debugPacketDataType.debugPacketType_telemetry.value:
+            receiver = self.__telemetryReceiver
+            if receiver is not None:
+                receiver.receive(packet.payload)
+
+        else:
+            raise Exception("Unknown packet type")
 
     def _handleLog(self, packet):
         """
         The main message-extraction logic for incoming log packets:
-        1. Extract the response (packet payload) from the packet
-        2. Extract the log's header and validate
-        3. Extract the log's main content
-        4. Hand off to Logging object for final processing (file I/O, parsing, etc.)
+        1. Decode the log (packet payload) directly from the packet's payload memoryview
+        2. Validate the log's header
+        3. Hand off to Logging object for final processing (file I/O, parsing, etc.)
         @param packet: the full response packet received from the transport layer
         @return: False if any of the response fails to validate, else True
         """
 
-        # 1. extract payload from packet
-        payload = list(bytes(packet.payload.bytes))
-
-        # 2. extract and populate the log response header
-        responseHeader = cefContract.cefCommandHeader()
-        for f in responseHeader._fields_:
-            numBytes = ctypes.sizeof(f[1])
-            n = int.from_bytes(payload[0:numBytes], self.__endianness)
-            setattr(responseHeader, f[0], n)
-            for b in range(numBytes):
-                payload.pop(0) # remove the consumed bytes
-            #print("{}: {}".format(f[0], hex(getattr(commandResponseHeader, f[0])))) # uncomment for debug
+        # 1. decode the log from the payload (the contract structure handles endianness)
+        payload = packet.payload
+        if len(payload) < ctypes.sizeof(cefContract.cefLog):
+            print("Log Response too short - received: {}, expected: {}".format(len(payload), ctypes.sizeof(cefContract.cefLog)))
+            return False
+        logResponseBody = cefContract.cefLog.from_buffer_copy(payload)
 
         # 2. validate header
-        if not self.__logger.validateResponseHeader(responseHeader):
+        if not self.__logger.validateResponseHeader(logResponseBody.m_header):
             return False
 
-        # 3. extract and populate log response body
-        logResponseBody = cefContract.cefLog()
-        for f in logResponseBody._fields_:
-            if f[0] == 'm_header':
-                continue # skip the header since we've already consumed those bytes above
-            numBytes = ctypes.sizeof(f[1])
-            if not issubclass(f[1], ctypes.Array):
-                n = int.from_bytes(payload[0:numBytes], self.__endianness)
-            else:
-                l = []
-                for c in range(numBytes):
-                    l.append((payload[c]))
-                n = bytes(bytearray(l))
-            setattr(logResponseBody, f[0], n)
-            for b in range(numBytes):
-                payload.pop(0) # remove the consumed bytes
-            #print("{}: {}".format(f[0], hex(getattr(commandResponse, f[0])))) # uncomment for debug
-
-        # 4. process the extracted log
+        # 3. process the extracted log
         self.__logger.processLogMessage(logResponseBody)
 
         return True
 
+    def _handlePackedLogs(self, packet):
+        """
+        Decode every log in a packed logging packet and hand each off to the Logging object
+        @param packet: the full packet received from the transport layer
+        @return: False if the packet could not be decoded, else True
+        """
+        try:
+            logs = unpackLogs(packet.payload)
+        except (IndexError, ValueError) as e:
+            print("Packed log packet could not be decoded: {}".format(e))
+            return False
+
+        for log in logs:
+            self.__logger.processLogMessage(log)
+
+        return True
+
+    def _handleBulkData(self, packet):
+        """
+        Hand the data of a bulk data packet to the receiver of its transfer
+        @param packet: the full packet received from the transport layer
+        @return: False if the packet could not be decoded or has no receiver, else True
+        """
+        try:
+            transferId, offset, data = decodeBulkData(packet.payload)
+        except ValueError as e:
+            print("Bulk data packet could not be decoded: {}".format(e))
+            return False
+
+        receiver = self.__bulkReceivers.get(transferId)
+        if receiver is None:
+            # the rest of a transfer that was abandoned
+            return False
+        receiver.receive(offset, data)
+        return True
+
+    def _handleEvents(self, packet):
+        """
+        Call the callbacks of each event in an event packet
+        @param packet: the full packet received from the transport layer
+        @return: False if the packet could not be decoded, else True
+        """
+        try:
+            events = decodeEvents(packet.payload)
+        except ValueError as e:
+            print("Event packet could not be decoded: {}".format(e))
+            return False
+
+        for event in events:
+            # the target numbers every event it raises, so a gap means its event queue was full
+            if self.__nextEventSequenceNumber is not None and event.sequenceNumber != self.__nextEventSequenceNumber:
+                numDropped = (event.sequenceNumber - self.__nextEventSequenceNumber) & 0xFFFFFFFF
+                self.droppedEvents += numDropped
+                print("Event Sequence Number error - received: {}, expected: {}".format(event.sequenceNumber, self.__nextEventSequenceNumber))
+            self.__nextEventSequenceNumber = (event.sequenceNumber + 1) & 0xFFFFFFFF
+
+            for callback in self.__eventCallbacks.get(event.eventId, []) + self.__eventCallbacks.get(None, []):
+                callback(event)
+
+        return True
+
     def _handleCommandResponse(self, packet):
         """
         The main message-extraction logic for incoming command response packets:
         1. Extract the response (packet payload) from the packet
         2. Check its length against the expected length (according to the contract)
-        3. Extract the command's header and validate (proper sequence number and opCode, no error codes)
-        4. Extract and validate the content of the command body (received values vs expected per CEF contract)
+        3. Decode the command response and validate its header (proper sequence number and opCode, no error codes)
+        4. Validate the content of the command body (received values vs expected per CEF contract)
         @param packet: the full response packet received from the transport layer
         @return: False if any part of the response does not match expected values, else True
         """
 
         # 1. extract payload from packet
-        payload = list(bytes(packet.payload.bytes))
+        payload = packet.payload
 
         # 2. check the length against the expected type of response
-        expectedLength = self.__lastSentCommand.expectedResponseLength()
-        if len(payload) != expectedLength:
-            print("Invalid command response length - received: {}, expected: {}".format(len(payload), expectedLength))
+        if not self.__lastSentCommand.validateResponseLength(len(payload)):
+            print("Invalid command response length - received: {}, expected: {}".format(len(payload), self.__lastSentCommand.expectedResponseLength()))
             return False
 
-        # 3. extract and populate the command response header
-        commandResponseHeader = cefContract.cefCommandHeader()
-        for f in commandResponseHeader._fields_:
-            numBytes = ctypes.sizeof(f[1])
-            n = int.from_bytes(payload[0:numBytes], self.__endianness)
-            setattr(commandResponseHeader, f[0], n)
-            for b in range(numBytes):
-                payload.pop(0) # remove the consumed bytes
-            #print("{}: {}".format(f[0], hex(getattr(commandResponseHeader, f[0])))) # uncomment for debug
+        # 3. decode the command response (the contract structure handles endianness)
+        commandResponse = self.__lastSentCommand.decodeResponse(payload)
 
         # 3. validate the extracted header
-        if not self.__lastSentCommand.validateResponseHeader(commandResponseHeader):
+        if not self.__lastSentCommand.validateResponseHeader(commandResponse.m_header):
             return False
-        
-        # 4. extract and populate command response body
-        commandResponse = self.__lastSentCommand.expectedResponseType
-        for f in commandResponse._fields_:
-            if f[0] == 'm_header':
-                continue # skip the header since we've already consumed those bytes above
-            numBytes = ctypes.sizeof(f[1])
-            n = int.from_bytes(payload[0:numBytes], self.__endianness)
-            setattr(commandResponse, f[0], n)
-            for b in range(numBytes):
-                payload.pop(0) # remove the consumed bytes
-            #print("{}: {}".format(f[0], hex(getattr(commandResponse, f[0])))) # uncomment for debug
 
         # 4. validate extracted command body
         if not self.__lastSentCommand.validateResponseBody(commandResponse):
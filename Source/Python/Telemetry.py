@@ -0,0 +1,185 @@
+# ##################################################################
+#\copyright COPYRIGHT AND PROPRIETARY RIGHTS NOTICES:
+#
+#Copyright (C) 2021, an unpublished work by Syncroness, Inc.
+#All rights reserved.
+#
+#This material contains the valuable properties and trade secrets of
+#Syncroness of Westminster, CO, United States of America
+#embodying substantial creative efforts and confidential information,
+#ideas and expressions, no part of which may be reproduced or
+#transmitted in any form or by any means, electronic, mechanical, or
+#otherwise, including photocopying and recording or in connection
+#with any information storage or retrieval system, without the prior
+#written permission of Syncroness.
+################################################################## #
+
+
+
+"""
+Reception of telemetry (see "Telemetry" in cefContract).  The target samples its registered telemetry channels once
+per tick, each channel every 'decimation' ticks, and sends the samples in debugPacketType_telemetry frames: a
+cefTelemetryFrameHeader followed by the samples of each tick in turn, the channels due on the tick in channel order.
+The Router hands each frame to the TelemetryReceiver, which appends the samples of each channel to an array.array.
+Arrays support the buffer protocol, so numpy uses them without a copy (numpy.frombuffer(), or asNumpy()).
+"""
+
+import sys
+from os.path import dirname, abspath
+import ctypes
+import struct
+import math
+import threading
+from array import array
+
+sys.path.append(dirname(dirname(abspath(__file__))))
+from Shared import cefContract
+
+
+# struct format / array type code of each cefContract.telemetryType
+TELEMETRY_TYPE_CODES = {
+    cefContract.telemetryType.telemetryType_uint8.value: 'B',
+    cefContract.telemetryType.telemetryType_int8.value: 'b',
+    cefContract.telemetryType.telemetryType_uint16.value: 'H',
+    cefContract.telemetryType.telemetryType_int16.value: 'h',
+    cefContract.telemetryType.telemetryType_uint32.value: 'I',
+    cefContract.telemetryType.telemetryType_int32.value: 'i',
+    cefContract.telemetryType.telemetryType_uint64.value: 'Q',
+    cefContract.telemetryType.telemetryType_int64.value: 'q',
+    cefContract.telemetryType.telemetryType_float32.value: 'f',
+    cefContract.telemetryType.telemetryType_float64.value: 'd'
+}
+
+
+class TelemetryChannel:
+    """
+    A telemetry channel registered on the target (as read with CommandTelemetry)
+    """
+    def __init__(self, index, name, telemetryType, decimation):
+        self.index = index
+        self.name = name
+        self.type = telemetryType        # cefContract.telemetryType value
+        self.decimation = decimation     # 0 if the channel is off
+
+    def __repr__(self):
+        return "TelemetryChannel({}, '{}', {}, decimation={})".format(self.index, self.name,
+                cefContract.telemetryType(self.type).name, self.decimation)
+
+
+class TelemetryReceiver:
+    """
+    Decodes the telemetry frames of one configuration of the channels (frames of another configuration, e.g. sent
+    before the channels were changed, are counted in ignoredFrames).  For each channel with a name, values[name] holds
+    its samples and timeStamps[name] the target time (ns) of each, interpolated between the frame's first and last tick.
+    """
+    def __init__(self, channels, configurationNumber=None):
+        """
+        @param channels: list of TelemetryChannel, in channel index order
+        @param configurationNumber: configuration number the target reported when the stream was started, or None
+                                    to keep frames until it is known (see setConfigurationNumber())
+        """
+        self.channels = channels
+        self.configurationNumber = configurationNumber
+        self.__pendingFrames = []
+        self.__lock = threading.Lock()
+        self.values = {channel.name: array(TELEMETRY_TYPE_CODES[channel.type]) for channel in channels}
+        self.timeStamps = {channel.name: array('Q') for channel in channels}
+        self.numFrames = 0
+        self.droppedFrames = 0
+        self.ignoredFrames = 0
+        self.__nextFrameSequenceNumber = None
+        self.__endianness = '<' if cefContract.structureEndiannessType == ctypes.LittleEndianStructure else '>'
+
+        # The channels due on a tick only depend on the tick modulo the decimations' least common multiple, so the
+        # decoder of each phase is built once
+        decimations = [channel.decimation for channel in channels if channel.decimation != 0]
+        self.__period = 1
+        for decimation in decimations:
+            self.__period = self.__period * decimation // math.gcd(self.__period, decimation)
+        self.__tickDecoders = {}
+
+    def _tickDecoder(self, tick):
+        """
+        @return: (struct.Struct of the samples of the tick, channels due on the tick)
+        """
+        phase = tick % self.__period
+        decoder = self.__tickDecoders.get(phase)
+        if decoder is None:
+            dueChannels = [channel for channel in self.channels if channel.decimation != 0 and tick % channel.decimation == 0]
+            decoder = (struct.Struct(self.__endianness + ''.join(TELEMETRY_TYPE_CODES[channel.type] for channel in dueChannels)),
+                       dueChannels)
+            self.__tickDecoders[phase] = decoder
+        return decoder
+
+    def setConfigurationNumber(self, configurationNumber):
+        """
+        Set the configuration number once the command starting the stream has its response, and decode the frames
+        that arrived before it
+        """
+        with self.__lock:
+            self.configurationNumber = configurationNumber
+            pendingFrames, self.__pendingFrames = self.__pendingFrames, []
+            for payload in pendingFrames:
+                self._decodeFrame(payload)
+
+    def receive(self, payload):
+        """
+        Append the samples of a telemetry frame to the channel arrays
+        @param payload: payload of a debugPacketType_telemetry packet
+        @return: False if the frame could not be decoded or is of another configuration, else True
+        """
+        with self.__lock:
+            if self.configurationNumber is None:
+                # the stream was started, but the command's response has not been handled yet
+                self.__pendingFrames.append(bytes(payload))
+                return True
+            return self._decodeFrame(payload)
+
+    def _decodeFrame(self, payload):
+        """
+        See receive()
+        """
+        headerSize = ctypes.sizeof(cefContract.cefTelemetryFrameHeader)
+        if len(payload) < headerSize:
+            print("Telemetry frame too short")
+            return False
+        header = cefContract.cefTelemetryFrameHeader.from_buffer_copy(payload[:headerSize])
+        if header.m_configurationNumber != self.configurationNumber:
+            self.ignoredFrames += 1
+            return False
+
+        # the target numbers every frame it finishes, so a gap means frames were dropped for lack of bandwidth
+        if self.__nextFrameSequenceNumber is not None and header.m_frameSequenceNumber != self.__nextFrameSequenceNumber:
+            self.droppedFrames += (header.m_frameSequenceNumber - self.__nextFrameSequenceNumber) & 0xFFFFFFFF
+            print("Telemetry frame sequence number error - received: {}, expected: {}".format(header.m_frameSequenceNumber, self.__nextFrameSequenceNumber))
+        self.__nextFrameSequenceNumber = (header.m_frameSequenceNumber + 1) & 0xFFFFFFFF
+
+        tickPeriodNs = 0
+        if header.m_numTicks > 1:
+            tickPeriodNs = (header.m_lastTickTimeStamp - header.m_firstTickTimeStamp) / (header.m_numTicks - 1)
+
+        samples = memoryview(payload)[headerSize:]
+        offset = 0
+        for tickInFrame in range(header.m_numTicks):
+            decoder, dueChannels = self._tickDecoder(header.m_firstTick + tickInFrame)
+            if not dueChannels:
+                continue
+            if offset + decoder.size > len(samples):
+                print("Telemetry frame truncated")
+                return False
+            timeStamp = header.m_firstTickTimeStamp + int(tickInFrame * tickPeriodNs)
+            for channel, value in zip(dueChannels, decoder.unpack_from(samples, offset)):
+                self.values[channel.name].append(value)
+                self.timeStamps[channel.name].append(timeStamp)
+            offset += decoder.size
+
+        self.numFrames += 1
+        return True
+
+    def asNumpy(self):
+        """
+        @return: dictionary of (time stamps, values) numpy arrays by channel name (needs numpy)
+        """
+        import numpy
+        return {name: (numpy.frombuffer(self.timeStamps[name], dtype=numpy.uint64),
+                       numpy.frombuffer(values, dtype=values.typecode)) for name, values in self.values.items()}
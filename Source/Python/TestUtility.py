@@ -15,8 +15,24 @@
 ################################################################## #
 
 
+import os
+import time
+import ctypes
+
 from Router import Router
 from Commands.PingCommand import CommandPing
+from Commands.FragmentLoopbackCommand import CommandFragmentLoopback
+from Commands.MemoryReadCommand import CommandMemoryRead
+from Commands.MemoryWriteCommand import CommandMemoryWrite
+from Commands.SetLogThresholdCommand import CommandSetLogThreshold
+from Commands.TimeSyncCommand import CommandTimeSync
+from Commands.DebugPortStatsCommand import CommandDebugPortStats
+from Commands.TelemetryCommand import CommandTelemetry
+from Commands.SoftwareScopeCommand import CommandSoftwareScope
+from ClockSync import ClockSync
+from BulkTransfer import BulkReceiver
+from Telemetry import TelemetryChannel, TelemetryReceiver
+from Shared import cefContract
 
 
 class Base:
@@ -38,7 +54,7 @@ class Base:
             print("Error occurred on send")
 
         while self.__router.commandResponsePending and not self.__router.timeoutOccurred:
-            pass
+            self.__router.poll()
         if self.__router.timeoutOccurred:
             return False
         else:
@@ -47,6 +63,64 @@ class Base:
             else:
                 return True
 
+    def executeFragmented(self, command):
+        """
+        Execute a fragmented command (see FragmentedCommandBase) until the target ends its transfer
+        @param command: fragmented command to be issued to the target
+        @return: False if any fragment times out or gives a faulty response, else True
+        """
+        while not command.transferComplete:
+            if not self.execute(command):
+                return False
+        return True
+
+    def executeBulkRead(self, command, receiver: BulkReceiver):
+        """
+        Send a command that starts a bulk transfer, and wait for all of its data
+        @param command: command to be issued to the target
+        @param receiver: BulkReceiver for the transfer the command starts
+        @return: False if the command fails or the data stops arriving before the transfer is done, else True
+        """
+        self.__router.addBulkReceiver(receiver)
+        try:
+            if not self.execute(command):
+                return False
+            return receiver.wait(self.__router.responseTimeoutInSeconds, None if self.__router.threaded else self.__router.poll)
+        finally:
+            self.__router.removeBulkReceiver(receiver)
+
+    def poll(self):
+        """
+        Handle the packets received since the last command (only needed with a synchronous port, see Router.poll())
+        """
+        self.__router.poll()
+
+    def setClockSync(self, clockSync):
+        """
+        @param clockSync: ClockSync used to write log time stamps as host time
+        """
+        self.__router.setClockSync(clockSync)
+
+    def setTelemetryReceiver(self, receiver: TelemetryReceiver):
+        """
+        @param receiver: TelemetryReceiver for the telemetry frames, or None to discard them
+        """
+        self.__router.setTelemetryReceiver(receiver)
+
+    def addEventCallback(self, eventId, callback):
+        """
+        Call a function whenever the target sends an event (see Router.addEventCallback())
+        @param eventId: event id (cefContract.eventId or an int) to call back for, or None for every event
+        @param callback: function taking the CefEvent
+        """
+        self.__router.addEventCallback(eventId, callback)
+
+    def removeEventCallback(self, eventId, callback):
+        """
+        Stop calling a function added with addEventCallback()
+        """
+        self.__router.removeEventCallback(eventId, callback)
+
 
 class Diag(Base):
     """
@@ -54,6 +128,10 @@ class Diag(Base):
     """
     def __init__(self, interface):
         super().__init__(interface)
+        self.clockSync = ClockSync()
+        self.setClockSync(self.clockSync)
+        self.transferId = 0
+        self.byteOrder = 'little' if cefContract.structureEndiannessType == ctypes.LittleEndianStructure else 'big'
 
     def ping(self, printResults=True):
         ping = CommandPing()
@@ -89,12 +167,249 @@ class Diag(Base):
         if pingCommandResult:
             print("Successfully executed {} Ping Commands".format(i+1))
 
+    def fragmentLoopback(self, numBytes=4096, printResults=True):
+        """
+        Send random data to the target in fragments and check the same data comes back
+        @param numBytes: number of bytes to loop back
+        @return: False if the transfer fails, else True
+        """
+        command = CommandFragmentLoopback(os.urandom(numBytes))
+        result = self.executeFragmented(command)
+
+        if (printResults):
+            if result:
+                print("Fragment Loopback Success! {} bytes".format(numBytes))
+            else:
+                print("Fragment Loopback Fail after {} bytes".format(command.responseNumBytesReceived))
+
+        return result
+
+    def memoryRead(self, address, numBytes, sink=None):
+        """
+        Read target memory.  The data is streamed by the target as fast as the debug port carries it.
+        @param address: target address to read from
+        @param numBytes: number of bytes to read
+        @param sink: object with a write() method (e.g. a file) or a bytearray the data is written to, default is a new bytearray
+        @return: the sink, or None if the read failed
+        """
+        self.transferId = (self.transferId + 1) & 0xFFFFFFFF
+        receiver = BulkReceiver(self.transferId, numBytes, sink)
+        if not self.executeBulkRead(CommandMemoryRead(address, numBytes, self.transferId), receiver):
+            # don't leave the target streaming a read no one is receiving
+            self.execute(CommandMemoryRead(address, 0, self.transferId))
+            return None
+        return receiver.sink
+
+    def memoryWrite(self, address, data):
+        """
+        Write target memory
+        @param address: target address to write to
+        @param data: bytes-like object of any size (sent CEF_MEMORY_WRITE_MAX_DATA_BYTES per command)
+        @return: False if any of the writes fails, else True
+        """
+        data = memoryview(data).cast('B')
+        for offset in range(0, len(data), cefContract.CEF_MEMORY_WRITE_MAX_DATA_BYTES):
+            chunk = data[offset:offset + cefContract.CEF_MEMORY_WRITE_MAX_DATA_BYTES]
+            if not self.execute(CommandMemoryWrite(address + offset, chunk)):
+                print("Memory write failed at address 0x{:X}".format(address + offset))
+                return False
+        return True
+
+    def peek(self, address, numBytes=4):
+        """
+        @return: the unsigned value of numBytes at a target address, or None if the read failed
+        """
+        data = self.memoryRead(address, numBytes)
+        return None if data is None else int.from_bytes(data, self.byteOrder)
+
+    def poke(self, address, value, numBytes=4):
+        """
+        Write an unsigned value of numBytes to a target address
+        @return: False if the write failed, else True
+        """
+        return self.memoryWrite(address, value.to_bytes(numBytes, self.byteOrder))
+
+    def dump(self, address, numBytes, fileName, printResults=True):
+        """
+        Read a target address range into a binary file
+        @return: False if the read failed, else True
+        """
+        startTime = time.time()
+        with open(fileName, 'wb') as f:
+            result = self.memoryRead(address, numBytes, f) is not None
+
+        if (printResults):
+            if result:
+                elapsed = time.time() - startTime
+                print("Dumped {} bytes to {} in {:.2f} s ({:.0f} bytes/s)".format(numBytes, fileName, elapsed, numBytes / elapsed))
+            else:
+                print("Dump Fail!")
+
+        return result
+
+    def setLogThreshold(self, logThreshold: cefContract.logType, moduleId=cefContract.LOGGING_MODULE_ID_ALL_MODULES):
+        """
+        Change the target's run time log threshold, e.g. setLogThreshold(cefContract.logType.logTypeWarning)
+        @param logThreshold: logs of this type and above are sent by the target
+        @param moduleId: target logging module id, default is all modules
+        @return: False if the command times out or the target rejects the threshold, else True
+        """
+        command = CommandSetLogThreshold(logThreshold, moduleId)
+        result = self.execute(command)
+        if result:
+            print("Log threshold changed from {} to {}".format(
+                cefContract.logType(command.receivedResponse.m_previousLogThreshold).name, logThreshold.name))
+        else:
+            print("Set log threshold failed")
+        return result
+
+    def timeSync(self, numSamples=8, printResults=True):
+        """
+        Measure the link round trip time and the target to host clock offset (NTP style, see ClockSync.py).
+        Afterwards, log time stamps are written as host time.  Call again periodically to correct for clock drift.
+        @param numSamples: number of time sync commands; the one with the smallest round trip time is used
+        @return: the resulting ClockSync.ClockSyncPoint, or None if every time sync command failed
+        """
+        samples = []
+        for i in range(numSamples):
+            command = CommandTimeSync()
+            if self.execute(command):
+                samples.append(command.timeStamps())
+
+        if not samples:
+            print("Time sync failed")
+            return None
+
+        syncPoint = self.clockSync.addSamples(samples)
+        if printResults:
+            print("Time sync: round trip time {:.1f} us, offset {} ns +/- {:.1f} us, drift {:.3f} ppm".format(
+                syncPoint.roundTripTimeNs / 1000, syncPoint.offsetNs, syncPoint.errorNs / 1000, self.clockSync.drift * 1e6))
+        return syncPoint
+
+    def debugPortStats(self, printResults=True):
+        """
+        Read the target's debug port error counters (receive errors by class, packets they dropped, and timeouts)
+        @return: dictionary of the counters (see CommandDebugPortStats.stats()), or None if the command failed
+        """
+        command = CommandDebugPortStats()
+        if not self.execute(command):
+            print("Debug port stats failed")
+            return None
+
+        stats = command.stats()
+        if printResults:
+            print("Debug port stats: " + ", ".join("{} {}".format(name, value) for name, value in stats.items()))
+        return stats
+
+    def _telemetry(self, channelIndex=0, decimation=cefContract.TELEMETRY_DECIMATION_UNCHANGED,
+                   control=cefContract.telemetryControl.telemetryControl_none):
+        """
+        Execute a telemetry command
+        @return: the response, or None if the command failed
+        """
+        command = CommandTelemetry(channelIndex, decimation, control)
+        if not self.execute(command):
+            print("Telemetry command failed")
+            return None
+        return command.receivedResponse
+
+    def telemetryChannels(self):
+        """
+        @return: list of the telemetry channels registered on the target (Telemetry.TelemetryChannel), or None if a
+                 command failed
+        """
+        channels = []
+        numChannels = 1
+        while len(channels) < numChannels:
+            response = self._telemetry(len(channels))
+            if response is None:
+                return None
+            numChannels = response.m_numChannels
+            if len(channels) < numChannels:
+                channels.append(TelemetryChannel(len(channels), response.m_name.decode(), response.m_type, response.m_decimation))
+        return channels
+
+    def startTelemetry(self, decimations=None):
+        """
+        Start streaming the target's telemetry channels
+        @param decimations: dictionary of decimation by channel name for the channels to change (0 turns a channel
+                            off), None to keep the target's decimations
+        @return: the TelemetryReceiver the samples are decoded into, or None if a command failed
+        """
+        channels = self.telemetryChannels()
+        if channels is None:
+            return None
+        for channel in channels:
+            if decimations is not None and channel.name in decimations:
+                response = self._telemetry(channel.index, decimations[channel.name])
+                if response is None:
+                    return None
+                channel.decimation = response.m_decimation
+
+        receiver = TelemetryReceiver(channels)
+        self.setTelemetryReceiver(receiver)
+        response = self._telemetry(control=cefContract.telemetryControl.telemetryControl_start)
+        if response is None:
+            self.setTelemetryReceiver(None)
+            return None
+        receiver.setConfigurationNumber(response.m_configurationNumber)
+        return receiver
+
+    def stopTelemetry(self):
+        """
+        Stop the telemetry stream.  The samples taken before the stop are still sent, the receiver keeps decoding
+        them until the next startTelemetry().
+        @return: False if the command failed
+        """
+        return self._telemetry(control=cefContract.telemetryControl.telemetryControl_stop) is not None
+
+    def startScope(self, elfSymbols, decimations, replace=True):
+        """
+        Software scope: sample global variables of the target by address, picked by name from its ELF file, and
+        stream them with the telemetry channels
+        @param elfSymbols: ElfSymbols of the target's ELF file
+        @param decimations: dictionary of decimation by variable (e.g. {"appStats.loopTimeUs[2]": 10}), at most
+                            cefContract.TELEMETRY_MAX_NUM_ADDRESS_CHANNELS
+        @param replace: True to stop sampling the variables of the last startScope()
+        @return: the TelemetryReceiver the samples are decoded into, or None if a command failed
+        """
+        entries = []
+        for name, decimation in decimations.items():
+            variable = elfSymbols.lookup(name)
+            if variable.type is None:
+                raise ValueError("{} is not a number, it can't be sampled".format(variable))
+            entries.append((name, variable.address, variable.type, decimation))
+
+        command = CommandSoftwareScope(entries, replace)
+        if not self.execute(command):
+            print("Software scope command failed")
+            return None
+        return self.startTelemetry()
+
+    def stopScope(self):
+        """
+        Stop the telemetry stream and stop sampling the software scope's variables
+        @return: False if a command failed
+        """
+        if not self.stopTelemetry():
+            return False
+        return self.execute(CommandSoftwareScope([], replace=True))
+
 
 
 if __name__ == '__main__':
     from DebugSerialPort import DebugSerialPort
     p = DebugSerialPort('/dev/ttyACM0', baudRate=115200)
     # p = DebugSerialPort('/dev/tty3', baudRate=9600)
+    # for a simulated target serving its debug port on localhost (see DebugSocketPort.py)
+    # from DebugSocketPort import DebugSocketPort
+    # p = DebugSocketPort('tcp')
+    # or on shared memory (see DebugSharedMemoryPort.py)
+    # from DebugSharedMemoryPort import DebugSharedMemoryPort
+    # p = DebugSharedMemoryPort()
+    # or loaded into this process (see DebugLibraryPort.py)
+    # from DebugLibraryPort import DebugLibraryPort
+    # p = DebugLibraryPort('./libcefsim.so')
     p.open()
     d = Diag(p)
     d.ping()
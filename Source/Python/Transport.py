@@ -18,186 +18,598 @@
 import sys
 from os.path import dirname, abspath
 import ctypes
-import copy
-from threading import Thread
+import struct
+import time
+from collections import deque, namedtuple, OrderedDict
+from threading import Thread, Condition
 
 sys.path.append(dirname(dirname(abspath(__file__))))
 from Shared import cefContract
 from DebugPortDriver import DebugPortDriver
+from Common import CefCommonDefines
+
+
+# Decoded cefCommandDebugPortHeader fields (same field names as the cefContract structure)
+DebugPortHeader = namedtuple('DebugPortHeader', [f[0] for f in cefContract.cefCommandDebugPortHeader._fields_])
+
+# A framed packet handed to the application; payload is a read-only memoryview of the payload bytes, and
+# hostReceiveTimeNs is the time.time_ns() time the read completing the packet returned
+CefPacket = namedtuple('CefPacket', ['header', 'payload', 'hostReceiveTimeNs'])
+
+_BATCH_HEADER_SIZE_BYTES = ctypes.sizeof(cefContract.cefBatchHeader)
+_BATCH_RECORD_TABLE_ENTRY_SIZE_BYTES = ctypes.sizeof(cefContract.cefBatchRecordTableEntry)
+_RELIABLE_HEADER_SIZE_BYTES = ctypes.sizeof(cefContract.cefReliableHeader)
+
+
+def unbatch(payload):
+    """
+    Split a batch payload (see "Batch Format" in cefContract.hpp) into its records
+    @param payload: memoryview of a debugPacketType_batch payload
+    @return: list of (record packet type, memoryview of the record)
+    """
+    if len(payload) < _BATCH_HEADER_SIZE_BYTES:
+        raise ValueError("batch too short for its header: {} bytes".format(len(payload)))
+    numRecords = cefContract.cefBatchHeader.from_buffer_copy(payload).m_numRecords
+
+    recordOffset = _BATCH_HEADER_SIZE_BYTES + (numRecords * _BATCH_RECORD_TABLE_ENTRY_SIZE_BYTES)
+    if recordOffset > len(payload):
+        raise ValueError("batch too short for {} record table entries: {} bytes".format(numRecords, len(payload)))
+
+    records = []
+    for i in range(numRecords):
+        tableEntryOffset = _BATCH_HEADER_SIZE_BYTES + (i * _BATCH_RECORD_TABLE_ENTRY_SIZE_BYTES)
+        tableEntry = cefContract.cefBatchRecordTableEntry.from_buffer_copy(payload[tableEntryOffset:])
+        recordEnd = recordOffset + tableEntry.m_recordNumBytes
+        if recordEnd > len(payload):
+            raise ValueError("batch record {} overruns the payload".format(i))
+        records.append((tableEntry.m_recordType, payload[recordOffset:recordEnd]))
+        recordOffset = recordEnd
+
+    return records
+
+
+def cobsEncode(data):
+    """
+    COBS (Consistent Overhead Byte Stuffing) encode data (see "DEBUG_PORT_FRAMING_COBS" in cefContract.hpp)
+    @param data: bytes-like object to encode
+    @return: the encoded bytes (without the delimiter), which never contain a zero
+    """
+    encoded = bytearray()
+    for block in bytes(data).split(b'\x00'):
+        # blocks of more than 254 non-zero bytes are split into full (code 0xFF) blocks with no implied zero
+        while len(block) >= 254:
+            encoded.append(0xFF)
+            encoded += block[:254]
+            block = block[254:]
+        encoded.append(len(block) + 1)
+        encoded += block
+    return bytes(encoded)
+
+
+def cobsDecode(frame):
+    """
+    Decode a COBS frame
+    @param frame: bytes-like object holding the frame, without the delimiter
+    @return: the decoded bytes
+    @raise ValueError: if the frame is not valid COBS (e.g. it was corrupted)
+    """
+    frame = bytes(frame)
+    decoded = bytearray()
+    offset = 0
+    while offset < len(frame):
+        code = frame[offset]
+        if code == 0 or offset + code > len(frame):
+            raise ValueError("invalid COBS code {} at offset {}".format(code, offset))
+        decoded += frame[offset + 1:offset + code]
+        offset += code
+        if code != 0xFF and offset < len(frame):
+            decoded.append(0)
+    return bytes(decoded)
 
 
 class Transport:
     """
     Object for packetizing outgoing commands and framing incoming data with bi-endian support.
-    The class runs a separate thread for capturing all incoming data from the port.
+    The class runs a separate thread for capturing all incoming data from the port, or, when not threaded
+    (a port that can be polled, see DebugPortDriver.poll()), reads it when the application calls poll().
     The debug port interface must be defined and supplied by the application.
-    Framed packets are placed in a queue for the application to retrieve from.
+    Framed packets are placed in a queue for the application to retrieve from.  Batch packets are split into
+    their records, and each record is queued as if it had been received in its own packet.
+
+    Incoming data is read in bulk (whatever the debug port has available) into a bytearray stream
+    buffer.  The stream buffer is scanned for the framing signature with find(), the header is decoded
+    with a single precompiled struct unpack, and the payload is handed out as a memoryview so the
+    application can decode it without any additional per byte copies.
+
+    With COBS framing (cefContract.DEBUG_PORT_FRAMING_COBS), packets are instead split out of the stream buffer at
+    each delimiter and decoded, so a corrupted packet only costs that packet and the next one is framed right after
+    the delimiter.
+
+    With reliable delivery (cefContract.DEBUG_PORT_RELIABLE_DELIVERY), every payload starts with a cefReliableHeader.
+    Commands are kept until the target acknowledges them, and retransmitted right away when the target reports one
+    lost or corrupted (NACK), or after DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS.  Received packets are acknowledged
+    with the next command, or by an ack packet once half a window is received or a tenth of the retransmit timeout
+    passes (so a stream of packets from the target doesn't get an ack packet each).
+    A corrupted or missing packet is NACKed right away, and packets received after a missing one are kept until it
+    is retransmitted, so they are handed to the application in order.
     """
 
     PAYLOAD_HEADER_SIZE_BYTES = ctypes.sizeof(cefContract.cefCommandDebugPortHeader())
-    PAYLOAD_MAX_SIZE_BYTES = cefContract.DEBUG_PORT_MAX_PACKET_SIZE_BYTES - PAYLOAD_HEADER_SIZE_BYTES
+    # Largest application payload (not including the reliable delivery header)
+    PAYLOAD_MAX_SIZE_BYTES = cefContract.DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+
+    FRAMING_SIGNATURE = bytes(cefContract.debugPacketFramingSignature)
 
-    def __init__(self, debugPortInterface: DebugPortDriver, endianness):
+    # Maximum number of bytes to request from the debug port in a single read
+    MAX_READ_SIZE_BYTES = 4096
+
+    def __init__(self, debugPortInterface: DebugPortDriver, endianness, captureWriter=None, cobsFraming=None, reliable=None,
+                 threaded=True):
         self.__debugPort = debugPortInterface
+        # False to read the debug port only from poll(), in the caller's thread
+        self.__threaded = threaded
         self.__endianness = endianness
+        # Must match how the target was built (DEBUG_PORT_FRAMING_COBS), defaults to the contract setting
+        self.__cobsFraming = bool(cefContract.DEBUG_PORT_FRAMING_COBS) if cobsFraming is None else cobsFraming
+        # Must match how the target was built (DEBUG_PORT_RELIABLE_DELIVERY), defaults to the contract setting
+        self.__reliable = bool(cefContract.DEBUG_PORT_RELIABLE_DELIVERY) if reliable is None else reliable
+        self.__reliableHeaderSize = _RELIABLE_HEADER_SIZE_BYTES if self.__reliable else 0
+        # Optional Capture.CaptureWriter, every framed packet is appended to it as received
+        self.__captureWriter = captureWriter
+
+        # Precompiled layout of cefCommandDebugPortHeader (must match the cefContract structure)
+        structEndianness = '<' if endianness == CefCommonDefines.LITTLE_ENDIAN else '>'
+        self.__headerStruct = struct.Struct(structEndianness + '{}sIIBBH'.format(cefContract.numElementsInDebugPacketFramingSignature))
+        assert(self.__headerStruct.size == self.PAYLOAD_HEADER_SIZE_BYTES)
+
         self.__readThread = Thread(target=self._readLoop)
-        #self.__readThread = Thread(target=self._readLoop1)
-        self.__readBuffer = []
-        self.__packetQueue = []
+        self.__readBuffer = bytearray()
+        self.__packetQueue = deque()
+        # m_flowControlCredits of the last valid packet received, None until a packet is received
+        self.__flowControlCredits = None
+
+        # Reliable delivery state (see Reliable Delivery in cefContract), shared by the read, retransmit and send threads
+        self.__reliableLock = Condition()
+        self.__nextTransmitSequenceNumber = 0
+        self.__unackedPackets = OrderedDict()   # sequence number: [payload, packet type, last send time]
+        self.__transmitSynchronized = False
+        self.__nextReceiveSequenceNumber = 0
+        self.__outOfOrderPackets = {}           # sequence number: (header, packet bytes, payload, receive time)
+        self.__numPacketsToAck = 0
+        self.__nackPending = False
+        self.__lastAckCheckTime = time.monotonic()
+        self.numRetransmits = 0
 
-        self.__readThread.start()
+        if self.__threaded:
+            self.__readThread.start()
+            if self.__reliable:
+                self.__retransmitThread = Thread(target=self._retransmitLoop)
+                self.__retransmitThread.start()
 
     @staticmethod
-    def calculateChecksum(data: bytes) -> int:
+    def calculateChecksum(data) -> int:
         """
         This simple checksum adds all bytes in the input
-        @param data: the data to compute the checksum over, as a byte array
+        @param data: the data to compute the checksum over (any bytes-like object)
         @return byteSum: the sum of all bytes in the input data
         """
-        byteSum = 0
-        for byte in data:
-            byteSum += byte
-        # print("CHECKSUM: {}".format(byteSum)) # uncomment for debug
-        return byteSum
+        return sum(data)
 
     def getNextPacket(self):
         """
         Accessor for received packets
         @return: the first packet in the queue of received packets
         """
-        if len(self.__packetQueue) > 0:
-            return self.__packetQueue.pop(0)
-        else:
+        try:
+            return self.__packetQueue.popleft()
+        except IndexError:
             return None
 
+    def getFlowControlCredits(self):
+        """
+        Accessor for the flow control credits the target last advertised (see "Flow Control Credits" in cefContract)
+        @return: (command credit limit, number of free log entries), or None if no packet has been received yet
+        """
+        credits = self.__flowControlCredits
+        if credits is None:
+            return None
+        return (credits & cefContract.DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK,
+                credits >> cefContract.DEBUG_PORT_CREDITS_LOG_CAPACITY_SHIFT)
+
+    def setCaptureWriter(self, captureWriter):
+        """
+        @param captureWriter: Capture.CaptureWriter to append received packets to, or None to stop capturing
+        """
+        self.__captureWriter = captureWriter
+
     def send(self, payload: bytes):
         """
         Transmitter for outgoing data
         @param payload: data to be packetized and sent to the target
         """
-        packet = self._buildPacket(payload)
-        self.__debugPort.send(packet)
+        if not self.__reliable:
+            self.__debugPort.send(self._buildPacket(payload))
+            return
 
+        commandRequest = cefContract.debugPacketDataType.debugPacketType_commandRequest.value
+        with self.__reliableLock:
+            # wait for the target to acknowledge a packet if the window is full
+            while len(self.__unackedPackets) >= cefContract.DEBUG_PORT_RELIABLE_WINDOW_SIZE:
+                if self.__threaded:
+                    self.__reliableLock.wait()
+                else:
+                    self.poll()
+            sequenceNumber = self.__nextTransmitSequenceNumber
+            self.__nextTransmitSequenceNumber = (sequenceNumber + 1) & 0xff
+            self.__unackedPackets[sequenceNumber] = [bytes(payload), commandRequest, 0]
+            self._sendReliable(sequenceNumber)
 
-    def _readLoop1(self):
+    def _readLoop(self):
+        """
+        Forever loop for reading incoming bytes.  Each pass reads whatever is available from the
+        debug port (blocking for at least one byte), appends it to the stream buffer, and then
+        frames as many complete packets as the stream buffer contains.
+        """
         while(True):
-            self.__debugPort.receive()
+            data = self.__debugPort.receive(self.MAX_READ_SIZE_BYTES)
+            if data:
+                self._receiveData(data)
 
+    def poll(self):
+        """
+        Read and frame whatever the debug port has, without blocking (only when not threaded).  With reliable delivery,
+        the oldest unacknowledged command is also retransmitted and pending acks sent, as the retransmit thread would.
+        """
+        data = self.__debugPort.poll(self.MAX_READ_SIZE_BYTES)
+        if data:
+            self._receiveData(data)
+        if self.__reliable:
+            timeout = cefContract.DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS / 1000
+            if time.monotonic() - self.__lastAckCheckTime >= timeout / 10:
+                self.__lastAckCheckTime = time.monotonic()
+                self._retransmitOldest(timeout)
+                self._sendPendingAck()
 
-    def _readLoop(self):
+    def _receiveData(self, data):
+        """
+        Append data read from the debug port to the stream buffer, and frame as many complete packets as it contains
         """
-        Forever loop for reading incoming bytes, with the following sequence:
-        1. Look for framing signature
-        2. Receive remaining header bytes
+        receiveTimeNs = time.time_ns()
+        self.__readBuffer += data
+        if self.__cobsFraming:
+            self._parseCobsReadBuffer(receiveTimeNs)
+        else:
+            self._parseReadBuffer(receiveTimeNs)
+        if self.__reliable:
+            self._sendPendingAck(urgentOnly=True)
+
+    def _parseReadBuffer(self, receiveTimeNs):
+        """
+        Frame packets out of the stream buffer with the following sequence:
+        1. Look for framing signature (anything before it is discarded)
+        2. Wait until the complete header has been received, and decode it
         3. Validate received header against received checksum
-        4. Check expected payload size and receive corresponding bytes
+        4. Check expected payload size and wait until the corresponding bytes are received
         5. Validate payload checksum against received checksum
         6. Put packet in the receiving queue
+        Incomplete packets are left in the stream buffer until more data arrives.
+        @param receiveTimeNs: host time the data was read, given to every packet completed by this read
         """
+        buffer = self.__readBuffer
+        signature = self.FRAMING_SIGNATURE
+        headerSize = self.PAYLOAD_HEADER_SIZE_BYTES
 
-        # retrieve the framing signature from the CEF contract which is byte by byte iterable
-        framingSignature = cefContract.debugPacketFramingSignature
-
-        # start the loop
-        while(True):
+        while True:
             # 1. look for framing signature
-            signatureFound = False
-            self.__readBuffer = []
-            while not signatureFound:
-                i = 0
-                # while all bytes of the framing signature, in order, are not yet received
-                while i < len(framingSignature):
-                    byte = self.__debugPort.receive()
-                    # if a byte matches our current position in the framing signature, 
-                    # save it and increment, else start over at the first byte
-                    if int.from_bytes(byte, self.__endianness) == framingSignature[i]:
-                        self.__readBuffer.append(byte)
-                        i += 1
-                    else:
-                        # reset the read buffer and start over
-                        self.__readBuffer = []
-                        i = 0
-                signatureFound = True
-            
-            # 2. receive remaining header bytes and populate a structure with them
-            for i in range(self.PAYLOAD_HEADER_SIZE_BYTES - len(framingSignature)):
-                byte = self.__debugPort.receive()
-                self.__readBuffer.append(byte)
-            print("HEADER FOUND, LEN:{}\n{}\n".format(len(self.__readBuffer),self.__readBuffer)) # uncomment for debug
-            packetHeader = cefContract.cefCommandDebugPortHeader()
-
-            # populate header fields from the buffer
-            for f in packetHeader._fields_:
-                numBytes = ctypes.sizeof(f[1])
-                if f[0] == 'm_framingSignature':
-                	for k in range (cefContract.numElementsInDebugPacketFramingSignature):
-                		packetHeader.m_framingSignature[k] = int.from_bytes(self.__readBuffer[k], self.__endianness)
-                else:               
-                	n = int.from_bytes(b''.join(self.__readBuffer[0:numBytes]), self.__endianness)
-                	setattr(packetHeader, f[0], n)
-                	
-                for b in range(numBytes):
-                    self.__readBuffer.pop(0) # remove the consumed bytes
-			                     			
-            # 3. validate received header against received checksum
-            headerCopy = copy.deepcopy(packetHeader)
-            headerCopy.m_packetHeaderChecksum = 0
-            headerChecksum = self.calculateChecksum(bytes(headerCopy))
-            # print("CHECKSUMS: CALCULATED {}    RECEIVED {}".format(headerChecksum, packetHeader.m_packetHeaderChecksum))
+            signatureOffset = buffer.find(signature)
+            if signatureOffset < 0:
+                # keep the tail in case the signature is split across two reads
+                del buffer[:max(0, len(buffer) - (len(signature) - 1))]
+                return
+            if signatureOffset > 0:
+                del buffer[:signatureOffset]
+
+            # 2. wait for, then decode, the complete header
+            if len(buffer) < headerSize:
+                return
+            packetHeader = DebugPortHeader._make(self.__headerStruct.unpack_from(buffer, 0))
+
+            # 3. validate received header against received checksum (computed over everything but the checksum itself)
+            headerChecksum = self.calculateChecksum(memoryview(buffer)[:headerSize - 2])
             if headerChecksum != packetHeader.m_packetHeaderChecksum:
-                #TODO: raise an exception here
                 print("PACKET FRAMING HEADER CHECKSUM FAILURE: {} != {}".format(headerChecksum, packetHeader.m_packetHeaderChecksum))
+                # resynchronize on the next framing signature
+                del buffer[:len(signature)]
+                self._packetLost()
+                continue
+
+            maxPayloadSize = self.PAYLOAD_MAX_SIZE_BYTES + self.__reliableHeaderSize
+            if packetHeader.m_payloadSize > maxPayloadSize:
+                print("PACKET FRAMING PAYLOAD SIZE TOO LARGE: {} > {}".format(packetHeader.m_payloadSize, maxPayloadSize))
+                del buffer[:len(signature)]
+                self._packetLost()
+                continue
+
+            # 4. wait until the complete payload has been received
+            packetSize = headerSize + packetHeader.m_payloadSize
+            if len(buffer) < packetSize:
+                return
 
-            # 4. check expected payload size and receive corresponding bytes
-            self.__readBuffer = []
-            for b in range(packetHeader.m_payloadSize):
-                self.__readBuffer.append(self.__debugPort.receive())
+            # The packet is copied out of the stream buffer once, as the stream buffer is compacted below
+            packetBytes = bytes(buffer[:packetSize])
+            del buffer[:packetSize]
+            payload = memoryview(packetBytes)[headerSize:]
 
             # 5. validate payload checksum against received checksum
-            payloadChecksum = self.calculateChecksum(b''.join(self.__readBuffer))
+            payloadChecksum = self.calculateChecksum(payload)
             if payloadChecksum != packetHeader.m_packetPayloadChecksum:
                 #TODO: raise an exception here
                 print("PACKET FRAMING PAYLOAD CHECKSUM FAILURE: {} != {}".format(payloadChecksum, packetHeader.m_packetPayloadChecksum))
-            
-            # 6. put packet in the receiving queue
-            packet = self._buildPacket(b''.join(self.__readBuffer), packetHeader)
-            self.__packetQueue.append(packet)
+                if self.__reliable:
+                    # the target sends it again
+                    self._packetLost()
+                    continue
 
-    def _buildPacket(self, payload: bytes, packetHeader=None):
+            # 6. capture the raw packet (if enabled), and put packet (or each record of a batch) in the receiving queue
+            self._receivePacket(packetHeader, packetBytes, payload, receiveTimeNs)
+
+    def _parseCobsReadBuffer(self, receiveTimeNs):
+        """
+        Frame COBS packets out of the stream buffer.  Each complete frame (everything up to a delimiter) is
+        decoded, and its header, size and payload validated before the packet is put in the receiving queue.
+        A frame that fails any check is dropped; the next frame starts right after its delimiter.
+        An incomplete frame is left in the stream buffer until more data arrives.
+        @param receiveTimeNs: host time the data was read, given to every packet completed by this read
         """
-        Helper function for incoming and outgoing packet assembly, combines header and payload
-        @param payload: the outgoing data in bytes
-        @param packetHeader: header to be used - reception should supply this argument while transmission 
-        should omit it
+        buffer = self.__readBuffer
+        headerSize = self.PAYLOAD_HEADER_SIZE_BYTES
+        delimiter = cefContract.DEBUG_PORT_COBS_DELIMITER
+
+        frameStart = 0
+        while True:
+            frameEnd = buffer.find(delimiter, frameStart)
+            if frameEnd < 0:
+                break
+            frame = memoryview(buffer)[frameStart:frameEnd]
+            frameStart = frameEnd + 1
+            if len(frame) == 0:
+                continue
+
+            try:
+                packetBytes = cobsDecode(frame)
+            except ValueError as e:
+                print("PACKET FRAMING COBS INVALID: {}".format(e))
+                self._packetLost()
+                continue
+            finally:
+                frame.release()
+
+            if len(packetBytes) < headerSize:
+                print("PACKET FRAMING TOO SHORT FOR HEADER: {} bytes".format(len(packetBytes)))
+                self._packetLost()
+                continue
+            packetHeader = DebugPortHeader._make(self.__headerStruct.unpack_from(packetBytes, 0))
+
+            headerChecksum = self.calculateChecksum(memoryview(packetBytes)[:headerSize - 2])
+            if headerChecksum != packetHeader.m_packetHeaderChecksum:
+                print("PACKET FRAMING HEADER CHECKSUM FAILURE: {} != {}".format(headerChecksum, packetHeader.m_packetHeaderChecksum))
+                self._packetLost()
+                continue
+
+            if len(packetBytes) != headerSize + packetHeader.m_payloadSize:
+                print("PACKET FRAMING SIZE MISMATCH: {} != {}".format(len(packetBytes), headerSize + packetHeader.m_payloadSize))
+                self._packetLost()
+                continue
+
+            payload = memoryview(packetBytes)[headerSize:]
+            payloadChecksum = self.calculateChecksum(payload)
+            if payloadChecksum != packetHeader.m_packetPayloadChecksum:
+                print("PACKET FRAMING PAYLOAD CHECKSUM FAILURE: {} != {}".format(payloadChecksum, packetHeader.m_packetPayloadChecksum))
+                self._packetLost()
+                continue
+
+            self._receivePacket(packetHeader, packetBytes, payload, receiveTimeNs)
+
+        del buffer[:frameStart]
+        # A frame can't be longer than the largest packet, anything longer has lost its delimiter
+        if len(buffer) > cefContract.DEBUG_PORT_MAX_FRAME_SIZE_BYTES:
+            del buffer[:]
+
+    def _receivePacket(self, packetHeader, packetBytes, payload, receiveTimeNs):
+        """
+        Hand a valid packet to reliable delivery (if enabled), else queue it
+        """
+        if self.__reliable:
+            self._receiveReliable(packetHeader, packetBytes, payload, receiveTimeNs)
+        else:
+            self._queuePacket(packetHeader, packetBytes, payload, receiveTimeNs)
+
+    def _packetLost(self):
+        """
+        A corrupted packet was dropped; with reliable delivery, the target is asked to send it again right away
+        """
+        if self.__reliable:
+            with self.__reliableLock:
+                self.__nackPending = True
+
+    def _receiveReliable(self, packetHeader, packetBytes, payload, receiveTimeNs):
+        """
+        Handle the acks in a packet's reliable header, and queue its payload (without the reliable header) if it is
+        the next data packet, along with any packets received after it that were waiting for it.  A packet received
+        after a missing one is kept, and the missing one is NACKed.
+        """
+        if len(payload) < _RELIABLE_HEADER_SIZE_BYTES:
+            print("PACKET TOO SHORT FOR RELIABLE HEADER: {} bytes".format(len(payload)))
+            self._packetLost()
+            return
+        reliableHeader = cefContract.cefReliableHeader.from_buffer_copy(payload)
+        windowSize = cefContract.DEBUG_PORT_RELIABLE_WINDOW_SIZE
+
+        with self.__reliableLock:
+            self._processAcks(reliableHeader)
+            if packetHeader.m_packetType == cefContract.debugPacketDataType.debugPacketType_ack.value:
+                return
+
+            sequenceNumber = reliableHeader.m_sequenceNumber
+            duplicate = ((self.__nextReceiveSequenceNumber - sequenceNumber - 1) & 0xff) < windowSize
+            if (reliableHeader.m_flags & cefContract.DEBUG_PORT_RELIABLE_FLAG_SYNC) and not duplicate:
+                # the target has (re)started, start expecting its sequence numbers
+                self.__nextReceiveSequenceNumber = sequenceNumber
+                self.__outOfOrderPackets.clear()
+
+            self.__numPacketsToAck += 1
+            if sequenceNumber != self.__nextReceiveSequenceNumber:
+                if not duplicate and ((sequenceNumber - self.__nextReceiveSequenceNumber) & 0xff) < windowSize:
+                    # a packet is missing, keep this one until it is retransmitted
+                    self.__outOfOrderPackets[sequenceNumber] = (packetHeader, packetBytes, payload, receiveTimeNs)
+                    self.__nackPending = True
+                return
+
+            readyPackets = [(packetHeader, packetBytes, payload, receiveTimeNs)]
+            self.__nextReceiveSequenceNumber = (sequenceNumber + 1) & 0xff
+            while self.__nextReceiveSequenceNumber in self.__outOfOrderPackets:
+                readyPackets.append(self.__outOfOrderPackets.pop(self.__nextReceiveSequenceNumber))
+                self.__nextReceiveSequenceNumber = (self.__nextReceiveSequenceNumber + 1) & 0xff
+            if self.__outOfOrderPackets:
+                # another packet is missing
+                self.__nackPending = True
+
+        for header, readyBytes, readyPayload, readyTimeNs in readyPackets:
+            applicationPayload = readyPayload[_RELIABLE_HEADER_SIZE_BYTES:]
+            header = header._replace(m_payloadSize=len(applicationPayload))
+            # the packet is captured as if it had been sent without the reliable header (the checksums are left as received)
+            readyBytes = self.__headerStruct.pack(*header) + bytes(applicationPayload)
+            self._queuePacket(header, readyBytes, applicationPayload, readyTimeNs)
+
+    def _processAcks(self, reliableHeader):
+        """
+        Release the commands the target has acknowledged, and retransmit one it NACKed
+        (called with the reliable delivery lock held)
+        """
+        if self.__unackedPackets:
+            oldestUnacked = next(iter(self.__unackedPackets))
+            numAcked = (reliableHeader.m_ackSequenceNumber - oldestUnacked) & 0xff
+            # acks are cumulative; one for a packet that isn't outstanding is from before a restart, so is ignored
+            if 0 < numAcked <= len(self.__unackedPackets):
+                for i in range(numAcked):
+                    self.__unackedPackets.popitem(last=False)
+                self.__transmitSynchronized = True
+                self.__reliableLock.notify_all()
+
+        # the target NACKs each corrupted or out of order packet, so a command can be retransmitted more than once
+        # (the target acks the duplicates)
+        nackSequenceNumber = reliableHeader.m_nackSequenceNumber
+        if (reliableHeader.m_flags & cefContract.DEBUG_PORT_RELIABLE_FLAG_NACK) and nackSequenceNumber in self.__unackedPackets:
+            self.numRetransmits += 1
+            self._sendReliable(nackSequenceNumber)
+
+    def _sendReliable(self, sequenceNumber):
+        """
+        Send (or send again) an unacknowledged data packet, with the current acks (called with the reliable delivery lock held)
+        """
+        unackedPacket = self.__unackedPackets[sequenceNumber]
+        payload, packetType, _ = unackedPacket
+        flags = 0
+        if not self.__transmitSynchronized and sequenceNumber == 0:
+            flags = cefContract.DEBUG_PORT_RELIABLE_FLAG_SYNC
+        unackedPacket[2] = time.monotonic()
+        self.__debugPort.send(self._buildPacket(self._buildReliableHeader(sequenceNumber, flags) + payload, packetType))
+
+    def _sendPendingAck(self, urgentOnly=False):
+        """
+        Tell the target what has been received (an ack packet), if anything has been received since the last one
+        @param urgentOnly: only send it if a packet needs to be NACKed, or half a window is waiting to be acknowledged
+        """
+        with self.__reliableLock:
+            if urgentOnly:
+                if not self.__nackPending and self.__numPacketsToAck < cefContract.DEBUG_PORT_RELIABLE_WINDOW_SIZE // 2:
+                    return
+            elif self.__numPacketsToAck == 0 and not self.__nackPending:
+                return
+            self.__debugPort.send(self._buildPacket(self._buildReliableHeader(0, 0),
+                                                    cefContract.debugPacketDataType.debugPacketType_ack.value))
+
+    def _buildReliableHeader(self, sequenceNumber, flags):
+        """
+        Build a cefReliableHeader carrying the current acks, and clear the pending ack
+        (called with the reliable delivery lock held)
+        @return: the header in bytes
+        """
+        reliableHeader = cefContract.cefReliableHeader()
+        reliableHeader.m_sequenceNumber = sequenceNumber
+        reliableHeader.m_ackSequenceNumber = self.__nextReceiveSequenceNumber
+        reliableHeader.m_nackSequenceNumber = self.__nextReceiveSequenceNumber
+        reliableHeader.m_flags = flags | (cefContract.DEBUG_PORT_RELIABLE_FLAG_NACK if self.__nackPending else 0)
+        self.__numPacketsToAck = 0
+        self.__nackPending = False
+        return bytes(reliableHeader)
+
+    def _retransmitLoop(self):
+        """
+        Forever loop retransmitting the oldest unacknowledged command once DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS
+        passes without the target acknowledging it, and acknowledging what was received since the last ack
+        """
+        timeout = cefContract.DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS / 1000
+        while(True):
+            time.sleep(timeout / 10)
+            self._retransmitOldest(timeout)
+            self._sendPendingAck()
+
+    def _retransmitOldest(self, timeout):
+        """
+        Retransmit the oldest unacknowledged command if it was last sent at least timeout seconds ago
+        """
+        with self.__reliableLock:
+            if self.__unackedPackets:
+                oldestUnacked = next(iter(self.__unackedPackets))
+                if time.monotonic() - self.__unackedPackets[oldestUnacked][2] >= timeout:
+                    self.numRetransmits += 1
+                    self._sendReliable(oldestUnacked)
+
+    def _queuePacket(self, packetHeader, packetBytes, payload, receiveTimeNs):
+        """
+        Capture the raw packet (if enabled), and put the packet (or each record of a batch) in the receiving queue.
+        The packet's flow control credits are recorded; flow control packets carry nothing else, so are not queued.
+        @param packetHeader: decoded DebugPortHeader of the packet
+        @param packetBytes: the packet (header and payload)
+        @param payload: memoryview of the packet's payload
+        @param receiveTimeNs: host time the packet was read
+        """
+        if self.__captureWriter is not None:
+            self.__captureWriter.writePacket(packetBytes, receiveTimeNs)
+        self.__flowControlCredits = packetHeader.m_flowControlCredits
+        if packetHeader.m_packetType == cefContract.debugPacketDataType.debugPacketType_flowControl.value:
+            return
+        if packetHeader.m_packetType == cefContract.debugPacketDataType.debugPacketType_batch.value:
+            try:
+                records = unbatch(payload)
+            except ValueError as e:
+                print("PACKET BATCH INVALID: {}".format(e))
+                return
+            for recordType, record in records:
+                recordHeader = packetHeader._replace(m_packetType=recordType, m_payloadSize=len(record))
+                self.__packetQueue.append(CefPacket(recordHeader, record, receiveTimeNs))
+        else:
+            self.__packetQueue.append(CefPacket(packetHeader, payload, receiveTimeNs))
+
+    def _buildPacket(self, payload: bytes, packetType=cefContract.debugPacketDataType.debugPacketType_commandRequest.value):
+        """
+        Helper function for outgoing packet assembly, combines header and payload
+        @param payload: the outgoing data in bytes (including the reliable header with reliable delivery)
+        @param packetType: debugPacketDataType of the packet (commands, or acks with reliable delivery)
         @return packet: the final, full packet with header and payload and associated checksums
         """
-        assert(len(payload) <= self.PAYLOAD_MAX_SIZE_BYTES)
-
-        if packetHeader is None:
-            packetHeader = cefContract.cefCommandDebugPortHeader()
-            packetHeader.m_framingSignature = (ctypes.c_uint8 * len(cefContract.debugPacketFramingSignature))(*cefContract.debugPacketFramingSignature)
-            packetHeader.m_packetPayloadChecksum = self.calculateChecksum(payload)
-            packetHeader.m_payloadSize = len(payload)
-            packetHeader.m_packetType = cefContract.debugPacketDataType.debugPacketType_commandRequest.value # Outgoing packets are always this type
-            packetHeader.m_reserve = 0
-            tmpChecksum = self.calculateChecksum(bytes(packetHeader))
-            packetHeader.m_packetHeaderChecksum = tmpChecksum
-
-        # defer structure definitions until now because the payload field size is variable
-        class CefPayload(ctypes.Structure):
-            # _pack_ = 1 # uncomment and edit this value if there are boundary alignment issues        
-            _fields_ = [('bytes', ctypes.c_byte * packetHeader.m_payloadSize)]
-
-        class CefPacket(ctypes.Structure):
-            # _pack_ = 1 # uncomment and edit this value if there are boundary alignment issues
-            _fields_ = [('header', cefContract.cefCommandDebugPortHeader), ('payload', CefPayload)]
-
-        packetPayload  = CefPayload()
-        packet = CefPacket()
-
-        # populate the fields
-        ctypes.memmove(packetPayload.bytes, payload, packetHeader.m_payloadSize)
-        
-        packet.header = packetHeader
-        packet.payload = packetPayload
+        assert(len(payload) <= self.PAYLOAD_MAX_SIZE_BYTES + self.__reliableHeaderSize)
+
+        headerFields = [self.FRAMING_SIGNATURE,
+                        self.calculateChecksum(payload),
+                        len(payload),
+                        packetType,
+                        0,  # m_flowControlCredits (the target does not flow control the host)
+                        0]  # m_packetHeaderChecksum is zero while the header checksum is calculated
+        headerFields[-1] = self.calculateChecksum(self.__headerStruct.pack(*headerFields))
+
+        packet = self.__headerStruct.pack(*headerFields) + bytes(payload)
+        if self.__cobsFraming:
+            return cobsEncode(packet) + bytes([cefContract.DEBUG_PORT_COBS_DELIMITER])
         return packet
@@ -74,6 +74,16 @@ enum
     errorCode_debugPortTransportPacketHeaderChecksumMismatch = 22,
     errorCode_debugPortTransportPayloadChecksumMismatch = 23,
     errorCode_debugPortTransportBufferNotBigEnoughForPayload = 24,
+    errorCode_CmdSetLogThresholdInvalidModuleId     = 25,
+    errorCode_CmdSetLogThresholdInvalidLogType      = 26,
+    errorCode_debugPortTransportFramingError        = 27,
+    errorCode_CmdFragmentOutOfOrder                 = 28,
+    errorCode_CmdFragmentInvalidSize                = 29,
+    errorCode_CmdMemoryAccessInvalidSize            = 30,
+    errorCode_debugPortTransportReceiveTimeout      = 31,
+    errorCode_CmdTelemetryInvalidChannel            = 32,
+    errorCode_CmdSoftwareScopeInvalidEntry          = 33,
+    errorCode_CmdMemoryAccessInvalidAddress         = 34,
 
 
     errorCode_NumApplicationErrorCodes, // Must be last entry for error checking
@@ -100,6 +110,14 @@ enum
     commandOpCodePing                           = 1,
     commandOpCodeDebugPortRouter                = 2,
     commandOpCodeCefCommandProxy                = 3,
+    commandOpCodeSetLogThreshold                = 4,
+    commandOpCodeTimeSync                       = 5,
+    commandOpCodeFragmentLoopback               = 6,
+    commandOpCodeMemoryRead                     = 7,
+    commandOpCodeMemoryWrite                    = 8,
+    commandOpCodeDebugPortStats                 = 9,
+    commandOpCodeTelemetry                      = 10,
+    commandOpCodeSoftwareScope                  = 11,
 
 
     maxCommandOpCodeNumber, // Must be last, except for 'invalid'
@@ -159,11 +177,40 @@ enum debugPacketDataType_t : uint8_t
     debugPacketType_commandRequest = 0,
     debugPacketType_commandResponse = 1,
     debugPacketType_loggingData = 2,
+    debugPacketType_loggingDataPacked = 3,
+    debugPacketType_batch = 4,
+    debugPacketType_flowControl = 5,        // No payload, only advertises flow control credits (see Flow Control Credits)
+    debugPacketType_ack = 6,                // Only a cefReliableHeader_t, acknowledges packets (see Reliable Delivery)
+    debugPacketType_bulkData = 7,           // A cefBulkDataHeader_t followed by data (see Memory Read and Write)
+    debugPacketType_event = 8,              // One or more events, each a cefEventHeader_t followed by its data (see Events)
+    debugPacketType_telemetry = 9,          // A cefTelemetryFrameHeader_t followed by samples (see Telemetry)
 
     // Must be last entry
     debugPacketType_invalid = 0xff
 };
 
+/**
+ * Debug Port Channels - packets sent by the embedded sw are scheduled over virtual channels.  Each channel has its
+ * own queue and a configurable share of the debug port bandwidth (deficit round robin), so one type of traffic
+ * can't starve another (e.g. a bulk transfer can't hold up command responses).  The packet type determines the channel:
+ * - commands:  debugPacketType_commandResponse (and batches with a command response)
+ * - logs:      debugPacketType_loggingData, debugPacketType_loggingDataPacked (and batches of logs)
+ * - bulk transfer: debugPacketType_bulkData
+ * - events:    debugPacketType_event
+ * - telemetry:  debugPacketType_telemetry
+ */
+enum debugPortChannel_t : uint8_t
+{
+    debugPortChannel_commands = 0,
+    debugPortChannel_logs = 1,
+    debugPortChannel_telemetry = 2,
+    debugPortChannel_bulkTransfer = 3,
+    debugPortChannel_events = 4,
+
+    // Must be last entry
+    debugPortChannel_numChannels
+};
+
 /**
  * CEF Command Header
  * Each Request and Receive command has a common header associated with it.
@@ -211,7 +258,7 @@ typedef struct
 
     //! The types of packets are defined in debugPacketDataType_t
     uint8_t m_packetType;				    //40 bit aligned
-    uint8_t m_reserve;					    //48 bit aligned
+    uint8_t m_flowControlCredits;		    //See Flow Control Credits (0 from Python), 48 bit aligned
     uint16_t m_packetHeaderChecksum;		//checksum over the header only, 64 bit aligned
 } cefCommandDebugPortHeader_t;
 
@@ -258,6 +305,337 @@ typedef struct
     uint64_t m_uint64Value;					// 64 bit aligned
 } cefCommandPingResponse_t;
 
+/**
+ * CommandTimeSync
+ *		See command implementation files for variable documentation
+ *
+ * NTP style time transfer: Python stamps the request with its transmit time (t0), the target stamps the response
+ * with the time it received the request (t1) and the time it sent the response (t2), and Python stamps the
+ * response with the time it received it (t3).  Target times are ShimBase::getTimeNs() nanoseconds.
+ *      round trip time = (t3 - t0) - (t2 - t1)
+ *      target to host clock offset = ((t0 - t1) + (t3 - t2)) / 2, +/- round trip time / 2
+ */
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint64_t m_hostTransmitTimeNs;			// 64 bit aligned
+} cefCommandTimeSyncRequest_t;
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint64_t m_hostTransmitTimeNs;			// 64 bit aligned
+    uint64_t m_targetReceiveTimeNs;			// 64 bit aligned
+    uint64_t m_targetTransmitTimeNs;		// 64 bit aligned
+} cefCommandTimeSyncResponse_t;
+
+/**
+ * Fragmented Commands
+ * A command whose request or response data does not fit in one packet sends it as a series of fragments.  Each
+ * fragment is a request/response pair of the command's opcode, so flow control, reliable delivery, and the size of
+ * the command buffers are unchanged, and the embedded sw processes the data a fragment at a time instead of needing
+ * all of it resident:
+ * - Each request and response is a cefCommandFragment_t with m_fragment.m_numBytes of m_data (m_commandNumBytes
+ *   only counts the data sent).
+ * - Python sends the request data in order.  The first fragment has CEF_FRAGMENT_FLAG_FIRST set (which ends any
+ *   transfer of the command in progress), and every fragment has the same m_totalNumBytes.  Once all of the request
+ *   data is sent, Python sends fragments with no data until a response has CEF_FRAGMENT_FLAG_LAST set.
+ * - Each response has the next response data the command has (possibly none), in order.  The response with
+ *   CEF_FRAGMENT_FLAG_LAST set ends the transfer.
+ * - A fragment out of order, or an error, ends the transfer (the response has the error code, and may only be a
+ *   cefCommandHeader_t).
+ * - The embedded sw keeps one transfer in progress; allocating another command may end it.
+ * A response's data is written over the request's data, so a command must be done with a fragment's request data
+ * before it adds response data.
+ */
+#define CEF_FRAGMENT_FLAG_FIRST 0x01
+#define CEF_FRAGMENT_FLAG_LAST  0x02
+
+typedef struct
+{
+    uint32_t m_totalNumBytes;				// Of all the data sent in this direction, 32 bit aligned
+    uint32_t m_offset;						// Of this fragment's data within all the data, 64 bit aligned
+    uint32_t m_numBytes;					// Of data in this fragment, 32 bit aligned
+    uint8_t m_flags;						// CEF_FRAGMENT_FLAG_xxx, 40 bit aligned
+    uint8_t m_padding1;						// 48 bit aligned
+    uint16_t m_padding2;					// 64 bit aligned
+} cefFragmentHeader_t;
+
+//! Maximum number of bytes in a command request or response, not including the cefCommandHeader_t
+#define CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER 512
+#define CEF_FRAGMENT_MAX_DATA_BYTES (CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER - sizeof(cefFragmentHeader_t))
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    cefFragmentHeader_t m_fragment;			// 64 bit aligned
+    uint8_t m_data[CEF_FRAGMENT_MAX_DATA_BYTES];	// Only m_fragment.m_numBytes are sent
+} cefCommandFragment_t;
+
+//! Number of bytes in a fragment request or response before its data
+#define CEF_FRAGMENT_HEADERS_NUM_BYTES (sizeof(cefCommandHeader_t) + sizeof(cefFragmentHeader_t))
+
+/**
+ * Memory Read and Write (CommandMemoryRead, CommandMemoryWrite)
+ *		See command implementation files for variable documentation
+ *
+ * A memory read streams an address range to Python without a round trip per packet: the response only accepts
+ * the read, and the embedded sw then sends the data from a cursor in debugPacketType_bulkData packets on the bulk
+ * transfer channel, as fast as the debug port takes them.  Each bulk data packet is a cefBulkDataHeader_t followed
+ * by the next data of the read; the read is done once m_numBytes have been sent.  A new read ends a read in
+ * progress, and a read of 0 bytes only ends it.  The memory is read as the packets are built.
+ *
+ * A memory write is a single command with the address and its data (m_commandNumBytes only counts the data sent),
+ * so Python writes a range with as many commands as it takes.
+ * An address range that doesn't fit in the target's address space (or wraps around its end) is rejected with
+ * errorCode_CmdMemoryAccessInvalidAddress.  Caution:  otherwise the addresses are not checked, an address the target
+ * can't access faults the target.
+ */
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint64_t m_address;						// 64 bit aligned
+    uint32_t m_numBytes;					// 32 bit aligned
+    uint32_t m_transferId;					// 64 bit aligned, chosen by Python, sent in each bulk data packet
+} cefCommandMemoryReadRequest_t;
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint32_t m_numBytes;					// 32 bit aligned
+    uint32_t m_transferId;					// 64 bit aligned
+} cefCommandMemoryReadResponse_t;
+
+typedef struct
+{
+    uint32_t m_transferId;					// 32 bit aligned
+    uint32_t m_offset;						// 64 bit aligned, of the packet's data within the read
+} cefBulkDataHeader_t;
+
+#define CEF_MEMORY_WRITE_MAX_DATA_BYTES (CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER - 16)
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint64_t m_address;						// 64 bit aligned
+    uint32_t m_numBytes;					// 32 bit aligned
+    uint32_t m_padding1;					// 64 bit aligned
+    uint8_t m_data[CEF_MEMORY_WRITE_MAX_DATA_BYTES];	// Only m_numBytes are sent
+} cefCommandMemoryWriteRequest_t;
+
+//! Number of bytes in a memory write request before its data
+#define CEF_MEMORY_WRITE_HEADERS_NUM_BYTES (sizeof(cefCommandMemoryWriteRequest_t) - CEF_MEMORY_WRITE_MAX_DATA_BYTES)
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint32_t m_numBytes;					// 32 bit aligned
+    uint32_t m_padding1;					// 64 bit aligned
+} cefCommandMemoryWriteResponse_t;
+
+/**
+ * CommandDebugPortStats
+ *		See command implementation files for variable documentation
+ *
+ * Debug port error counts since the target started, for checking how the link is doing and that the target
+ * recovers from errors.  The receive errors are the classes of errors a UART reports (each one drops the packet
+ * being received, see m_numReceiveErrorPacketsDropped).
+ */
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+} cefCommandDebugPortStatsRequest_t;
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint32_t m_numParityErrors;				// 32 bit aligned
+    uint32_t m_numNoiseErrors;				// 64 bit aligned
+    uint32_t m_numFramingErrors;			// 32 bit aligned
+    uint32_t m_numOverrunErrors;			// 64 bit aligned
+    uint32_t m_numOtherErrors;				// 32 bit aligned
+    uint32_t m_numReceiveErrorPacketsDropped;	// 64 bit aligned
+    uint32_t m_numReceiveTimeouts;			// 32 bit aligned
+    uint32_t m_numTransmitTimeouts;			// 64 bit aligned
+} cefCommandDebugPortStatsResponse_t;
+
+/**
+ * Events (debugPacketType_event)
+ *
+ * Events tell Python that something happened on the embedded sw (a command finished in the background, a threshold
+ * was crossed, a buffer was freed) as soon as it happens, so Python doesn't have to poll for it with commands.  They
+ * are raised with EventQueue::raiseEvent() (from the main loop or from interrupts) and sent on the events channel.
+ * An event packet holds as many events as fit, each a cefEventHeader_t followed by m_numDataBytes of data, padded to
+ * a multiple of 8 bytes.  An event raised while the queue is full is dropped, which shows as a gap in
+ * m_eventSequenceNumber.
+ */
+enum eventId_t : uint16_t
+{
+    eventId_memoryReadDone = 1,             // A memory read has sent all of its data (cefEventMemoryReadDone_t)
+
+    // Event ids from here on are for the application's own events
+    eventId_firstApplicationEvent = 0x100
+};
+
+typedef struct
+{
+    uint16_t m_eventId;						// 16 bit aligned, eventId_t
+    uint16_t m_numDataBytes;				// 32 bit aligned, bytes of data after the header (not counting padding)
+    uint32_t m_eventSequenceNumber;			// 64 bit aligned, counts every event raised (including dropped ones)
+    uint64_t m_timeStamp;					// 64 bit aligned, time the event was raised (ns, see ShimBase::getTimeNs())
+} cefEventHeader_t;
+
+//! Max number of bytes of data an event can have
+#define CEF_EVENT_MAX_DATA_BYTES 32
+
+typedef struct
+{
+    uint32_t m_transferId;					// 32 bit aligned, of the memory read
+    uint32_t m_numBytes;					// 64 bit aligned, number of bytes sent
+} cefEventMemoryReadDone_t;
+
+/**
+ * Telemetry (CommandTelemetry, debugPacketType_telemetry)
+ *		See command implementation files for variable documentation
+ *
+ * Variables of the embedded sw (loop times, queue depths, sensor values) are streamed to Python at fixed rates,
+ * without a command round trip per sample.  The application registers each variable as a telemetry channel (name,
+ * telemetryType_t, decimation) with TelemetryStream.  Each call of TelemetryStream::sample() is a tick (from the
+ * main loop, or from a timer interrupt for a steady rate), and a channel is sampled on the ticks that are a multiple
+ * of its decimation.  Samples go into a frame that is sent when it is full (or TELEMETRY_MAX_FRAME_LATENCY_MS after
+ * its first tick) on the telemetry channel, while the next frame is filled.
+ *
+ * A frame is a cefTelemetryFrameHeader_t followed by the samples of each tick in turn: the value of every channel
+ * due on the tick, in channel index order, at its natural size and without padding.  So Python works out which
+ * channels are in each tick from m_firstTick and the channel decimations, which it reads with CommandTelemetry.
+ * CommandTelemetry also changes a channel's decimation (0 turns the channel off) and starts or stops the stream;
+ * each change starts a new frame with the next m_configurationNumber.  A frame that could not be sent before the
+ * next one was full is dropped, which shows as a gap in m_frameSequenceNumber.
+ */
+enum telemetryType_t : uint8_t
+{
+    telemetryType_uint8 = 0,
+    telemetryType_int8 = 1,
+    telemetryType_uint16 = 2,
+    telemetryType_int16 = 3,
+    telemetryType_uint32 = 4,
+    telemetryType_int32 = 5,
+    telemetryType_uint64 = 6,
+    telemetryType_int64 = 7,
+    telemetryType_float32 = 8,
+    telemetryType_float64 = 9,
+
+    telemetryType_numTypes
+};
+
+enum telemetryControl_t : uint8_t
+{
+    telemetryControl_none = 0,              // Leave the stream as it is
+    telemetryControl_start = 1,
+    telemetryControl_stop = 2
+};
+
+//! Maximum number of telemetry channels, and bytes in a channel name (including the terminating 0)
+#define TELEMETRY_MAX_NUM_CHANNELS 16
+#define TELEMETRY_CHANNEL_NAME_NUM_BYTES 24
+
+//! m_decimation of a CommandTelemetry request that leaves the channel's decimation as it is
+#define TELEMETRY_DECIMATION_UNCHANGED 0xFFFF
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint16_t m_channelIndex;				// 16 bit aligned
+    uint16_t m_decimation;					// 32 bit aligned, or TELEMETRY_DECIMATION_UNCHANGED
+    uint8_t m_control;						// 40 bit aligned, telemetryControl_t
+    uint8_t m_padding1;						// 48 bit aligned
+    uint16_t m_padding2;					// 64 bit aligned
+} cefCommandTelemetryRequest_t;
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint16_t m_numChannels;					// 16 bit aligned, registered channels
+    uint16_t m_channelIndex;				// 32 bit aligned
+    uint16_t m_decimation;					// 48 bit aligned, 0 if the channel is off
+    uint8_t m_type;							// 56 bit aligned, telemetryType_t
+    uint8_t m_streaming;					// 64 bit aligned, 1 if the stream is started
+    uint16_t m_configurationNumber;			// 16 bit aligned, of the frames sent from now on
+    uint16_t m_padding1;					// 32 bit aligned
+    uint32_t m_padding2;					// 64 bit aligned
+    char m_name[TELEMETRY_CHANNEL_NAME_NUM_BYTES];	// 64 bit aligned
+} cefCommandTelemetryResponse_t;
+
+typedef struct
+{
+    uint64_t m_firstTickTimeStamp;			// 64 bit aligned, time of the frame's first tick (ns)
+    uint64_t m_lastTickTimeStamp;			// 64 bit aligned, time of the frame's last tick (ns)
+    uint32_t m_frameSequenceNumber;			// 32 bit aligned
+    uint32_t m_firstTick;					// 64 bit aligned, tick number of the frame's first tick
+    uint16_t m_numTicks;					// 16 bit aligned, ticks in the frame
+    uint16_t m_configurationNumber;			// 32 bit aligned
+    uint32_t m_padding1;					// 64 bit aligned
+} cefTelemetryFrameHeader_t;
+
+/**
+ * Software Scope (CommandSoftwareScope)
+ *		See command implementation files for variable documentation
+ *
+ * Python reads the address and type of global variables from the embedded sw's ELF file (symbol table and DWARF
+ * debug info, see ElfSymbols.py), and uploads them as a sampling list.  Each entry is added to the telemetry
+ * channels as an address channel, sampled every m_decimation ticks like any other telemetry channel, so any variable
+ * can be watched at telemetry rates without rebuilding the embedded sw.  The frames are decoded like any telemetry.
+ * m_commandNumBytes only counts the entries sent.  With m_replace, the address channels uploaded before are removed.
+ * Each address has to be aligned, fit in the target's address space, and be readable memory as far as the platform
+ * can tell (ShimBase::isAddressRangeReadable(), which accepts any address on the simulator).
+ */
+//! Maximum number of address channels, and of entries in a Software Scope request
+#define TELEMETRY_MAX_NUM_ADDRESS_CHANNELS 8
+
+typedef struct
+{
+    uint64_t m_address;						// 64 bit aligned, must be aligned to the size of m_type
+    uint16_t m_decimation;					// 16 bit aligned, 0 adds the channel turned off
+    uint8_t m_type;							// 24 bit aligned, telemetryType_t
+    uint8_t m_padding1;						// 32 bit aligned
+    uint32_t m_padding2;					// 64 bit aligned
+    char m_name[TELEMETRY_CHANNEL_NAME_NUM_BYTES];	// 64 bit aligned, name of the channel (e.g. the variable's name)
+} cefSoftwareScopeEntry_t;
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint8_t m_numEntries;					// 8 bit aligned
+    uint8_t m_replace;						// 16 bit aligned, 1 to remove the address channels uploaded before
+    uint16_t m_padding1;					// 32 bit aligned
+    uint32_t m_padding2;					// 64 bit aligned
+    cefSoftwareScopeEntry_t m_entries[TELEMETRY_MAX_NUM_ADDRESS_CHANNELS];	// Only m_numEntries are sent
+} cefCommandSoftwareScopeRequest_t;
+
+//! Number of bytes in a Software Scope request before its entries
+#define CEF_SOFTWARE_SCOPE_HEADERS_NUM_BYTES (sizeof(cefCommandHeader_t) + 8)
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint16_t m_numChannels;					// 16 bit aligned, telemetry channels, including the address channels
+    uint16_t m_numAddressChannels;			// 32 bit aligned
+    uint16_t m_configurationNumber;			// 48 bit aligned
+    uint16_t m_padding1;					// 64 bit aligned
+} cefCommandSoftwareScopeResponse_t;
+
 /*********************************************************************************************************************/
 /******  LOGGING                                                                                                ******/
 /*********************************************************************************************************************/
@@ -277,6 +655,34 @@ typedef enum logType
 // Converts logging uint64_t nano second value/count into seconds
 #define LOGGING_UINT64_NSEC_TO_SECONDS 1000000000LLU
 
+// Module id used in logging commands to address every logging module at once
+#define LOGGING_MODULE_ID_ALL_MODULES 0xFF
+
+/**
+ * CommandSetLogThreshold
+ *		See command implementation files for variable documentation
+ */
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint8_t m_moduleId;						// 8  bit aligned
+    uint8_t m_logThreshold;					// 16 bit aligned
+    uint16_t m_padding1;					// 32 bit aligned
+    uint32_t m_padding2;					// 64 bit aligned
+} cefCommandSetLogThresholdRequest_t;
+
+typedef struct
+{
+    cefCommandHeader_t m_header;			// Must be 1st entry in structure, guaranteed to be 64 bit aligned
+
+    uint8_t m_moduleId;						// 8  bit aligned
+    uint8_t m_previousLogThreshold;			// 16 bit aligned
+    uint8_t m_numLogModules;				// 24 bit aligned
+    uint8_t m_padding1;						// 32 bit aligned
+    uint32_t m_padding2;					// 64 bit aligned
+} cefCommandSetLogThresholdResponse_t;
+
 
 /**
  * Logging Structures.  For now, a display string is passed that python uses to display the variables.
@@ -314,9 +720,100 @@ typedef struct
     //! Type of log message
     uint8_t m_logType;               // 64 bit aligned
 
+    //! Number of logs from the same call site that were rate limited or coalesced since its previous log
+    uint32_t m_numSuppressedLogs;    // 32 bit aligned
+    uint32_t m_padding1;             // 64 bit aligned
+
 } cefLog_t;
 
 
+/**
+ * Packed Logging Format (debugPacketType_loggingDataPacked)
+ * The payload is one or more packed log records back to back (there is no cefCommandHeader_t).  Each record is
+ *      uint8_t  flags                  LOG_PACKED_FLAG_xxx
+ *      uint8_t  logType
+ *      uint8_t  moduleId
+ *      varint   logSequenceNumber
+ *      varint   timeStamp              zig-zag delta from the previous record in the packet, or absolute
+ *                                      (not zig-zag) if LOG_PACKED_FLAG_ABSOLUTE_TIMESTAMP is set (always set for the 1st record)
+ *      varint   logVariable[n]         zig-zag (of the int64_t value); n is (flags & LOG_PACKED_FLAGS_NUM_VARIABLES_MASK).
+ *                                      Trailing zero variables are not sent.
+ *      varint   fileLineNumber
+ *      varint   numSuppressedLogs      only if LOG_PACKED_FLAG_SUPPRESSED_LOGS is set
+ *      varint   logString length, followed by the logString characters (no null)
+ *      varint   fileName length, followed by the fileName characters (no null)
+ * A varint is an unsigned value sent 7 bits at a time, least significant bits first, with bit 7 set on all but the last byte.
+ * Zig-zag maps signed values to unsigned values so small negative values are small: (n << 1) ^ (n >> 63)
+ */
+#define LOG_PACKED_FLAGS_NUM_VARIABLES_MASK 0x03
+#define LOG_PACKED_FLAG_ABSOLUTE_TIMESTAMP  0x04
+#define LOG_PACKED_FLAG_SUPPRESSED_LOGS     0x08
+
+
+/**
+ * Batch Format (debugPacketType_batch)
+ * Several records, each of which could have been the payload of its own packet, sent in one packet to save the
+ * per packet header, checksums and inter packet gap.  The payload is a cefBatchHeader_t, followed by one
+ * cefBatchRecordTableEntry_t per record, followed by the records back to back in table order.
+ * Record types are debugPacketType_commandResponse, debugPacketType_loggingData, and debugPacketType_loggingDataPacked.
+ */
+#define DEBUG_PORT_BATCH_MAX_NUM_RECORDS 8
+
+typedef struct
+{
+    uint8_t m_numRecords;					// 8  bit aligned
+    uint8_t m_padding1;						// 16 bit aligned
+    uint16_t m_padding2;					// 32 bit aligned
+} cefBatchHeader_t;
+
+typedef struct
+{
+    uint8_t m_recordType;					// debugPacketDataType_t of the record, 8 bit aligned
+    uint8_t m_padding1;						// 16 bit aligned
+    uint16_t m_recordNumBytes;				// 32 bit aligned
+} cefBatchRecordTableEntry_t;
+
+/**
+ * Reliable Delivery
+ * When DEBUG_PORT_RELIABLE_DELIVERY is 1, every payload starts with a cefReliableHeader_t (included in the packet's
+ * m_payloadSize and payload checksum), and lost or corrupted packets are retransmitted in both directions:
+ * - Every packet but debugPacketType_ack is a data packet, numbered (modulo 256) in the order first sent.
+ * - Every packet acknowledges the data packets received from the other side (m_ackSequenceNumber, cumulative).
+ * - A sender has at most DEBUG_PORT_RELIABLE_WINDOW_SIZE data packets unacknowledged, and keeps a copy of each.
+ * - A receiver that gets a corrupted packet, or a data packet after a missing one, right away sends a NACK for the
+ *   missing packet (DEBUG_PORT_RELIABLE_FLAG_NACK), which is retransmitted right away.  A packet that is still not
+ *   acknowledged after DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS is retransmitted.
+ * - Python keeps the data packets received after a missing one, so only the missing one is retransmitted.  The
+ *   embedded sw drops them (Python has at most one command outstanding) and they are retransmitted too.
+ * - The first data packet sent after starting up has DEBUG_PORT_RELIABLE_FLAG_SYNC set, so the receiver starts
+ *   expecting the sender's sequence numbers (either side can restart without the other).
+ * - A packet type of debugPacketType_ack has no data after the cefReliableHeader_t, and is not numbered.
+ * When 0, there is no cefReliableHeader_t, and lost or corrupted packets are dropped.
+ * Python and the embedded sw must use the same setting.
+ */
+#ifndef DEBUG_PORT_RELIABLE_DELIVERY
+    #define DEBUG_PORT_RELIABLE_DELIVERY 0
+#endif
+#define DEBUG_PORT_RELIABLE_WINDOW_SIZE 4
+#ifndef DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS
+    #define DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS 250
+#endif
+#define DEBUG_PORT_RELIABLE_FLAG_NACK 0x01
+#define DEBUG_PORT_RELIABLE_FLAG_SYNC 0x02
+
+typedef struct
+{
+    uint8_t m_sequenceNumber;				// Of this packet (data packets only), 8 bit aligned
+    uint8_t m_ackSequenceNumber;			// Next data packet expected from the other side, 16 bit aligned
+    uint8_t m_flags;						// DEBUG_PORT_RELIABLE_FLAG_xxx, 24 bit aligned
+    uint8_t m_nackSequenceNumber;			// Data packet to retransmit (if DEBUG_PORT_RELIABLE_FLAG_NACK), 32 bit aligned
+    uint32_t m_padding1;					// Keeps the payload that follows 64 bit aligned
+} cefReliableHeader_t;
+
+//! Number of bytes the reliable delivery header adds to a payload
+#define DEBUG_PORT_RELIABLE_HEADER_SIZE_BYTES (DEBUG_PORT_RELIABLE_DELIVERY * sizeof(cefReliableHeader_t))
+
+
 /*********************************************************************************************************************/
 /******  Debug Port constants that rely on previously defined structures                                        ******/
 /*********************************************************************************************************************/
@@ -329,7 +826,7 @@ typedef struct
  * Caution:  DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND is used to size memory buffers, so be careful to not
  * make it too big...or to small or we won't be able to allocate commands.
  */
-#define DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND (sizeof(cefCommandHeader_t) + 512)
+#define DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND (sizeof(cefCommandHeader_t) + CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER)
 #define DEBUG_PORT_MAX_APPLICATION_PAYLOAD_LOG     (sizeof(cefLog_t))
 #define MAX_LOCAL(A,B)  (A > B ? A : B)
 #define DEBUG_PORT_MAX_APPLICATION_PAYLOAD  MAX_LOCAL(DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND, DEBUG_PORT_MAX_APPLICATION_PAYLOAD_LOG)
@@ -338,7 +835,50 @@ typedef struct
  * Debug Port Packet Size
  * Max number of bytes in a debug port packet
  */
-#define DEBUG_PORT_MAX_PACKET_SIZE_BYTES (sizeof(cefCommandDebugPortHeader_t) + DEBUG_PORT_MAX_APPLICATION_PAYLOAD)
+#define DEBUG_PORT_MAX_PACKET_SIZE_BYTES (sizeof(cefCommandDebugPortHeader_t) + DEBUG_PORT_RELIABLE_HEADER_SIZE_BYTES + \
+                                          DEBUG_PORT_MAX_APPLICATION_PAYLOAD)
+
+/**
+ * Debug Port Framing
+ * When DEBUG_PORT_FRAMING_COBS is 1, each packet (header and payload) is COBS (Consistent Overhead Byte Stuffing)
+ * encoded and followed by a DEBUG_PORT_COBS_DELIMITER byte.  The encoded packet never contains the delimiter, so a
+ * receiver that loses sync (e.g. due to a bit error) resynchronizes at the next delimiter instead of searching the
+ * data for the framing signature (which can also appear in a payload).  COBS adds 1 byte per 254 bytes, plus 1 byte.
+ * COBS doesn't make the link more tolerant of bit errors: a bit error that creates or removes a delimiter also loses
+ * the packet next to the corrupted one, so with random bit errors fewer packets get through than with the signature.
+ * When 0, packets are sent as is, and found by their framing signature.
+ * Python and the embedded sw must use the same framing.
+ */
+#ifndef DEBUG_PORT_FRAMING_COBS
+    #define DEBUG_PORT_FRAMING_COBS 0
+#endif
+#define DEBUG_PORT_COBS_DELIMITER 0x00
+#define DEBUG_PORT_COBS_MAX_ENCODED_SIZE_BYTES(numBytes) ((numBytes) + ((numBytes) / 254) + 1)
+
+/**
+ * Debug Port Frame Size
+ * Max number of bytes on the wire for a debug port packet (COBS encoded packet and delimiter)
+ */
+#define DEBUG_PORT_MAX_FRAME_SIZE_BYTES (DEBUG_PORT_COBS_MAX_ENCODED_SIZE_BYTES(DEBUG_PORT_MAX_PACKET_SIZE_BYTES) + 1)
+
+/**
+ * Flow Control Credits
+ * Every packet from the embedded sw advertises how much room it has in the header's m_flowControlCredits:
+ * - bits 0-3:  command credit limit.  The number of command packets the embedded sw has finished with (received
+ *              and freed the receive buffer of, including packets dropped due to errors) plus the number of free
+ *              command receive slots, modulo 16.  Python may have sent (limit - number of commands sent) more
+ *              commands.  The limit is a running count rather than a count of free slots, so a packet sent before
+ *              the embedded sw received a command does not make the command look like it was never sent.
+ * - bits 4-7:  number of free log entries (saturates at DEBUG_PORT_CREDITS_LOG_CAPACITY_MAX)
+ * When the command credit limit changes and there is nothing else to send, the embedded sw sends a
+ * debugPacketType_flowControl packet so Python does not have to wait for the next packet to learn about it.
+ * A command lost on the way (never framed by the embedded sw) is never counted, so Python resynchronizes its
+ * count when the command times out.
+ */
+#define DEBUG_PORT_NUM_COMMAND_RECEIVE_SLOTS 1
+#define DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK 0x0F
+#define DEBUG_PORT_CREDITS_LOG_CAPACITY_SHIFT 4
+#define DEBUG_PORT_CREDITS_LOG_CAPACITY_MAX 0x0F
 
 /**
  * This must be the last line in the shared structures section in order to
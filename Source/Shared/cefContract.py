@@ -69,6 +69,16 @@ class errorCode(Enum):
     errorCode_debugPortTransportPacketHeaderChecksumMismatch 					= 22
     errorCode_debugPortTransportPayloadChecksumMismatch 						= 23
     errorCode_debugPortTransportBufferNotBigEnoughForPayload 					= 24
+    errorCode_CmdSetLogThresholdInvalidModuleId                                 = 25
+    errorCode_CmdSetLogThresholdInvalidLogType                                  = 26
+    errorCode_debugPortTransportFramingError                                    = 27
+    errorCode_CmdFragmentOutOfOrder                                             = 28
+    errorCode_CmdFragmentInvalidSize                                            = 29
+    errorCode_CmdMemoryAccessInvalidSize                                        = 30
+    errorCode_debugPortTransportReceiveTimeout                                  = 31
+    errorCode_CmdTelemetryInvalidChannel                                        = 32
+    errorCode_CmdSoftwareScopeInvalidEntry                                      = 33
+    errorCode_CmdMemoryAccessInvalidAddress                                     = 34
 	    
     errorCode_NumApplicationErrorCodes                                          = auto()
 
@@ -89,6 +99,14 @@ class commandOpCode(Enum):
     commandOpCodePing               = 1
     commandOpCodeDebugPortRouter    = 2
     commandOpCodeCefCommandProxy    = 3
+    commandOpCodeSetLogThreshold    = 4
+    commandOpCodeTimeSync           = 5
+    commandOpCodeFragmentLoopback   = 6
+    commandOpCodeMemoryRead         = 7
+    commandOpCodeMemoryWrite        = 8
+    commandOpCodeDebugPortStats     = 9
+    commandOpCodeTelemetry          = 10
+    commandOpCodeSoftwareScope      = 11
 
     maxCommandOpCodeNumber          = auto()
     commandOpCodeInvalid            = 0xFFFF
@@ -135,10 +153,31 @@ class debugPacketDataType(Enum):
     debugPacketType_commandRequest                          = 0
     debugPacketType_commandResponse                         = 1
     debugPacketType_loggingData                             = 2
+    debugPacketType_loggingDataPacked                       = 3
+    debugPacketType_batch                                   = 4
+    debugPacketType_flowControl                             = 5
+    debugPacketType_ack                                     = 6
+    debugPacketType_bulkData                                = 7
+    debugPacketType_event                                   = 8
+    debugPacketType_telemetry                               = 9
 
     debugPacketType_invalid                                 = 0xff
 
 
+class debugPortChannel(Enum):
+    """
+    Debug Port Channels - packets sent by the embedded sw are scheduled over virtual channels, each with its
+    own queue and share of the debug port bandwidth.  See cefContract.hpp for which packet types are on which channel.
+    """
+    debugPortChannel_commands                               = 0
+    debugPortChannel_logs                                   = 1
+    debugPortChannel_telemetry                              = 2
+    debugPortChannel_bulkTransfer                           = 3
+    debugPortChannel_events                                 = 4
+
+    debugPortChannel_numChannels                            = 5
+
+
 class cefCommandHeader(structureEndiannessType):
     """
     CEF Command Header
@@ -180,7 +219,7 @@ class cefCommandDebugPortHeader(structureEndiannessType):
 
         # The types of packets are defined in class debugPacketDataType
         ('m_packetType', ctypes.c_uint8),
-        ('m_reserve', ctypes.c_uint8),
+        ('m_flowControlCredits', ctypes.c_uint8),      # See Flow Control Credits (0 from Python)
         ('m_packetHeaderChecksum', ctypes.c_uint16)
     ]
   
@@ -236,6 +275,349 @@ class cefCommandPingResponse(structureEndiannessType):
         ('m_padding2', ctypes.c_uint32),
         ('m_uint64Value', ctypes.c_uint64)
     ]
+
+
+class cefCommandTimeSyncRequest(structureEndiannessType):
+    """
+    CommandTimeSync
+        See command implementation files for variable documentation
+
+    NTP style time transfer, see ClockSync.py for how the time stamps are used
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_hostTransmitTimeNs', ctypes.c_uint64)
+    ]
+
+
+class cefCommandTimeSyncResponse(structureEndiannessType):
+    """
+    CommandTimeSync
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_hostTransmitTimeNs', ctypes.c_uint64),
+        ('m_targetReceiveTimeNs', ctypes.c_uint64),
+        ('m_targetTransmitTimeNs', ctypes.c_uint64)
+    ]
+
+
+"""
+Fragmented Commands
+See cefContract.hpp, a command whose request or response data does not fit in one packet sends it as a series of
+fragments, each a request/response pair of the command's opcode with a cefFragmentHeader.  The first request has
+CEF_FRAGMENT_FLAG_FIRST set, and the response with CEF_FRAGMENT_FLAG_LAST set ends the transfer.
+"""
+CEF_FRAGMENT_FLAG_FIRST = 0x01
+CEF_FRAGMENT_FLAG_LAST = 0x02
+
+class cefFragmentHeader(structureEndiannessType):
+    """
+    Where a fragment's data goes in all the data sent in its direction (see Fragmented Commands)
+    """
+    _fields_ = [
+        ('m_totalNumBytes', ctypes.c_uint32),
+        ('m_offset', ctypes.c_uint32),
+        ('m_numBytes', ctypes.c_uint32),
+        ('m_flags', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint8),
+        ('m_padding2', ctypes.c_uint16)
+    ]
+
+# Maximum number of bytes in a command request or response, not including the cefCommandHeader
+CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER = 512
+CEF_FRAGMENT_MAX_DATA_BYTES = CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER - ctypes.sizeof(cefFragmentHeader)
+
+class cefCommandFragment(structureEndiannessType):
+    """
+    Request and response of every fragment of a fragmented command
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_fragment', cefFragmentHeader),
+        ('m_data', ctypes.c_uint8 * CEF_FRAGMENT_MAX_DATA_BYTES)   # only m_fragment.m_numBytes are sent
+    ]
+
+# Number of bytes in a fragment request or response before its data
+CEF_FRAGMENT_HEADERS_NUM_BYTES = ctypes.sizeof(cefCommandHeader) + ctypes.sizeof(cefFragmentHeader)
+
+
+"""
+Memory Read and Write
+See cefContract.hpp, a memory read response only accepts the read; the data follows in debugPacketType_bulkData
+packets (a cefBulkDataHeader followed by data) until m_numBytes have been sent.  A memory write is a single command
+with the address and its data.
+"""
+class cefCommandMemoryReadRequest(structureEndiannessType):
+    """
+    CommandMemoryRead
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_address', ctypes.c_uint64),
+        ('m_numBytes', ctypes.c_uint32),
+        ('m_transferId', ctypes.c_uint32)
+    ]
+
+
+class cefCommandMemoryReadResponse(structureEndiannessType):
+    """
+    CommandMemoryRead
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_numBytes', ctypes.c_uint32),
+        ('m_transferId', ctypes.c_uint32)
+    ]
+
+
+class cefBulkDataHeader(structureEndiannessType):
+    """
+    Start of every debugPacketType_bulkData packet, the data follows
+    """
+    _fields_ = [
+        ('m_transferId', ctypes.c_uint32),
+        ('m_offset', ctypes.c_uint32)
+    ]
+
+CEF_MEMORY_WRITE_MAX_DATA_BYTES = CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER - 16
+
+class cefCommandMemoryWriteRequest(structureEndiannessType):
+    """
+    CommandMemoryWrite
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_address', ctypes.c_uint64),
+        ('m_numBytes', ctypes.c_uint32),
+        ('m_padding1', ctypes.c_uint32),
+        ('m_data', ctypes.c_uint8 * CEF_MEMORY_WRITE_MAX_DATA_BYTES)   # only m_numBytes are sent
+    ]
+
+# Number of bytes in a memory write request before its data
+CEF_MEMORY_WRITE_HEADERS_NUM_BYTES = ctypes.sizeof(cefCommandMemoryWriteRequest) - CEF_MEMORY_WRITE_MAX_DATA_BYTES
+
+
+class cefCommandMemoryWriteResponse(structureEndiannessType):
+    """
+    CommandMemoryWrite
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_numBytes', ctypes.c_uint32),
+        ('m_padding1', ctypes.c_uint32)
+    ]
+
+
+class cefCommandDebugPortStatsRequest(structureEndiannessType):
+    """
+    CommandDebugPortStats
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader)
+    ]
+
+
+class cefCommandDebugPortStatsResponse(structureEndiannessType):
+    """
+    CommandDebugPortStats
+        See command implementation files for variable documentation
+
+    Debug port error counts since the target started
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_numParityErrors', ctypes.c_uint32),
+        ('m_numNoiseErrors', ctypes.c_uint32),
+        ('m_numFramingErrors', ctypes.c_uint32),
+        ('m_numOverrunErrors', ctypes.c_uint32),
+        ('m_numOtherErrors', ctypes.c_uint32),
+        ('m_numReceiveErrorPacketsDropped', ctypes.c_uint32),
+        ('m_numReceiveTimeouts', ctypes.c_uint32),
+        ('m_numTransmitTimeouts', ctypes.c_uint32)
+    ]
+
+
+"""
+Events
+See cefContract.hpp, a debugPacketType_event packet holds one or more events, each a cefEventHeader followed by
+m_numDataBytes of data, padded to a multiple of 8 bytes
+"""
+class eventId(Enum):
+    eventId_memoryReadDone                                  = 1
+
+    eventId_firstApplicationEvent                           = 0x100
+
+
+class cefEventHeader(structureEndiannessType):
+    """
+    Start of every event in a debugPacketType_event packet, the event's data follows
+    """
+    _fields_ = [
+        ('m_eventId', ctypes.c_uint16),
+        ('m_numDataBytes', ctypes.c_uint16),
+        ('m_eventSequenceNumber', ctypes.c_uint32),
+        ('m_timeStamp', ctypes.c_uint64)
+    ]
+
+CEF_EVENT_MAX_DATA_BYTES = 32
+
+
+class cefEventMemoryReadDone(structureEndiannessType):
+    """
+    Data of eventId_memoryReadDone
+    """
+    _fields_ = [
+        ('m_transferId', ctypes.c_uint32),
+        ('m_numBytes', ctypes.c_uint32)
+    ]
+
+
+"""
+Telemetry
+See cefContract.hpp, a debugPacketType_telemetry packet is a cefTelemetryFrameHeader followed by the samples of
+each tick in turn (see Telemetry.py)
+"""
+class telemetryType(Enum):
+    telemetryType_uint8                                     = 0
+    telemetryType_int8                                      = 1
+    telemetryType_uint16                                    = 2
+    telemetryType_int16                                     = 3
+    telemetryType_uint32                                    = 4
+    telemetryType_int32                                     = 5
+    telemetryType_uint64                                    = 6
+    telemetryType_int64                                     = 7
+    telemetryType_float32                                   = 8
+    telemetryType_float64                                   = 9
+
+
+class telemetryControl(Enum):
+    telemetryControl_none                                   = 0
+    telemetryControl_start                                  = 1
+    telemetryControl_stop                                   = 2
+
+TELEMETRY_MAX_NUM_CHANNELS = 16
+TELEMETRY_CHANNEL_NAME_NUM_BYTES = 24
+TELEMETRY_DECIMATION_UNCHANGED = 0xFFFF
+
+
+class cefCommandTelemetryRequest(structureEndiannessType):
+    """
+    CommandTelemetry
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_channelIndex', ctypes.c_uint16),
+        ('m_decimation', ctypes.c_uint16),
+        ('m_control', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint8),
+        ('m_padding2', ctypes.c_uint16)
+    ]
+
+
+class cefCommandTelemetryResponse(structureEndiannessType):
+    """
+    CommandTelemetry
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_numChannels', ctypes.c_uint16),
+        ('m_channelIndex', ctypes.c_uint16),
+        ('m_decimation', ctypes.c_uint16),
+        ('m_type', ctypes.c_uint8),
+        ('m_streaming', ctypes.c_uint8),
+        ('m_configurationNumber', ctypes.c_uint16),
+        ('m_padding1', ctypes.c_uint16),
+        ('m_padding2', ctypes.c_uint32),
+        ('m_name', ctypes.c_char * TELEMETRY_CHANNEL_NAME_NUM_BYTES)
+    ]
+
+
+class cefTelemetryFrameHeader(structureEndiannessType):
+    """
+    Start of every debugPacketType_telemetry packet, the samples follow
+    """
+    _fields_ = [
+        ('m_firstTickTimeStamp', ctypes.c_uint64),
+        ('m_lastTickTimeStamp', ctypes.c_uint64),
+        ('m_frameSequenceNumber', ctypes.c_uint32),
+        ('m_firstTick', ctypes.c_uint32),
+        ('m_numTicks', ctypes.c_uint16),
+        ('m_configurationNumber', ctypes.c_uint16),
+        ('m_padding1', ctypes.c_uint32)
+    ]
+
+
+"""
+Software Scope
+See cefContract.hpp, the entries of a sampling list are added to the telemetry channels as address channels
+"""
+TELEMETRY_MAX_NUM_ADDRESS_CHANNELS = 8
+
+
+class cefSoftwareScopeEntry(structureEndiannessType):
+    """
+    An address to sample, in a CommandSoftwareScope request
+    """
+    _fields_ = [
+        ('m_address', ctypes.c_uint64),
+        ('m_decimation', ctypes.c_uint16),
+        ('m_type', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint8),
+        ('m_padding2', ctypes.c_uint32),
+        ('m_name', ctypes.c_char * TELEMETRY_CHANNEL_NAME_NUM_BYTES)
+    ]
+
+
+class cefCommandSoftwareScopeRequest(structureEndiannessType):
+    """
+    CommandSoftwareScope
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_numEntries', ctypes.c_uint8),
+        ('m_replace', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint16),
+        ('m_padding2', ctypes.c_uint32),
+        ('m_entries', cefSoftwareScopeEntry * TELEMETRY_MAX_NUM_ADDRESS_CHANNELS)
+    ]
+
+CEF_SOFTWARE_SCOPE_HEADERS_NUM_BYTES = ctypes.sizeof(cefCommandHeader) + 8
+
+
+class cefCommandSoftwareScopeResponse(structureEndiannessType):
+    """
+    CommandSoftwareScope
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_numChannels', ctypes.c_uint16),
+        ('m_numAddressChannels', ctypes.c_uint16),
+        ('m_configurationNumber', ctypes.c_uint16),
+        ('m_padding1', ctypes.c_uint16)
+    ]
     
 
 #####################################################################################################################
@@ -257,6 +639,40 @@ class logType(Enum):
 #Converts logging uint64_t nano second value/count into seconds
 LOGGING_UINT64_NSEC_TO_SECONDS = 1000000000
 
+#Module id used in logging commands to address every logging module at once
+LOGGING_MODULE_ID_ALL_MODULES = 0xFF
+
+
+class cefCommandSetLogThresholdRequest(structureEndiannessType):
+    """
+    CommandSetLogThreshold
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_moduleId', ctypes.c_uint8),
+        ('m_logThreshold', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint16),
+        ('m_padding2', ctypes.c_uint32)
+    ]
+
+
+class cefCommandSetLogThresholdResponse(structureEndiannessType):
+    """
+    CommandSetLogThreshold
+        See command implementation files for variable documentation
+    """
+    _fields_ = [
+        ('m_header', cefCommandHeader),
+
+        ('m_moduleId', ctypes.c_uint8),
+        ('m_previousLogThreshold', ctypes.c_uint8),
+        ('m_numLogModules', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint8),
+        ('m_padding2', ctypes.c_uint32)
+    ]
+
 LOGGING_ASCII_LOG_STRING_MAX_NUM_CHARACTERS = 128
 LOGGING_ASCII_FILENAME_NUM_CHARACTERS = 40
 
@@ -276,11 +692,76 @@ class cefLog(structureEndiannessType):
         ('m_fileLineNumber', ctypes.c_uint32),
         ('m_logSequenceNumber', ctypes.c_uint16),
         ('m_moduleId', ctypes.c_uint8),
-        ('m_logType', ctypes.c_uint8),    
+        ('m_logType', ctypes.c_uint8),
+        ('m_numSuppressedLogs', ctypes.c_uint32),
+        ('m_padding1', ctypes.c_uint32),
     ]
  
  
  
+"""
+Packed Logging Format (debugPacketType_loggingDataPacked)
+See cefContract.hpp for the packed log record layout
+"""
+LOG_PACKED_FLAGS_NUM_VARIABLES_MASK = 0x03
+LOG_PACKED_FLAG_ABSOLUTE_TIMESTAMP  = 0x04
+LOG_PACKED_FLAG_SUPPRESSED_LOGS     = 0x08
+
+
+"""
+Batch Format (debugPacketType_batch)
+See cefContract.hpp for the batch layout
+"""
+DEBUG_PORT_BATCH_MAX_NUM_RECORDS = 8
+
+class cefBatchHeader(structureEndiannessType):
+    """
+    Start of a batch payload, followed by m_numRecords cefBatchRecordTableEntry and then the records
+    """
+    _fields_ = [
+        ('m_numRecords', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint8),
+        ('m_padding2', ctypes.c_uint16)
+    ]
+
+
+class cefBatchRecordTableEntry(structureEndiannessType):
+    """
+    Type (debugPacketDataType) and size of one record in a batch
+    """
+    _fields_ = [
+        ('m_recordType', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint8),
+        ('m_recordNumBytes', ctypes.c_uint16)
+    ]
+
+
+"""
+Reliable Delivery
+See cefContract.hpp, when DEBUG_PORT_RELIABLE_DELIVERY is 1 every payload starts with a cefReliableHeader, and lost or
+corrupted packets are retransmitted (sliding window, cumulative ACKs, NACKs for selective retransmission)
+"""
+DEBUG_PORT_RELIABLE_DELIVERY = 0
+DEBUG_PORT_RELIABLE_WINDOW_SIZE = 4
+DEBUG_PORT_RELIABLE_RETRANSMIT_TIMEOUT_MS = 250
+DEBUG_PORT_RELIABLE_FLAG_NACK = 0x01
+DEBUG_PORT_RELIABLE_FLAG_SYNC = 0x02
+
+class cefReliableHeader(structureEndiannessType):
+    """
+    Reliable delivery header at the start of every payload (see Reliable Delivery)
+    """
+    _fields_ = [
+        ('m_sequenceNumber', ctypes.c_uint8),
+        ('m_ackSequenceNumber', ctypes.c_uint8),
+        ('m_flags', ctypes.c_uint8),
+        ('m_nackSequenceNumber', ctypes.c_uint8),
+        ('m_padding1', ctypes.c_uint32)
+    ]
+
+DEBUG_PORT_RELIABLE_HEADER_SIZE_BYTES = DEBUG_PORT_RELIABLE_DELIVERY * ctypes.sizeof(cefReliableHeader)
+
+
 #####################################################################################################################
 ######  DEBUG PORT CONSTANTS THAT RELY ON PREVIOUSLY DEFINED CLASSES                                           ######
 #####################################################################################################################
@@ -292,7 +773,7 @@ In other words, the total number of bytes the application layer would request th
 transport layer to received/send.
 This number does NOT include Transport layer headers.
 """
-DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND = ctypes.sizeof(cefCommandHeader) + 512
+DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND = ctypes.sizeof(cefCommandHeader) + CEF_COMMAND_MAX_NUM_BYTES_AFTER_HEADER
 DEBUG_PORT_MAX_APPLICATION_PAYLOAD_LOG = ctypes.sizeof(cefLog)
 DEBUG_PORT_MAX_APPLICATION_PAYLOAD = DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND \
 		if DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND > DEBUG_PORT_MAX_APPLICATION_PAYLOAD_LOG \
@@ -302,5 +783,32 @@ DEBUG_PORT_MAX_APPLICATION_PAYLOAD = DEBUG_PORT_MAX_APPLICATION_PAYLOAD_COMMAND
 Debug Port Packet Size
   * Max number of bytes in a debug port packet
 """
-DEBUG_PORT_MAX_PACKET_SIZE_BYTES = ctypes.sizeof(cefCommandDebugPortHeader) + DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+DEBUG_PORT_MAX_PACKET_SIZE_BYTES = ctypes.sizeof(cefCommandDebugPortHeader) + DEBUG_PORT_RELIABLE_HEADER_SIZE_BYTES + \
+                                   DEBUG_PORT_MAX_APPLICATION_PAYLOAD
+
+"""
+Debug Port Framing
+See cefContract.hpp, when DEBUG_PORT_FRAMING_COBS is 1 packets are COBS encoded and delimited by DEBUG_PORT_COBS_DELIMITER
+"""
+DEBUG_PORT_FRAMING_COBS = 0
+DEBUG_PORT_COBS_DELIMITER = 0x00
+
+def DEBUG_PORT_COBS_MAX_ENCODED_SIZE_BYTES(numBytes):
+    return numBytes + (numBytes // 254) + 1
+
+"""
+Debug Port Frame Size
+  * Max number of bytes on the wire for a debug port packet (COBS encoded packet and delimiter)
+"""
+DEBUG_PORT_MAX_FRAME_SIZE_BYTES = DEBUG_PORT_COBS_MAX_ENCODED_SIZE_BYTES(DEBUG_PORT_MAX_PACKET_SIZE_BYTES) + 1
+
+"""
+Flow Control Credits
+See cefContract.hpp, the embedded sw advertises its command credit limit (bits 0-3) and free log entries (bits 4-7)
+in every header's m_flowControlCredits
+"""
+DEBUG_PORT_NUM_COMMAND_RECEIVE_SLOTS = 1
+DEBUG_PORT_CREDITS_COMMAND_LIMIT_MASK = 0x0F
+DEBUG_PORT_CREDITS_LOG_CAPACITY_SHIFT = 4
+DEBUG_PORT_CREDITS_LOG_CAPACITY_MAX = 0x0F
  